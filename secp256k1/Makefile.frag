@@ -0,0 +1,7 @@
+BENCH_INI =
+BENCH_ARGS =
+
+bench: all
+	$(PHP_EXECUTABLE) -n -d extension_dir=$(phplibdir) -d extension=secp256k1.$(SHLIB_DL_SUFFIX_NAME) $(BENCH_INI) $(srcdir)/bench/run.php $(BENCH_ARGS)
+
+.PHONY: bench
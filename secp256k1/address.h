@@ -0,0 +1,187 @@
+#include <stdint.h>
+#include <string.h>
+
+/** Bitcoin address encoding: base58check for P2PKH, bech32 (BIP173) for
+ *  segwit v0 and bech32m (BIP350) for taproot outputs.
+ *
+ *  Only encoding is provided, the inputs come from libsecp256k1 and are
+ *  valid by construction. Everything here is plain C and safe to run on the
+ *  batch pool. Requires sha2.h and ripemd160.h to be included first.
+ */
+
+/* BIP173 and BIP350 cap a whole address at 90 characters, which leaves the
+ * hrp what the separator, the version, the program in 5 bit words and the
+ * checksum do not take: 50 characters for P2WPKH, 30 for P2TR. */
+#define BECH32_MAX_LENGTH 90
+#define BECH32_MAX_HRP_LENGTH(proglen) (BECH32_MAX_LENGTH - 1 - 1 - ((proglen) * 8 + 4) / 5 - 6)
+/* room for the longest address and the terminator */
+#define ADDRESS_MAX_LENGTH (BECH32_MAX_LENGTH + 1)
+#define BASE58CHECK_MAX_INPUT 82
+
+static const char php_secp256k1_base58_alphabet[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+static const char php_secp256k1_bech32_charset[] = "qpzry9x8gf2tvdw0s3jn54khce6mua7l";
+
+/* writes the base58 encoding of data || SHA256(SHA256(data))[0..4] to out,
+ * NUL terminated, and returns its length. len is at most
+ * BASE58CHECK_MAX_INPUT. */
+static size_t php_secp256k1_base58check_encode(const unsigned char *data, size_t len, char *out)
+{
+    unsigned char buf[BASE58CHECK_MAX_INPUT + 4], digest[32];
+    // log(256) / log(58) rounded up
+    unsigned char digits[(BASE58CHECK_MAX_INPUT + 4) * 138 / 100 + 1];
+    php_secp256k1_sha256 hash;
+    size_t total = len + 4, zeros = 0, size, length = 0, i, j, n = 0;
+    unsigned int carry;
+
+    php_secp256k1_sha256_init(&hash);
+    php_secp256k1_sha256_write(&hash, data, len);
+    php_secp256k1_sha256_finalize(&hash, digest);
+    php_secp256k1_sha256_init(&hash);
+    php_secp256k1_sha256_write(&hash, digest, 32);
+    php_secp256k1_sha256_finalize(&hash, digest);
+    memcpy(buf, data, len);
+    memcpy(buf + len, digest, 4);
+
+    // leading zero bytes are encoded as leading '1's
+    while (zeros < total && buf[zeros] == 0) {
+        zeros++;
+    }
+    size = (total - zeros) * 138 / 100 + 1;
+    memset(digits, 0, size);
+    for (i = zeros; i < total; i++) {
+        carry = buf[i];
+        for (j = 0; carry != 0 || j < length; j++) {
+            carry += 256 * (unsigned int) digits[size - 1 - j];
+            digits[size - 1 - j] = (unsigned char) (carry % 58);
+            carry /= 58;
+        }
+        length = j;
+    }
+
+    for (i = 0; i < zeros; i++) {
+        out[n++] = '1';
+    }
+    for (j = size - length; j < size; j++) {
+        out[n++] = php_secp256k1_base58_alphabet[digits[j]];
+    }
+    out[n] = '\0';
+    return n;
+}
+
+/* checks a human readable part for a witness program of proglen bytes:
+ * printable characters, lowercase as the encoder does not fold case, and
+ * short enough to keep the address within BECH32_MAX_LENGTH. */
+static int php_secp256k1_bech32_hrp_valid(const char *hrp, size_t len, size_t proglen)
+{
+    size_t i;
+    if (len < 1 || len > BECH32_MAX_HRP_LENGTH(proglen)) {
+        return 0;
+    }
+    for (i = 0; i < len; i++) {
+        if (hrp[i] < 33 || hrp[i] > 126 || (hrp[i] >= 'A' && hrp[i] <= 'Z')) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static uint32_t php_secp256k1_bech32_polymod_step(uint32_t pre)
+{
+    uint32_t b = pre >> 25;
+    return ((pre & 0x1ffffff) << 5)
+        ^ ((b & 1) ? 0x3b6a57b2 : 0)
+        ^ ((b & 2) ? 0x26508e6d : 0)
+        ^ ((b & 4) ? 0x1ea119fa : 0)
+        ^ ((b & 8) ? 0x3d4233dd : 0)
+        ^ ((b & 16) ? 0x2a1462b3 : 0);
+}
+
+/* writes the segwit address of a witness program to out, NUL terminated:
+ * bech32 for version 0, bech32m for later versions. returns its length.
+ * hrp must pass php_secp256k1_bech32_hrp_valid for proglen. */
+static size_t php_secp256k1_segwit_encode(char *out, const char *hrp, size_t hrplen,
+                                          unsigned char witver, const unsigned char *prog, size_t proglen)
+{
+    unsigned char data[BECH32_MAX_LENGTH];
+    size_t datalen = 0, i, n = 0;
+    uint32_t chk = 1, acc = 0;
+    int bits = 0;
+
+    // the version, then the program regrouped from 8 to 5 bit words
+    data[datalen++] = witver;
+    for (i = 0; i < proglen; i++) {
+        acc = (acc << 8) | prog[i];
+        bits += 8;
+        while (bits >= 5) {
+            bits -= 5;
+            data[datalen++] = (acc >> bits) & 31;
+        }
+    }
+    if (bits > 0) {
+        data[datalen++] = (acc << (5 - bits)) & 31;
+    }
+
+    for (i = 0; i < hrplen; i++) {
+        chk = php_secp256k1_bech32_polymod_step(chk) ^ ((unsigned char) hrp[i] >> 5);
+    }
+    chk = php_secp256k1_bech32_polymod_step(chk);
+    for (i = 0; i < hrplen; i++) {
+        chk = php_secp256k1_bech32_polymod_step(chk) ^ (hrp[i] & 31);
+        out[n++] = hrp[i];
+    }
+    out[n++] = '1';
+    for (i = 0; i < datalen; i++) {
+        chk = php_secp256k1_bech32_polymod_step(chk) ^ data[i];
+        out[n++] = php_secp256k1_bech32_charset[data[i]];
+    }
+    for (i = 0; i < 6; i++) {
+        chk = php_secp256k1_bech32_polymod_step(chk);
+    }
+    chk ^= witver == 0 ? 1 : 0x2bc830a3;
+    for (i = 0; i < 6; i++) {
+        out[n++] = php_secp256k1_bech32_charset[(chk >> ((5 - i) * 5)) & 31];
+    }
+    out[n] = '\0';
+    return n;
+}
+
+/* writes the P2PKH address of a serialized public key. */
+static size_t php_secp256k1_address_p2pkh(char *out, unsigned char version, const unsigned char *pubkey, size_t pubkeylen)
+{
+    unsigned char payload[21];
+    payload[0] = version;
+    php_secp256k1_hash160(pubkey, pubkeylen, payload + 1);
+    return php_secp256k1_base58check_encode(payload, sizeof(payload), out);
+}
+
+/* writes the P2WPKH address of a compressed public key. */
+static size_t php_secp256k1_address_p2wpkh(char *out, const char *hrp, size_t hrplen, const unsigned char *pubkey33)
+{
+    unsigned char program[20];
+    php_secp256k1_hash160(pubkey33, PUBKEY_COMPRESSED_LENGTH, program);
+    return php_secp256k1_segwit_encode(out, hrp, hrplen, 0, program, sizeof(program));
+}
+
+#ifdef SECP256K1_MODULE_EXTRAKEYS
+/* computes the BIP341 output key of an internal key without a script tree,
+ * as BIP86 wallets use: P + hash_TapTweak(P) * G. */
+static int php_secp256k1_taproot_output_key(const secp256k1_context *ctx, unsigned char *out32,
+                                            const secp256k1_xonly_pubkey *internal)
+{
+    static const unsigned char tag[] = "TapTweak";
+    php_secp256k1_sha256 hash;
+    unsigned char x[32], tweak[32];
+    secp256k1_pubkey output;
+    secp256k1_xonly_pubkey xonly;
+
+    if (!secp256k1_xonly_pubkey_serialize(ctx, x, internal)) {
+        return 0;
+    }
+    php_secp256k1_sha256_init_tagged(&hash, tag, sizeof(tag) - 1);
+    php_secp256k1_sha256_write(&hash, x, 32);
+    php_secp256k1_sha256_finalize(&hash, tweak);
+    return secp256k1_xonly_pubkey_tweak_add(ctx, &output, internal, tweak)
+        && secp256k1_xonly_pubkey_from_pubkey(ctx, &xonly, NULL, &output)
+        && secp256k1_xonly_pubkey_serialize(ctx, out32, &xonly);
+}
+#endif
@@ -0,0 +1,612 @@
+<?php
+/**
+ * Benchmark definitions, loaded by run.php with $bench in scope.
+ *
+ * Inputs are created once up front so each closure only measures the call
+ * itself. Functions writing to an out parameter are given a fresh variable
+ * where the function would otherwise free the previous value, as a caller
+ * in a loop would.
+ *
+ * @var Bench $bench
+ */
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$priv = pack("H*", "31a84594060e103f5a63eb742bd46cf5f5900d8406e2726dedfc61c7cf43ebad");
+$priv2 = pack("H*", "17a2209250b59f07a25b560aa09cb395a183eb260797c0396b82904f918518d5");
+$msg32 = pack("H*", "9e5755ec2f328cc8635a55415d0e9a09c2b6f2c9b0343c945fbbfe08247a4cbe");
+$tweak32 = hash('sha256', 'tweak', true);
+
+$pub = null;
+secp256k1_ec_pubkey_create($ctx, $pub, $priv);
+$pubObj = new \Secp256k1\PublicKey();
+secp256k1_ec_pubkey_create($ctx, $pubObj, $priv);
+$pub33 = '';
+secp256k1_ec_pubkey_serialize($ctx, $pub33, $pub, SECP256K1_EC_COMPRESSED);
+$pub65 = '';
+secp256k1_ec_pubkey_serialize($ctx, $pub65, $pub, SECP256K1_EC_UNCOMPRESSED);
+
+$sig = null;
+secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv);
+$sigObj = new \Secp256k1\EcdsaSignature();
+secp256k1_ecdsa_sign($ctx, $sigObj, $msg32, $priv);
+$sigDer = '';
+secp256k1_ecdsa_signature_serialize_der($ctx, $sigDer, $sig);
+$sig64 = '';
+secp256k1_ecdsa_signature_serialize_compact($ctx, $sig64, $sig);
+
+// batches of distinct keys, messages and signatures
+$batchSize = 256;
+$batchPrivs = [];
+$batchMsgs = [];
+$batchPubs = [];
+$batchSigs = [];
+$batchVector = new \Secp256k1\PublicKeyVector($batchSize);
+for ($i = 0; $i < $batchSize; $i++) {
+    $batchPrivs[$i] = hash('sha256', "key $i", true);
+    $batchMsgs[$i] = hash('sha256', "message $i", true);
+    $batchPubs[$i] = null;
+    $batchSigs[$i] = null;
+    secp256k1_ec_pubkey_create($ctx, $batchPubs[$i], $batchPrivs[$i]);
+    secp256k1_ecdsa_sign($ctx, $batchSigs[$i], $batchMsgs[$i], $batchPrivs[$i]);
+    $batchVector->append($batchPubs[$i]);
+}
+$batchBlob33 = '';
+secp256k1_ec_pubkey_serialize_many($ctx, $batchBlob33, $batchVector, SECP256K1_EC_COMPRESSED);
+
+// userland equivalents of the native nonce and hash functions, to measure
+// the cost of calling back into PHP
+$nonceCallback = function (&$nonce, $msg32, $key32, $algo16, $data, $attempt) {
+    return secp256k1_nonce_function_rfc6979($nonce, $msg32, $key32, $algo16, $data, $attempt);
+};
+$ecdhCallback = function (&$output, $x, $y) {
+    $output = hash('sha256', chr(0x02 | (ord($y[31]) & 0x01)) . $x, true);
+    return 1;
+};
+$ecdhSha512 = function (&$output, $x, $y) {
+    $output = hash('sha512', $x . $y, true);
+    return 1;
+};
+
+// context
+$bench->add('secp256k1_context_create', 'none', function () {
+    secp256k1_context_create(SECP256K1_CONTEXT_NONE);
+});
+$bench->add('secp256k1_context_create', 'sign_verify', function () {
+    secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+});
+$bench->add('secp256k1_context_clone', '', function () use ($ctx) {
+    secp256k1_context_clone($ctx);
+});
+$bench->add('secp256k1_context_destroy', '', function () {
+    $c = secp256k1_context_create(SECP256K1_CONTEXT_NONE);
+    secp256k1_context_destroy($c);
+});
+$bench->add('secp256k1_context_persistent', '', function () {
+    secp256k1_context_persistent(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+});
+$bench->add('secp256k1_cache_stats', '', function () {
+    secp256k1_cache_stats();
+});
+$bench->add('secp256k1_stats', '', function () {
+    secp256k1_stats();
+});
+if (ini_get('secp256k1.trace')) {
+    $bench->add('secp256k1_trace_register', 'and unregister', function () {
+        secp256k1_trace_unregister(secp256k1_trace_register(null, null));
+    });
+}
+$bench->add('secp256k1_trace_unregister', 'unknown id', function () {
+    secp256k1_trace_unregister(-1);
+});
+$randomizeCtx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN);
+$seed32 = random_bytes(32);
+$bench->add('secp256k1_context_randomize', '', function () use ($randomizeCtx, $seed32) {
+    secp256k1_context_randomize($randomizeCtx, $seed32);
+});
+$bench->add('secp256k1_scratch_space_create', '', function () use ($ctx) {
+    secp256k1_scratch_space_create($ctx, 1024);
+});
+$bench->add('secp256k1_scratch_space_destroy', '', function () use ($ctx) {
+    $scratch = secp256k1_scratch_space_create($ctx, 1024);
+    secp256k1_scratch_space_destroy($ctx, $scratch);
+});
+
+// secret keys
+$bench->add('secp256k1_ec_seckey_verify', '', function () use ($ctx, $priv) {
+    secp256k1_ec_seckey_verify($ctx, $priv);
+});
+$bench->add('secp256k1_ec_privkey_negate', '', function () use ($ctx, $priv) {
+    $key = $priv;
+    secp256k1_ec_privkey_negate($ctx, $key);
+});
+$bench->add('secp256k1_ec_privkey_tweak_add', '', function () use ($ctx, $priv, $tweak32) {
+    $key = $priv;
+    secp256k1_ec_privkey_tweak_add($ctx, $key, $tweak32);
+});
+$bench->add('secp256k1_ec_privkey_tweak_mul', '', function () use ($ctx, $priv, $tweak32) {
+    $key = $priv;
+    secp256k1_ec_privkey_tweak_mul($ctx, $key, $tweak32);
+});
+
+// public keys
+$bench->add('secp256k1_ec_pubkey_create', 'resource', function () use ($ctx, $priv) {
+    $out = null;
+    secp256k1_ec_pubkey_create($ctx, $out, $priv);
+});
+$bench->add('secp256k1_ec_pubkey_create', 'object', function () use ($ctx, $priv) {
+    $out = new \Secp256k1\PublicKey();
+    secp256k1_ec_pubkey_create($ctx, $out, $priv);
+});
+$batchPrivBlob = implode('', $batchPrivs);
+$bench->add('secp256k1_ec_pubkey_create_many', "loop/$batchSize", function () use ($ctx, $batchPrivs) {
+    $out = '';
+    foreach ($batchPrivs as $batchPriv) {
+        $pubkey = null;
+        $one = '';
+        secp256k1_ec_pubkey_create($ctx, $pubkey, $batchPriv);
+        secp256k1_ec_pubkey_serialize($ctx, $one, $pubkey, SECP256K1_EC_COMPRESSED);
+        $out .= $one;
+    }
+}, $batchSize);
+$bench->add('secp256k1_ec_pubkey_create_many', "$batchSize", function () use ($ctx, $batchPrivBlob) {
+    $out = null;
+    $valid = null;
+    secp256k1_ec_pubkey_create_many($ctx, $out, $valid, $batchPrivBlob, SECP256K1_EC_COMPRESSED);
+}, $batchSize);
+$bip32Master = null;
+$bip32Account = null;
+secp256k1_bip32_master($ctx, $bip32Master, $priv);
+secp256k1_bip32_derive($ctx, $bip32Account, $bip32Master, "m/84'/0'/0'/0");
+$bench->add('secp256k1_bip32_derive', 'path/uncached', function () use ($ctx, $bip32Master) {
+    static $i = 0;
+    $out = null;
+    ini_set('secp256k1.bip32_cache_size', '0');
+    secp256k1_bip32_derive($ctx, $out, $bip32Master, "m/84'/0'/0'/0/" . ($i++ & 0x7fffffff));
+    ini_set('secp256k1.bip32_cache_size', '256');
+});
+$bench->add('secp256k1_bip32_derive', 'path/cached', function () use ($ctx, $bip32Master) {
+    static $i = 0;
+    $out = null;
+    secp256k1_bip32_derive($ctx, $out, $bip32Master, "m/84'/0'/0'/0/" . ($i++ & 0x7fffffff));
+});
+$bench->add('secp256k1_bip32_derive_many', "loop/$batchSize", function () use ($ctx, $bip32Account, $batchSize) {
+    $out = '';
+    // uncached, like the batch
+    ini_set('secp256k1.bip32_cache_size', '0');
+    for ($i = 0; $i < $batchSize; $i++) {
+        $child = null;
+        $pubkey = null;
+        $one = '';
+        secp256k1_bip32_derive($ctx, $child, $bip32Account, "$i");
+        secp256k1_bip32_pubkey($ctx, $pubkey, $child);
+        secp256k1_ec_pubkey_serialize($ctx, $one, $pubkey, SECP256K1_EC_COMPRESSED);
+        $out .= $one;
+    }
+    ini_set('secp256k1.bip32_cache_size', '256');
+}, $batchSize);
+$bench->add('secp256k1_bip32_derive_many', "$batchSize", function () use ($ctx, $bip32Account, $batchSize) {
+    $out = null;
+    $valid = null;
+    secp256k1_bip32_derive_many($ctx, $out, $valid, $bip32Account, 0, $batchSize, SECP256K1_EC_COMPRESSED);
+}, $batchSize);
+$bench->add('secp256k1_address_p2wpkh', 'single', function () use ($ctx, $pub) {
+    $out = null;
+    secp256k1_address_p2wpkh($ctx, $out, $pub);
+});
+$bench->add('secp256k1_address_many', "loop/$batchSize", function () use ($ctx, $batchPubs) {
+    foreach ($batchPubs as $pubkey) {
+        $out = null;
+        secp256k1_address_p2wpkh($ctx, $out, $pubkey);
+    }
+}, $batchSize);
+$bench->add('secp256k1_address_many', "$batchSize", function () use ($ctx, $batchBlob33) {
+    $out = null;
+    $valid = null;
+    secp256k1_address_many($ctx, $out, $valid, SECP256K1_ADDRESS_P2WPKH, $batchBlob33);
+}, $batchSize);
+$sha256Prefix = new \Secp256k1\Sha256('MyProtocol/leaf');
+$bench->add('secp256k1_tagged_sha256', 'userland', function () use ($msg32) {
+    $tag = hash('sha256', 'TapTweak', true);
+    hash('sha256', $tag . $tag . $msg32, true);
+});
+$bench->add('secp256k1_tagged_sha256', 'native', function () use ($msg32) {
+    $out = null;
+    secp256k1_tagged_sha256($out, 'TapTweak', $msg32);
+});
+$bench->add('secp256k1_tagged_sha256', 'object/clone', function () use ($msg32, $sha256Prefix) {
+    $hash = clone $sha256Prefix;
+    $hash->update($msg32);
+    $hash->digest();
+});
+$bench->add('secp256k1_ec_pubkey_parse', 'compressed', function () use ($ctx, $pub33) {
+    $out = null;
+    secp256k1_ec_pubkey_parse($ctx, $out, $pub33);
+});
+$bench->add('secp256k1_ec_pubkey_parse', 'uncompressed', function () use ($ctx, $pub65) {
+    $out = null;
+    secp256k1_ec_pubkey_parse($ctx, $out, $pub65);
+});
+$bench->add('secp256k1_ec_pubkey_parse', 'object', function () use ($ctx, $pub33) {
+    $out = new \Secp256k1\PublicKey();
+    secp256k1_ec_pubkey_parse($ctx, $out, $pub33);
+});
+$bench->add('secp256k1_ec_pubkey_parse', "loop/$batchSize", function () use ($ctx, $batchBlob33, $batchSize) {
+    for ($i = 0; $i < $batchSize; $i++) {
+        $out = null;
+        secp256k1_ec_pubkey_parse($ctx, $out, substr($batchBlob33, $i * 33, 33));
+    }
+}, $batchSize);
+$bench->add('secp256k1_ec_pubkey_parse_many', "$batchSize", function () use ($ctx, $batchBlob33) {
+    $keys = null;
+    $valid = null;
+    secp256k1_ec_pubkey_parse_many($ctx, $keys, $valid, $batchBlob33, 33);
+}, $batchSize);
+$bench->add('secp256k1_ec_pubkey_serialize', 'resource', function () use ($ctx, $pub) {
+    $out = '';
+    secp256k1_ec_pubkey_serialize($ctx, $out, $pub, SECP256K1_EC_COMPRESSED);
+});
+$bench->add('secp256k1_ec_pubkey_serialize', 'object', function () use ($ctx, $pubObj) {
+    $out = '';
+    secp256k1_ec_pubkey_serialize($ctx, $out, $pubObj, SECP256K1_EC_COMPRESSED);
+});
+$bench->add('secp256k1_ec_pubkey_serialize', "loop/$batchSize", function () use ($ctx, $batchPubs) {
+    $out = '';
+    foreach ($batchPubs as $batchPub) {
+        $one = '';
+        secp256k1_ec_pubkey_serialize($ctx, $one, $batchPub, SECP256K1_EC_COMPRESSED);
+        $out .= $one;
+    }
+}, $batchSize);
+$bench->add('secp256k1_ec_pubkey_serialize_many', "array/$batchSize", function () use ($ctx, $batchPubs) {
+    $out = '';
+    secp256k1_ec_pubkey_serialize_many($ctx, $out, $batchPubs, SECP256K1_EC_COMPRESSED);
+}, $batchSize);
+$bench->add('secp256k1_ec_pubkey_serialize_many', "vector/$batchSize", function () use ($ctx, $batchVector) {
+    $out = '';
+    secp256k1_ec_pubkey_serialize_many($ctx, $out, $batchVector, SECP256K1_EC_COMPRESSED);
+}, $batchSize);
+$bench->add('secp256k1_ec_pubkey_negate', '', function () use ($ctx, $pubObj) {
+    secp256k1_ec_pubkey_negate($ctx, $pubObj);
+});
+$bench->add('secp256k1_ec_pubkey_tweak_add', '', function () use ($ctx, $pub33, $tweak32) {
+    $key = new \Secp256k1\PublicKey();
+    secp256k1_ec_pubkey_parse($ctx, $key, $pub33);
+    secp256k1_ec_pubkey_tweak_add($ctx, $key, $tweak32);
+});
+$bench->add('secp256k1_ec_pubkey_tweak_mul', '', function () use ($ctx, $pub33, $tweak32) {
+    $key = new \Secp256k1\PublicKey();
+    secp256k1_ec_pubkey_parse($ctx, $key, $pub33);
+    secp256k1_ec_pubkey_tweak_mul($ctx, $key, $tweak32);
+});
+$bench->add('secp256k1_ec_pubkey_combine', "array/$batchSize", function () use ($ctx, $batchPubs) {
+    $out = null;
+    secp256k1_ec_pubkey_combine($ctx, $out, $batchPubs);
+}, $batchSize);
+$bench->add('secp256k1_ec_pubkey_combine', "vector/$batchSize", function () use ($ctx, $batchVector) {
+    $out = null;
+    secp256k1_ec_pubkey_combine($ctx, $out, $batchVector);
+}, $batchSize);
+
+// ecdsa signatures
+$bench->add('secp256k1_ecdsa_sign', 'native_nonce', function () use ($ctx, $msg32, $priv) {
+    $out = null;
+    secp256k1_ecdsa_sign($ctx, $out, $msg32, $priv);
+});
+$bench->add('secp256k1_ecdsa_sign', 'native_nonce/object', function () use ($ctx, $msg32, $priv) {
+    $out = new \Secp256k1\EcdsaSignature();
+    secp256k1_ecdsa_sign($ctx, $out, $msg32, $priv);
+});
+$bench->add('secp256k1_ecdsa_sign', 'nonce_function_rfc6979', function () use ($ctx, $msg32, $priv) {
+    $out = null;
+    secp256k1_ecdsa_sign($ctx, $out, $msg32, $priv, 'secp256k1_nonce_function_rfc6979');
+});
+$bench->add('secp256k1_ecdsa_sign', 'userland_nonce', function () use ($ctx, $msg32, $priv, $nonceCallback) {
+    $out = null;
+    secp256k1_ecdsa_sign($ctx, $out, $msg32, $priv, $nonceCallback);
+});
+$bench->add('secp256k1_ecdsa_verify', 'resource', function () use ($ctx, $sig, $msg32, $pub) {
+    secp256k1_ecdsa_verify($ctx, $sig, $msg32, $pub);
+});
+$bench->add('secp256k1_ecdsa_verify', 'object', function () use ($ctx, $sigObj, $msg32, $pubObj) {
+    secp256k1_ecdsa_verify($ctx, $sigObj, $msg32, $pubObj);
+});
+$bench->add('secp256k1_ecdsa_verify', 'parse/der', function () use ($ctx, $sigDer, $msg32, $pub33) {
+    $sig = null;
+    $pub = null;
+    secp256k1_ecdsa_signature_parse_der($ctx, $sig, $sigDer);
+    secp256k1_ec_pubkey_parse($ctx, $pub, $pub33);
+    secp256k1_ecdsa_verify($ctx, $sig, $msg32, $pub);
+});
+$bench->add('secp256k1_ecdsa_verify_raw', 'der', function () use ($ctx, $sigDer, $msg32, $pub33) {
+    secp256k1_ecdsa_verify_raw($ctx, $sigDer, $msg32, $pub33);
+});
+$bench->add('secp256k1_ecdsa_verify_raw', 'compact', function () use ($ctx, $sig64, $msg32, $pub33) {
+    secp256k1_ecdsa_verify_raw($ctx, $sig64, $msg32, $pub33, SECP256K1_SIG_FORMAT_COMPACT);
+});
+$bench->add('secp256k1_ecdsa_verify', "loop/$batchSize", function () use ($ctx, $batchSigs, $batchMsgs, $batchPubs) {
+    foreach ($batchSigs as $i => $batchSig) {
+        secp256k1_ecdsa_verify($ctx, $batchSig, $batchMsgs[$i], $batchPubs[$i]);
+    }
+}, $batchSize);
+$bench->add('secp256k1_ecdsa_verify_batch', "array/$batchSize", function () use ($ctx, $batchSigs, $batchMsgs, $batchPubs) {
+    $results = null;
+    secp256k1_ecdsa_verify_batch($ctx, $batchSigs, $batchMsgs, $batchPubs, $results);
+}, $batchSize);
+$bench->add('secp256k1_ecdsa_verify_batch', "vector/$batchSize", function () use ($ctx, $batchSigs, $batchMsgs, $batchVector) {
+    $results = null;
+    secp256k1_ecdsa_verify_batch($ctx, $batchSigs, $batchMsgs, $batchVector, $results);
+}, $batchSize);
+$bench->add('secp256k1_ecdsa_signature_parse_der', '', function () use ($ctx, $sigDer) {
+    $out = null;
+    secp256k1_ecdsa_signature_parse_der($ctx, $out, $sigDer);
+});
+$bench->add('ecdsa_signature_parse_der_lax', '', function () use ($ctx, $sigDer) {
+    $out = null;
+    ecdsa_signature_parse_der_lax($ctx, $out, $sigDer);
+});
+$bench->add('secp256k1_ecdsa_signature_parse_compact', '', function () use ($ctx, $sig64) {
+    $out = null;
+    secp256k1_ecdsa_signature_parse_compact($ctx, $out, $sig64);
+});
+$bench->add('secp256k1_ecdsa_signature_serialize_der', '', function () use ($ctx, $sig) {
+    $out = '';
+    secp256k1_ecdsa_signature_serialize_der($ctx, $out, $sig);
+});
+$bench->add('secp256k1_ecdsa_signature_serialize_der_many', "$batchSize", function () use ($ctx, $batchSigs) {
+    $out = '';
+    $lengths = '';
+    secp256k1_ecdsa_signature_serialize_der_many($ctx, $out, $lengths, $batchSigs);
+}, $batchSize);
+$bench->add('secp256k1_ecdsa_signature_serialize_compact', '', function () use ($ctx, $sig) {
+    $out = '';
+    secp256k1_ecdsa_signature_serialize_compact($ctx, $out, $sig);
+});
+$bench->add('secp256k1_ecdsa_signature_serialize_compact_many', "$batchSize", function () use ($ctx, $batchSigs) {
+    $out = '';
+    secp256k1_ecdsa_signature_serialize_compact_many($ctx, $out, $batchSigs);
+}, $batchSize);
+$bench->add('secp256k1_ecdsa_signature_normalize', '', function () use ($ctx, $sig) {
+    $out = null;
+    secp256k1_ecdsa_signature_normalize($ctx, $out, $sig);
+});
+
+// nonce functions called directly
+$bench->add('secp256k1_nonce_function_default', '', function () use ($msg32, $priv) {
+    $nonce = '';
+    secp256k1_nonce_function_default($nonce, $msg32, $priv, null, null, 0);
+});
+$bench->add('secp256k1_nonce_function_rfc6979', '', function () use ($msg32, $priv) {
+    $nonce = '';
+    secp256k1_nonce_function_rfc6979($nonce, $msg32, $priv, null, null, 0);
+});
+
+if (function_exists('secp256k1_ecdsa_sign_recoverable')) {
+    $recSig = null;
+    secp256k1_ecdsa_sign_recoverable($ctx, $recSig, $msg32, $priv);
+    $recSig64 = '';
+    $recId = 0;
+    secp256k1_ecdsa_recoverable_signature_serialize_compact($ctx, $recSig64, $recId, $recSig);
+
+    $bench->add('secp256k1_ecdsa_sign_recoverable', '', function () use ($ctx, $msg32, $priv) {
+        $out = null;
+        secp256k1_ecdsa_sign_recoverable($ctx, $out, $msg32, $priv);
+    });
+    $bench->add('secp256k1_ecdsa_recover', 'resource', function () use ($ctx, $recSig, $msg32) {
+        $out = null;
+        secp256k1_ecdsa_recover($ctx, $out, $recSig, $msg32);
+    });
+    $bench->add('secp256k1_ecdsa_recover', 'object', function () use ($ctx, $recSig, $msg32) {
+        $out = new \Secp256k1\PublicKey();
+        secp256k1_ecdsa_recover($ctx, $out, $recSig, $msg32);
+    });
+
+    // r || s || v records, as an Ethereum ingest would receive them
+    $batchRecords = '';
+    for ($i = 0; $i < $batchSize; $i++) {
+        $out = null;
+        $batchSig64 = '';
+        $batchRecId = 0;
+        secp256k1_ecdsa_sign_recoverable($ctx, $out, $batchMsgs[$i], $batchPrivs[$i]);
+        secp256k1_ecdsa_recoverable_signature_serialize_compact($ctx, $batchSig64, $batchRecId, $out);
+        $batchRecords .= $batchSig64 . chr($batchRecId + 27);
+    }
+    $batchMsgBlob = implode('', $batchMsgs);
+    $bench->add('secp256k1_ecdsa_recover_many', "loop/$batchSize", function () use ($ctx, $batchRecords, $batchMsgs, $batchSize) {
+        for ($i = 0; $i < $batchSize; $i++) {
+            $sig = null;
+            $pubkey = null;
+            $out = '';
+            secp256k1_ecdsa_recoverable_signature_parse_compact($ctx, $sig, substr($batchRecords, $i * 65, 64), ord($batchRecords[$i * 65 + 64]) - 27);
+            secp256k1_ecdsa_recover($ctx, $pubkey, $sig, $batchMsgs[$i]);
+            secp256k1_ec_pubkey_serialize($ctx, $out, $pubkey, SECP256K1_EC_UNCOMPRESSED);
+        }
+    }, $batchSize);
+    $bench->add('secp256k1_ecdsa_recover_many', "$batchSize", function () use ($ctx, $batchRecords, $batchMsgBlob) {
+        $out = null;
+        $valid = null;
+        secp256k1_ecdsa_recover_many($ctx, $out, $valid, $batchRecords, $batchMsgBlob, SECP256K1_EC_UNCOMPRESSED);
+    }, $batchSize);
+    $bench->add('secp256k1_ecdsa_recover_address', '', function () use ($ctx, $batchRecords, $msg32) {
+        $out = null;
+        secp256k1_ecdsa_recover_address($ctx, $out, substr($batchRecords, 0, 65), $msg32);
+    });
+    $bench->add('secp256k1_ecdsa_recover_address_many', "$batchSize", function () use ($ctx, $batchRecords, $batchMsgBlob) {
+        $out = null;
+        $valid = null;
+        secp256k1_ecdsa_recover_address_many($ctx, $out, $valid, $batchRecords, $batchMsgBlob);
+    }, $batchSize);
+    $bench->add('secp256k1_ecdsa_recoverable_signature_parse_compact', '', function () use ($ctx, $recSig64, $recId) {
+        $out = null;
+        secp256k1_ecdsa_recoverable_signature_parse_compact($ctx, $out, $recSig64, $recId);
+    });
+    $bench->add('secp256k1_ecdsa_recoverable_signature_serialize_compact', '', function () use ($ctx, $recSig) {
+        $out = '';
+        $id = 0;
+        secp256k1_ecdsa_recoverable_signature_serialize_compact($ctx, $out, $id, $recSig);
+    });
+    $bench->add('secp256k1_ecdsa_recoverable_signature_convert', '', function () use ($ctx, $recSig) {
+        $out = null;
+        secp256k1_ecdsa_recoverable_signature_convert($ctx, $out, $recSig);
+    });
+}
+
+if (function_exists('secp256k1_ecdh')) {
+    $bench->add('secp256k1_ecdh', 'native_hash', function () use ($ctx, $pub, $priv2) {
+        $out = '';
+        secp256k1_ecdh($ctx, $out, $pub, $priv2);
+    });
+    $bench->add('secp256k1_ecdh', 'native_hash/object', function () use ($ctx, $pubObj, $priv2) {
+        $out = '';
+        secp256k1_ecdh($ctx, $out, $pubObj, $priv2);
+    });
+    $bench->add('secp256k1_ecdh', 'userland_hash', function () use ($ctx, $pub, $priv2, $ecdhCallback) {
+        $out = '';
+        secp256k1_ecdh($ctx, $out, $pub, $priv2, $ecdhCallback, 32);
+    });
+    $bench->add('secp256k1_ecdh', 'native_sha512_xy', function () use ($ctx, $pub, $priv2) {
+        $out = '';
+        secp256k1_ecdh($ctx, $out, $pub, $priv2, SECP256K1_ECDH_HASH_SHA512_XY);
+    });
+    $bench->add('secp256k1_ecdh', 'userland_sha512_xy', function () use ($ctx, $pub, $priv2, $ecdhSha512) {
+        $out = '';
+        secp256k1_ecdh($ctx, $out, $pub, $priv2, $ecdhSha512, 64);
+    });
+    $bench->add('secp256k1_ecdh_many', "loop/$batchSize", function () use ($ctx, $batchPubs, $priv2) {
+        $out = '';
+        foreach ($batchPubs as $batchPub) {
+            $secret = '';
+            secp256k1_ecdh($ctx, $secret, $batchPub, $priv2);
+            $out .= $secret;
+        }
+    }, $batchSize);
+    $bench->add('secp256k1_ecdh_many', "array/$batchSize", function () use ($ctx, $batchPubs, $priv2) {
+        $out = '';
+        secp256k1_ecdh_many($ctx, $out, $priv2, $batchPubs);
+    }, $batchSize);
+    $bench->add('secp256k1_ecdh_many', "vector/$batchSize", function () use ($ctx, $batchVector, $priv2) {
+        $out = '';
+        secp256k1_ecdh_many($ctx, $out, $priv2, $batchVector);
+    }, $batchSize);
+}
+
+if (function_exists('secp256k1_keypair_create')) {
+    $keypair = null;
+    secp256k1_keypair_create($ctx, $keypair, $priv);
+    $keypairObj = new \Secp256k1\KeyPair();
+    secp256k1_keypair_create($ctx, $keypairObj, $priv);
+    $xonly = null;
+    $parity = 0;
+    secp256k1_keypair_xonly_pub($ctx, $xonly, $parity, $keypair);
+    $xonly32 = '';
+    secp256k1_xonly_pubkey_serialize($ctx, $xonly32, $xonly);
+    $tweaked = null;
+    secp256k1_xonly_pubkey_tweak_add($ctx, $tweaked, $xonly, $tweak32);
+    $tweakedXonly = null;
+    $tweakedParity = 0;
+    secp256k1_xonly_pubkey_from_pubkey($ctx, $tweakedXonly, $tweakedParity, $tweaked);
+    $tweaked32 = '';
+    secp256k1_xonly_pubkey_serialize($ctx, $tweaked32, $tweakedXonly);
+
+    $bench->add('secp256k1_xonly_pubkey_parse', '', function () use ($ctx, $xonly32) {
+        $out = null;
+        secp256k1_xonly_pubkey_parse($ctx, $out, $xonly32);
+    });
+    $bench->add('secp256k1_xonly_pubkey_serialize', '', function () use ($ctx, $xonly) {
+        $out = '';
+        secp256k1_xonly_pubkey_serialize($ctx, $out, $xonly);
+    });
+    $bench->add('secp256k1_xonly_pubkey_from_pubkey', '', function () use ($ctx, $pub) {
+        $out = null;
+        $outParity = 0;
+        secp256k1_xonly_pubkey_from_pubkey($ctx, $out, $outParity, $pub);
+    });
+    $bench->add('secp256k1_xonly_pubkey_tweak_add', '', function () use ($ctx, $xonly, $tweak32) {
+        $out = null;
+        secp256k1_xonly_pubkey_tweak_add($ctx, $out, $xonly, $tweak32);
+    });
+    $bench->add('secp256k1_xonly_pubkey_tweak_add_check', '', function () use ($ctx, $tweaked32, $tweakedParity, $xonly, $tweak32) {
+        secp256k1_xonly_pubkey_tweak_add_check($ctx, $tweaked32, $tweakedParity, $xonly, $tweak32);
+    });
+    $bench->add('secp256k1_keypair_create', 'resource', function () use ($ctx, $priv) {
+        $out = null;
+        secp256k1_keypair_create($ctx, $out, $priv);
+    });
+    $bench->add('secp256k1_keypair_create', 'object', function () use ($ctx, $priv) {
+        $out = new \Secp256k1\KeyPair();
+        secp256k1_keypair_create($ctx, $out, $priv);
+    });
+    $bench->add('secp256k1_keypair_sec', '', function () use ($ctx, $keypair) {
+        $out = '';
+        secp256k1_keypair_sec($ctx, $out, $keypair);
+    });
+    $bench->add('secp256k1_keypair_pub', '', function () use ($ctx, $keypair) {
+        $out = null;
+        secp256k1_keypair_pub($ctx, $out, $keypair);
+    });
+    $bench->add('secp256k1_keypair_xonly_pub', '', function () use ($ctx, $keypair) {
+        $out = null;
+        $outParity = 0;
+        secp256k1_keypair_xonly_pub($ctx, $out, $outParity, $keypair);
+    });
+    $bench->add('secp256k1_keypair_xonly_tweak_add', '', function () use ($ctx, $priv, $tweak32) {
+        $out = new \Secp256k1\KeyPair();
+        secp256k1_keypair_create($ctx, $out, $priv);
+        secp256k1_keypair_xonly_tweak_add($ctx, $out, $tweak32);
+    });
+
+    if (function_exists('secp256k1_schnorrsig_sign')) {
+        $schnorrSig = '';
+        secp256k1_schnorrsig_sign($ctx, $schnorrSig, $msg32, $keypair);
+        $schnorrSigs = [];
+        $schnorrPubs = [];
+        for ($i = 0; $i < $batchSize; $i++) {
+            $kp = null;
+            $xo = null;
+            $xoParity = 0;
+            $schnorrSigs[$i] = '';
+            secp256k1_keypair_create($ctx, $kp, $batchPrivs[$i]);
+            secp256k1_keypair_xonly_pub($ctx, $xo, $xoParity, $kp);
+            secp256k1_schnorrsig_sign($ctx, $schnorrSigs[$i], $batchMsgs[$i], $kp);
+            $schnorrPubs[$i] = $xo;
+        }
+        $bipNonce = function (&$nonce, $msg32, $key32, $xonly32, $algo16, $data) {
+            return secp256k1_nonce_function_bip340($nonce, $msg32, $key32, $xonly32, $algo16, $data);
+        };
+
+        $bench->add('secp256k1_schnorrsig_sign', 'native_nonce', function () use ($ctx, $msg32, $keypair) {
+            $out = '';
+            secp256k1_schnorrsig_sign($ctx, $out, $msg32, $keypair);
+        });
+        $bench->add('secp256k1_schnorrsig_sign', 'native_nonce/object', function () use ($ctx, $msg32, $keypairObj) {
+            $out = '';
+            secp256k1_schnorrsig_sign($ctx, $out, $msg32, $keypairObj);
+        });
+        $bench->add('secp256k1_schnorrsig_sign', 'nonce_function_bip340', function () use ($ctx, $msg32, $keypair) {
+            $out = '';
+            secp256k1_schnorrsig_sign($ctx, $out, $msg32, $keypair, 'secp256k1_nonce_function_bip340');
+        });
+        $bench->add('secp256k1_schnorrsig_sign', 'userland_nonce', function () use ($ctx, $msg32, $keypair, $bipNonce) {
+            $out = '';
+            secp256k1_schnorrsig_sign($ctx, $out, $msg32, $keypair, $bipNonce);
+        });
+        $bench->add('secp256k1_schnorrsig_verify', '', function () use ($ctx, $schnorrSig, $msg32, $xonly) {
+            secp256k1_schnorrsig_verify($ctx, $schnorrSig, $msg32, $xonly);
+        });
+        $bench->add('secp256k1_schnorrsig_verify_raw', '', function () use ($ctx, $schnorrSig, $msg32, $xonly32) {
+            secp256k1_schnorrsig_verify_raw($ctx, $schnorrSig, $msg32, $xonly32);
+        });
+        $bench->add('secp256k1_schnorrsig_verify', "loop/$batchSize", function () use ($ctx, $schnorrSigs, $batchMsgs, $schnorrPubs) {
+            foreach ($schnorrSigs as $i => $schnorrSig) {
+                secp256k1_schnorrsig_verify($ctx, $schnorrSig, $batchMsgs[$i], $schnorrPubs[$i]);
+            }
+        }, $batchSize);
+        $bench->add('secp256k1_schnorrsig_verify_batch', "$batchSize", function () use ($ctx, $schnorrSigs, $batchMsgs, $schnorrPubs) {
+            $results = null;
+            secp256k1_schnorrsig_verify_batch($ctx, $schnorrSigs, $batchMsgs, $schnorrPubs, $results);
+        }, $batchSize);
+        $bench->add('secp256k1_nonce_function_bip340', '', function () use ($msg32, $priv, $xonly32) {
+            $nonce = '';
+            secp256k1_nonce_function_bip340($nonce, $msg32, $priv, $xonly32, "BIP0340/nonce\0\0\0", str_repeat("\0", 32));
+        });
+    }
+}
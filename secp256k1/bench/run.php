@@ -0,0 +1,167 @@
+<?php
+/**
+ * Microbenchmarks for the secp256k1 extension.
+ *
+ * Every function exported by the extension has at least one benchmark, see
+ * benchmarks.php. Each benchmark is called repeatedly for a fixed amount of
+ * time and the latency of every call is recorded, so the report holds both
+ * throughput and latency percentiles. Functions without a benchmark are listed
+ * as uncovered.
+ *
+ * Usage: php run.php [--filter=REGEX] [--time=SECONDS] [--json]
+ *
+ *   --filter  only run benchmarks whose name matches REGEX, eg. --filter=/ecdh/
+ *   --time    seconds spent on each benchmark, default 1
+ *   --json    print a JSON report instead of a table
+ *
+ * Run from the extension directory with `make bench`, which loads the freshly
+ * built module. Script options go in BENCH_ARGS and ini settings in BENCH_INI:
+ *
+ *   make bench BENCH_ARGS="--json --time=2" BENCH_INI="-d secp256k1.threads=4"
+ *
+ * The parse and verify benchmarks repeat the same inputs, so with
+ * BENCH_INI="-d secp256k1.pubkey_cache_size=65536 -d secp256k1.sigcache_size=65536"
+ * they measure cache hits. BENCH_INI="-d secp256k1.stats=1" measures the cost of
+ * the call statistics, and BENCH_INI="-d secp256k1.trace=1" the cost of tracing
+ * with no observer registered.
+ */
+
+if (!extension_loaded('secp256k1')) {
+    fwrite(STDERR, "the secp256k1 extension is not loaded\n");
+    exit(1);
+}
+
+class Bench
+{
+    /** @var array[] */
+    private $benchmarks = [];
+
+    /**
+     * @param string $function the extension function being measured
+     * @param string $variant describes what sets this benchmark apart from others for $function
+     * @param callable $fn performs one call, a fresh $fn is used for every benchmark
+     * @param int $items number of operations performed by one call of $fn, for batch functions
+     */
+    public function add(string $function, string $variant, callable $fn, int $items = 1)
+    {
+        $this->benchmarks[] = [
+            'name' => $variant === '' ? $function : "$function/$variant",
+            'function' => $function,
+            'variant' => $variant,
+            'fn' => $fn,
+            'items' => $items,
+        ];
+    }
+
+    /**
+     * @return string[] names of the extension functions which have a benchmark
+     */
+    public function covered(): array
+    {
+        return array_values(array_unique(array_column($this->benchmarks, 'function')));
+    }
+
+    public function run(string $filter = null, float $seconds = 1.0): array
+    {
+        $results = [];
+        foreach ($this->benchmarks as $benchmark) {
+            if ($filter !== null && !preg_match($filter, $benchmark['name'])) {
+                continue;
+            }
+            $results[] = $this->measure($benchmark, $seconds);
+        }
+        return $results;
+    }
+
+    private function measure(array $benchmark, float $seconds): array
+    {
+        $fn = $benchmark['fn'];
+        $budget = (int) ($seconds * 1e9);
+
+        // warm up caches, and the lazily created contexts and worker pool
+        $warmupEnd = self::now() + intdiv($budget, 20);
+        do {
+            $fn();
+        } while (self::now() < $warmupEnd);
+
+        $samples = [];
+        $start = self::now();
+        $end = $start + $budget;
+        do {
+            $t = self::now();
+            $fn();
+            $samples[] = self::now() - $t;
+        } while ($t < $end && count($samples) < 1000000);
+        $total = self::now() - $start;
+
+        sort($samples);
+        $calls = count($samples);
+        return [
+            'name' => $benchmark['name'],
+            'function' => $benchmark['function'],
+            'variant' => $benchmark['variant'],
+            'calls' => $calls,
+            'items_per_call' => $benchmark['items'],
+            'ops_per_sec' => $calls / ($total / 1e9),
+            'items_per_sec' => $calls * $benchmark['items'] / ($total / 1e9),
+            'ns' => [
+                'min' => $samples[0],
+                'p50' => self::percentile($samples, 50),
+                'p90' => self::percentile($samples, 90),
+                'p99' => self::percentile($samples, 99),
+                'max' => $samples[$calls - 1],
+            ],
+        ];
+    }
+
+    private static function percentile(array $sorted, int $p): int
+    {
+        return $sorted[(int) min(count($sorted) - 1, floor(count($sorted) * $p / 100))];
+    }
+
+    private static function now(): int
+    {
+        static $hrtime = null;
+        if ($hrtime === null) {
+            $hrtime = function_exists('hrtime');
+        }
+        return $hrtime ? hrtime(true) : (int) (microtime(true) * 1e9);
+    }
+}
+
+$options = getopt('', ['filter:', 'time:', 'json']);
+$filter = isset($options['filter']) ? $options['filter'] : null;
+$seconds = isset($options['time']) ? (float) $options['time'] : 1.0;
+$json = isset($options['json']);
+
+$bench = new Bench();
+require __DIR__ . '/benchmarks.php';
+
+$results = $bench->run($filter, $seconds);
+$uncovered = array_values(array_diff(get_extension_funcs('secp256k1'), $bench->covered()));
+
+if ($json) {
+    echo json_encode([
+        'php' => PHP_VERSION,
+        'extension' => phpversion('secp256k1'),
+        'threads' => (int) ini_get('secp256k1.threads'),
+        'pubkey_cache_size' => (int) ini_get('secp256k1.pubkey_cache_size'),
+        'sigcache_size' => (int) ini_get('secp256k1.sigcache_size'),
+        'stats' => (bool) ini_get('secp256k1.stats'),
+        'trace' => (bool) ini_get('secp256k1.trace'),
+        'seconds' => $seconds,
+        'results' => $results,
+        'uncovered' => $uncovered,
+    ], JSON_PRETTY_PRINT | JSON_UNESCAPED_SLASHES) . PHP_EOL;
+    exit(0);
+}
+
+printf("%-64s %12s %12s %10s %10s %10s\n", 'benchmark', 'ops/sec', 'items/sec', 'p50 us', 'p90 us', 'p99 us');
+foreach ($results as $result) {
+    printf("%-64s %12.0f %12.0f %10.2f %10.2f %10.2f\n",
+        $result['name'], $result['ops_per_sec'], $result['items_per_sec'],
+        $result['ns']['p50'] / 1e3, $result['ns']['p90'] / 1e3, $result['ns']['p99'] / 1e3);
+}
+foreach ($uncovered as $function) {
+    fwrite(STDERR, "no benchmark for $function\n");
+}
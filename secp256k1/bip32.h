@@ -0,0 +1,230 @@
+#include <stdint.h>
+#include <string.h>
+
+/** BIP32 hierarchical deterministic key derivation.
+ *
+ *  A node is an extended key: a chain code and a public key, plus the secret
+ *  key when it is an extended private key. The public key is kept parsed and
+ *  serialized, CKDpub needs the former and every HMAC the latter.
+ *
+ *  Child derivation only touches libsecp256k1 and the nodes passed in, so it
+ *  runs on the batch pool. Private derivation needs a context for signing,
+ *  public derivation one for verification. Requires sha2.h and ripemd160.h
+ *  to be included first.
+ */
+
+#define BIP32_HARDENED 0x80000000u
+#define BIP32_SERIALIZED_LENGTH 78
+#define BIP32_MAX_DEPTH 255
+
+typedef struct _php_secp256k1_bip32_node {
+    unsigned char chaincode[32];
+    unsigned char seckey[32];
+    unsigned char pubkey33[PUBKEY_COMPRESSED_LENGTH];
+    secp256k1_pubkey pubkey;
+    unsigned char parent_fingerprint[4];
+    uint32_t child_number;
+    unsigned char depth;
+    unsigned char has_private;
+} php_secp256k1_bip32_node;
+
+static void php_secp256k1_bip32_write32(unsigned char *out, uint32_t value)
+{
+    out[0] = (unsigned char) (value >> 24);
+    out[1] = (unsigned char) (value >> 16);
+    out[2] = (unsigned char) (value >> 8);
+    out[3] = (unsigned char) value;
+}
+
+static uint32_t php_secp256k1_bip32_read32(const unsigned char *in)
+{
+    return ((uint32_t) in[0] << 24) | ((uint32_t) in[1] << 16) | ((uint32_t) in[2] << 8) | (uint32_t) in[3];
+}
+
+/* fills in the public key of a node from its secret key. */
+static int php_secp256k1_bip32_complete(const secp256k1_context *ctx, php_secp256k1_bip32_node *node)
+{
+    size_t len = PUBKEY_COMPRESSED_LENGTH;
+    if (node->has_private && !secp256k1_ec_pubkey_create(ctx, &node->pubkey, node->seckey)) {
+        return 0;
+    }
+    return secp256k1_ec_pubkey_serialize(ctx, node->pubkey33, &len, &node->pubkey, SECP256K1_EC_COMPRESSED);
+}
+
+/* writes the first four bytes of HASH160(pubkey33), the identifier
+ * children refer to their parent by. */
+static void php_secp256k1_bip32_fingerprint(const php_secp256k1_bip32_node *node, unsigned char *out4)
+{
+    unsigned char id[20];
+    php_secp256k1_hash160(node->pubkey33, PUBKEY_COMPRESSED_LENGTH, id);
+    memcpy(out4, id, 4);
+}
+
+/* derives the master node from a seed. returns 0 for the (astronomically
+ * unlikely) seeds whose left half is not a valid secret key. */
+static int php_secp256k1_bip32_master(const secp256k1_context *ctx, php_secp256k1_bip32_node *node,
+                                      const unsigned char *seed, size_t seedlen)
+{
+    static const unsigned char key[] = "Bitcoin seed";
+    unsigned char I[64];
+    int result;
+
+    memset(node, 0, sizeof(*node));
+    php_secp256k1_hmac_sha512(key, sizeof(key) - 1, seed, seedlen, I);
+    memcpy(node->seckey, I, 32);
+    memcpy(node->chaincode, I + 32, 32);
+    node->has_private = 1;
+    result = secp256k1_ec_seckey_verify(ctx, node->seckey) && php_secp256k1_bip32_complete(ctx, node);
+    ZEND_SECURE_ZERO(I, sizeof(I));
+    if (!result) {
+        ZEND_SECURE_ZERO(node, sizeof(*node));
+    }
+    return result;
+}
+
+/* derives child index of parent: CKDpriv if parent holds a secret key,
+ * CKDpub otherwise. parent_fingerprint is the parent's fingerprint, passed
+ * in so deriving many children of one parent hashes it once. returns 0 for
+ * hardened indices of a public parent, at the maximum depth, and for the
+ * indices BIP32 declares invalid. */
+static int php_secp256k1_bip32_ckd(const secp256k1_context *ctx, php_secp256k1_bip32_node *child,
+                                   const php_secp256k1_bip32_node *parent,
+                                   const unsigned char *parent_fingerprint, uint32_t index)
+{
+    unsigned char data[37], I[64];
+    int result;
+
+    if (parent->depth == BIP32_MAX_DEPTH || ((index & BIP32_HARDENED) && !parent->has_private)) {
+        return 0;
+    }
+    if (index & BIP32_HARDENED) {
+        data[0] = 0;
+        memcpy(data + 1, parent->seckey, 32);
+    } else {
+        memcpy(data, parent->pubkey33, PUBKEY_COMPRESSED_LENGTH);
+    }
+    php_secp256k1_bip32_write32(data + 33, index);
+    php_secp256k1_hmac_sha512(parent->chaincode, 32, data, sizeof(data), I);
+
+    child->has_private = parent->has_private;
+    if (parent->has_private) {
+        // tweak_add rejects tweaks outside the group order and a zero result
+        memcpy(child->seckey, parent->seckey, 32);
+        result = secp256k1_ec_privkey_tweak_add(ctx, child->seckey, I);
+    } else {
+        memset(child->seckey, 0, 32);
+        child->pubkey = parent->pubkey;
+        result = secp256k1_ec_pubkey_tweak_add(ctx, &child->pubkey, I);
+    }
+    if (result) {
+        result = php_secp256k1_bip32_complete(ctx, child);
+    }
+    memcpy(child->chaincode, I + 32, 32);
+    memcpy(child->parent_fingerprint, parent_fingerprint, 4);
+    child->child_number = index;
+    child->depth = parent->depth + 1;
+
+    ZEND_SECURE_ZERO(data, sizeof(data));
+    ZEND_SECURE_ZERO(I, sizeof(I));
+    if (!result) {
+        ZEND_SECURE_ZERO(child, sizeof(*child));
+    }
+    return result;
+}
+
+/* writes the 78 byte serialization: version, depth, parent fingerprint,
+ * child number, chain code and either 0x00 || seckey or the compressed
+ * public key. base58check encoding is left to the caller. */
+static void php_secp256k1_bip32_serialize(const php_secp256k1_bip32_node *node, uint32_t version, unsigned char *out78)
+{
+    php_secp256k1_bip32_write32(out78, version);
+    out78[4] = node->depth;
+    memcpy(out78 + 5, node->parent_fingerprint, 4);
+    php_secp256k1_bip32_write32(out78 + 9, node->child_number);
+    memcpy(out78 + 13, node->chaincode, 32);
+    if (node->has_private) {
+        out78[45] = 0;
+        memcpy(out78 + 46, node->seckey, 32);
+    } else {
+        memcpy(out78 + 45, node->pubkey33, PUBKEY_COMPRESSED_LENGTH);
+    }
+}
+
+/* parses a 78 byte serialization, returns 0 if the key data is invalid or a
+ * master key claims a parent. version is not checked, it is only returned. */
+static int php_secp256k1_bip32_parse(const secp256k1_context *ctx, php_secp256k1_bip32_node *node,
+                                     uint32_t *version, const unsigned char *in78)
+{
+    static const unsigned char zero[4] = {0};
+    int result;
+
+    memset(node, 0, sizeof(*node));
+    *version = php_secp256k1_bip32_read32(in78);
+    node->depth = in78[4];
+    memcpy(node->parent_fingerprint, in78 + 5, 4);
+    node->child_number = php_secp256k1_bip32_read32(in78 + 9);
+    memcpy(node->chaincode, in78 + 13, 32);
+
+    if (node->depth == 0 && (node->child_number != 0 || memcmp(node->parent_fingerprint, zero, 4) != 0)) {
+        return 0;
+    }
+    if (in78[45] == 0) {
+        node->has_private = 1;
+        memcpy(node->seckey, in78 + 46, 32);
+        result = secp256k1_ec_seckey_verify(ctx, node->seckey) && php_secp256k1_bip32_complete(ctx, node);
+    } else if (in78[45] == 2 || in78[45] == 3) {
+        result = secp256k1_ec_pubkey_parse(ctx, &node->pubkey, in78 + 45, PUBKEY_COMPRESSED_LENGTH);
+        memcpy(node->pubkey33, in78 + 45, PUBKEY_COMPRESSED_LENGTH);
+    } else {
+        result = 0;
+    }
+    if (!result) {
+        ZEND_SECURE_ZERO(node, sizeof(*node));
+    }
+    return result;
+}
+
+/* parses a derivation path such as "m/84'/0'/0'/0/5" into at most
+ * BIP32_MAX_DEPTH indices. the leading "m" is optional, hardened steps are
+ * marked with ', h or H. returns 0 on a syntax error or index overflow. */
+static int php_secp256k1_bip32_parse_path(const char *path, size_t len, uint32_t *indices, size_t *count)
+{
+    size_t pos = 0, n = 0;
+    uint64_t index;
+
+    if (len > 0 && (path[0] == 'm' || path[0] == 'M')) {
+        pos = 1;
+        if (pos == len) {
+            *count = 0;
+            return 1;
+        }
+        if (path[pos++] != '/' || pos == len) {
+            return 0;
+        }
+    }
+    while (pos < len) {
+        if (n == BIP32_MAX_DEPTH || path[pos] < '0' || path[pos] > '9') {
+            return 0;
+        }
+        index = 0;
+        while (pos < len && path[pos] >= '0' && path[pos] <= '9') {
+            index = index * 10 + (uint64_t) (path[pos++] - '0');
+            if (index >= BIP32_HARDENED) {
+                return 0;
+            }
+        }
+        if (pos < len && (path[pos] == '\'' || path[pos] == 'h' || path[pos] == 'H')) {
+            index |= BIP32_HARDENED;
+            pos++;
+        }
+        indices[n++] = (uint32_t) index;
+        if (pos < len) {
+            // a separator must be followed by another step
+            if (path[pos++] != '/' || pos == len) {
+                return 0;
+            }
+        }
+    }
+    *count = n;
+    return 1;
+}
@@ -119,7 +119,43 @@ if test "$PHP_SECP256K1" != "no"; then
     AC_DEFINE(SECP256K1_MODULE_ECDH, 1, [ ])
   fi
 
+  dnl # worker threads used by the batch functions, see secp256k1.threads
+  AC_CHECK_HEADER([pthread.h], [
+    PHP_CHECK_LIBRARY(pthread, pthread_create,
+    [
+      PHP_ADD_LIBRARY(pthread,, SECP256K1_SHARED_LIBADD)
+      AC_DEFINE(HAVE_SECP256K1_THREADS, 1, [ ])
+    ],[
+    ],[
+    ])
+  ])
+
+  dnl # seeds and salts, see csprng.h
+  AC_CHECK_HEADERS([sys/random.h])
+  AC_CHECK_FUNCS([getrandom])
+
+  dnl # shared memory caches, see secp256k1.pubkey_cache_size and secp256k1.sigcache_size
+  AC_CHECK_HEADER([sys/mman.h], [
+    AC_MSG_CHECKING([for __atomic builtins])
+    AC_LINK_IFELSE([AC_LANG_PROGRAM([[#include <stdint.h>]], [[
+      uint32_t seq = 0, expected = 0;
+      uint64_t counter = 0;
+      __atomic_compare_exchange_n(&seq, &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+      __atomic_thread_fence(__ATOMIC_RELEASE);
+      __atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED);
+      return (int) __atomic_load_n(&seq, __ATOMIC_ACQUIRE);
+    ]])], [
+      AC_MSG_RESULT([yes])
+      AC_DEFINE(HAVE_SECP256K1_SHM, 1, [ ])
+    ], [
+      AC_MSG_RESULT([no])
+    ])
+  ])
+
   PHP_SUBST(SECP256K1_SHARED_LIBADD)
 
   PHP_NEW_EXTENSION(secp256k1, secp256k1.c, $ext_shared,, -DZEND_ENABLE_STATIC_TSRMLS_CACHE=1)
+
+  dnl # make bench, see bench/run.php
+  PHP_ADD_MAKEFILE_FRAGMENT
 fi
@@ -0,0 +1,69 @@
+#include <stddef.h>
+
+/** Seeds and salts from the operating system's CSPRNG.
+ *
+ *  php_random_bytes() only got its silent variant in PHP 7.1, so the
+ *  extension reads the system source itself: getrandom() where the system
+ *  has it, /dev/urandom otherwise, and the Windows CSPRNG on Windows. Nothing
+ *  here touches the engine, so it is safe to call before a worker forks and
+ *  on the batch pool.
+ */
+
+#ifdef PHP_WIN32
+#include "win32/winutil.h"
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(HAVE_GETRANDOM) && defined(HAVE_SYS_RANDOM_H)
+#include <sys/random.h>
+#endif
+#endif
+
+/* fills buf with len bytes from the system's CSPRNG. returns 0 if they
+ * could not be had, buf is then left in an unspecified state. */
+static int php_secp256k1_os_random(void *buf, size_t len)
+{
+#ifdef PHP_WIN32
+    return php_win32_get_random_bytes((unsigned char *) buf, len) == SUCCESS;
+#else
+    unsigned char *out = (unsigned char *) buf;
+    size_t done = 0;
+    ssize_t got;
+    int fd;
+
+#if defined(HAVE_GETRANDOM) && defined(HAVE_SYS_RANDOM_H)
+    while (done < len) {
+        if ((got = getrandom(out + done, len - done, 0)) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // a kernel older than the C library, try the device instead
+            if (errno == ENOSYS) {
+                break;
+            }
+            return 0;
+        }
+        done += (size_t) got;
+    }
+    if (done == len) {
+        return 1;
+    }
+#endif
+
+    if ((fd = open("/dev/urandom", O_RDONLY)) < 0) {
+        return 0;
+    }
+    while (done < len) {
+        if ((got = read(fd, out + done, len - done)) <= 0) {
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        done += (size_t) got;
+    }
+    close(fd);
+    return done == len;
+#endif
+}
@@ -0,0 +1,103 @@
+#include <stdint.h>
+#include <string.h>
+
+/** Keccak-256 as Ethereum uses it: the original Keccak padding (0x01), not
+ *  the SHA3-256 one (0x06) that FIPS 202 settled on. One-shot only, the
+ *  inputs are public keys and other short messages. Plain C, safe to run on
+ *  the batch pool.
+ */
+
+#define KECCAK256_RATE 136
+
+static const uint64_t php_secp256k1_keccak_rc[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+/* rotation offsets and lane order of the combined rho and pi steps */
+static const unsigned int php_secp256k1_keccak_rotc[24] = {
+    1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44
+};
+static const unsigned int php_secp256k1_keccak_piln[24] = {
+    10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1
+};
+
+#define KECCAK_ROL64(x, n) (((x) << (n)) | ((x) >> (64 - (n))))
+
+static void php_secp256k1_keccakf(uint64_t *st)
+{
+    uint64_t bc[5], t;
+    int round, i, j;
+
+    for (round = 0; round < 24; round++) {
+        // theta
+        for (i = 0; i < 5; i++) {
+            bc[i] = st[i] ^ st[i + 5] ^ st[i + 10] ^ st[i + 15] ^ st[i + 20];
+        }
+        for (i = 0; i < 5; i++) {
+            t = bc[(i + 4) % 5] ^ KECCAK_ROL64(bc[(i + 1) % 5], 1);
+            for (j = 0; j < 25; j += 5) {
+                st[j + i] ^= t;
+            }
+        }
+        // rho and pi
+        t = st[1];
+        for (i = 0; i < 24; i++) {
+            j = php_secp256k1_keccak_piln[i];
+            bc[0] = st[j];
+            st[j] = KECCAK_ROL64(t, php_secp256k1_keccak_rotc[i]);
+            t = bc[0];
+        }
+        // chi
+        for (j = 0; j < 25; j += 5) {
+            for (i = 0; i < 5; i++) {
+                bc[i] = st[j + i];
+            }
+            for (i = 0; i < 5; i++) {
+                st[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+            }
+        }
+        // iota
+        st[0] ^= php_secp256k1_keccak_rc[round];
+    }
+}
+
+/* absorbs len bytes of data into the rate part of the state, lanes being
+ * little endian. */
+static void php_secp256k1_keccak_absorb(uint64_t *st, const unsigned char *data, size_t len)
+{
+    size_t i;
+    for (i = 0; i < len; i++) {
+        st[i / 8] ^= (uint64_t) data[i] << (8 * (i % 8));
+    }
+}
+
+/* computes the Keccak-256 hash of data into out32. */
+static void php_secp256k1_keccak256(const unsigned char *data, size_t len, unsigned char *out32)
+{
+    uint64_t st[25];
+    unsigned char last[KECCAK256_RATE];
+    size_t i;
+
+    memset(st, 0, sizeof(st));
+    while (len >= KECCAK256_RATE) {
+        php_secp256k1_keccak_absorb(st, data, KECCAK256_RATE);
+        php_secp256k1_keccakf(st);
+        data += KECCAK256_RATE;
+        len -= KECCAK256_RATE;
+    }
+    memset(last, 0, sizeof(last));
+    memcpy(last, data, len);
+    last[len] |= 0x01;
+    last[KECCAK256_RATE - 1] |= 0x80;
+    php_secp256k1_keccak_absorb(st, last, KECCAK256_RATE);
+    php_secp256k1_keccakf(st);
+
+    for (i = 0; i < 32; i++) {
+        out32[i] = (unsigned char) (st[i / 8] >> (8 * (i % 8)));
+    }
+}
@@ -33,12 +33,66 @@ extern zend_module_entry secp256k1_module_entry;
 #ifdef SECP256K1_MODULE_SCHNORRSIG
 #endif
 
+/* address types secp256k1_address_many encodes */
+#define SECP256K1_ADDRESS_P2PKH 0
+#define SECP256K1_ADDRESS_P2WPKH 1
+#define SECP256K1_ADDRESS_P2TR 2
+
+/* signature encodings secp256k1_ecdsa_verify_raw parses, optionally or'ed
+ * with SECP256K1_SIG_ALLOW_HIGH_S */
+#define SECP256K1_SIG_FORMAT_DER 0
+#define SECP256K1_SIG_FORMAT_DER_LAX 1
+#define SECP256K1_SIG_FORMAT_COMPACT 2
+#define SECP256K1_SIG_FORMAT_MASK 3
+#define SECP256K1_SIG_ALLOW_HIGH_S 4
+
+#ifdef SECP256K1_MODULE_ECDH
+/* hash modes secp256k1_ecdh accepts in place of a hash callable */
+#define SECP256K1_ECDH_HASH_DEFAULT 0
+#define SECP256K1_ECDH_HASH_X 1
+#define SECP256K1_ECDH_HASH_XY 2
+#define SECP256K1_ECDH_HASH_SHA256_X 3
+#define SECP256K1_ECDH_HASH_SHA512_XY 4
+#define SECP256K1_ECDH_HASH_TAGGED_X 5
+#endif
+
+ZEND_BEGIN_MODULE_GLOBALS(secp256k1)
+    zend_bool preload_context;
+    zend_long threads;
+    zend_long bip32_cache_size;
+    HashTable *bip32_cache;
+    zend_long pubkey_cache_size;
+    zend_long sigcache_size;
+    zend_long randomize_ops;
+    zend_long randomize_seconds;
+    zend_bool stats;
+    struct _php_secp256k1_stats_slot *stats_slots;
+    const char *stats_variant;
+    size_t stats_items;
+    zend_bool trace;
+    double trace_sample_rate;
+    HashTable *trace_observers;
+    zend_long trace_next_id;
+    int trace_depth;
+    uint64_t trace_rng;
+ZEND_END_MODULE_GLOBALS(secp256k1)
+
+ZEND_EXTERN_MODULE_GLOBALS(secp256k1)
+
 #ifdef ZTS
 # define SECP256K1_G(v) TSRMG(secp256k1_globals_id, zend_secp256k1_globals *, v)
 #else
 # define SECP256K1_G(v) (secp256k1_globals.v)
 #endif
 
+#if defined(ZTS) && defined(COMPILE_DL_SECP256K1)
+ZEND_TSRMLS_CACHE_EXTERN()
+#endif
+
+#ifndef ZEND_SECURE_ZERO
+# define ZEND_SECURE_ZERO(var, size) memset((var), 0, (size))
+#endif
+
 #define MAX_SIGNATURE_LENGTH 72
 #define SCHNORRSIG_LENGTH 64
 #define COMPACT_SIGNATURE_LENGTH 64
@@ -48,26 +102,44 @@ extern zend_module_entry secp256k1_module_entry;
 #define SECRETKEY_LENGTH 32
 #define DERKEY_LENGTH 300
 
+/* result bitmaps returned by the batch functions hold one bit per input,
+ * least significant bit first. */
+#define BITMAP_LENGTH(n) (((n) + 7) / 8)
+#define BITMAP_SET(bitmap, i) ((bitmap)[(i) >> 3] |= (unsigned char) (1 << ((i) & 7)))
+#define BITMAP_GET(bitmap, i) (((bitmap)[(i) >> 3] >> ((i) & 7)) & 1)
+
 PHP_FUNCTION(secp256k1_context_create);
 PHP_FUNCTION(secp256k1_context_destroy);
 PHP_FUNCTION(secp256k1_context_clone);
 PHP_FUNCTION(secp256k1_context_randomize);
+PHP_FUNCTION(secp256k1_context_persistent);
+PHP_FUNCTION(secp256k1_cache_stats);
+PHP_FUNCTION(secp256k1_stats);
+PHP_FUNCTION(secp256k1_trace_register);
+PHP_FUNCTION(secp256k1_trace_unregister);
 
 PHP_FUNCTION(secp256k1_ecdsa_verify);
+PHP_FUNCTION(secp256k1_ecdsa_verify_raw);
+PHP_FUNCTION(secp256k1_ecdsa_verify_batch);
 PHP_FUNCTION(secp256k1_ecdsa_sign);
 PHP_FUNCTION(secp256k1_ecdsa_signature_parse_der);
 PHP_FUNCTION(secp256k1_ecdsa_signature_parse_compact);
 PHP_FUNCTION(ecdsa_signature_parse_der_lax);
 PHP_FUNCTION(secp256k1_ecdsa_signature_serialize_der);
+PHP_FUNCTION(secp256k1_ecdsa_signature_serialize_der_many);
 PHP_FUNCTION(secp256k1_ecdsa_signature_serialize_compact);
+PHP_FUNCTION(secp256k1_ecdsa_signature_serialize_compact_many);
 PHP_FUNCTION(secp256k1_ecdsa_signature_normalize);
 
 PHP_FUNCTION(secp256k1_ec_seckey_verify);
 PHP_FUNCTION(secp256k1_ec_privkey_negate);
 PHP_FUNCTION(secp256k1_ec_pubkey_negate);
 PHP_FUNCTION(secp256k1_ec_pubkey_create);
+PHP_FUNCTION(secp256k1_ec_pubkey_create_many);
 PHP_FUNCTION(secp256k1_ec_pubkey_parse);
+PHP_FUNCTION(secp256k1_ec_pubkey_parse_many);
 PHP_FUNCTION(secp256k1_ec_pubkey_serialize);
+PHP_FUNCTION(secp256k1_ec_pubkey_serialize_many);
 
 PHP_FUNCTION(secp256k1_ec_privkey_tweak_add);
 PHP_FUNCTION(secp256k1_ec_privkey_tweak_mul);
@@ -76,6 +148,33 @@ PHP_FUNCTION(secp256k1_ec_pubkey_tweak_mul);
 
 PHP_FUNCTION(secp256k1_ec_pubkey_combine);
 
+PHP_FUNCTION(secp256k1_bip32_master);
+PHP_FUNCTION(secp256k1_bip32_derive);
+PHP_FUNCTION(secp256k1_bip32_derive_many);
+PHP_FUNCTION(secp256k1_bip32_serialize);
+PHP_FUNCTION(secp256k1_bip32_parse);
+PHP_FUNCTION(secp256k1_bip32_neuter);
+PHP_FUNCTION(secp256k1_bip32_pubkey);
+PHP_FUNCTION(secp256k1_bip32_seckey);
+
+PHP_FUNCTION(secp256k1_address_p2pkh);
+PHP_FUNCTION(secp256k1_address_p2wpkh);
+PHP_FUNCTION(secp256k1_address_many);
+
+PHP_FUNCTION(secp256k1_sha256);
+PHP_FUNCTION(secp256k1_tagged_sha256);
+PHP_FUNCTION(secp256k1_hmac_sha256);
+
+PHP_METHOD(Secp256k1_PublicKeyVector, __construct);
+PHP_METHOD(Secp256k1_PublicKeyVector, append);
+PHP_METHOD(Secp256k1_PublicKeyVector, get);
+PHP_METHOD(Secp256k1_PublicKeyVector, slice);
+PHP_METHOD(Secp256k1_PublicKeyVector, count);
+
+PHP_METHOD(Secp256k1_Sha256, __construct);
+PHP_METHOD(Secp256k1_Sha256, update);
+PHP_METHOD(Secp256k1_Sha256, digest);
+
 PHP_FUNCTION(secp256k1_scratch_space_create);
 PHP_FUNCTION(secp256k1_scratch_space_destroy);
 
@@ -86,6 +185,9 @@ PHP_FUNCTION(secp256k1_nonce_function_rfc6979);
 #ifdef SECP256K1_MODULE_RECOVERY
 PHP_FUNCTION(secp256k1_ecdsa_sign_recoverable);
 PHP_FUNCTION(secp256k1_ecdsa_recover);
+PHP_FUNCTION(secp256k1_ecdsa_recover_many);
+PHP_FUNCTION(secp256k1_ecdsa_recover_address);
+PHP_FUNCTION(secp256k1_ecdsa_recover_address_many);
 PHP_FUNCTION(secp256k1_ecdsa_recoverable_signature_convert);
 PHP_FUNCTION(secp256k1_ecdsa_recoverable_signature_serialize_compact);
 PHP_FUNCTION(secp256k1_ecdsa_recoverable_signature_parse_compact);
@@ -94,6 +196,7 @@ PHP_FUNCTION(secp256k1_ecdsa_recoverable_signature_parse_compact);
 /* ECDH module */
 #ifdef SECP256K1_MODULE_ECDH
 PHP_FUNCTION(secp256k1_ecdh);
+PHP_FUNCTION(secp256k1_ecdh_many);
 #endif /* end of ecdh module */
 
 
@@ -109,12 +212,15 @@ PHP_FUNCTION(secp256k1_keypair_sec);
 PHP_FUNCTION(secp256k1_keypair_pub);
 PHP_FUNCTION(secp256k1_keypair_xonly_pub);
 PHP_FUNCTION(secp256k1_keypair_xonly_tweak_add);
+PHP_FUNCTION(secp256k1_address_p2tr);
 #endif /* end of schnorrsig module */
 
 /* schnorr module */
 #ifdef SECP256K1_MODULE_SCHNORRSIG
 PHP_FUNCTION(secp256k1_schnorrsig_sign);
 PHP_FUNCTION(secp256k1_schnorrsig_verify);
+PHP_FUNCTION(secp256k1_schnorrsig_verify_raw);
+PHP_FUNCTION(secp256k1_schnorrsig_verify_batch);
 PHP_FUNCTION(secp256k1_nonce_function_bip340);
 #endif /* end of schnorrsig module */
 
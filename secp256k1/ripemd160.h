@@ -0,0 +1,141 @@
+#include <stdint.h>
+#include <string.h>
+
+/** RIPEMD-160, for the HASH160 (RIPEMD160(SHA256(x))) key identifiers used
+ *  by BIP32 fingerprints. Only a one-shot function is provided, the inputs
+ *  are serialized public keys. Requires sha2.h to be included first.
+ */
+
+static const unsigned char php_secp256k1_ripemd160_rl[80] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    7, 4, 13, 1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8,
+    3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5, 12,
+    1, 9, 11, 10, 0, 8, 12, 4, 13, 3, 7, 15, 14, 5, 6, 2,
+    4, 0, 5, 9, 7, 12, 2, 10, 14, 1, 3, 8, 11, 6, 15, 13
+};
+
+static const unsigned char php_secp256k1_ripemd160_rr[80] = {
+    5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12,
+    6, 11, 3, 7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2,
+    15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4, 13,
+    8, 6, 4, 1, 3, 11, 15, 0, 5, 12, 2, 13, 9, 7, 10, 14,
+    12, 15, 10, 4, 1, 5, 8, 7, 6, 2, 13, 14, 0, 3, 9, 11
+};
+
+static const unsigned char php_secp256k1_ripemd160_sl[80] = {
+    11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8,
+    7, 6, 8, 13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12,
+    11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5, 12, 7, 5,
+    11, 12, 14, 15, 14, 15, 9, 8, 9, 14, 5, 6, 8, 6, 5, 12,
+    9, 15, 5, 11, 6, 8, 13, 12, 5, 12, 13, 14, 11, 8, 5, 6
+};
+
+static const unsigned char php_secp256k1_ripemd160_sr[80] = {
+    8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6,
+    9, 13, 15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11,
+    9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13, 13, 7, 5,
+    15, 5, 8, 11, 14, 14, 6, 14, 6, 9, 12, 9, 12, 5, 15, 8,
+    8, 5, 12, 9, 12, 5, 14, 6, 8, 13, 6, 5, 15, 13, 11, 11
+};
+
+static const uint32_t php_secp256k1_ripemd160_kl[5] = {
+    0x00000000, 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xa953fd4e
+};
+
+static const uint32_t php_secp256k1_ripemd160_kr[5] = {
+    0x50a28be6, 0x5c4dd124, 0x6d703ef3, 0x7a6d76e9, 0x00000000
+};
+
+#define RIPEMD160_ROL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+/* the five boolean functions, round j of the left line uses f(j / 16), the
+ * right line uses them in reverse order. */
+static uint32_t php_secp256k1_ripemd160_f(int round, uint32_t x, uint32_t y, uint32_t z)
+{
+    switch (round) {
+        case 0: return x ^ y ^ z;
+        case 1: return (x & y) | (~x & z);
+        case 2: return (x | ~y) ^ z;
+        case 3: return (x & z) | (y & ~z);
+        default: return x ^ (y | ~z);
+    }
+}
+
+static void php_secp256k1_ripemd160_transform(uint32_t *s, const unsigned char *chunk)
+{
+    uint32_t x[16], al, bl, cl, dl, el, ar, br, cr, dr, er, t;
+    int i, round;
+
+    for (i = 0; i < 16; i++) {
+        x[i] = (uint32_t) chunk[i * 4] | ((uint32_t) chunk[i * 4 + 1] << 8)
+             | ((uint32_t) chunk[i * 4 + 2] << 16) | ((uint32_t) chunk[i * 4 + 3] << 24);
+    }
+
+    al = ar = s[0]; bl = br = s[1]; cl = cr = s[2]; dl = dr = s[3]; el = er = s[4];
+    for (i = 0; i < 80; i++) {
+        round = i / 16;
+        t = al + php_secp256k1_ripemd160_f(round, bl, cl, dl) + x[php_secp256k1_ripemd160_rl[i]]
+          + php_secp256k1_ripemd160_kl[round];
+        t = RIPEMD160_ROL(t, php_secp256k1_ripemd160_sl[i]) + el;
+        al = el; el = dl; dl = RIPEMD160_ROL(cl, 10); cl = bl; bl = t;
+
+        t = ar + php_secp256k1_ripemd160_f(4 - round, br, cr, dr) + x[php_secp256k1_ripemd160_rr[i]]
+          + php_secp256k1_ripemd160_kr[round];
+        t = RIPEMD160_ROL(t, php_secp256k1_ripemd160_sr[i]) + er;
+        ar = er; er = dr; dr = RIPEMD160_ROL(cr, 10); cr = br; br = t;
+    }
+    t = s[1] + cl + dr;
+    s[1] = s[2] + dl + er;
+    s[2] = s[3] + el + ar;
+    s[3] = s[4] + al + br;
+    s[4] = s[0] + bl + cr;
+    s[0] = t;
+}
+
+/* computes RIPEMD160(data) into out20. */
+static void php_secp256k1_ripemd160(const unsigned char *data, size_t len, unsigned char *out20)
+{
+    uint32_t s[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+    unsigned char block[128];
+    uint64_t bits = (uint64_t) len << 3;
+    size_t rest, padded, i;
+
+    for (; len >= 64; data += 64, len -= 64) {
+        php_secp256k1_ripemd160_transform(s, data);
+    }
+
+    // 0x80, zeros, then the length in bits, spilling into a second block
+    // when fewer than 9 bytes are left in the first
+    rest = len;
+    padded = rest < 56 ? 64 : 128;
+    memset(block, 0, sizeof(block));
+    memcpy(block, data, rest);
+    block[rest] = 0x80;
+    for (i = 0; i < 8; i++) {
+        block[padded - 8 + i] = (unsigned char) (bits >> (8 * i));
+    }
+    php_secp256k1_ripemd160_transform(s, block);
+    if (padded == 128) {
+        php_secp256k1_ripemd160_transform(s, block + 64);
+    }
+
+    for (i = 0; i < 5; i++) {
+        out20[i * 4] = (unsigned char) s[i];
+        out20[i * 4 + 1] = (unsigned char) (s[i] >> 8);
+        out20[i * 4 + 2] = (unsigned char) (s[i] >> 16);
+        out20[i * 4 + 3] = (unsigned char) (s[i] >> 24);
+    }
+}
+
+/* computes HASH160, RIPEMD160(SHA256(data)), into out20. */
+static void php_secp256k1_hash160(const unsigned char *data, size_t len, unsigned char *out20)
+{
+    php_secp256k1_sha256 hash;
+    unsigned char digest[32];
+    php_secp256k1_sha256_init(&hash);
+    php_secp256k1_sha256_write(&hash, data, len);
+    php_secp256k1_sha256_finalize(&hash, digest);
+    php_secp256k1_ripemd160(digest, 32, out20);
+}
+
+#undef RIPEMD160_ROL
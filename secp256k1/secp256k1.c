@@ -8,12 +8,64 @@
 #include "php_version.h"
 #include "php_ini.h"
 #include "ext/standard/info.h"
+#include <time.h>
 #include "php_secp256k1.h"
 #include "lax_der.h"
+#include "thread_pool.h"
+#include "sha2.h"
+#include "ripemd160.h"
+#include "bip32.h"
+#include "address.h"
+#include "keccak.h"
+#include "csprng.h"
+#include "shm_cache.h"
+#include "stats.h"
 #include "zend_exceptions.h"
+#include "zend_extensions.h"
+#include "zend_interfaces.h"
+#if PHP_VERSION_ID < 70200
+#include "ext/spl/spl_iterators.h"
+#define zend_ce_countable spl_ce_Countable
+#endif
 
 static zend_class_entry *spl_ce_InvalidArgumentException;
 
+ZEND_DECLARE_MODULE_GLOBALS(secp256k1)
+
+// secp256k1_context_wrapper is what a context resource points at, the
+// context and the flags it was created with, plus the signing budget of
+// secp256k1.randomize_ops and secp256k1.randomize_seconds: signing
+// operations since the context was last randomized, and when that was.
+typedef struct secp256k1_context_wrapper {
+        secp256k1_context* ctx;
+        long flags;
+        zend_long ops;
+        time_t randomized;
+} secp256k1_context_wrapper;
+
+// Persistent contexts live for the lifetime of the process, one per
+// combination of SECP256K1_CONTEXT_SIGN / SECP256K1_CONTEXT_VERIFY. Contexts
+// created during MINIT are inherited copy-on-write by forked workers.
+#define PERSISTENT_CTX_SLOTS 4
+#define PERSISTENT_CTX_SLOT(flags) (((flags) >> 8) & 3)
+static secp256k1_context_wrapper persistent_ctx[PERSISTENT_CTX_SLOTS];
+#ifdef ZTS
+static MUTEX_T persistent_ctx_mutex;
+#endif
+
+#ifdef HAVE_SECP256K1_SHM
+// Parsed public keys shared by all processes forked after MINIT, mapped when
+// secp256k1.pubkey_cache_size is set. Read only after MINIT, so workers of
+// the batch pool use it too.
+static php_secp256k1_shm_cache *pubkey_cache;
+// Signatures which verified, mapped when secp256k1.sigcache_size is set. A
+// key is the hash of what was verified under a salt drawn in MINIT, only
+// positive results are stored.
+static php_secp256k1_shm_cache *sig_cache;
+// SHA256 state after the salt, copied for every key
+static php_secp256k1_sha256 sig_cache_salted;
+#endif
+
 // secp256k1_scratch_space_wrapper embeds the scratch space
 // and the context which created it, as the function
 // secp256k1_scratch_space_destroy is called in dtor functions
@@ -23,60 +75,136 @@ typedef struct secp256k1_scratch_space_wrapper {
         secp256k1_scratch_space* scratch;
 } secp256k1_scratch_space_wrapper;
 
-// php_secp256k1_nonce_function_data is used to provide data to an invocation
-// of php_secp256k1_nonce_function_callback or php_secp256k1_nonce_function_hardened_callback.
-// It contains function call information for the userland PHP function, and any
-// extra data for the nonce function if provided.
-typedef struct php_secp256k1_nonce_function_data {
+// Secp256k1\PublicKey, Secp256k1\EcdsaSignature, Secp256k1\XOnlyPublicKey
+// and Secp256k1\KeyPair embed the libsecp256k1 struct ahead of the
+// zend_object, so a value costs one allocation and is reached without a
+// resource list lookup. initialized is set once a function wrote a value.
+typedef struct _php_secp256k1_pubkey_obj {
+    secp256k1_pubkey pubkey;
+    zend_bool initialized;
+    zend_object std;
+} php_secp256k1_pubkey_obj;
+
+typedef struct _php_secp256k1_ecdsa_signature_obj {
+    secp256k1_ecdsa_signature sig;
+    zend_bool initialized;
+    zend_object std;
+} php_secp256k1_ecdsa_signature_obj;
+
+#ifdef SECP256K1_MODULE_EXTRAKEYS
+typedef struct _php_secp256k1_xonly_pubkey_obj {
+    secp256k1_xonly_pubkey pubkey;
+    zend_bool initialized;
+    zend_object std;
+} php_secp256k1_xonly_pubkey_obj;
+
+typedef struct _php_secp256k1_keypair_obj {
+    secp256k1_keypair keypair;
+    zend_bool initialized;
+    zend_object std;
+} php_secp256k1_keypair_obj;
+#endif
+
+// Secp256k1\ExtendedKey is a BIP32 node, holding the secret key when it is an
+// extended private key.
+typedef struct _php_secp256k1_extended_key_obj {
+    php_secp256k1_bip32_node node;
+    zend_bool initialized;
+    zend_object std;
+} php_secp256k1_extended_key_obj;
+
+// Secp256k1\Sha256 is a running hash. cloning copies the state, which is how
+// a midstate is reused.
+typedef struct _php_secp256k1_sha256_obj {
+    php_secp256k1_sha256 hash;
+    zend_object std;
+} php_secp256k1_sha256_obj;
+
+// Secp256k1\PublicKeyVector keeps its keys in one contiguous array, so a key
+// costs sizeof(secp256k1_pubkey) and a batch can use the keys in place.
+typedef struct _php_secp256k1_pubkey_vector_obj {
+    secp256k1_pubkey *keys;
+    size_t count;
+    size_t capacity;
+    zend_object std;
+} php_secp256k1_pubkey_vector_obj;
+
+#define PHP_SECP256K1_OBJ(type, obj) ((type *)((char *) (obj) - XtOffsetOf(type, std)))
+#define PHP_SECP256K1_OBJ_P(type, zv) PHP_SECP256K1_OBJ(type, Z_OBJ_P(zv))
+
+// php_secp256k1_callback holds what is needed to call a userland function from
+// inside libsecp256k1. The argument slots are prepared once by
+// php_secp256k1_callback_init and reused by every invocation until
+// php_secp256k1_callback_release, however many attempts or library calls that
+// spans: the by-reference output slot is kept and reset, and input strings are
+// overwritten in place as long as the PHP function did not hold on to them.
+// args[0] is the output reference, arguments after the ones we own may be
+// borrowed from the caller and are never released here.
+typedef struct _php_secp256k1_callback {
     zend_fcall_info* fci;
     zend_fcall_info_cache* fcc;
-    zval* data;
-} php_secp256k1_nonce_function_data;
-
-// php_secp256k1_nonce_function_callback is an implementation of secp256k1_nonce_function
-// designed to call a PHP land function to calculate a nonce for the signature algorithm.
-// it expects that the arbitrary *data is *php_secp256k1_nonce_function_data, so it has
-// sufficient context to call the embedded PHP function, and pass optional additional data
-// if present. it writes the nonce provided the PHP function to *nonce32 for the signing
-// algorithm to continue.
-static int php_secp256k1_nonce_function_callback(unsigned char *nonce32, const unsigned char *msg32,
-                               const unsigned char *key32, const unsigned char *algo16,
-                               void *data, unsigned int attempt) {
-    php_secp256k1_nonce_function_data* callback;
-    zend_string* output_str;
-    zval retval, zvalout;
     zval args[6];
-    int result, i;
+} php_secp256k1_callback;
 
-    callback = (php_secp256k1_nonce_function_data*) data;
-    callback->fci->size = sizeof(*(callback->fci));
-    callback->fci->object = NULL;
-    callback->fci->retval = &retval;
-    callback->fci->params = args;
-    callback->fci->param_count = 6;
-    ZVAL_NEW_STR(&zvalout, zend_string_init("", 0, 0));
-
-    // wrt ownership, args 0-3 & 5 are managed by us in order to
-    // receive the result, and pass in the x & y parameters.
-    // arg 3 is owned by the caller of secp256k1_ecdh.
-    ZVAL_NEW_REF(&args[0], &zvalout);
-    ZVAL_STR(&args[1], zend_string_init((const char *) msg32, 32, 0));
-    ZVAL_STR(&args[2], zend_string_init((const char *) key32, 32, 0));
-    if (algo16 == NULL) {
-        ZVAL_NULL(&args[3]);
-    } else {
-        // This is impossible to test unless secp256k1 starts to use
-        // this value, which for ECDSA & schnorr are presently null.
-        ZVAL_STR(&args[3], zend_string_init((const char *) algo16, strlen((const char *) algo16), 0));
+static void php_secp256k1_callback_init(php_secp256k1_callback *callback, zend_fcall_info *fci,
+                                        zend_fcall_info_cache *fcc, uint32_t param_count)
+{
+    int i;
+
+    callback->fci = fci;
+    callback->fcc = fcc;
+    fci->size = sizeof(*fci);
+    fci->object = NULL;
+    fci->params = callback->args;
+    fci->param_count = param_count;
+
+    ZVAL_NEW_EMPTY_REF(&callback->args[0]);
+    ZVAL_EMPTY_STRING(Z_REFVAL(callback->args[0]));
+    for (i = 1; i < 6; i++) {
+        ZVAL_UNDEF(&callback->args[i]);
     }
-    if (callback->data != NULL) {
-        zval* data = callback->data;
-        args[4] = *data;
-    } else {
-        ZVAL_NULL(&args[4]);
+}
+
+// releases the first owned argument slots, the remaining ones are borrowed.
+static void php_secp256k1_callback_release(php_secp256k1_callback *callback, int owned)
+{
+    int i;
+    for (i = 0; i < owned; i++) {
+        zval_ptr_dtor(&callback->args[i]);
+    }
+}
+
+// php_secp256k1_callback_arg stores len bytes at p as the string in an argument
+// slot. zend_call_function copies the arguments into the callee's frame, so once
+// the call returned our slot is the only owner again unless the callee kept a
+// copy, and the string can be overwritten instead of allocating a new one.
+static void php_secp256k1_callback_arg(zval *arg, const unsigned char *p, size_t len)
+{
+    if (Z_TYPE_P(arg) == IS_STRING && Z_STRLEN_P(arg) == len
+        && !ZSTR_IS_INTERNED(Z_STR_P(arg)) && GC_REFCOUNT(Z_STR_P(arg)) == 1) {
+        memcpy(Z_STRVAL_P(arg), p, len);
+        zend_string_forget_hash_val(Z_STR_P(arg));
+        return;
     }
-    ZVAL_LONG(&args[5], (zend_long) attempt);
+    zval_ptr_dtor(arg);
+    ZVAL_STRINGL(arg, (const char *) p, len);
+}
+
+// php_secp256k1_callback_call invokes the userland function with the prepared
+// arguments. The function must return true or a non-zero integer, and write
+// exactly output_len bytes to its first argument, which are then copied to output.
+static int php_secp256k1_callback_call(php_secp256k1_callback *callback, unsigned char *output, size_t output_len)
+{
+    zval retval;
+    zval *zOutput = Z_REFVAL(callback->args[0]);
+    int result;
+
+    // every invocation starts with an empty output, as a new reference would
+    zval_ptr_dtor(zOutput);
+    ZVAL_EMPTY_STRING(zOutput);
 
+    ZVAL_UNDEF(&retval);
+    callback->fci->retval = &retval;
     result = zend_call_function(callback->fci, callback->fcc) == SUCCESS;
 
     // check function invocation result
@@ -90,108 +218,133 @@ static int php_secp256k1_nonce_function_callback(unsigned char *nonce32, const u
             result = Z_LVAL(retval);
         }
     }
+    zval_ptr_dtor(&retval);
 
     // there's more! what if the length doesn't match? avoid.
-    if (result) {
-        output_str = Z_STR_P(Z_REFVAL(args[0]));
-        if (output_str->len != 32) {
-            // this perhaps ought to be an exception,
-            // as these callbacks _MUST_ write 32 bytes
-            result = 0;
-        }
+    zOutput = Z_REFVAL(callback->args[0]);
+    if (result && (Z_TYPE_P(zOutput) != IS_STRING || Z_STRLEN_P(zOutput) != output_len)) {
+        // this perhaps ought to be an exception,
+        // as these callbacks _MUST_ write output_len bytes
+        result = 0;
     }
 
     // callback OK & length correct
     if (result) {
-        memcpy(nonce32, output_str->val, 32);
+        memcpy(output, Z_STRVAL_P(zOutput), output_len);
     }
 
-    // zval_dtor on our args. arg 3 is managed elsewhere.
-    zval_dtor(&args[0]);
-    zval_dtor(&args[1]);
-    zval_dtor(&args[2]);
-    zval_dtor(&args[3]);
-    zval_dtor(&args[5]);
-
     return result;
 }
 
+// php_secp256k1_nonce_function_callback is an implementation of secp256k1_nonce_function
+// designed to call a PHP land function to calculate a nonce for the signing algorithm.
+// it expects that the arbitrary *data is a *php_secp256k1_callback with six parameters,
+// the optional additional data already placed in args[4]. it writes the nonce provided
+// by the PHP function to *nonce32 for the signing algorithm to continue.
+static int php_secp256k1_nonce_function_callback(unsigned char *nonce32, const unsigned char *msg32,
+                               const unsigned char *key32, const unsigned char *algo16,
+                               void *data, unsigned int attempt) {
+    php_secp256k1_callback* callback = (php_secp256k1_callback*) data;
+
+    php_secp256k1_callback_arg(&callback->args[1], msg32, 32);
+    php_secp256k1_callback_arg(&callback->args[2], key32, 32);
+    if (algo16 == NULL) {
+        zval_ptr_dtor(&callback->args[3]);
+        ZVAL_NULL(&callback->args[3]);
+    } else {
+        // This is impossible to test unless secp256k1 starts to use
+        // this value, which for ECDSA & schnorr are presently null.
+        php_secp256k1_callback_arg(&callback->args[3], algo16, strlen((const char *) algo16));
+    }
+    ZVAL_LONG(&callback->args[5], (zend_long) attempt);
+
+    return php_secp256k1_callback_call(callback, nonce32, 32);
+}
 
 // php_secp256k1_nonce_function_hardened_callback is an implementation of secp256k1_nonce_function_hardened
 // designed to call a PHP land function to calculate a nonce for the Schnorr signature algorithm in
-// secp256k1_schnorrsig_sig. It expects that the arbitrary data pointer is a pointer to a
-// *php_secp256k1_nonce_function_data so it has sufficient context to call the specified PHP function, and
-// pass optional additional data if present. It writes the nonce provided by the PHP function to *nonce32
-// for the signing algorithm to continue.
+// secp256k1_schnorrsig_sig. It expects that the arbitrary data pointer is a *php_secp256k1_callback
+// with six parameters, the optional additional data already placed in args[5]. It writes the nonce
+// provided by the PHP function to *nonce32 for the signing algorithm to continue.
 static int php_secp256k1_nonce_function_hardened_callback(unsigned char *nonce32, const unsigned char *msg32,
                                                  const unsigned char *key32, const unsigned char *xonly_pk32,
                                                  const unsigned char *algo16, void *data) {
-    php_secp256k1_nonce_function_data* callback;
-    zend_string* output_str;
-    zval retval, zvalout;
-    zval args[6];
-    int result, i;
+    php_secp256k1_callback* callback = (php_secp256k1_callback*) data;
 
-    callback = (php_secp256k1_nonce_function_data*) data;
-    callback->fci->size = sizeof(*(callback->fci));
-    callback->fci->object = NULL;
-    callback->fci->retval = &retval;
-    callback->fci->params = args;
-    callback->fci->param_count = 6;
-    ZVAL_NEW_STR(&zvalout, zend_string_init("", 0, 0));
-
-    // wrt ownership, args 0-4 are managed by us in order to
-    // receive the result, and pass inputs. The final argument
-    // is provided by the caller and must not be dtor'd!
-    ZVAL_NEW_REF(&args[0], &zvalout);
-    ZVAL_STR(&args[1], zend_string_init((const char *) msg32, 32, 0));
-    ZVAL_STR(&args[2], zend_string_init((const char *) key32, 32, 0));
-    ZVAL_STR(&args[3], zend_string_init((const char *) xonly_pk32, 32, 0));
-    ZVAL_STR(&args[4], zend_string_init((const char *) algo16, 16, 0));
-    if (callback->data != NULL) {
-        zval* data = callback->data;
-        args[5] = *data;
-    } else {
-        ZVAL_NULL(&args[5]);
-    }
+    php_secp256k1_callback_arg(&callback->args[1], msg32, 32);
+    php_secp256k1_callback_arg(&callback->args[2], key32, 32);
+    php_secp256k1_callback_arg(&callback->args[3], xonly_pk32, 32);
+    php_secp256k1_callback_arg(&callback->args[4], algo16, 16);
 
-    result = zend_call_function(callback->fci, callback->fcc) == SUCCESS;
+    return php_secp256k1_callback_call(callback, nonce32, 32);
+}
 
-    // check function invocation result
-    if (result) {
-        // now respect return value
-        if (Z_TYPE(retval) == IS_FALSE) {
-            result = 0;
-        } else if (Z_TYPE(retval) == IS_TRUE) {
-            result = 1;
-        } else if (Z_TYPE(retval) == IS_LONG) {
-            result = Z_LVAL(retval);
-        }
+// zData may be any type, however this function is only used in the rfc6979
+// and schnorrsig nonce functions, so it returns a negative result if
+// the value is not NULL or a string. if it's a string value, it's length
+// must be 32 bytes.
+static int php_nonce_function_extract_data(zval *zData, unsigned char **data)
+{
+    // read arbitrary data pointer. enforce expectations of secp256k1_nonce_function_bipschnorr.
+    switch (Z_TYPE_P(zData)) {
+        case IS_STRING:
+            if (Z_STRLEN_P(zData) != 32) {
+                return 0;
+            }
+            *data = (unsigned char *) Z_STRVAL_P(zData);
+            return 1;
+        case IS_NULL:
+            *data = NULL;
+            return 1;
+        default:
+            // rfc6979 expects a 32byte string or NULL.
+            return 0;
     }
+}
 
-    // there's more! what if the length doesn't match? avoid.
-    if (result) {
-        output_str = Z_STR_P(Z_REFVAL(args[0]));
-        if (output_str->len != 32) {
-            // this perhaps ought to be an exception,
-            // as these callbacks _MUST_ write 32 bytes
-            result = 0;
-        }
-    }
+typedef void (*php_secp256k1_handler)(INTERNAL_FUNCTION_PARAMETERS);
 
-    // callback OK & length correct
-    if (result) {
-        memcpy(nonce32, output_str->val, 32);
-    }
+// with secp256k1.stats or secp256k1.trace enabled MINIT replaces the handler
+// of the functions they cover with php_secp256k1_instrument_handler,
+// remembering the original one here. each function finds its entry in its
+// reserved[instrumented_slot], the table keyed by function name is only
+// walked to report the figures. read only once MINIT is done.
+typedef struct _php_secp256k1_instrumented {
+    php_secp256k1_handler handler;
+    uint32_t index;
+    zend_bool traced;
+} php_secp256k1_instrumented;
 
-    // zval_dtor on our args. arg 5 is managed elsewhere.
-    zval_dtor(&args[0]);
-    zval_dtor(&args[1]);
-    zval_dtor(&args[2]);
-    zval_dtor(&args[3]);
-    zval_dtor(&args[4]);
+static HashTable instrumented_functions;
+static uint32_t instrumented_count = 0;
+static int instrumented_slot = -1;
 
-    return result;
+#define PHP_SECP256K1_INSTRUMENTED(fn) \
+    ((php_secp256k1_instrumented *) (fn)->internal_function.reserved[instrumented_slot])
+
+static void php_secp256k1_instrument_handler(INTERNAL_FUNCTION_PARAMETERS);
+
+// returns the handler an internal function was registered with, looking
+// through the instrumentation wrapper.
+static php_secp256k1_handler php_secp256k1_function_handler(zend_function *fn)
+{
+    if (fn->internal_function.handler == php_secp256k1_instrument_handler) {
+        return PHP_SECP256K1_INSTRUMENTED(fn)->handler;
+    }
+    return fn->internal_function.handler;
+}
+
+// php_secp256k1_is_native_nonce_function checks whether the callable zpp resolved
+// into fcc is the PHP binding of one of our own nonce functions, identified by
+// its handler. This holds for the plain function name as well as for closures
+// created from it, and allows the signing functions to hand the libsecp256k1
+// implementation straight to the library instead of calling back into PHP
+// for every attempt.
+static int php_secp256k1_is_native_nonce_function(zend_fcall_info_cache *fcc, void (*handler)(INTERNAL_FUNCTION_PARAMETERS))
+{
+    return fcc->function_handler != NULL
+        && fcc->function_handler->type == ZEND_INTERNAL_FUNCTION
+        && php_secp256k1_function_handler(fcc->function_handler) == handler;
 }
 
 /* Function argument documentation */
@@ -202,7 +355,7 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_ecdsa_signature_parse_der_lax, IS_L
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_ecdsa_signature_parse_der_lax, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, ecdsaSignatureOut, IS_RESOURCE, 1)
+    ZEND_ARG_INFO(1, ecdsaSignatureOut)
     ZEND_ARG_TYPE_INFO(0, sigLaxDerIn, IS_STRING, 0)
 ZEND_END_ARG_INFO();
 
@@ -230,16 +383,68 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_context_destroy, _IS_BOOL
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
 ZEND_END_ARG_INFO();
 
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_context_persistent, IS_RESOURCE, NULL, 1)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_context_persistent, IS_RESOURCE, 1)
+#endif
+    ZEND_ARG_TYPE_INFO(0, flags, IS_LONG, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_cache_stats, IS_ARRAY, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_cache_stats, IS_ARRAY, 0)
+#endif
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_stats, IS_ARRAY, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_stats, IS_ARRAY, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, reset, _IS_BOOL, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_trace_register, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_trace_register, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, begin, IS_CALLABLE, 1)
+    ZEND_ARG_TYPE_INFO(0, end, IS_CALLABLE, 1)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_trace_unregister, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_trace_unregister, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, id, IS_LONG, 0)
+ZEND_END_ARG_INFO();
+
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_parse, IS_LONG, NULL, 0)
 #else
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_parse, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, ecPublicKey, IS_RESOURCE, 1)
+    ZEND_ARG_INFO(1, ecPublicKey)
     ZEND_ARG_TYPE_INFO(0, publicKeyIn, IS_STRING, 0)
 ZEND_END_ARG_INFO();
 
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_parse_many, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_parse_many, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(1, ecPublicKeys)
+    ZEND_ARG_TYPE_INFO(1, validOut, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(0, publicKeysIn, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, stride, IS_LONG, 0)
+ZEND_END_ARG_INFO();
+
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_serialize, IS_LONG, NULL, 0)
 #else
@@ -247,7 +452,18 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_serialize, IS_L
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
     ZEND_ARG_TYPE_INFO(1, publicKeyOut, IS_STRING, 1)
-    ZEND_ARG_TYPE_INFO(0, ecPublicKey, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(0, ecPublicKey)
+    ZEND_ARG_TYPE_INFO(0, flags, IS_LONG, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_serialize_many, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_serialize_many, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(1, publicKeysOut, IS_STRING, 1)
+    ZEND_ARG_INFO(0, ecPublicKeys)
     ZEND_ARG_TYPE_INFO(0, flags, IS_LONG, 0)
 ZEND_END_ARG_INFO();
 
@@ -257,7 +473,7 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_signature_parse_com
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_signature_parse_compact, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, ecdsaSignatureOut, IS_RESOURCE, 1)
+    ZEND_ARG_INFO(1, ecdsaSignatureOut)
     ZEND_ARG_TYPE_INFO(0, sig64In, IS_STRING, 0)
 ZEND_END_ARG_INFO();
 
@@ -267,7 +483,7 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_signature_parse_der
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_signature_parse_der, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, ecdsaSignatureOut, IS_RESOURCE, 1)
+    ZEND_ARG_INFO(1, ecdsaSignatureOut)
     ZEND_ARG_TYPE_INFO(0, sigDerIn, IS_STRING, 0)
 ZEND_END_ARG_INFO();
 
@@ -278,7 +494,18 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_signature_serialize
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
     ZEND_ARG_TYPE_INFO(1, sigDerOut, IS_STRING, 1)
-    ZEND_ARG_TYPE_INFO(0, ecdsaSignature, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(0, ecdsaSignature)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_signature_serialize_der_many, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_signature_serialize_der_many, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(1, sigsDerOut, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(1, lengthsOut, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(0, ecdsaSignatures, IS_ARRAY, 0)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
@@ -288,7 +515,17 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_signature_serialize
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
     ZEND_ARG_TYPE_INFO(1, sig64Out, IS_STRING, 1)
-    ZEND_ARG_TYPE_INFO(0, ecdsaSignature, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(0, ecdsaSignature)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_signature_serialize_compact_many, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_signature_serialize_compact_many, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(1, sigs64Out, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(0, ecdsaSignatures, IS_ARRAY, 0)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
@@ -297,9 +534,33 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_verify, IS_LONG, NU
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_verify, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(0, ecdsaSignature, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(0, ecdsaSignature)
+    ZEND_ARG_TYPE_INFO(0, msg32, IS_STRING, 0)
+    ZEND_ARG_INFO(0, ecPublicKey)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_verify_raw, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_verify_raw, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(0, signature, IS_STRING, 0)
     ZEND_ARG_TYPE_INFO(0, msg32, IS_STRING, 0)
-    ZEND_ARG_TYPE_INFO(0, ecPublicKey, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(0, publicKey, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, flags, IS_LONG, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_verify_batch, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_verify_batch, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(0, ecdsaSignatures, IS_ARRAY, 0)
+    ZEND_ARG_TYPE_INFO(0, msgs32, IS_ARRAY, 0)
+    ZEND_ARG_INFO(0, ecPublicKeys)
+    ZEND_ARG_TYPE_INFO(1, resultsOut, IS_STRING, 1)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
@@ -308,8 +569,8 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_signature_normalize
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_signature_normalize, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, ecdsaSignatureNormalized, IS_RESOURCE, 1)
-    ZEND_ARG_TYPE_INFO(0, ecdsaSignature, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(1, ecdsaSignatureNormalized)
+    ZEND_ARG_INFO(0, ecdsaSignature)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
@@ -318,7 +579,7 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_sign, IS_LONG, NULL
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_sign, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, ecdsaSignatureOut, IS_RESOURCE, 1)
+    ZEND_ARG_INFO(1, ecdsaSignatureOut)
     ZEND_ARG_TYPE_INFO(0, msg32, IS_STRING, 0)
     ZEND_ARG_TYPE_INFO(0, secretKey, IS_STRING, 0)
     ZEND_ARG_CALLABLE_INFO(0, noncefp, 1)
@@ -340,10 +601,22 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_create, IS_LONG
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_create, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, ecPublicKey, IS_RESOURCE, 1)
+    ZEND_ARG_INFO(1, ecPublicKey)
     ZEND_ARG_TYPE_INFO(0, secretKey, IS_STRING, 0)
 ZEND_END_ARG_INFO();
 
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_create_many, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_create_many, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(1, publicKeysOut, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(1, validOut, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(0, secretKeys, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, flags, IS_LONG, 0)
+ZEND_END_ARG_INFO();
+
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_privkey_negate, IS_LONG, NULL, 0)
 #else
@@ -359,7 +632,7 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_negate, IS_LONG
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_negate, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, ecPublicKey, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(1, ecPublicKey)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
@@ -378,7 +651,7 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_tweak_add, IS_L
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_tweak_add, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, ecPublicKey, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(1, ecPublicKey)
     ZEND_ARG_TYPE_INFO(0, tweak32, IS_STRING, 0)
 ZEND_END_ARG_INFO();
 
@@ -398,7 +671,7 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_tweak_mul, IS_L
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_tweak_mul, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, ecPublicKey, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(1, ecPublicKey)
     ZEND_ARG_TYPE_INFO(0, tweak32, IS_STRING, 0)
 ZEND_END_ARG_INFO();
 
@@ -417,172 +690,386 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_combine, IS_LON
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ec_pubkey_combine, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, combinedEcPublicKey, IS_RESOURCE, 1)
-    ZEND_ARG_TYPE_INFO(0, publicKeys, IS_ARRAY, 0)
+    ZEND_ARG_INFO(1, combinedEcPublicKey)
+    ZEND_ARG_INFO(0, publicKeys)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_nonce_function_default, IS_LONG, NULL, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_bip32_master, IS_LONG, NULL, 0)
 #else
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_nonce_function_default, IS_LONG, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_bip32_master, IS_LONG, 0)
 #endif
-    ZEND_ARG_TYPE_INFO(1, data, IS_STRING, 1)
-    ZEND_ARG_TYPE_INFO(0, msg32, IS_STRING, 0)
-    ZEND_ARG_TYPE_INFO(0, key32, IS_STRING, 0)
-    ZEND_ARG_TYPE_INFO(0, algo16, IS_STRING, 1)
-    ZEND_ARG_INFO(0, data)
-    ZEND_ARG_TYPE_INFO(0, attempt, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(1, extendedKey)
+    ZEND_ARG_TYPE_INFO(0, seed, IS_STRING, 0)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_nonce_function_rfc6979, IS_LONG, NULL, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_bip32_derive, IS_LONG, NULL, 0)
 #else
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_nonce_function_rfc6979, IS_LONG, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_bip32_derive, IS_LONG, 0)
 #endif
-    ZEND_ARG_TYPE_INFO(1, nonce32, IS_STRING, 1)
-    ZEND_ARG_TYPE_INFO(0, msg32, IS_STRING, 0)
-    ZEND_ARG_TYPE_INFO(0, key32, IS_STRING, 0)
-    ZEND_ARG_TYPE_INFO(0, algo16, IS_STRING, 1)
-    ZEND_ARG_INFO(0, data)
-    ZEND_ARG_TYPE_INFO(0, attempt, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(1, childKey)
+    ZEND_ARG_INFO(0, parentKey)
+    ZEND_ARG_TYPE_INFO(0, path, IS_STRING, 0)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_scratch_space_create, IS_RESOURCE, NULL, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_bip32_derive_many, IS_LONG, NULL, 0)
 #else
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_scratch_space_create, IS_RESOURCE, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_bip32_derive_many, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(0, size, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(1, publicKeysOut, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(1, validOut, IS_STRING, 1)
+    ZEND_ARG_INFO(0, parentKey)
+    ZEND_ARG_TYPE_INFO(0, start, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, count, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, flags, IS_LONG, 0)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_scratch_space_destroy, IS_RESOURCE, NULL, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_bip32_serialize, IS_LONG, NULL, 0)
 #else
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_scratch_space_destroy, IS_RESOURCE, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_bip32_serialize, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(0, scratch, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(1, extendedKeyOut, IS_STRING, 1)
+    ZEND_ARG_INFO(0, extendedKey)
+    ZEND_ARG_TYPE_INFO(0, version, IS_LONG, 0)
 ZEND_END_ARG_INFO();
 
-//recovery
-#ifdef SECP256K1_MODULE_RECOVERY
-
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recoverable_signature_parse_compact, IS_LONG, NULL, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_bip32_parse, IS_LONG, NULL, 0)
 #else
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recoverable_signature_parse_compact, IS_LONG, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_bip32_parse, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, ecdsaRecoverableSignatureOut, IS_RESOURCE, 1)
-    ZEND_ARG_TYPE_INFO(0, sig64, IS_STRING, 0)
-    ZEND_ARG_TYPE_INFO(0, recId, IS_LONG, 0)
+    ZEND_ARG_INFO(1, extendedKey)
+    ZEND_ARG_TYPE_INFO(0, extendedKeyIn, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(1, version, IS_LONG, 1)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recoverable_signature_convert, IS_LONG, NULL, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_bip32_neuter, IS_LONG, NULL, 0)
 #else
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recoverable_signature_convert, IS_LONG, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_bip32_neuter, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, ecdsaSignature, IS_RESOURCE, 1)
-    ZEND_ARG_TYPE_INFO(0, ecdsaRecoverableSignature, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(1, publicKey)
+    ZEND_ARG_INFO(0, extendedKey)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recoverable_signature_serialize_compact, IS_LONG, NULL, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_bip32_pubkey, IS_LONG, NULL, 0)
 #else
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recoverable_signature_serialize_compact, IS_LONG, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_bip32_pubkey, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, sig64Out, IS_STRING, 1)
-    ZEND_ARG_TYPE_INFO(1, recIdOut, IS_LONG, 1)
-    ZEND_ARG_TYPE_INFO(0, ecdsaRecoverableSignature, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(1, ecPublicKey)
+    ZEND_ARG_INFO(0, extendedKey)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_sign_recoverable, IS_LONG, NULL, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_bip32_seckey, IS_LONG, NULL, 0)
 #else
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_sign_recoverable, IS_LONG, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_bip32_seckey, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, ecdsaRecoverableSignatureOut, IS_RESOURCE, 1)
-    ZEND_ARG_TYPE_INFO(0, msg32, IS_STRING, 0)
-    ZEND_ARG_TYPE_INFO(0, secretKey, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(1, secretKeyOut, IS_STRING, 1)
+    ZEND_ARG_INFO(0, extendedKey)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recover, IS_LONG, NULL, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_address_p2pkh, IS_LONG, NULL, 0)
 #else
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recover, IS_LONG, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_address_p2pkh, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, ecPublicKey, IS_RESOURCE, 1)
-    ZEND_ARG_TYPE_INFO(0, ecdsaRecoverableSignature, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(0, msg32, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(1, addressOut, IS_STRING, 1)
+    ZEND_ARG_INFO(0, ecPublicKey)
+    ZEND_ARG_TYPE_INFO(0, version, IS_LONG, 0)
 ZEND_END_ARG_INFO();
 
-#endif
-
-//ecdh
-#ifdef SECP256K1_MODULE_ECDH
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdh, IS_LONG, NULL, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_address_p2wpkh, IS_LONG, NULL, 0)
 #else
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdh, IS_LONG, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_address_p2wpkh, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, result, IS_STRING, 0)
-    ZEND_ARG_TYPE_INFO(0, ecPublicKey, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(0, privKey, IS_STRING, 0)
-    ZEND_ARG_CALLABLE_INFO(0, hashfxn, 1)
-    ZEND_ARG_TYPE_INFO(0, outputLen, IS_LONG, 1)
-    ZEND_ARG_INFO(0, data)
+    ZEND_ARG_TYPE_INFO(1, addressOut, IS_STRING, 1)
+    ZEND_ARG_INFO(0, ecPublicKey)
+    ZEND_ARG_TYPE_INFO(0, hrp, IS_STRING, 1)
 ZEND_END_ARG_INFO();
-#endif
 
-//extrakeys
 #ifdef SECP256K1_MODULE_EXTRAKEYS
-
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_xonly_pubkey_parse, IS_LONG, NULL, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_address_p2tr, IS_LONG, NULL, 0)
 #else
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_xonly_pubkey_parse, IS_LONG, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_address_p2tr, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, pubkey,  IS_RESOURCE, 1)
-    ZEND_ARG_TYPE_INFO(0, input32, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(1, addressOut, IS_STRING, 1)
+    ZEND_ARG_INFO(0, xonlyPublicKey)
+    ZEND_ARG_TYPE_INFO(0, hrp, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(0, tweak, _IS_BOOL, 0)
 ZEND_END_ARG_INFO();
+#endif
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_xonly_pubkey_serialize, IS_LONG, NULL, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_address_many, IS_LONG, NULL, 0)
 #else
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_xonly_pubkey_serialize, IS_LONG, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_address_many, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, pubkey,  IS_STRING, 1)
-    ZEND_ARG_TYPE_INFO(0, pubkey, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(1, addressesOut, IS_ARRAY, 1)
+    ZEND_ARG_TYPE_INFO(1, validOut, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(0, type, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, publicKeys, IS_STRING, 0)
+    ZEND_ARG_INFO(0, prefix)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_xonly_pubkey_from_pubkey, IS_LONG, NULL, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_sha256, IS_LONG, NULL, 0)
 #else
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_xonly_pubkey_from_pubkey, IS_LONG, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_sha256, IS_LONG, 0)
 #endif
-    ZEND_ARG_TYPE_INFO(0, context,   IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, pubkey,    IS_RESOURCE, 1)
-    ZEND_ARG_TYPE_INFO(1, pk_parity, IS_LONG,     1)
-    ZEND_ARG_TYPE_INFO(0, pubkey,    IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(1, hashOut, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(0, data, IS_STRING, 0)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_xonly_pubkey_tweak_add, IS_LONG, NULL, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_tagged_sha256, IS_LONG, NULL, 0)
 #else
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_xonly_pubkey_tweak_add, IS_LONG, 0)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_tagged_sha256, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(1, hashOut, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(0, tag, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, data, IS_STRING, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_hmac_sha256, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_hmac_sha256, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(1, hashOut, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(0, key, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, data, IS_STRING, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_nonce_function_default, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_nonce_function_default, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(1, data, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(0, msg32, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, key32, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, algo16, IS_STRING, 1)
+    ZEND_ARG_INFO(0, data)
+    ZEND_ARG_TYPE_INFO(0, attempt, IS_LONG, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_nonce_function_rfc6979, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_nonce_function_rfc6979, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(1, nonce32, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(0, msg32, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, key32, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, algo16, IS_STRING, 1)
+    ZEND_ARG_INFO(0, data)
+    ZEND_ARG_TYPE_INFO(0, attempt, IS_LONG, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_scratch_space_create, IS_RESOURCE, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_scratch_space_create, IS_RESOURCE, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(0, size, IS_LONG, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_scratch_space_destroy, IS_RESOURCE, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_scratch_space_destroy, IS_RESOURCE, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(0, scratch, IS_RESOURCE, 0)
+ZEND_END_ARG_INFO();
+
+//recovery
+#ifdef SECP256K1_MODULE_RECOVERY
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recoverable_signature_parse_compact, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recoverable_signature_parse_compact, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(1, ecdsaRecoverableSignatureOut, IS_RESOURCE, 1)
+    ZEND_ARG_TYPE_INFO(0, sig64, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, recId, IS_LONG, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recoverable_signature_convert, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recoverable_signature_convert, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(1, ecdsaSignature)
+    ZEND_ARG_TYPE_INFO(0, ecdsaRecoverableSignature, IS_RESOURCE, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recoverable_signature_serialize_compact, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recoverable_signature_serialize_compact, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(1, sig64Out, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(1, recIdOut, IS_LONG, 1)
+    ZEND_ARG_TYPE_INFO(0, ecdsaRecoverableSignature, IS_RESOURCE, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_sign_recoverable, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_sign_recoverable, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(1, ecdsaRecoverableSignatureOut, IS_RESOURCE, 1)
+    ZEND_ARG_TYPE_INFO(0, msg32, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, secretKey, IS_STRING, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recover, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recover, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(1, ecPublicKey)
+    ZEND_ARG_TYPE_INFO(0, ecdsaRecoverableSignature, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(0, msg32, IS_STRING, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recover_many, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recover_many, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(1, publicKeysOut, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(1, validOut, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(0, signatures, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, msgs32, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, flags, IS_LONG, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recover_address, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recover_address, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(1, addressOut, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(0, sig65, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, msg32, IS_STRING, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recover_address_many, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdsa_recover_address_many, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(1, addressesOut, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(1, validOut, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(0, signatures, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, msgs32, IS_STRING, 0)
+ZEND_END_ARG_INFO();
+
+#endif
+
+//ecdh
+#ifdef SECP256K1_MODULE_ECDH
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdh, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdh, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(1, result, IS_STRING, 0)
+    ZEND_ARG_INFO(0, ecPublicKey)
+    ZEND_ARG_TYPE_INFO(0, privKey, IS_STRING, 0)
+    ZEND_ARG_INFO(0, hashfxn)
+    ZEND_ARG_TYPE_INFO(0, outputLen, IS_LONG, 1)
+    ZEND_ARG_INFO(0, data)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdh_many, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_ecdh_many, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(1, secrets, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, privKey, IS_STRING, 0)
+    ZEND_ARG_INFO(0, ecPublicKeys)
+    ZEND_ARG_TYPE_INFO(0, hashMode, IS_LONG, 0)
+    ZEND_ARG_INFO(0, data)
+ZEND_END_ARG_INFO();
+#endif
+
+//extrakeys
+#ifdef SECP256K1_MODULE_EXTRAKEYS
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_xonly_pubkey_parse, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_xonly_pubkey_parse, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(1, pubkey)
+    ZEND_ARG_TYPE_INFO(0, input32, IS_STRING, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_xonly_pubkey_serialize, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_xonly_pubkey_serialize, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(1, pubkey,  IS_STRING, 1)
+    ZEND_ARG_INFO(0, pubkey)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_xonly_pubkey_from_pubkey, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_xonly_pubkey_from_pubkey, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context,   IS_RESOURCE, 0)
+    ZEND_ARG_INFO(1, pubkey)
+    ZEND_ARG_TYPE_INFO(1, pk_parity, IS_LONG,     1)
+    ZEND_ARG_INFO(0, pubkey)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_xonly_pubkey_tweak_add, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_xonly_pubkey_tweak_add, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context,         IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, output_pubkey,   IS_RESOURCE, 1)
-    ZEND_ARG_TYPE_INFO(0, internal_pubkey, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(1, output_pubkey)
+    ZEND_ARG_INFO(0, internal_pubkey)
     ZEND_ARG_TYPE_INFO(0, tweak,           IS_STRING, 0)
 ZEND_END_ARG_INFO();
 
@@ -594,7 +1081,7 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_xonly_pubkey_tweak_add_ch
     ZEND_ARG_TYPE_INFO(0, context,          IS_RESOURCE, 0)
     ZEND_ARG_TYPE_INFO(0, tweaked_pubkey32, IS_STRING, 0)
     ZEND_ARG_TYPE_INFO(0, tweaked_pubkey_parity,  IS_LONG, 0)
-    ZEND_ARG_TYPE_INFO(0, internal_pubkey,  IS_RESOURCE, 0)
+    ZEND_ARG_INFO(0, internal_pubkey)
     ZEND_ARG_TYPE_INFO(0, tweak32,          IS_STRING, 0)
 ZEND_END_ARG_INFO();
 
@@ -604,7 +1091,7 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_keypair_create, IS_LONG,
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_keypair_create, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, keypair, IS_RESOURCE, 1)
+    ZEND_ARG_INFO(1, keypair)
     ZEND_ARG_TYPE_INFO(0, seckey,  IS_STRING, 0)
 ZEND_END_ARG_INFO();
 
@@ -615,7 +1102,7 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_keypair_sec, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
     ZEND_ARG_TYPE_INFO(1, seckey,  IS_STRING, 1)
-    ZEND_ARG_TYPE_INFO(0, keypair, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(0, keypair)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
@@ -624,8 +1111,8 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_keypair_pub, IS_LONG, NUL
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_keypair_pub, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, pubkey,  IS_RESOURCE, 1)
-    ZEND_ARG_TYPE_INFO(0, keypair, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(1, pubkey)
+    ZEND_ARG_INFO(0, keypair)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
@@ -634,9 +1121,9 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_keypair_xonly_pub, IS_LON
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_keypair_xonly_pub, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, pubkey,  IS_RESOURCE, 1)
+    ZEND_ARG_INFO(1, pubkey)
     ZEND_ARG_TYPE_INFO(1, pk_parity, IS_LONG,   1)
-    ZEND_ARG_TYPE_INFO(0, keypair, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(0, keypair)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
@@ -645,7 +1132,7 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_keypair_xonly_tweak_add,
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_keypair_xonly_tweak_add, IS_LONG, 0)
 #endif
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
-    ZEND_ARG_TYPE_INFO(1, keypair, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(1, keypair)
     ZEND_ARG_TYPE_INFO(0, tweak32, IS_STRING, 0)
 ZEND_END_ARG_INFO();
 
@@ -661,7 +1148,7 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_schnorrsig_sign, IS_LONG,
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
     ZEND_ARG_TYPE_INFO(1, sig64, IS_RESOURCE, 1)
     ZEND_ARG_TYPE_INFO(0, msg32, IS_STRING, 0)
-    ZEND_ARG_TYPE_INFO(0, keypair, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(0, keypair)
     ZEND_ARG_CALLABLE_INFO(0, noncefp, 1)
     ZEND_ARG_INFO(0, ndata)
 ZEND_END_ARG_INFO();
@@ -674,7 +1161,30 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_schnorrsig_verify, IS_LON
     ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
     ZEND_ARG_TYPE_INFO(0, sig64, IS_STRING, 0)
     ZEND_ARG_TYPE_INFO(0, msg32, IS_STRING, 0)
-    ZEND_ARG_TYPE_INFO(0, pubkey, IS_RESOURCE, 0)
+    ZEND_ARG_INFO(0, pubkey)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_schnorrsig_verify_raw, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_schnorrsig_verify_raw, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(0, sig64, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, msg32, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, xonlyPubkey32, IS_STRING, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_schnorrsig_verify_batch, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_schnorrsig_verify_batch, IS_LONG, 0)
+#endif
+    ZEND_ARG_TYPE_INFO(0, context, IS_RESOURCE, 0)
+    ZEND_ARG_TYPE_INFO(0, sigs64, IS_ARRAY, 0)
+    ZEND_ARG_TYPE_INFO(0, msgs32, IS_ARRAY, 0)
+    ZEND_ARG_TYPE_INFO(0, pubkeys, IS_ARRAY, 0)
+    ZEND_ARG_TYPE_INFO(1, resultsOut, IS_STRING, 1)
 ZEND_END_ARG_INFO();
 
 #if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
@@ -702,21 +1212,33 @@ const zend_function_entry secp256k1_functions[] = {
         PHP_FE(secp256k1_context_create,                     arginfo_secp256k1_context_create)
         PHP_FE(secp256k1_context_clone,                      arginfo_secp256k1_context_clone)
         PHP_FE(secp256k1_context_destroy,                    arginfo_secp256k1_context_destroy)
+        PHP_FE(secp256k1_context_persistent,                 arginfo_secp256k1_context_persistent)
+        PHP_FE(secp256k1_cache_stats,                        arginfo_secp256k1_cache_stats)
+        PHP_FE(secp256k1_stats,                              arginfo_secp256k1_stats)
+        PHP_FE(secp256k1_trace_register,                     arginfo_secp256k1_trace_register)
+        PHP_FE(secp256k1_trace_unregister,                   arginfo_secp256k1_trace_unregister)
 
         PHP_FE(secp256k1_ec_pubkey_parse,                    arginfo_secp256k1_ec_pubkey_parse)
+        PHP_FE(secp256k1_ec_pubkey_parse_many,               arginfo_secp256k1_ec_pubkey_parse_many)
         PHP_FE(secp256k1_ec_pubkey_serialize,                arginfo_secp256k1_ec_pubkey_serialize)
+        PHP_FE(secp256k1_ec_pubkey_serialize_many,           arginfo_secp256k1_ec_pubkey_serialize_many)
 
         PHP_FE(secp256k1_ecdsa_signature_parse_compact,      arginfo_secp256k1_ecdsa_signature_parse_compact)
         PHP_FE(secp256k1_ecdsa_signature_parse_der,          arginfo_secp256k1_ecdsa_signature_parse_der)
         PHP_FE(secp256k1_ecdsa_signature_serialize_der,      arginfo_secp256k1_ecdsa_signature_serialize_der)
+        PHP_FE(secp256k1_ecdsa_signature_serialize_der_many, arginfo_secp256k1_ecdsa_signature_serialize_der_many)
         PHP_FE(secp256k1_ecdsa_signature_serialize_compact,  arginfo_secp256k1_ecdsa_signature_serialize_compact)
+        PHP_FE(secp256k1_ecdsa_signature_serialize_compact_many, arginfo_secp256k1_ecdsa_signature_serialize_compact_many)
 
         PHP_FE(secp256k1_ecdsa_verify,                       arginfo_secp256k1_ecdsa_verify)
+        PHP_FE(secp256k1_ecdsa_verify_raw,                   arginfo_secp256k1_ecdsa_verify_raw)
+        PHP_FE(secp256k1_ecdsa_verify_batch,                 arginfo_secp256k1_ecdsa_verify_batch)
         PHP_FE(secp256k1_ecdsa_signature_normalize,          arginfo_secp256k1_ecdsa_signature_normalize)
         PHP_FE(secp256k1_ecdsa_sign,                         arginfo_secp256k1_ecdsa_sign)
         PHP_FE(secp256k1_ec_seckey_verify,                   arginfo_secp256k1_ec_seckey_verify)
 
         PHP_FE(secp256k1_ec_pubkey_create,                   arginfo_secp256k1_ec_pubkey_create)
+        PHP_FE(secp256k1_ec_pubkey_create_many,              arginfo_secp256k1_ec_pubkey_create_many)
         PHP_FE(secp256k1_ec_privkey_negate,                  arginfo_secp256k1_ec_privkey_negate)
         PHP_FE(secp256k1_ec_pubkey_negate,                   arginfo_secp256k1_ec_pubkey_negate)
 
@@ -728,6 +1250,26 @@ const zend_function_entry secp256k1_functions[] = {
         PHP_FE(secp256k1_context_randomize,                  arginfo_secp256k1_context_randomize)
         PHP_FE(secp256k1_ec_pubkey_combine,                  arginfo_secp256k1_ec_pubkey_combine)
 
+        PHP_FE(secp256k1_bip32_master,                       arginfo_secp256k1_bip32_master)
+        PHP_FE(secp256k1_bip32_derive,                       arginfo_secp256k1_bip32_derive)
+        PHP_FE(secp256k1_bip32_derive_many,                  arginfo_secp256k1_bip32_derive_many)
+        PHP_FE(secp256k1_bip32_serialize,                    arginfo_secp256k1_bip32_serialize)
+        PHP_FE(secp256k1_bip32_parse,                        arginfo_secp256k1_bip32_parse)
+        PHP_FE(secp256k1_bip32_neuter,                       arginfo_secp256k1_bip32_neuter)
+        PHP_FE(secp256k1_bip32_pubkey,                       arginfo_secp256k1_bip32_pubkey)
+        PHP_FE(secp256k1_bip32_seckey,                       arginfo_secp256k1_bip32_seckey)
+
+        PHP_FE(secp256k1_address_p2pkh,                      arginfo_secp256k1_address_p2pkh)
+        PHP_FE(secp256k1_address_p2wpkh,                     arginfo_secp256k1_address_p2wpkh)
+#ifdef SECP256K1_MODULE_EXTRAKEYS
+        PHP_FE(secp256k1_address_p2tr,                       arginfo_secp256k1_address_p2tr)
+#endif
+        PHP_FE(secp256k1_address_many,                       arginfo_secp256k1_address_many)
+
+        PHP_FE(secp256k1_sha256,                             arginfo_secp256k1_sha256)
+        PHP_FE(secp256k1_tagged_sha256,                      arginfo_secp256k1_tagged_sha256)
+        PHP_FE(secp256k1_hmac_sha256,                        arginfo_secp256k1_hmac_sha256)
+
         PHP_FE(secp256k1_scratch_space_create,               arginfo_secp256k1_scratch_space_create)
         PHP_FE(secp256k1_scratch_space_destroy,              arginfo_secp256k1_scratch_space_destroy)
 
@@ -741,11 +1283,15 @@ const zend_function_entry secp256k1_functions[] = {
         PHP_FE(secp256k1_ecdsa_recoverable_signature_serialize_compact, arginfo_secp256k1_ecdsa_recoverable_signature_serialize_compact)
         PHP_FE(secp256k1_ecdsa_sign_recoverable,             arginfo_secp256k1_ecdsa_sign_recoverable)
         PHP_FE(secp256k1_ecdsa_recover,                      arginfo_secp256k1_ecdsa_recover)
+        PHP_FE(secp256k1_ecdsa_recover_many,                 arginfo_secp256k1_ecdsa_recover_many)
+        PHP_FE(secp256k1_ecdsa_recover_address,              arginfo_secp256k1_ecdsa_recover_address)
+        PHP_FE(secp256k1_ecdsa_recover_address_many,         arginfo_secp256k1_ecdsa_recover_address_many)
 #endif
 
         // secp256k1_ecdh.h
 #ifdef SECP256K1_MODULE_ECDH
         PHP_FE(secp256k1_ecdh,                               arginfo_secp256k1_ecdh)
+        PHP_FE(secp256k1_ecdh_many,                          arginfo_secp256k1_ecdh_many)
 #endif
         // secp256k1_extrakeys.h
 #ifdef SECP256K1_MODULE_EXTRAKEYS
@@ -764,6 +1310,8 @@ const zend_function_entry secp256k1_functions[] = {
 #ifdef SECP256K1_MODULE_SCHNORRSIG
         PHP_FE(secp256k1_schnorrsig_sign,                    arginfo_secp256k1_schnorrsig_sign)
         PHP_FE(secp256k1_schnorrsig_verify,                  arginfo_secp256k1_schnorrsig_verify)
+        PHP_FE(secp256k1_schnorrsig_verify_raw,              arginfo_secp256k1_schnorrsig_verify_raw)
+        PHP_FE(secp256k1_schnorrsig_verify_batch,            arginfo_secp256k1_schnorrsig_verify_batch)
         PHP_FE(secp256k1_nonce_function_bip340,              arginfo_secp256k1_nonce_function_bip340)
 #endif
 
@@ -771,8 +1319,68 @@ const zend_function_entry secp256k1_functions[] = {
 };
 /* }}} */
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_secp256k1_pubkey_vector_construct, 0, 0, 0)
+    ZEND_ARG_TYPE_INFO(0, capacity, IS_LONG, 0)
+ZEND_END_ARG_INFO();
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_secp256k1_pubkey_vector_append, 0, 0, 1)
+    ZEND_ARG_INFO(0, ecPublicKey)
+ZEND_END_ARG_INFO();
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_secp256k1_pubkey_vector_get, 0, 0, 1)
+    ZEND_ARG_TYPE_INFO(0, index, IS_LONG, 0)
+ZEND_END_ARG_INFO();
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_secp256k1_pubkey_vector_slice, 0, 0, 1)
+    ZEND_ARG_TYPE_INFO(0, offset, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, length, IS_LONG, 1)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_pubkey_vector_count, IS_LONG, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_pubkey_vector_count, IS_LONG, 0)
+#endif
+ZEND_END_ARG_INFO();
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_secp256k1_sha256_construct, 0, 0, 0)
+    ZEND_ARG_TYPE_INFO(0, tag, IS_STRING, 1)
+ZEND_END_ARG_INFO();
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_secp256k1_sha256_update, 0, 0, 1)
+    ZEND_ARG_TYPE_INFO(0, data, IS_STRING, 0)
+ZEND_END_ARG_INFO();
+
+#if (PHP_VERSION_ID >= 70000 && PHP_VERSION_ID <= 70200)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_sha256_digest, IS_STRING, NULL, 0)
+#else
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(arginfo_secp256k1_sha256_digest, IS_STRING, 0)
+#endif
+ZEND_END_ARG_INFO();
+
+/* {{{ secp256k1_pubkey_vector_methods[] */
+static const zend_function_entry secp256k1_pubkey_vector_methods[] = {
+        PHP_ME(Secp256k1_PublicKeyVector, __construct,      arginfo_secp256k1_pubkey_vector_construct, ZEND_ACC_PUBLIC)
+        PHP_ME(Secp256k1_PublicKeyVector, append,           arginfo_secp256k1_pubkey_vector_append,    ZEND_ACC_PUBLIC)
+        PHP_ME(Secp256k1_PublicKeyVector, get,              arginfo_secp256k1_pubkey_vector_get,       ZEND_ACC_PUBLIC)
+        PHP_ME(Secp256k1_PublicKeyVector, slice,            arginfo_secp256k1_pubkey_vector_slice,     ZEND_ACC_PUBLIC)
+        PHP_ME(Secp256k1_PublicKeyVector, count,            arginfo_secp256k1_pubkey_vector_count,     ZEND_ACC_PUBLIC)
+        PHP_FE_END
+};
+/* }}} */
+
+/* {{{ secp256k1_sha256_methods[] */
+static const zend_function_entry secp256k1_sha256_methods[] = {
+        PHP_ME(Secp256k1_Sha256, __construct,               arginfo_secp256k1_sha256_construct,        ZEND_ACC_PUBLIC)
+        PHP_ME(Secp256k1_Sha256, update,                    arginfo_secp256k1_sha256_update,           ZEND_ACC_PUBLIC)
+        PHP_ME(Secp256k1_Sha256, digest,                    arginfo_secp256k1_sha256_digest,           ZEND_ACC_PUBLIC)
+        PHP_FE_END
+};
+/* }}} */
+
 /* resource numbers */
 static int le_secp256k1_ctx;
+static int le_secp256k1_persistent_ctx;
 static int le_secp256k1_pubkey;
 static int le_secp256k1_sig;
 static int le_secp256k1_scratch_space;
@@ -783,12 +1391,19 @@ static int le_secp256k1_keypair;
 /* dtor functions */
 static void secp256k1_ctx_dtor(zend_resource *rsrc)
 {
-    secp256k1_context *ctx = (secp256k1_context*) rsrc->ptr;
-    if (ctx) {
-        secp256k1_context_destroy(ctx);
+    secp256k1_context_wrapper *wrapper = (secp256k1_context_wrapper*) rsrc->ptr;
+    if (wrapper) {
+        secp256k1_context_destroy(wrapper->ctx);
+        efree(wrapper);
     }
 }
 
+// persistent contexts are owned by the module and destroyed in MSHUTDOWN,
+// the request resource only borrows them.
+static void secp256k1_persistent_ctx_dtor(zend_resource *rsrc)
+{
+}
+
 static void secp256k1_pubkey_dtor(zend_resource *rsrc)
 {
     secp256k1_pubkey *pubkey = (secp256k1_pubkey*) rsrc->ptr;
@@ -840,29 +1455,561 @@ static void secp256k1_keypair_dtor(zend_resource * rsrc)
     }
 }
 #endif
-// helper functions to extract pointers from resource zvals
+/* value classes */
+static zend_class_entry *secp256k1_pubkey_ce;
+static zend_class_entry *secp256k1_ecdsa_signature_ce;
+static zend_object_handlers secp256k1_pubkey_handlers;
+static zend_object_handlers secp256k1_ecdsa_signature_handlers;
+static zend_class_entry *secp256k1_pubkey_vector_ce;
+static zend_object_handlers secp256k1_pubkey_vector_handlers;
+static zend_class_entry *secp256k1_extended_key_ce;
+static zend_object_handlers secp256k1_extended_key_handlers;
+static zend_class_entry *secp256k1_sha256_ce;
+static zend_object_handlers secp256k1_sha256_handlers;
+#ifdef SECP256K1_MODULE_EXTRAKEYS
+static zend_class_entry *secp256k1_xonly_pubkey_ce;
+static zend_class_entry *secp256k1_keypair_ce;
+static zend_object_handlers secp256k1_xonly_pubkey_handlers;
+static zend_object_handlers secp256k1_keypair_handlers;
+#endif
 
-// attempt to read a sec256k1_context* from the provided resource zval
-static secp256k1_context* php_get_secp256k1_context(zval* pcontext) {
-    return (secp256k1_context *)zend_fetch_resource2_ex(pcontext, SECP256K1_CTX_RES_NAME, le_secp256k1_ctx, -1);
+// the embedded struct lives in the handlers->offset bytes before std
+static zend_object *php_secp256k1_value_create(zend_class_entry *ce, zend_object_handlers *handlers)
+{
+    char *intern = ecalloc(1, handlers->offset + sizeof(zend_object) + zend_object_properties_size(ce));
+    zend_object *std = (zend_object *) (intern + handlers->offset);
+
+    zend_object_std_init(std, ce);
+    object_properties_init(std, ce);
+    std->handlers = handlers;
+    return std;
 }
 
-// attempt to read a sec256k1_ecdsa_signature* from the provided resource zval
-static secp256k1_ecdsa_signature* php_get_secp256k1_ecdsa_signature(zval *psig) {
-    return (secp256k1_ecdsa_signature *)zend_fetch_resource2_ex(psig, SECP256K1_SIG_RES_NAME, le_secp256k1_sig, -1);
+#if PHP_VERSION_ID >= 80000
+static zend_object *php_secp256k1_value_clone(zend_object *old)
+{
+#else
+static zend_object *php_secp256k1_value_clone(zval *zold)
+{
+    zend_object *old = Z_OBJ_P(zold);
+#endif
+    zend_object *new = old->ce->create_object(old->ce);
+    memcpy((char *) new - old->handlers->offset, (char *) old - old->handlers->offset, old->handlers->offset);
+    zend_objects_clone_members(new, old);
+    return new;
 }
 
-// attempt to read a sec256k1_pubkey* from the provided resource zval
-static secp256k1_pubkey* php_get_secp256k1_pubkey(zval *pkey) {
-    return (secp256k1_pubkey *)zend_fetch_resource2_ex(pkey, SECP256K1_PUBKEY_RES_NAME, le_secp256k1_pubkey, -1);
+static void php_secp256k1_value_free(zend_object *obj)
+{
+    // a KeyPair holds the secret key, wipe every value alike
+    ZEND_SECURE_ZERO((char *) obj - obj->handlers->offset, obj->handlers->offset);
+    zend_object_std_dtor(obj);
 }
 
-// attempt to read a sec256k1_scratch_space * from the provided resource zval
-static secp256k1_scratch_space_wrapper* php_get_secp256k1_scratch_space(zval *psig) {
-    return (secp256k1_scratch_space_wrapper *)zend_fetch_resource2_ex(psig, SECP256K1_SCRATCH_SPACE_RES_NAME, le_secp256k1_scratch_space, -1);
+static zend_object *php_secp256k1_pubkey_create_object(zend_class_entry *ce)
+{
+    return php_secp256k1_value_create(ce, &secp256k1_pubkey_handlers);
 }
 
-#ifdef SECP256K1_MODULE_RECOVERY
+static zend_object *php_secp256k1_extended_key_create_object(zend_class_entry *ce)
+{
+    return php_secp256k1_value_create(ce, &secp256k1_extended_key_handlers);
+}
+
+// a new hash starts out as an untagged SHA256
+static zend_object *php_secp256k1_sha256_create_object(zend_class_entry *ce)
+{
+    zend_object *obj = php_secp256k1_value_create(ce, &secp256k1_sha256_handlers);
+    php_secp256k1_sha256_init(&PHP_SECP256K1_OBJ(php_secp256k1_sha256_obj, obj)->hash);
+    return obj;
+}
+
+static zend_object *php_secp256k1_pubkey_vector_create_object(zend_class_entry *ce)
+{
+    return php_secp256k1_value_create(ce, &secp256k1_pubkey_vector_handlers);
+}
+
+// makes room for n more keys. capacity grows by half so appending one key
+// at a time stays amortized constant without doubling the memory used.
+static void php_secp256k1_pubkey_vector_reserve(php_secp256k1_pubkey_vector_obj *vec, size_t n)
+{
+    size_t capacity;
+    if (vec->capacity - vec->count >= n) {
+        return;
+    }
+    capacity = vec->capacity + (vec->capacity >> 1);
+    if (capacity < vec->count + n) {
+        capacity = vec->count + n;
+    }
+    vec->keys = safe_erealloc(vec->keys, capacity, sizeof(secp256k1_pubkey), 0);
+    vec->capacity = capacity;
+}
+
+#if PHP_VERSION_ID >= 80000
+static zend_object *php_secp256k1_pubkey_vector_clone(zend_object *old)
+{
+#else
+static zend_object *php_secp256k1_pubkey_vector_clone(zval *zold)
+{
+    zend_object *old = Z_OBJ_P(zold);
+#endif
+    zend_object *new = old->ce->create_object(old->ce);
+    php_secp256k1_pubkey_vector_obj *from = PHP_SECP256K1_OBJ(php_secp256k1_pubkey_vector_obj, old);
+    php_secp256k1_pubkey_vector_obj *to = PHP_SECP256K1_OBJ(php_secp256k1_pubkey_vector_obj, new);
+
+    if (from->count > 0) {
+        php_secp256k1_pubkey_vector_reserve(to, from->count);
+        memcpy(to->keys, from->keys, from->count * sizeof(secp256k1_pubkey));
+        to->count = from->count;
+    }
+    zend_objects_clone_members(new, old);
+    return new;
+}
+
+static void php_secp256k1_pubkey_vector_free(zend_object *obj)
+{
+    php_secp256k1_pubkey_vector_obj *vec = PHP_SECP256K1_OBJ(php_secp256k1_pubkey_vector_obj, obj);
+    if (vec->keys != NULL) {
+        efree(vec->keys);
+    }
+    zend_object_std_dtor(obj);
+}
+
+// lets count() skip the method call
+#if PHP_VERSION_ID >= 80000
+static int php_secp256k1_pubkey_vector_count_elements(zend_object *obj, zend_long *count)
+{
+#else
+static int php_secp256k1_pubkey_vector_count_elements(zval *zobj, zend_long *count)
+{
+    zend_object *obj = Z_OBJ_P(zobj);
+#endif
+    *count = (zend_long) PHP_SECP256K1_OBJ(php_secp256k1_pubkey_vector_obj, obj)->count;
+    return SUCCESS;
+}
+
+static zend_object *php_secp256k1_ecdsa_signature_create_object(zend_class_entry *ce)
+{
+    return php_secp256k1_value_create(ce, &secp256k1_ecdsa_signature_handlers);
+}
+
+#ifdef SECP256K1_MODULE_EXTRAKEYS
+static zend_object *php_secp256k1_xonly_pubkey_create_object(zend_class_entry *ce)
+{
+    return php_secp256k1_value_create(ce, &secp256k1_xonly_pubkey_handlers);
+}
+
+static zend_object *php_secp256k1_keypair_create_object(zend_class_entry *ce)
+{
+    return php_secp256k1_value_create(ce, &secp256k1_keypair_handlers);
+}
+#endif
+
+static zend_class_entry *php_secp256k1_register_value_class(zend_class_entry *ce,
+        zend_object *(*create_object)(zend_class_entry *), zend_object_handlers *handlers, int offset)
+{
+    zend_class_entry *value_ce = zend_register_internal_class(ce);
+    value_ce->ce_flags |= ZEND_ACC_FINAL;
+    value_ce->create_object = create_object;
+#if PHP_VERSION_ID >= 80100
+    value_ce->ce_flags |= ZEND_ACC_NOT_SERIALIZABLE;
+#else
+    value_ce->serialize = zend_class_serialize_deny;
+    value_ce->unserialize = zend_class_unserialize_deny;
+#endif
+
+    memcpy(handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+    handlers->offset = offset;
+    handlers->clone_obj = php_secp256k1_value_clone;
+    handlers->free_obj = php_secp256k1_value_free;
+    return value_ce;
+}
+
+// objects which were never written to hold no value and are rejected as input
+static int php_secp256k1_value_initialized(zval *zv, zend_bool initialized)
+{
+    if (!initialized) {
+        php_error_docref(NULL, E_WARNING, "supplied %s has not been initialized", ZSTR_VAL(Z_OBJCE_P(zv)->name));
+    }
+    return initialized;
+}
+
+// helper functions to extract pointers from resource zvals
+
+// attempt to read a secp256k1_context_wrapper* from the provided resource zval
+static secp256k1_context_wrapper* php_get_secp256k1_context_wrapper(zval* pcontext) {
+    return (secp256k1_context_wrapper *)zend_fetch_resource2_ex(pcontext, SECP256K1_CTX_RES_NAME, le_secp256k1_ctx, le_secp256k1_persistent_ctx);
+}
+
+// attempt to read a sec256k1_context* from the provided resource zval
+static secp256k1_context* php_get_secp256k1_context(zval* pcontext) {
+    secp256k1_context_wrapper *wrapper = php_get_secp256k1_context_wrapper(pcontext);
+    return wrapper != NULL ? wrapper->ctx : NULL;
+}
+
+// returns the process wide context for flags, creating it on first use.
+// a SIGN|VERIFY context is handed out for any flags once it exists.
+static secp256k1_context_wrapper* php_secp256k1_persistent_context(long flags) {
+    secp256k1_context_wrapper *wrapper;
+
+#ifdef ZTS
+    tsrm_mutex_lock(persistent_ctx_mutex);
+#endif
+    wrapper = &persistent_ctx[PERSISTENT_CTX_SLOT(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY)];
+    if (wrapper->ctx == NULL) {
+        wrapper = &persistent_ctx[PERSISTENT_CTX_SLOT(flags)];
+        if (wrapper->ctx == NULL) {
+            wrapper->ctx = secp256k1_context_create(flags | SECP256K1_CONTEXT_NONE);
+            wrapper->flags = flags;
+        }
+    }
+#ifdef ZTS
+    tsrm_mutex_unlock(persistent_ctx_mutex);
+#endif
+    return wrapper->ctx != NULL ? wrapper : NULL;
+}
+
+// whether the context of zCtx was created with SECP256K1_CONTEXT_VERIFY. the
+// signature cache only answers for such contexts, so a hit never lets a
+// context accept a signature it could not have verified itself.
+static int php_secp256k1_context_verifies(zval *zCtx) {
+    secp256k1_context_wrapper *wrapper = php_get_secp256k1_context_wrapper(zCtx);
+    return wrapper != NULL && (wrapper->flags & SECP256K1_CONTEXT_VERIFY) == SECP256K1_CONTEXT_VERIFY;
+}
+
+// charges ops signing operations to the context of zCtx. once
+// secp256k1.randomize_ops operations or secp256k1.randomize_seconds seconds
+// have passed since it was last randomized, the context is randomized first
+// with a seed from the operating system's CSPRNG. a context which was never
+// randomized is due as soon as secp256k1.randomize_seconds is set.
+static void php_secp256k1_context_budget(zval *zCtx, zend_long ops) {
+    secp256k1_context_wrapper *wrapper;
+    zend_long max_ops = SECP256K1_G(randomize_ops), max_seconds = SECP256K1_G(randomize_seconds);
+    unsigned char seed32[32];
+    time_t now = 0;
+
+    if ((max_ops <= 0 && max_seconds <= 0) || (wrapper = php_get_secp256k1_context_wrapper(zCtx)) == NULL) {
+        return;
+    }
+#ifdef ZTS
+    // other threads may be signing with a persistent context right now
+    if (Z_RES_P(zCtx)->type == le_secp256k1_persistent_ctx) {
+        return;
+    }
+#endif
+
+    if (max_seconds > 0) {
+        now = time(NULL);
+    }
+    if ((max_ops > 0 && wrapper->ops >= max_ops) || (max_seconds > 0 && now - wrapper->randomized >= max_seconds)) {
+        // without a seed the context keeps its blinding and is due again next time
+        if (php_secp256k1_os_random(seed32, sizeof(seed32))) {
+            if (secp256k1_context_randomize(wrapper->ctx, seed32)) {
+                wrapper->ops = 0;
+                wrapper->randomized = max_seconds > 0 ? now : time(NULL);
+            }
+            ZEND_SECURE_ZERO(seed32, sizeof(seed32));
+        }
+    }
+    wrapper->ops += ops;
+}
+
+// applies fn to items [0, n), spread across the worker pool when
+// secp256k1.threads allows it. bitmap receives one bit per item, without a
+// bitmap processing stops at the first failure.
+static int php_secp256k1_batch(const secp256k1_context *ctx, php_secp256k1_batch_fn fn, void *arg,
+                               size_t n, unsigned char *bitmap) {
+#ifdef HAVE_SECP256K1_THREADS
+    php_secp256k1_pool *pool;
+#endif
+    // picked up by php_secp256k1_instrument_handler for the batch size
+    SECP256K1_G(stats_items) = n;
+#ifdef HAVE_SECP256K1_THREADS
+    if (SECP256K1_G(threads) > 1 && n >= POOL_MIN_BATCH) {
+        // the calling thread is one of the threads
+        size_t nworkers = (size_t) SECP256K1_G(threads) - 1;
+        if ((pool = php_secp256k1_pool_get(nworkers, NULL)) == NULL) {
+            secp256k1_context_wrapper *wrapper = php_secp256k1_persistent_context(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+            pool = php_secp256k1_pool_get(nworkers, wrapper != NULL ? wrapper->ctx : NULL);
+        }
+        if (pool != NULL) {
+            return php_secp256k1_pool_run(pool, ctx, fn, arg, n, bitmap);
+        }
+    }
+#endif
+    return php_secp256k1_batch_serial(ctx, fn, arg, 0, n, bitmap);
+}
+
+#ifdef HAVE_SECP256K1_SHM
+// the key is the length of the encoding followed by the encoding, zero
+// padded, so 32 byte x-only keys and 33 or 65 byte keys never collide.
+#define PUBKEY_CACHE_KEY_LENGTH (1 + PUBKEY_UNCOMPRESSED_LENGTH)
+
+static uint64_t php_secp256k1_pubkey_cache_key(unsigned char *key, const unsigned char *in, size_t len)
+{
+    memset(key, 0, PUBKEY_CACHE_KEY_LENGTH);
+    key[0] = (unsigned char) len;
+    memcpy(key + 1, in, len);
+    return php_secp256k1_shm_cache_hash(pubkey_cache, key);
+}
+#endif
+
+// parses a serialized public key through the public key cache. only keys
+// which parsed are cached, so a hit never skips a validity check.
+static int php_secp256k1_ec_pubkey_parse_cached(const secp256k1_context *ctx, secp256k1_pubkey *pubkey,
+                                                const unsigned char *in, size_t len) {
+#ifdef HAVE_SECP256K1_SHM
+    unsigned char key[PUBKEY_CACHE_KEY_LENGTH];
+    uint64_t hash;
+    if (pubkey_cache != NULL && (len == PUBKEY_COMPRESSED_LENGTH || len == PUBKEY_UNCOMPRESSED_LENGTH)) {
+        hash = php_secp256k1_pubkey_cache_key(key, in, len);
+        if (php_secp256k1_shm_cache_get(pubkey_cache, hash, key, pubkey)) {
+            return 1;
+        }
+        if (!secp256k1_ec_pubkey_parse(ctx, pubkey, in, len)) {
+            return 0;
+        }
+        php_secp256k1_shm_cache_put(pubkey_cache, hash, key, pubkey);
+        return 1;
+    }
+#endif
+    return secp256k1_ec_pubkey_parse(ctx, pubkey, in, len);
+}
+
+#ifdef SECP256K1_MODULE_EXTRAKEYS
+static int php_secp256k1_xonly_pubkey_parse_cached(const secp256k1_context *ctx, secp256k1_xonly_pubkey *pubkey,
+                                                   const unsigned char *in32) {
+#ifdef HAVE_SECP256K1_SHM
+    unsigned char key[PUBKEY_CACHE_KEY_LENGTH];
+    uint64_t hash;
+    if (pubkey_cache != NULL) {
+        hash = php_secp256k1_pubkey_cache_key(key, in32, 32);
+        if (php_secp256k1_shm_cache_get(pubkey_cache, hash, key, pubkey)) {
+            return 1;
+        }
+        if (!secp256k1_xonly_pubkey_parse(ctx, pubkey, in32)) {
+            return 0;
+        }
+        php_secp256k1_shm_cache_put(pubkey_cache, hash, key, pubkey);
+        return 1;
+    }
+#endif
+    return secp256k1_xonly_pubkey_parse(ctx, pubkey, in32);
+}
+#endif
+
+#ifdef HAVE_SECP256K1_SHM
+#define SIG_CACHE_SALT_LENGTH 64
+#define SIG_CACHE_ECDSA 0
+#define SIG_CACHE_SCHNORRSIG 1
+
+// hashes the scheme, the signature, the message and the public key as
+// libsecp256k1 stores them, so the raw and the parsed verify functions share
+// entries. the key is uniformly random, its first bytes pick the bucket.
+static uint64_t php_secp256k1_sig_cache_key(unsigned char *key32, unsigned char scheme, const unsigned char *sig64,
+                                            const unsigned char *msg32, const unsigned char *pubkey64)
+{
+    php_secp256k1_sha256 hash = sig_cache_salted;
+    uint64_t bits = 0;
+    int i;
+
+    php_secp256k1_sha256_write(&hash, &scheme, 1);
+    php_secp256k1_sha256_write(&hash, sig64, 64);
+    php_secp256k1_sha256_write(&hash, msg32, HASH_LENGTH);
+    php_secp256k1_sha256_write(&hash, pubkey64, 64);
+    php_secp256k1_sha256_finalize(&hash, key32);
+    for (i = 0; i < 8; i++) {
+        bits |= (uint64_t) key32[i] << (8 * i);
+    }
+    return bits;
+}
+#endif
+
+// verifies an ECDSA signature unless the signature cache holds it already.
+// cached is php_secp256k1_context_verifies() of the context.
+static int php_secp256k1_ecdsa_verify_cached(const secp256k1_context *ctx, int cached, const secp256k1_ecdsa_signature *sig,
+                                             const unsigned char *msg32, const secp256k1_pubkey *pubkey) {
+#ifdef HAVE_SECP256K1_SHM
+    unsigned char key[HASH_LENGTH];
+    uint64_t hash;
+    if (sig_cache != NULL && cached) {
+        hash = php_secp256k1_sig_cache_key(key, SIG_CACHE_ECDSA, sig->data, msg32, pubkey->data);
+        if (php_secp256k1_shm_cache_get(sig_cache, hash, key, NULL)) {
+            return 1;
+        }
+        if (!secp256k1_ecdsa_verify(ctx, sig, msg32, pubkey)) {
+            return 0;
+        }
+        php_secp256k1_shm_cache_put(sig_cache, hash, key, NULL);
+        return 1;
+    }
+#endif
+    return secp256k1_ecdsa_verify(ctx, sig, msg32, pubkey);
+}
+
+#ifdef SECP256K1_MODULE_SCHNORRSIG
+static int php_secp256k1_schnorrsig_verify_cached(const secp256k1_context *ctx, int cached, const unsigned char *sig64,
+                                                  const unsigned char *msg32, const secp256k1_xonly_pubkey *pubkey) {
+#ifdef HAVE_SECP256K1_SHM
+    unsigned char key[HASH_LENGTH];
+    uint64_t hash;
+    if (sig_cache != NULL && cached) {
+        hash = php_secp256k1_sig_cache_key(key, SIG_CACHE_SCHNORRSIG, sig64, msg32, pubkey->data);
+        if (php_secp256k1_shm_cache_get(sig_cache, hash, key, NULL)) {
+            return 1;
+        }
+        if (!secp256k1_schnorrsig_verify(ctx, sig64, msg32, pubkey)) {
+            return 0;
+        }
+        php_secp256k1_shm_cache_put(sig_cache, hash, key, NULL);
+        return 1;
+    }
+#endif
+    return secp256k1_schnorrsig_verify(ctx, sig64, msg32, pubkey);
+}
+#endif
+
+// BIP32 children derived during a request are cached by parent and index, so
+// deriving m/84'/0'/0'/0/i for sequential i only computes the last step. The
+// hash keeps insertion order: a hit moves to the back and the front is
+// evicted, which bounds the cache to secp256k1.bip32_cache_size nodes in least
+// recently used order.
+#define BIP32_CACHE_KEY_LENGTH (32 + PUBKEY_COMPRESSED_LENGTH + 1 + 1 + 4)
+
+static void php_secp256k1_bip32_cache_dtor(zval *zv)
+{
+    ZEND_SECURE_ZERO(Z_PTR_P(zv), sizeof(php_secp256k1_bip32_node));
+    efree(Z_PTR_P(zv));
+}
+
+static void php_secp256k1_bip32_cache_destroy(void)
+{
+    if (SECP256K1_G(bip32_cache) != NULL) {
+        zend_hash_destroy(SECP256K1_G(bip32_cache));
+        FREE_HASHTABLE(SECP256K1_G(bip32_cache));
+        SECP256K1_G(bip32_cache) = NULL;
+    }
+}
+
+// derives child index of parent, going through the request's cache
+static int php_secp256k1_bip32_derive_child(const secp256k1_context *ctx, php_secp256k1_bip32_node *child,
+                                            const php_secp256k1_bip32_node *parent, uint32_t index)
+{
+    unsigned char key[BIP32_CACHE_KEY_LENGTH], fingerprint[4];
+    php_secp256k1_bip32_node *cached;
+    HashTable *cache = SECP256K1_G(bip32_cache);
+    zend_long size = SECP256K1_G(bip32_cache_size);
+    Bucket *oldest = NULL;
+
+    // the chain code and public key identify the parent, has_private tells
+    // an extended private key from its neutered twin. the depth is part of
+    // the child, so the same parent serialized at another depth is another
+    // entry.
+    memcpy(key, parent->chaincode, 32);
+    memcpy(key + 32, parent->pubkey33, PUBKEY_COMPRESSED_LENGTH);
+    key[32 + PUBKEY_COMPRESSED_LENGTH] = parent->has_private;
+    key[32 + PUBKEY_COMPRESSED_LENGTH + 1] = parent->depth;
+    php_secp256k1_bip32_write32(key + 32 + PUBKEY_COMPRESSED_LENGTH + 2, index);
+
+    if (size > 0 && cache != NULL && (cached = zend_hash_str_find_ptr(cache, (char *) key, sizeof(key))) != NULL) {
+        *child = *cached;
+        zend_hash_str_del(cache, (char *) key, sizeof(key));
+        zend_hash_str_add_mem(cache, (char *) key, sizeof(key), child, sizeof(*child));
+        return 1;
+    }
+
+    php_secp256k1_bip32_fingerprint(parent, fingerprint);
+    if (!php_secp256k1_bip32_ckd(ctx, child, parent, fingerprint, index)) {
+        return 0;
+    }
+
+    if (size > 0) {
+        if (cache == NULL) {
+            ALLOC_HASHTABLE(cache);
+            zend_hash_init(cache, 16, NULL, php_secp256k1_bip32_cache_dtor, 0);
+            SECP256K1_G(bip32_cache) = cache;
+        }
+        // the limit may have been lowered since the cache filled up
+        while ((zend_long) zend_hash_num_elements(cache) >= size) {
+            ZEND_HASH_FOREACH_BUCKET(cache, oldest) {
+                break;
+            } ZEND_HASH_FOREACH_END();
+            zend_hash_del_bucket(cache, oldest);
+        }
+        zend_hash_str_add_mem(cache, (char *) key, sizeof(key), child, sizeof(*child));
+    }
+    return 1;
+}
+
+// value arguments are parsed as zvals so they may hold a value object, which
+// lifted the type check arginfo did for resources. argument arg_num of the
+// current call which is neither a resource nor the value class gets the
+// TypeError it used to, returns 1 if one was thrown. array elements pass 0
+// and are left to zend_fetch_resource2_ex.
+static int php_secp256k1_resource_arg_type_error(zval *arg, uint32_t arg_num) {
+    if (arg_num == 0 || Z_TYPE_P(arg) == IS_RESOURCE) {
+        return 0;
+    }
+#if PHP_VERSION_ID >= 80000
+    zend_argument_type_error(arg_num, "must be of type resource, %s given", zend_zval_type_name(arg));
+#else
+    zend_type_error("Argument %d passed to %s() must be of the type resource, %s given",
+        (int) arg_num, get_active_function_name(), zend_zval_type_name(arg));
+#endif
+    return 1;
+}
+
+// attempt to read a sec256k1_ecdsa_signature* from the provided resource zval
+static secp256k1_ecdsa_signature* php_get_secp256k1_ecdsa_signature(zval *psig, uint32_t arg_num) {
+    php_secp256k1_ecdsa_signature_obj *obj;
+    if (Z_TYPE_P(psig) == IS_OBJECT && Z_OBJCE_P(psig) == secp256k1_ecdsa_signature_ce) {
+        obj = PHP_SECP256K1_OBJ_P(php_secp256k1_ecdsa_signature_obj, psig);
+        return php_secp256k1_value_initialized(psig, obj->initialized) ? &obj->sig : NULL;
+    }
+    if (php_secp256k1_resource_arg_type_error(psig, arg_num)) {
+        return NULL;
+    }
+    return (secp256k1_ecdsa_signature *)zend_fetch_resource2_ex(psig, SECP256K1_SIG_RES_NAME, le_secp256k1_sig, -1);
+}
+
+// attempt to read a sec256k1_pubkey* from the provided resource zval
+static secp256k1_pubkey* php_get_secp256k1_pubkey(zval *pkey, uint32_t arg_num) {
+    php_secp256k1_pubkey_obj *obj;
+    if (Z_TYPE_P(pkey) == IS_OBJECT && Z_OBJCE_P(pkey) == secp256k1_pubkey_ce) {
+        obj = PHP_SECP256K1_OBJ_P(php_secp256k1_pubkey_obj, pkey);
+        return php_secp256k1_value_initialized(pkey, obj->initialized) ? &obj->pubkey : NULL;
+    }
+    if (php_secp256k1_resource_arg_type_error(pkey, arg_num)) {
+        return NULL;
+    }
+    return (secp256k1_pubkey *)zend_fetch_resource2_ex(pkey, SECP256K1_PUBKEY_RES_NAME, le_secp256k1_pubkey, -1);
+}
+
+// returns the vector if pvec is a Secp256k1\PublicKeyVector, NULL otherwise
+static php_secp256k1_pubkey_vector_obj* php_get_secp256k1_pubkey_vector(zval *pvec) {
+    if (Z_TYPE_P(pvec) == IS_OBJECT && Z_OBJCE_P(pvec) == secp256k1_pubkey_vector_ce) {
+        return PHP_SECP256K1_OBJ_P(php_secp256k1_pubkey_vector_obj, pvec);
+    }
+    return NULL;
+}
+
+// returns the node of an initialized Secp256k1\ExtendedKey, NULL otherwise
+static php_secp256k1_bip32_node* php_get_secp256k1_extended_key(zval *pkey) {
+    php_secp256k1_extended_key_obj *obj;
+    if (Z_TYPE_P(pkey) == IS_OBJECT && Z_OBJCE_P(pkey) == secp256k1_extended_key_ce) {
+        obj = PHP_SECP256K1_OBJ_P(php_secp256k1_extended_key_obj, pkey);
+        return php_secp256k1_value_initialized(pkey, obj->initialized) ? &obj->node : NULL;
+    }
+    php_error_docref(NULL, E_WARNING, "supplied argument is not a Secp256k1\\ExtendedKey");
+    return NULL;
+}
+
+// attempt to read a sec256k1_scratch_space * from the provided resource zval
+static secp256k1_scratch_space_wrapper* php_get_secp256k1_scratch_space(zval *psig) {
+    return (secp256k1_scratch_space_wrapper *)zend_fetch_resource2_ex(psig, SECP256K1_SCRATCH_SPACE_RES_NAME, le_secp256k1_scratch_space, -1);
+}
+
+#ifdef SECP256K1_MODULE_RECOVERY
 // attempt to read a sec256k1_ecdsa_recoverable_signature* from the provided resource zval
 static secp256k1_ecdsa_recoverable_signature* php_get_secp256k1_ecdsa_recoverable_signature(zval *precsig) {
     return (secp256k1_ecdsa_recoverable_signature *)zend_fetch_resource2_ex(precsig, SECP256K1_RECOVERABLE_SIG_RES_NAME, le_secp256k1_recoverable_sig, -1);
@@ -871,161 +2018,2003 @@ static secp256k1_ecdsa_recoverable_signature* php_get_secp256k1_ecdsa_recoverabl
 
 #ifdef SECP256K1_MODULE_EXTRAKEYS
 // attempt to read a sec256k1_ecdsa_recoverable_signature* from the provided resource zval
-static secp256k1_xonly_pubkey* php_get_secp256k1_xonly_pubkey(zval *precsig) {
+static secp256k1_xonly_pubkey* php_get_secp256k1_xonly_pubkey(zval *precsig, uint32_t arg_num) {
+    php_secp256k1_xonly_pubkey_obj *obj;
+    if (Z_TYPE_P(precsig) == IS_OBJECT && Z_OBJCE_P(precsig) == secp256k1_xonly_pubkey_ce) {
+        obj = PHP_SECP256K1_OBJ_P(php_secp256k1_xonly_pubkey_obj, precsig);
+        return php_secp256k1_value_initialized(precsig, obj->initialized) ? &obj->pubkey : NULL;
+    }
+    if (php_secp256k1_resource_arg_type_error(precsig, arg_num)) {
+        return NULL;
+    }
     return (secp256k1_xonly_pubkey *)zend_fetch_resource2_ex(precsig, SECP256K1_XONLY_PUBKEY_RES_NAME, le_secp256k1_xonly_pubkey, -1);
 }
-static secp256k1_keypair* php_get_secp256k1_keypair(zval *precsig) {
+static secp256k1_keypair* php_get_secp256k1_keypair(zval *precsig, uint32_t arg_num) {
+    php_secp256k1_keypair_obj *obj;
+    if (Z_TYPE_P(precsig) == IS_OBJECT && Z_OBJCE_P(precsig) == secp256k1_keypair_ce) {
+        obj = PHP_SECP256K1_OBJ_P(php_secp256k1_keypair_obj, precsig);
+        return php_secp256k1_value_initialized(precsig, obj->initialized) ? &obj->keypair : NULL;
+    }
+    if (php_secp256k1_resource_arg_type_error(precsig, arg_num)) {
+        return NULL;
+    }
     return (secp256k1_keypair *)zend_fetch_resource2_ex(precsig, SECP256K1_KEYPAIR_RES_NAME, le_secp256k1_keypair, -1);
 }
 #endif
 
-PHP_MINIT_FUNCTION(secp256k1) {
-    REGISTER_STRING_CONSTANT("SECP256K1_TYPE_CONTEXT", SECP256K1_CTX_RES_NAME, CONST_CS | CONST_PERSISTENT);
-    REGISTER_STRING_CONSTANT("SECP256K1_TYPE_PUBKEY", SECP256K1_PUBKEY_RES_NAME, CONST_CS | CONST_PERSISTENT);
-    REGISTER_STRING_CONSTANT("SECP256K1_TYPE_SIG", SECP256K1_SIG_RES_NAME, CONST_CS | CONST_PERSISTENT);
-    REGISTER_STRING_CONSTANT("SECP256K1_TYPE_SCRATCH_SPACE", SECP256K1_SCRATCH_SPACE_RES_NAME, CONST_CS | CONST_PERSISTENT);
+// helper functions to store a value into an out parameter. it is written in
+// place when the parameter holds an object of the matching class, otherwise
+// the parameter is replaced with a new resource.
+
+static void php_secp256k1_ecdsa_signature_out(zval *zOut, const secp256k1_ecdsa_signature *sig) {
+    php_secp256k1_ecdsa_signature_obj *obj;
+    secp256k1_ecdsa_signature *copy;
+    if (Z_TYPE_P(zOut) == IS_OBJECT && Z_OBJCE_P(zOut) == secp256k1_ecdsa_signature_ce) {
+        obj = PHP_SECP256K1_OBJ_P(php_secp256k1_ecdsa_signature_obj, zOut);
+        obj->sig = *sig;
+        obj->initialized = 1;
+        return;
+    }
+    copy = (secp256k1_ecdsa_signature *) emalloc(sizeof(secp256k1_ecdsa_signature));
+    *copy = *sig;
+    zval_dtor(zOut);
+    ZVAL_RES(zOut, zend_register_resource(copy, le_secp256k1_sig));
+}
 
-    /** Flags to pass to secp256k1_context_create */
-    REGISTER_LONG_CONSTANT("SECP256K1_CONTEXT_VERIFY", SECP256K1_CONTEXT_VERIFY, CONST_CS | CONST_PERSISTENT);
-    REGISTER_LONG_CONSTANT("SECP256K1_CONTEXT_SIGN", SECP256K1_CONTEXT_SIGN, CONST_CS | CONST_PERSISTENT);
-    REGISTER_LONG_CONSTANT("SECP256K1_CONTEXT_NONE", SECP256K1_CONTEXT_NONE, CONST_CS | CONST_PERSISTENT);
+static void php_secp256k1_pubkey_out(zval *zOut, const secp256k1_pubkey *pubkey) {
+    php_secp256k1_pubkey_obj *obj;
+    secp256k1_pubkey *copy;
+    if (Z_TYPE_P(zOut) == IS_OBJECT && Z_OBJCE_P(zOut) == secp256k1_pubkey_ce) {
+        obj = PHP_SECP256K1_OBJ_P(php_secp256k1_pubkey_obj, zOut);
+        obj->pubkey = *pubkey;
+        obj->initialized = 1;
+        return;
+    }
+    copy = (secp256k1_pubkey *) emalloc(sizeof(secp256k1_pubkey));
+    *copy = *pubkey;
+    zval_dtor(zOut);
+    ZVAL_RES(zOut, zend_register_resource(copy, le_secp256k1_pubkey));
+}
 
-    /** Flags to pass to secp256k1_ec_pubkey_serialize */
-    REGISTER_LONG_CONSTANT("SECP256K1_EC_COMPRESSED", SECP256K1_EC_COMPRESSED, CONST_CS | CONST_PERSISTENT);
-    REGISTER_LONG_CONSTANT("SECP256K1_EC_UNCOMPRESSED", SECP256K1_EC_UNCOMPRESSED, CONST_CS | CONST_PERSISTENT);
+// an extended key has no resource type, anything else is replaced with a new object
+static void php_secp256k1_extended_key_out(zval *zOut, const php_secp256k1_bip32_node *node) {
+    php_secp256k1_extended_key_obj *obj;
+    if (!(Z_TYPE_P(zOut) == IS_OBJECT && Z_OBJCE_P(zOut) == secp256k1_extended_key_ce)) {
+        zval_dtor(zOut);
+        object_init_ex(zOut, secp256k1_extended_key_ce);
+    }
+    obj = PHP_SECP256K1_OBJ_P(php_secp256k1_extended_key_obj, zOut);
+    obj->node = *node;
+    obj->initialized = 1;
+}
 
-    /** Prefix byte used to tag various encoded curvepoints for specific purposes */
-    REGISTER_LONG_CONSTANT("SECP256K1_TAG_PUBKEY_EVEN", SECP256K1_TAG_PUBKEY_EVEN, CONST_CS | CONST_PERSISTENT);
-    REGISTER_LONG_CONSTANT("SECP256K1_TAG_PUBKEY_ODD", SECP256K1_TAG_PUBKEY_ODD, CONST_CS | CONST_PERSISTENT);
-    REGISTER_LONG_CONSTANT("SECP256K1_TAG_PUBKEY_UNCOMPRESSED", SECP256K1_TAG_PUBKEY_UNCOMPRESSED, CONST_CS | CONST_PERSISTENT);
-    REGISTER_LONG_CONSTANT("SECP256K1_TAG_PUBKEY_HYBRID_EVEN", SECP256K1_TAG_PUBKEY_HYBRID_EVEN, CONST_CS | CONST_PERSISTENT);
-    REGISTER_LONG_CONSTANT("SECP256K1_TAG_PUBKEY_HYBRID_ODD", SECP256K1_TAG_PUBKEY_HYBRID_ODD, CONST_CS | CONST_PERSISTENT);
-    le_secp256k1_ctx = zend_register_list_destructors_ex(secp256k1_ctx_dtor, NULL, SECP256K1_CTX_RES_NAME, module_number);
-    le_secp256k1_pubkey = zend_register_list_destructors_ex(secp256k1_pubkey_dtor, NULL, SECP256K1_PUBKEY_RES_NAME, module_number);
-    le_secp256k1_sig = zend_register_list_destructors_ex(secp256k1_sig_dtor, NULL, SECP256K1_SIG_RES_NAME, module_number);
-    le_secp256k1_scratch_space = zend_register_list_destructors_ex(secp256k1_scratch_space_dtor, NULL, SECP256K1_SCRATCH_SPACE_RES_NAME, module_number);
+#ifdef SECP256K1_MODULE_EXTRAKEYS
+static void php_secp256k1_xonly_pubkey_out(zval *zOut, const secp256k1_xonly_pubkey *pubkey) {
+    php_secp256k1_xonly_pubkey_obj *obj;
+    secp256k1_xonly_pubkey *copy;
+    if (Z_TYPE_P(zOut) == IS_OBJECT && Z_OBJCE_P(zOut) == secp256k1_xonly_pubkey_ce) {
+        obj = PHP_SECP256K1_OBJ_P(php_secp256k1_xonly_pubkey_obj, zOut);
+        obj->pubkey = *pubkey;
+        obj->initialized = 1;
+        return;
+    }
+    copy = (secp256k1_xonly_pubkey *) emalloc(sizeof(secp256k1_xonly_pubkey));
+    *copy = *pubkey;
+    zval_dtor(zOut);
+    ZVAL_RES(zOut, zend_register_resource(copy, le_secp256k1_xonly_pubkey));
+}
 
-#ifdef SECP256K1_MODULE_RECOVERY
-    REGISTER_STRING_CONSTANT("SECP256K1_TYPE_RECOVERABLE_SIG", SECP256K1_RECOVERABLE_SIG_RES_NAME, CONST_CS | CONST_PERSISTENT);
-    le_secp256k1_recoverable_sig = zend_register_list_destructors_ex(secp256k1_recoverable_sig_dtor, NULL, SECP256K1_RECOVERABLE_SIG_RES_NAME, module_number);
+static void php_secp256k1_keypair_out(zval *zOut, const secp256k1_keypair *keypair) {
+    php_secp256k1_keypair_obj *obj;
+    secp256k1_keypair *copy;
+    if (Z_TYPE_P(zOut) == IS_OBJECT && Z_OBJCE_P(zOut) == secp256k1_keypair_ce) {
+        obj = PHP_SECP256K1_OBJ_P(php_secp256k1_keypair_obj, zOut);
+        obj->keypair = *keypair;
+        obj->initialized = 1;
+        return;
+    }
+    copy = (secp256k1_keypair *) emalloc(sizeof(secp256k1_keypair));
+    *copy = *keypair;
+    zval_dtor(zOut);
+    ZVAL_RES(zOut, zend_register_resource(copy, le_secp256k1_keypair));
+}
 #endif
 
-#ifdef SECP256K1_MODULE_EXTRAKEYS
-    REGISTER_STRING_CONSTANT("SECP256K1_TYPE_XONLY_PUBKEY", SECP256K1_XONLY_PUBKEY_RES_NAME, CONST_CS | CONST_PERSISTENT);
-    le_secp256k1_xonly_pubkey = zend_register_list_destructors_ex(secp256k1_xonly_pubkey_dtor, NULL, SECP256K1_XONLY_PUBKEY_RES_NAME, module_number);
-    REGISTER_STRING_CONSTANT("SECP256K1_TYPE_KEYPAIR", SECP256K1_KEYPAIR_RES_NAME, CONST_CS | CONST_PERSISTENT);
-    le_secp256k1_keypair = zend_register_list_destructors_ex(secp256k1_keypair_dtor, NULL, SECP256K1_KEYPAIR_RES_NAME, module_number);
-#endif
-    return SUCCESS;
+/* {{{ proto void Secp256k1\PublicKeyVector::__construct(int capacity = 0)
+ * Create an empty vector, with room for capacity keys before it needs to grow. */
+PHP_METHOD(Secp256k1_PublicKeyVector, __construct)
+{
+    php_secp256k1_pubkey_vector_obj *vec;
+    zend_long capacity = 0;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "|l", &capacity) == FAILURE) {
+        return;
+    }
+
+    if (capacity < 0) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "Secp256k1\\PublicKeyVector::__construct(): Parameter 1 should not be negative");
+        return;
+    }
+
+    vec = PHP_SECP256K1_OBJ_P(php_secp256k1_pubkey_vector_obj, getThis());
+    php_secp256k1_pubkey_vector_reserve(vec, (size_t) capacity);
 }
+/* }}} */
 
-PHP_MSHUTDOWN_FUNCTION(secp256k1) {
-    return SUCCESS;
+/* {{{ proto void Secp256k1\PublicKeyVector::append(resource|Secp256k1\PublicKey ecPublicKey)
+ * Copy a public key onto the end of the vector. */
+PHP_METHOD(Secp256k1_PublicKeyVector, append)
+{
+    zval *zPubKey;
+    php_secp256k1_pubkey_vector_obj *vec;
+    secp256k1_pubkey *pubkey;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "z", &zPubKey) == FAILURE) {
+        return;
+    }
+
+    if ((pubkey = php_get_secp256k1_pubkey(zPubKey, 1)) == NULL) {
+        return;
+    }
+
+    vec = PHP_SECP256K1_OBJ_P(php_secp256k1_pubkey_vector_obj, getThis());
+    php_secp256k1_pubkey_vector_reserve(vec, 1);
+    vec->keys[vec->count++] = *pubkey;
 }
+/* }}} */
+
+/* {{{ proto Secp256k1\PublicKey Secp256k1\PublicKeyVector::get(int index)
+ * Returns a copy of the key at index. */
+PHP_METHOD(Secp256k1_PublicKeyVector, get)
+{
+    php_secp256k1_pubkey_vector_obj *vec;
+    zend_long index;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "l", &index) == FAILURE) {
+        return;
+    }
+
+    vec = PHP_SECP256K1_OBJ_P(php_secp256k1_pubkey_vector_obj, getThis());
+    if (index < 0 || (size_t) index >= vec->count) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "Secp256k1\\PublicKeyVector::get(): Parameter 1 should be a valid index");
+        return;
+    }
+
+    object_init_ex(return_value, secp256k1_pubkey_ce);
+    php_secp256k1_pubkey_out(return_value, &vec->keys[index]);
+}
+/* }}} */
+
+/* {{{ proto Secp256k1\PublicKeyVector Secp256k1\PublicKeyVector::slice(int offset, int length = null)
+ * Returns a new vector holding up to length keys starting at offset, or every
+ * key from offset onwards if length is null. */
+PHP_METHOD(Secp256k1_PublicKeyVector, slice)
+{
+    php_secp256k1_pubkey_vector_obj *vec, *slice;
+    zend_long offset, length = 0;
+    zend_bool length_is_null = 1;
+    size_t n;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "l|l!", &offset, &length, &length_is_null) == FAILURE) {
+        return;
+    }
+
+    vec = PHP_SECP256K1_OBJ_P(php_secp256k1_pubkey_vector_obj, getThis());
+    if (offset < 0 || (size_t) offset > vec->count) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "Secp256k1\\PublicKeyVector::slice(): Parameter 1 should be between 0 and the number of keys");
+        return;
+    }
+    if (!length_is_null && length < 0) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "Secp256k1\\PublicKeyVector::slice(): Parameter 2 should not be negative");
+        return;
+    }
+
+    n = vec->count - (size_t) offset;
+    if (!length_is_null && (size_t) length < n) {
+        n = (size_t) length;
+    }
+
+    object_init_ex(return_value, secp256k1_pubkey_vector_ce);
+    if (n > 0) {
+        slice = PHP_SECP256K1_OBJ_P(php_secp256k1_pubkey_vector_obj, return_value);
+        php_secp256k1_pubkey_vector_reserve(slice, n);
+        memcpy(slice->keys, vec->keys + offset, n * sizeof(secp256k1_pubkey));
+        slice->count = n;
+    }
+}
+/* }}} */
+
+/* {{{ proto int Secp256k1\PublicKeyVector::count()
+ * Returns the number of keys in the vector. */
+PHP_METHOD(Secp256k1_PublicKeyVector, count)
+{
+    if (zend_parse_parameters_none() == FAILURE) {
+        return;
+    }
+
+    RETURN_LONG((zend_long) PHP_SECP256K1_OBJ_P(php_secp256k1_pubkey_vector_obj, getThis())->count);
+}
+/* }}} */
+
+/* {{{ proto void Secp256k1\Sha256::__construct(string tag = null)
+ * Start a SHA256 hash, or a BIP-340 tagged hash if tag is given. The prefix of
+ * the BIP-340 and BIP-341 tags is precomputed, clone a hash to reuse the
+ * prefix of any other tag. */
+PHP_METHOD(Secp256k1_Sha256, __construct)
+{
+    php_secp256k1_sha256_obj *obj;
+    zend_string *tag = NULL;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "|S!", &tag) == FAILURE) {
+        return;
+    }
+
+    obj = PHP_SECP256K1_OBJ_P(php_secp256k1_sha256_obj, getThis());
+    if (tag != NULL) {
+        php_secp256k1_sha256_init_tagged(&obj->hash, (unsigned char *) tag->val, tag->len);
+    } else {
+        php_secp256k1_sha256_init(&obj->hash);
+    }
+}
+/* }}} */
+
+/* {{{ proto void Secp256k1\Sha256::update(string data)
+ * Append data to the hash. */
+PHP_METHOD(Secp256k1_Sha256, update)
+{
+    zend_string *data;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "S", &data) == FAILURE) {
+        return;
+    }
+
+    php_secp256k1_sha256_write(&PHP_SECP256K1_OBJ_P(php_secp256k1_sha256_obj, getThis())->hash,
+                               (unsigned char *) data->val, data->len);
+}
+/* }}} */
+
+/* {{{ proto string Secp256k1\Sha256::digest()
+ * Returns the 32 byte hash of the data so far. The hash can be updated
+ * further afterwards. */
+PHP_METHOD(Secp256k1_Sha256, digest)
+{
+    php_secp256k1_sha256 hash;
+    unsigned char out[HASH_LENGTH];
+
+    if (zend_parse_parameters_none() == FAILURE) {
+        return;
+    }
+
+    // finalize a copy, the object keeps its state
+    hash = PHP_SECP256K1_OBJ_P(php_secp256k1_sha256_obj, getThis())->hash;
+    php_secp256k1_sha256_finalize(&hash, out);
+    RETURN_STRINGL((char *) out, HASH_LENGTH);
+}
+/* }}} */
+
+// per thread figures of one function: all calls, and the calls split by
+// nonce path or batch size class, keyed by the variant name.
+typedef struct _php_secp256k1_stats_slot {
+    php_secp256k1_stats_entry all;
+    HashTable *variants;
+} php_secp256k1_stats_slot;
+
+static uint64_t php_secp256k1_stats_now(void)
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t) tv.tv_sec * 1000000000 + (uint64_t) tv.tv_usec * 1000;
+#endif
+}
+
+static void php_secp256k1_pefree_dtor(zval *zv)
+{
+    pefree(Z_PTR_P(zv), 1);
+}
+
+static void php_secp256k1_stats_variant_add(php_secp256k1_stats_slot *slot, const char *variant, size_t len, uint64_t ns)
+{
+    php_secp256k1_stats_entry *entry;
+    if (slot->variants == NULL) {
+        slot->variants = pemalloc(sizeof(HashTable), 1);
+        zend_hash_init(slot->variants, 8, NULL, php_secp256k1_pefree_dtor, 1);
+    }
+    if ((entry = zend_hash_str_find_ptr(slot->variants, variant, len)) == NULL) {
+        entry = pecalloc(1, sizeof(php_secp256k1_stats_entry), 1);
+        zend_hash_str_add_ptr(slot->variants, variant, len, entry);
+    }
+    php_secp256k1_stats_record(entry, ns);
+}
+
+static void php_secp256k1_stats_add(uint32_t index, uint64_t ns)
+{
+    php_secp256k1_stats_slot *slot;
+    char batch_class[48];
+
+    if (SECP256K1_G(stats_slots) == NULL) {
+        SECP256K1_G(stats_slots) = pecalloc(instrumented_count, sizeof(php_secp256k1_stats_slot), 1);
+    }
+    slot = &SECP256K1_G(stats_slots)[index];
+    php_secp256k1_stats_record(&slot->all, ns);
+    if (SECP256K1_G(stats_variant) != NULL) {
+        php_secp256k1_stats_variant_add(slot, SECP256K1_G(stats_variant), strlen(SECP256K1_G(stats_variant)), ns);
+    }
+    if (SECP256K1_G(stats_items) > 0) {
+        php_secp256k1_stats_variant_add(slot, batch_class,
+                php_secp256k1_stats_batch_class(batch_class, sizeof(batch_class), SECP256K1_G(stats_items)), ns);
+    }
+}
+
+// functions secp256k1.trace reports spans for: signing, verification,
+// recovery, ecdh and the batch functions.
+static const char *php_secp256k1_traced_functions[] = {
+    "secp256k1_ecdsa_sign",
+    "secp256k1_ecdsa_verify",
+    "secp256k1_ecdsa_verify_raw",
+    "secp256k1_ecdsa_verify_batch",
+    "secp256k1_ec_pubkey_create_many",
+    "secp256k1_ec_pubkey_parse_many",
+    "secp256k1_ec_pubkey_serialize_many",
+    "secp256k1_ecdsa_signature_serialize_der_many",
+    "secp256k1_ecdsa_signature_serialize_compact_many",
+    "secp256k1_bip32_derive_many",
+    "secp256k1_address_many",
+    "secp256k1_ecdsa_sign_recoverable",
+    "secp256k1_ecdsa_recover",
+    "secp256k1_ecdsa_recover_many",
+    "secp256k1_ecdsa_recover_address",
+    "secp256k1_ecdsa_recover_address_many",
+    "secp256k1_ecdh",
+    "secp256k1_ecdh_many",
+    "secp256k1_schnorrsig_sign",
+    "secp256k1_schnorrsig_verify",
+    "secp256k1_schnorrsig_verify_raw",
+    "secp256k1_schnorrsig_verify_batch",
+    NULL
+};
+
+static int php_secp256k1_is_traced_function(const char *name)
+{
+    const char **traced;
+    for (traced = php_secp256k1_traced_functions; *traced != NULL; traced++) {
+        if (strcmp(*traced, name) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// drops the observers of the request. the table only exists while one is
+// registered, so php_secp256k1_instrument_handler needs no more than a NULL
+// check to tell.
+static void php_secp256k1_trace_observers_destroy(void)
+{
+    if (SECP256K1_G(trace_observers) != NULL) {
+        zend_hash_destroy(SECP256K1_G(trace_observers));
+        FREE_HASHTABLE(SECP256K1_G(trace_observers));
+        SECP256K1_G(trace_observers) = NULL;
+    }
+}
+
+// decides whether this call gets a span: an observer is registered, we are
+// not inside one, and the call falls within secp256k1.trace_sample_rate.
+static int php_secp256k1_trace_sampled(void)
+{
+    uint64_t x;
+    if (SECP256K1_G(trace_observers) == NULL || zend_hash_num_elements(SECP256K1_G(trace_observers)) == 0
+        || SECP256K1_G(trace_depth) > 0 || SECP256K1_G(trace_sample_rate) <= 0) {
+        return 0;
+    }
+    if (SECP256K1_G(trace_sample_rate) >= 1) {
+        return 1;
+    }
+    // xorshift64*, sampling needs no better than that
+    if ((x = SECP256K1_G(trace_rng)) == 0
+        && (!php_secp256k1_os_random(&x, sizeof(x)) || x == 0)) {
+        x = (uint64_t) time(NULL) | 1;
+    }
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    SECP256K1_G(trace_rng) = x;
+    return (double) ((x * 0x2545F4914F6CDD1DULL) >> 11) / 9007199254740992.0 < SECP256K1_G(trace_sample_rate);
+}
+
+// calls the begin callback of every observer with the function name, keeping
+// what each returns in spans for its end callback.
+static void php_secp256k1_trace_begin(zend_string *name, zval *spans)
+{
+    zend_ulong id;
+    zval *observer, *begin, args[1], retval;
+
+    array_init(spans);
+    ZVAL_STR_COPY(&args[0], name);
+    SECP256K1_G(trace_depth)++;
+    ZEND_HASH_FOREACH_NUM_KEY_VAL(SECP256K1_G(trace_observers), id, observer) {
+        begin = zend_hash_index_find(Z_ARRVAL_P(observer), 0);
+        ZVAL_NULL(&retval);
+        if (Z_TYPE_P(begin) != IS_NULL
+            && (call_user_function(NULL, NULL, begin, &retval, 1, args) == FAILURE || Z_ISUNDEF(retval))) {
+            ZVAL_NULL(&retval);
+        }
+        add_index_zval(spans, id, &retval);
+        if (EG(exception)) {
+            break;
+        }
+    } ZEND_HASH_FOREACH_END();
+    SECP256K1_G(trace_depth)--;
+    zval_ptr_dtor(&args[0]);
+}
+
+// calls the end callback of every observer whose begin callback ran, with
+// the value it returned, the function name and the span attributes.
+static void php_secp256k1_trace_end(zend_string *name, zval *spans, zval *return_value, uint64_t ns)
+{
+    zend_ulong id;
+    zval *span, *observer, *end, args[3], retval;
+    const char *variant = SECP256K1_G(stats_variant), *eq;
+    int threw;
+
+    ZVAL_STR_COPY(&args[1], name);
+    array_init(&args[2]);
+    add_assoc_string(&args[2], "outcome", EG(exception) ? "exception" : zend_is_true(return_value) ? "ok" : "failed");
+    if (SECP256K1_G(stats_items) > 0) {
+        add_assoc_long(&args[2], "batch_size", (zend_long) SECP256K1_G(stats_items));
+    }
+    if (variant != NULL && (eq = strchr(variant, '=')) != NULL) {
+        add_assoc_stringl_ex(&args[2], variant, (size_t) (eq - variant), (char *) eq + 1, strlen(eq + 1));
+    }
+    add_assoc_long(&args[2], "duration_ns", (zend_long) ns);
+
+    // put a pending exception aside while the observers run, an exception
+    // they throw gets it as previous one
+    threw = EG(exception) != NULL;
+    if (threw) {
+        zend_exception_save();
+    }
+    SECP256K1_G(trace_depth)++;
+    ZEND_HASH_FOREACH_NUM_KEY_VAL(Z_ARRVAL_P(spans), id, span) {
+        // an observer unregistered during the call gets no end
+        if (SECP256K1_G(trace_observers) == NULL
+            || (observer = zend_hash_index_find(SECP256K1_G(trace_observers), id)) == NULL) {
+            continue;
+        }
+        end = zend_hash_index_find(Z_ARRVAL_P(observer), 1);
+        if (Z_TYPE_P(end) == IS_NULL) {
+            continue;
+        }
+        ZVAL_COPY_VALUE(&args[0], span);
+        if (call_user_function(NULL, NULL, end, &retval, 3, args) == SUCCESS) {
+            zval_ptr_dtor(&retval);
+        }
+    } ZEND_HASH_FOREACH_END();
+    SECP256K1_G(trace_depth)--;
+    if (threw) {
+        zend_exception_restore();
+    }
+    zval_ptr_dtor(&args[1]);
+    zval_ptr_dtor(&args[2]);
+}
+
+// times the original handler of the function being called for
+// secp256k1.stats, and reports it to the secp256k1.trace observers. the
+// variant and batch size the function reports are those of this call only:
+// a nonce callback calling back into the extension gets a fresh pair, and
+// the caller's are put back once it returns.
+static void php_secp256k1_instrument_handler(INTERNAL_FUNCTION_PARAMETERS)
+{
+    zend_string *name = execute_data->func->common.function_name;
+    php_secp256k1_instrumented *wrapped = PHP_SECP256K1_INSTRUMENTED(execute_data->func);
+    const char *variant;
+    size_t items;
+    int traced;
+    uint64_t start = 0, ns;
+    zval spans;
+
+    variant = SECP256K1_G(stats_variant);
+    items = SECP256K1_G(stats_items);
+
+    // only traced functions are wrapped without secp256k1.stats, and while no
+    // observer is registered they have nothing to report. a traced caller
+    // whose observer went away meanwhile still gets its own pair back.
+    if (!SECP256K1_G(stats) && SECP256K1_G(trace_observers) == NULL) {
+        wrapped->handler(INTERNAL_FUNCTION_PARAM_PASSTHRU);
+        SECP256K1_G(stats_variant) = variant;
+        SECP256K1_G(stats_items) = items;
+        return;
+    }
+
+    traced = wrapped->traced && php_secp256k1_trace_sampled();
+    SECP256K1_G(stats_variant) = NULL;
+    SECP256K1_G(stats_items) = 0;
+    if (traced) {
+        php_secp256k1_trace_begin(name, &spans);
+        if (EG(exception)) {
+            // a begin callback threw, the call does not happen
+            zval_ptr_dtor(&spans);
+            SECP256K1_G(stats_variant) = variant;
+            SECP256K1_G(stats_items) = items;
+            return;
+        }
+    }
+    if (SECP256K1_G(stats) || traced) {
+        start = php_secp256k1_stats_now();
+    }
+    wrapped->handler(INTERNAL_FUNCTION_PARAM_PASSTHRU);
+    if (SECP256K1_G(stats) || traced) {
+        ns = php_secp256k1_stats_now() - start;
+        if (SECP256K1_G(stats)) {
+            php_secp256k1_stats_add(wrapped->index, ns);
+        }
+        if (traced) {
+            php_secp256k1_trace_end(name, &spans, return_value, ns);
+            zval_ptr_dtor(&spans);
+        }
+    }
+
+    SECP256K1_G(stats_variant) = variant;
+    SECP256K1_G(stats_items) = items;
+}
+
+// wraps the handler of every function but the ones reading the figures with
+// secp256k1.stats, and of the traced ones with secp256k1.trace. functions
+// are registered before MINIT runs. nothing is wrapped while both are off,
+// so they cost nothing then.
+static void php_secp256k1_instrument_startup(void)
+{
+#if PHP_VERSION_ID < 80100
+    static zend_extension handle_owner = { "secp256k1" };
+#endif
+    const zend_function_entry *fe;
+    zend_function *fn;
+    php_secp256k1_instrumented *wrapped;
+    int traced;
+
+    zend_hash_init(&instrumented_functions, 128, NULL, php_secp256k1_pefree_dtor, 1);
+    // the slot is handed out like those of zend extensions, so it cannot
+    // clash with opcache's or a debugger's
+#if PHP_VERSION_ID >= 80100
+    instrumented_slot = zend_get_resource_handle("secp256k1");
+#else
+    instrumented_slot = zend_get_resource_handle(&handle_owner);
+#endif
+    if (instrumented_slot < 0) {
+        zend_error(E_WARNING, "secp256k1: no reserved function slot is left, secp256k1.stats and secp256k1.trace are disabled");
+        return;
+    }
+    for (fe = secp256k1_functions; fe->fname != NULL; fe++) {
+        traced = SECP256K1_G(trace) && php_secp256k1_is_traced_function(fe->fname);
+        if ((!traced && !SECP256K1_G(stats))
+            || fe->handler == ZEND_FN(secp256k1_stats)
+            || fe->handler == ZEND_FN(secp256k1_trace_register)
+            || fe->handler == ZEND_FN(secp256k1_trace_unregister)
+            || (fn = zend_hash_str_find_ptr(CG(function_table), fe->fname, strlen(fe->fname))) == NULL
+            || fn->type != ZEND_INTERNAL_FUNCTION || fn->internal_function.handler != fe->handler) {
+            continue;
+        }
+        wrapped = pemalloc(sizeof(php_secp256k1_instrumented), 1);
+        wrapped->handler = fn->internal_function.handler;
+        wrapped->index = instrumented_count++;
+        wrapped->traced = (zend_bool) traced;
+        zend_hash_add_ptr(&instrumented_functions, fn->common.function_name, wrapped);
+        fn->internal_function.reserved[instrumented_slot] = wrapped;
+        fn->internal_function.handler = php_secp256k1_instrument_handler;
+    }
+}
+
+// frees the figures of one thread, GSHUTDOWN may run on another thread.
+static void php_secp256k1_stats_clear(php_secp256k1_stats_slot **slots)
+{
+    uint32_t i;
+    if (*slots == NULL) {
+        return;
+    }
+    for (i = 0; i < instrumented_count; i++) {
+        if ((*slots)[i].variants != NULL) {
+            zend_hash_destroy((*slots)[i].variants);
+            pefree((*slots)[i].variants, 1);
+        }
+    }
+    pefree(*slots, 1);
+    *slots = NULL;
+}
+
+PHP_INI_BEGIN()
+    STD_PHP_INI_BOOLEAN("secp256k1.preload_context", "0", PHP_INI_SYSTEM, OnUpdateBool, preload_context, zend_secp256k1_globals, secp256k1_globals)
+    STD_PHP_INI_ENTRY("secp256k1.threads", "0", PHP_INI_SYSTEM, OnUpdateLong, threads, zend_secp256k1_globals, secp256k1_globals)
+    STD_PHP_INI_ENTRY("secp256k1.bip32_cache_size", "256", PHP_INI_ALL, OnUpdateLong, bip32_cache_size, zend_secp256k1_globals, secp256k1_globals)
+    STD_PHP_INI_ENTRY("secp256k1.pubkey_cache_size", "0", PHP_INI_SYSTEM, OnUpdateLong, pubkey_cache_size, zend_secp256k1_globals, secp256k1_globals)
+    STD_PHP_INI_ENTRY("secp256k1.sigcache_size", "0", PHP_INI_SYSTEM, OnUpdateLong, sigcache_size, zend_secp256k1_globals, secp256k1_globals)
+    STD_PHP_INI_ENTRY("secp256k1.randomize_ops", "0", PHP_INI_ALL, OnUpdateLong, randomize_ops, zend_secp256k1_globals, secp256k1_globals)
+    STD_PHP_INI_ENTRY("secp256k1.randomize_seconds", "0", PHP_INI_ALL, OnUpdateLong, randomize_seconds, zend_secp256k1_globals, secp256k1_globals)
+    STD_PHP_INI_BOOLEAN("secp256k1.stats", "0", PHP_INI_SYSTEM, OnUpdateBool, stats, zend_secp256k1_globals, secp256k1_globals)
+    STD_PHP_INI_BOOLEAN("secp256k1.trace", "0", PHP_INI_SYSTEM, OnUpdateBool, trace, zend_secp256k1_globals, secp256k1_globals)
+    STD_PHP_INI_ENTRY("secp256k1.trace_sample_rate", "1", PHP_INI_ALL, OnUpdateReal, trace_sample_rate, zend_secp256k1_globals, secp256k1_globals)
+PHP_INI_END()
+
+static PHP_GINIT_FUNCTION(secp256k1)
+{
+#if defined(COMPILE_DL_SECP256K1) && defined(ZTS)
+    ZEND_TSRMLS_CACHE_UPDATE();
+#endif
+    memset(secp256k1_globals, 0, sizeof(*secp256k1_globals));
+}
+
+static PHP_GSHUTDOWN_FUNCTION(secp256k1)
+{
+    php_secp256k1_stats_clear(&secp256k1_globals->stats_slots);
+}
+
+#ifdef HAVE_SECP256K1_SHM
+// maps a shared memory cache for an ini setting, NULL if it is disabled.
+static php_secp256k1_shm_cache *php_secp256k1_shm_cache_startup(const char *setting, zend_long entries,
+                                                                size_t key_size, size_t value_size)
+{
+    php_secp256k1_shm_cache *cache;
+    if (entries <= 0) {
+        return NULL;
+    }
+    if ((cache = php_secp256k1_shm_cache_create((size_t) entries, key_size, value_size)) == NULL) {
+        zend_error(E_WARNING, "secp256k1: cannot map %ld entries for %s, the cache is disabled", (long) entries, setting);
+    }
+    return cache;
+}
+#endif
+
+PHP_MINIT_FUNCTION(secp256k1) {
+    zend_class_entry ce;
+
+    REGISTER_INI_ENTRIES();
+
+    REGISTER_STRING_CONSTANT("SECP256K1_TYPE_CONTEXT", SECP256K1_CTX_RES_NAME, CONST_CS | CONST_PERSISTENT);
+    REGISTER_STRING_CONSTANT("SECP256K1_TYPE_PUBKEY", SECP256K1_PUBKEY_RES_NAME, CONST_CS | CONST_PERSISTENT);
+    REGISTER_STRING_CONSTANT("SECP256K1_TYPE_SIG", SECP256K1_SIG_RES_NAME, CONST_CS | CONST_PERSISTENT);
+    REGISTER_STRING_CONSTANT("SECP256K1_TYPE_SCRATCH_SPACE", SECP256K1_SCRATCH_SPACE_RES_NAME, CONST_CS | CONST_PERSISTENT);
+
+    /** Flags to pass to secp256k1_context_create */
+    REGISTER_LONG_CONSTANT("SECP256K1_CONTEXT_VERIFY", SECP256K1_CONTEXT_VERIFY, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SECP256K1_CONTEXT_SIGN", SECP256K1_CONTEXT_SIGN, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SECP256K1_CONTEXT_NONE", SECP256K1_CONTEXT_NONE, CONST_CS | CONST_PERSISTENT);
+
+    /** Flags to pass to secp256k1_ec_pubkey_serialize */
+    REGISTER_LONG_CONSTANT("SECP256K1_EC_COMPRESSED", SECP256K1_EC_COMPRESSED, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SECP256K1_EC_UNCOMPRESSED", SECP256K1_EC_UNCOMPRESSED, CONST_CS | CONST_PERSISTENT);
+
+    /** Prefix byte used to tag various encoded curvepoints for specific purposes */
+    REGISTER_LONG_CONSTANT("SECP256K1_TAG_PUBKEY_EVEN", SECP256K1_TAG_PUBKEY_EVEN, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SECP256K1_TAG_PUBKEY_ODD", SECP256K1_TAG_PUBKEY_ODD, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SECP256K1_TAG_PUBKEY_UNCOMPRESSED", SECP256K1_TAG_PUBKEY_UNCOMPRESSED, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SECP256K1_TAG_PUBKEY_HYBRID_EVEN", SECP256K1_TAG_PUBKEY_HYBRID_EVEN, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SECP256K1_TAG_PUBKEY_HYBRID_ODD", SECP256K1_TAG_PUBKEY_HYBRID_ODD, CONST_CS | CONST_PERSISTENT);
+    le_secp256k1_ctx = zend_register_list_destructors_ex(secp256k1_ctx_dtor, NULL, SECP256K1_CTX_RES_NAME, module_number);
+    le_secp256k1_persistent_ctx = zend_register_list_destructors_ex(secp256k1_persistent_ctx_dtor, NULL, SECP256K1_CTX_RES_NAME, module_number);
+    le_secp256k1_pubkey = zend_register_list_destructors_ex(secp256k1_pubkey_dtor, NULL, SECP256K1_PUBKEY_RES_NAME, module_number);
+    le_secp256k1_sig = zend_register_list_destructors_ex(secp256k1_sig_dtor, NULL, SECP256K1_SIG_RES_NAME, module_number);
+    le_secp256k1_scratch_space = zend_register_list_destructors_ex(secp256k1_scratch_space_dtor, NULL, SECP256K1_SCRATCH_SPACE_RES_NAME, module_number);
+
+    INIT_NS_CLASS_ENTRY(ce, "Secp256k1", "PublicKey", NULL);
+    secp256k1_pubkey_ce = php_secp256k1_register_value_class(&ce, php_secp256k1_pubkey_create_object,
+            &secp256k1_pubkey_handlers, XtOffsetOf(php_secp256k1_pubkey_obj, std));
+    INIT_NS_CLASS_ENTRY(ce, "Secp256k1", "EcdsaSignature", NULL);
+    secp256k1_ecdsa_signature_ce = php_secp256k1_register_value_class(&ce, php_secp256k1_ecdsa_signature_create_object,
+            &secp256k1_ecdsa_signature_handlers, XtOffsetOf(php_secp256k1_ecdsa_signature_obj, std));
+    INIT_NS_CLASS_ENTRY(ce, "Secp256k1", "PublicKeyVector", secp256k1_pubkey_vector_methods);
+    secp256k1_pubkey_vector_ce = php_secp256k1_register_value_class(&ce, php_secp256k1_pubkey_vector_create_object,
+            &secp256k1_pubkey_vector_handlers, XtOffsetOf(php_secp256k1_pubkey_vector_obj, std));
+    secp256k1_pubkey_vector_handlers.clone_obj = php_secp256k1_pubkey_vector_clone;
+    secp256k1_pubkey_vector_handlers.free_obj = php_secp256k1_pubkey_vector_free;
+    secp256k1_pubkey_vector_handlers.count_elements = php_secp256k1_pubkey_vector_count_elements;
+    zend_class_implements(secp256k1_pubkey_vector_ce, 1, zend_ce_countable);
+    INIT_NS_CLASS_ENTRY(ce, "Secp256k1", "ExtendedKey", NULL);
+    secp256k1_extended_key_ce = php_secp256k1_register_value_class(&ce, php_secp256k1_extended_key_create_object,
+            &secp256k1_extended_key_handlers, XtOffsetOf(php_secp256k1_extended_key_obj, std));
+    INIT_NS_CLASS_ENTRY(ce, "Secp256k1", "Sha256", secp256k1_sha256_methods);
+    secp256k1_sha256_ce = php_secp256k1_register_value_class(&ce, php_secp256k1_sha256_create_object,
+            &secp256k1_sha256_handlers, XtOffsetOf(php_secp256k1_sha256_obj, std));
+    php_secp256k1_sha256_tags_init();
+
+    /** Added to a BIP32 child index to select hardened derivation */
+    REGISTER_LONG_CONSTANT("SECP256K1_BIP32_HARDENED", (zend_long) BIP32_HARDENED, CONST_CS | CONST_PERSISTENT);
+
+    /** Address types to pass to secp256k1_address_many */
+    REGISTER_LONG_CONSTANT("SECP256K1_ADDRESS_P2PKH", SECP256K1_ADDRESS_P2PKH, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SECP256K1_ADDRESS_P2WPKH", SECP256K1_ADDRESS_P2WPKH, CONST_CS | CONST_PERSISTENT);
+#ifdef SECP256K1_MODULE_EXTRAKEYS
+    REGISTER_LONG_CONSTANT("SECP256K1_ADDRESS_P2TR", SECP256K1_ADDRESS_P2TR, CONST_CS | CONST_PERSISTENT);
+#endif
+
+    /** Flags to pass to secp256k1_ecdsa_verify_raw */
+    REGISTER_LONG_CONSTANT("SECP256K1_SIG_FORMAT_DER", SECP256K1_SIG_FORMAT_DER, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SECP256K1_SIG_FORMAT_DER_LAX", SECP256K1_SIG_FORMAT_DER_LAX, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SECP256K1_SIG_FORMAT_COMPACT", SECP256K1_SIG_FORMAT_COMPACT, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SECP256K1_SIG_ALLOW_HIGH_S", SECP256K1_SIG_ALLOW_HIGH_S, CONST_CS | CONST_PERSISTENT);
+
+#ifdef SECP256K1_MODULE_RECOVERY
+    REGISTER_STRING_CONSTANT("SECP256K1_TYPE_RECOVERABLE_SIG", SECP256K1_RECOVERABLE_SIG_RES_NAME, CONST_CS | CONST_PERSISTENT);
+    le_secp256k1_recoverable_sig = zend_register_list_destructors_ex(secp256k1_recoverable_sig_dtor, NULL, SECP256K1_RECOVERABLE_SIG_RES_NAME, module_number);
+#endif
+
+#ifdef SECP256K1_MODULE_EXTRAKEYS
+    REGISTER_STRING_CONSTANT("SECP256K1_TYPE_XONLY_PUBKEY", SECP256K1_XONLY_PUBKEY_RES_NAME, CONST_CS | CONST_PERSISTENT);
+    le_secp256k1_xonly_pubkey = zend_register_list_destructors_ex(secp256k1_xonly_pubkey_dtor, NULL, SECP256K1_XONLY_PUBKEY_RES_NAME, module_number);
+    REGISTER_STRING_CONSTANT("SECP256K1_TYPE_KEYPAIR", SECP256K1_KEYPAIR_RES_NAME, CONST_CS | CONST_PERSISTENT);
+    le_secp256k1_keypair = zend_register_list_destructors_ex(secp256k1_keypair_dtor, NULL, SECP256K1_KEYPAIR_RES_NAME, module_number);
+
+    INIT_NS_CLASS_ENTRY(ce, "Secp256k1", "XOnlyPublicKey", NULL);
+    secp256k1_xonly_pubkey_ce = php_secp256k1_register_value_class(&ce, php_secp256k1_xonly_pubkey_create_object,
+            &secp256k1_xonly_pubkey_handlers, XtOffsetOf(php_secp256k1_xonly_pubkey_obj, std));
+    INIT_NS_CLASS_ENTRY(ce, "Secp256k1", "KeyPair", NULL);
+    secp256k1_keypair_ce = php_secp256k1_register_value_class(&ce, php_secp256k1_keypair_create_object,
+            &secp256k1_keypair_handlers, XtOffsetOf(php_secp256k1_keypair_obj, std));
+#endif
+
+#ifdef SECP256K1_MODULE_ECDH
+    /** Native hash modes to pass to secp256k1_ecdh instead of a callable */
+    REGISTER_LONG_CONSTANT("SECP256K1_ECDH_HASH_DEFAULT", SECP256K1_ECDH_HASH_DEFAULT, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SECP256K1_ECDH_HASH_X", SECP256K1_ECDH_HASH_X, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SECP256K1_ECDH_HASH_XY", SECP256K1_ECDH_HASH_XY, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SECP256K1_ECDH_HASH_SHA256_X", SECP256K1_ECDH_HASH_SHA256_X, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SECP256K1_ECDH_HASH_SHA512_XY", SECP256K1_ECDH_HASH_SHA512_XY, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SECP256K1_ECDH_HASH_TAGGED_X", SECP256K1_ECDH_HASH_TAGGED_X, CONST_CS | CONST_PERSISTENT);
+#endif
+
+#ifdef ZTS
+    persistent_ctx_mutex = tsrm_mutex_alloc();
+#endif
+    if (SECP256K1_G(preload_context)) {
+        php_secp256k1_persistent_context(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+    }
+    if (SECP256K1_G(stats) || SECP256K1_G(trace)) {
+        php_secp256k1_instrument_startup();
+    }
+#ifdef HAVE_SECP256K1_SHM
+    // mapped before php-fpm forks its workers, so they all share them
+    pubkey_cache = php_secp256k1_shm_cache_startup("secp256k1.pubkey_cache_size", SECP256K1_G(pubkey_cache_size),
+            PUBKEY_CACHE_KEY_LENGTH, sizeof(secp256k1_pubkey));
+    sig_cache = php_secp256k1_shm_cache_startup("secp256k1.sigcache_size", SECP256K1_G(sigcache_size), HASH_LENGTH, 0);
+    if (sig_cache != NULL) {
+        unsigned char salt[SIG_CACHE_SALT_LENGTH];
+        if (php_secp256k1_os_random(salt, sizeof(salt))) {
+            php_secp256k1_sha256_init(&sig_cache_salted);
+            php_secp256k1_sha256_write(&sig_cache_salted, salt, sizeof(salt));
+            ZEND_SECURE_ZERO(salt, sizeof(salt));
+        } else {
+            zend_error(E_WARNING, "secp256k1: cannot read a salt for secp256k1.sigcache_size, the cache is disabled");
+            php_secp256k1_shm_cache_destroy(sig_cache);
+            sig_cache = NULL;
+        }
+    }
+#endif
+    return SUCCESS;
+}
+
+PHP_MSHUTDOWN_FUNCTION(secp256k1) {
+    int i;
+#ifdef HAVE_SECP256K1_THREADS
+    php_secp256k1_pool_shutdown();
+#endif
+    for (i = 0; i < PERSISTENT_CTX_SLOTS; i++) {
+        if (persistent_ctx[i].ctx != NULL) {
+            secp256k1_context_destroy(persistent_ctx[i].ctx);
+            persistent_ctx[i].ctx = NULL;
+        }
+    }
+#ifdef HAVE_SECP256K1_SHM
+    if (pubkey_cache != NULL) {
+        php_secp256k1_shm_cache_destroy(pubkey_cache);
+        pubkey_cache = NULL;
+    }
+    if (sig_cache != NULL) {
+        php_secp256k1_shm_cache_destroy(sig_cache);
+        sig_cache = NULL;
+    }
+#endif
+    if (SECP256K1_G(stats) || SECP256K1_G(trace)) {
+        zend_hash_destroy(&instrumented_functions);
+    }
+#ifdef ZTS
+    tsrm_mutex_free(persistent_ctx_mutex);
+#endif
+    UNREGISTER_INI_ENTRIES();
+    return SUCCESS;
+}
+
+/* Remove if there's nothing to do at request start */
+PHP_RINIT_FUNCTION(secp256k1) {
+#ifdef HAVE_SECP256K1_SHM
+    // workers fork after MINIT, each counts cache statistics in its own slot
+    php_secp256k1_shm_cache_select((unsigned long) getpid());
+#endif
+    return SUCCESS;
+}
+
+/* Remove if there's nothing to do at request end */
+PHP_RSHUTDOWN_FUNCTION(secp256k1) {
+    php_secp256k1_bip32_cache_destroy();
+    php_secp256k1_trace_observers_destroy();
+    return SUCCESS;
+}
+
+#ifdef HAVE_SECP256K1_SHM
+static void php_secp256k1_shm_cache_info(const char *name, php_secp256k1_shm_cache *cache)
+{
+    char capacity[32];
+    if (cache != NULL) {
+        snprintf(capacity, sizeof(capacity), ZEND_LONG_FMT " entries", (zend_long) php_secp256k1_shm_cache_capacity(cache));
+        php_info_print_table_row(2, name, capacity);
+    } else {
+        php_info_print_table_row(2, name, "disabled");
+    }
+}
+#endif
+
+// the secp256k1.stats figures of the process, or thread, rendering phpinfo()
+static void php_secp256k1_stats_info(void)
+{
+    zend_string *name;
+    php_secp256k1_instrumented *wrapped;
+    php_secp256k1_stats_entry *entry;
+    char calls[32], p50[32], p99[32], max[32];
+
+    php_info_print_table_start();
+    php_info_print_table_header(5, "function", "calls", "p50 (ns)", "p99 (ns)", "max (ns)");
+    ZEND_HASH_FOREACH_STR_KEY_PTR(&instrumented_functions, name, wrapped) {
+        entry = &SECP256K1_G(stats_slots)[wrapped->index].all;
+        if (entry->calls == 0) {
+            continue;
+        }
+        snprintf(calls, sizeof(calls), ZEND_LONG_FMT, (zend_long) entry->calls);
+        snprintf(p50, sizeof(p50), ZEND_LONG_FMT, (zend_long) php_secp256k1_stats_quantile(entry, 500));
+        snprintf(p99, sizeof(p99), ZEND_LONG_FMT, (zend_long) php_secp256k1_stats_quantile(entry, 990));
+        snprintf(max, sizeof(max), ZEND_LONG_FMT, (zend_long) entry->max_ns);
+        php_info_print_table_row(5, ZSTR_VAL(name), calls, p50, p99, max);
+    } ZEND_HASH_FOREACH_END();
+    php_info_print_table_end();
+}
+
+PHP_MINFO_FUNCTION(secp256k1) {
+    php_info_print_table_start();
+    php_info_print_table_header(2, "secp256k1 support", "enabled");
+#ifdef HAVE_SECP256K1_THREADS
+    php_info_print_table_row(2, "worker threads", "supported");
+#else
+    php_info_print_table_row(2, "worker threads", "not supported");
+#endif
+#ifdef HAVE_SECP256K1_SHM
+    php_secp256k1_shm_cache_info("public key cache", pubkey_cache);
+    php_secp256k1_shm_cache_info("signature cache", sig_cache);
+#else
+    php_info_print_table_row(2, "shared memory caches", "not supported");
+#endif
+    php_info_print_table_end();
+
+    if (SECP256K1_G(stats_slots) != NULL) {
+        php_secp256k1_stats_info();
+    }
+
+    DISPLAY_INI_ENTRIES();
+}
+
+zend_module_entry secp256k1_module_entry = {
+        STANDARD_MODULE_HEADER,
+        "secp256k1",
+        secp256k1_functions,
+        PHP_MINIT(secp256k1),
+        PHP_MSHUTDOWN(secp256k1),
+        PHP_RINIT(secp256k1), /* Replace with NULL if there's nothing to do at request start */
+        PHP_RSHUTDOWN(secp256k1), /* Replace with NULL if there's nothing to do at request end */
+        PHP_MINFO(secp256k1),
+        PHP_SECP256K1_VERSION,
+        PHP_MODULE_GLOBALS(secp256k1),
+        PHP_GINIT(secp256k1),
+        PHP_GSHUTDOWN(secp256k1),
+        NULL,
+        STANDARD_MODULE_PROPERTIES_EX
+};
+
+#ifdef COMPILE_DL_SECP256K1
+#ifdef ZTS
+ZEND_TSRMLS_CACHE_DEFINE()
+#endif
+ZEND_GET_MODULE(secp256k1)
+#endif
+
+/* {{{ proto ?resource secp256k1_context_create(int flags)
+ * Create a secp256k1 context object. */
+PHP_FUNCTION(secp256k1_context_create)
+{
+    long flags;
+    secp256k1_context_wrapper *wrapper;
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "l", &flags) == FAILURE) {
+        return;
+    }
+
+    if ((flags & ~(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY)) > 0) {
+        return;
+    }
+
+    wrapper = ecalloc(1, sizeof(secp256k1_context_wrapper));
+    wrapper->ctx = secp256k1_context_create(flags);
+    wrapper->flags = flags;
+    RETURN_RES(zend_register_resource(wrapper, le_secp256k1_ctx));
+}
+/* }}} */
+
+/* {{{ proto bool secp256k1_context_destroy(resource context)
+ * Destroy a secp256k1 context object. */
+PHP_FUNCTION(secp256k1_context_destroy)
+{
+    zval *zCtx;
+    secp256k1_context *ctx;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "r", &zCtx) == FAILURE) {
+        RETURN_FALSE;
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_FALSE;
+    }
+
+    zend_list_close(Z_RES_P(zCtx));
+    RETURN_TRUE;
+}
+/* }}} */
+
+/* {{{ proto ?resource secp256k1_context_clone(resource context)
+ * Copies a secp256k1 context object. */
+PHP_FUNCTION(secp256k1_context_clone)
+{
+    zval *zCtx;
+    secp256k1_context_wrapper *wrapper;
+    secp256k1_context_wrapper *newWrapper;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "r", &zCtx) == FAILURE) {
+        RETURN_NULL();
+    }
+
+    if ((wrapper = php_get_secp256k1_context_wrapper(zCtx)) == NULL) {
+        RETURN_NULL();
+    }
+
+    // the clone inherits the blinding, and with it what is left of the budget
+    newWrapper = emalloc(sizeof(secp256k1_context_wrapper));
+    *newWrapper = *wrapper;
+    newWrapper->ctx = secp256k1_context_clone(wrapper->ctx);
+    RETURN_RES(zend_register_resource(newWrapper, le_secp256k1_ctx));
+}
+/* }}} */
+
+/* {{{ proto ?resource secp256k1_context_persistent(int flags)
+ * Returns a process wide secp256k1 context which outlives the request. */
+PHP_FUNCTION(secp256k1_context_persistent)
+{
+    long flags;
+    secp256k1_context_wrapper *wrapper;
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "l", &flags) == FAILURE) {
+        return;
+    }
+
+    if ((flags & ~(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY)) > 0) {
+        return;
+    }
+
+    if ((wrapper = php_secp256k1_persistent_context(flags)) == NULL) {
+        return;
+    }
+
+    RETURN_RES(zend_register_resource(wrapper, le_secp256k1_persistent_ctx));
+}
+/* }}} */
+
+#ifdef HAVE_SECP256K1_SHM
+static void php_secp256k1_cache_stats_add(zval *stats, const char *name, php_secp256k1_shm_cache *cache)
+{
+    php_secp256k1_shm_cache_counters counters;
+    zval zCache;
+    if (cache == NULL) {
+        add_assoc_null(stats, name);
+        return;
+    }
+    // counters are shared with the other workers and keep moving
+    php_secp256k1_shm_cache_counters_sum(cache, &counters);
+    array_init(&zCache);
+    add_assoc_long(&zCache, "capacity", (zend_long) php_secp256k1_shm_cache_capacity(cache));
+    add_assoc_long(&zCache, "hits", (zend_long) counters.hits);
+    add_assoc_long(&zCache, "misses", (zend_long) counters.misses);
+    add_assoc_long(&zCache, "inserts", (zend_long) counters.inserts);
+    add_assoc_long(&zCache, "evictions", (zend_long) counters.evictions);
+    add_assoc_zval(stats, name, &zCache);
+}
+#endif
+
+/* {{{ proto array secp256k1_cache_stats()
+ * Returns the counters of the shared memory caches, summed over every process
+ * sharing them. A cache which is disabled or not supported is null. */
+PHP_FUNCTION(secp256k1_cache_stats)
+{
+    if (zend_parse_parameters_none() == FAILURE) {
+        return;
+    }
+
+    array_init(return_value);
+#ifdef HAVE_SECP256K1_SHM
+    php_secp256k1_cache_stats_add(return_value, "pubkey", pubkey_cache);
+    php_secp256k1_cache_stats_add(return_value, "sig", sig_cache);
+#else
+    add_assoc_null(return_value, "pubkey");
+    add_assoc_null(return_value, "sig");
+#endif
+}
+/* }}} */
+
+static void php_secp256k1_stats_entry_zval(zval *out, const php_secp256k1_stats_entry *entry)
+{
+    zval zHistogram;
+    unsigned int i;
+
+    array_init(out);
+    add_assoc_long(out, "calls", (zend_long) entry->calls);
+    add_assoc_long(out, "total_ns", (zend_long) entry->total_ns);
+    add_assoc_long(out, "max_ns", (zend_long) entry->max_ns);
+    add_assoc_long(out, "p50_ns", (zend_long) php_secp256k1_stats_quantile(entry, 500));
+    add_assoc_long(out, "p90_ns", (zend_long) php_secp256k1_stats_quantile(entry, 900));
+    add_assoc_long(out, "p99_ns", (zend_long) php_secp256k1_stats_quantile(entry, 990));
+    array_init(&zHistogram);
+    for (i = 0; i < STATS_BUCKETS; i++) {
+        if (entry->histogram[i] > 0) {
+            add_index_long(&zHistogram, (zend_ulong) php_secp256k1_stats_bucket_low(i), (zend_long) entry->histogram[i]);
+        }
+    }
+    add_assoc_zval(out, "histogram", &zHistogram);
+}
+
+/* {{{ proto array secp256k1_stats([bool reset = false])
+ * Returns call counts and latencies of the functions called so far by this
+ * process, or thread in a threaded build, keyed by function name. Empty
+ * unless secp256k1.stats is enabled. Percentiles are upper bounds from the
+ * histogram, keyed by the smallest latency each bucket counts. With reset
+ * the figures start over after being returned. */
+PHP_FUNCTION(secp256k1_stats)
+{
+    zend_bool reset = 0;
+    zend_string *name, *variant;
+    php_secp256k1_instrumented *wrapped;
+    php_secp256k1_stats_slot *slot;
+    php_secp256k1_stats_entry *entry;
+    zval zFunction, zVariants, zVariant;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "|b", &reset) == FAILURE) {
+        return;
+    }
+
+    array_init(return_value);
+    if (SECP256K1_G(stats_slots) == NULL) {
+        return;
+    }
+
+    ZEND_HASH_FOREACH_STR_KEY_PTR(&instrumented_functions, name, wrapped) {
+        slot = &SECP256K1_G(stats_slots)[wrapped->index];
+        if (slot->all.calls == 0) {
+            continue;
+        }
+        php_secp256k1_stats_entry_zval(&zFunction, &slot->all);
+        if (slot->variants != NULL) {
+            array_init(&zVariants);
+            ZEND_HASH_FOREACH_STR_KEY_PTR(slot->variants, variant, entry) {
+                php_secp256k1_stats_entry_zval(&zVariant, entry);
+                add_assoc_zval_ex(&zVariants, ZSTR_VAL(variant), ZSTR_LEN(variant), &zVariant);
+            } ZEND_HASH_FOREACH_END();
+            add_assoc_zval(&zFunction, "variants", &zVariants);
+        }
+        add_assoc_zval_ex(return_value, ZSTR_VAL(name), ZSTR_LEN(name), &zFunction);
+    } ZEND_HASH_FOREACH_END();
+
+    if (reset) {
+        php_secp256k1_stats_clear(&SECP256K1_G(stats_slots));
+    }
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_trace_register(?callable begin, ?callable end)
+ * Registers an observer for the rest of the request. With secp256k1.trace
+ * enabled, begin(string $function) is called before each sampled signing,
+ * verification, recovery, ecdh or batch call, and end($begin, string
+ * $function, array $attributes) after it, $begin being what begin returned.
+ * Returns an id for secp256k1_trace_unregister(), or 0 on failure. */
+PHP_FUNCTION(secp256k1_trace_register)
+{
+    zval *zBegin = NULL, *zEnd = NULL, zObserver;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "z!z!", &zBegin, &zEnd) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if (zBegin != NULL && !zend_is_callable(zBegin, 0, NULL)) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+            "secp256k1_trace_register(): Parameter 1 should be a callable or null");
+        return;
+    } else if (zEnd != NULL && !zend_is_callable(zEnd, 0, NULL)) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+            "secp256k1_trace_register(): Parameter 2 should be a callable or null");
+        return;
+    }
+
+    if (!SECP256K1_G(trace)) {
+        php_error_docref(NULL, E_WARNING, "secp256k1.trace is disabled, the observer would never be called");
+        RETURN_LONG(0);
+    } else if (SECP256K1_G(trace_depth) > 0) {
+        php_error_docref(NULL, E_WARNING, "cannot register an observer from an observer");
+        RETURN_LONG(0);
+    }
+
+    if (SECP256K1_G(trace_observers) == NULL) {
+        ALLOC_HASHTABLE(SECP256K1_G(trace_observers));
+        zend_hash_init(SECP256K1_G(trace_observers), 4, NULL, ZVAL_PTR_DTOR, 0);
+    }
+    // [begin, end], either may be null
+    array_init_size(&zObserver, 2);
+    if (zBegin != NULL) {
+        Z_TRY_ADDREF_P(zBegin);
+        add_next_index_zval(&zObserver, zBegin);
+    } else {
+        add_next_index_null(&zObserver);
+    }
+    if (zEnd != NULL) {
+        Z_TRY_ADDREF_P(zEnd);
+        add_next_index_zval(&zObserver, zEnd);
+    } else {
+        add_next_index_null(&zObserver);
+    }
+    zend_hash_index_add_new(SECP256K1_G(trace_observers), (zend_ulong) ++SECP256K1_G(trace_next_id), &zObserver);
+
+    RETURN_LONG(SECP256K1_G(trace_next_id));
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_trace_unregister(int id)
+ * Removes an observer registered with secp256k1_trace_register(). Returns 1
+ * if it was registered, 0 otherwise. */
+PHP_FUNCTION(secp256k1_trace_unregister)
+{
+    zend_long id;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "l", &id) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if (SECP256K1_G(trace_depth) > 0) {
+        php_error_docref(NULL, E_WARNING, "cannot unregister an observer from an observer");
+        RETURN_LONG(0);
+    }
+
+    if (SECP256K1_G(trace_observers) == NULL
+        || zend_hash_index_del(SECP256K1_G(trace_observers), (zend_ulong) id) == FAILURE) {
+        RETURN_LONG(0);
+    }
+    // unregistering from a nonce callback is allowed, php_secp256k1_trace_end
+    // copes with the table going away under a call it traces
+    if (zend_hash_num_elements(SECP256K1_G(trace_observers)) == 0) {
+        php_secp256k1_trace_observers_destroy();
+    }
+    RETURN_LONG(1);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_context_randomize(resource context, [string bytes32 = NULL])
+ * Updates the context randomization. */
+PHP_FUNCTION(secp256k1_context_randomize)
+{
+    zval *zCtx, *zSeed = NULL;
+    secp256k1_context_wrapper *wrapper;
+    unsigned char *seed32 = NULL;
+    int result;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "r|z", &zCtx, &zSeed) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((wrapper = php_get_secp256k1_context_wrapper(zCtx)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+#ifdef ZTS
+    // other threads may be signing with a persistent context right now
+    if (Z_RES_P(zCtx)->type == le_secp256k1_persistent_ctx) {
+        php_error_docref(NULL, E_WARNING, "cannot randomize a persistent context in a threaded build, clone it first");
+        RETURN_LONG(0);
+    }
+#endif
+
+    if (zSeed != NULL) {
+        if (Z_TYPE_P(zSeed) == IS_STRING) {
+            if (Z_STRLEN_P(zSeed) != 32) {
+                zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                        "secp256k1_context_randomize(): Parameter 2 should be 32 bytes");
+                return;
+            }
+            seed32 = (unsigned char *) Z_STRVAL_P(zSeed);
+        }
+    }
+
+    result = secp256k1_context_randomize(wrapper->ctx, seed32);
+    // a seed restarts the budget, no seed resets the blinding
+    if (result) {
+        wrapper->ops = 0;
+        wrapper->randomized = seed32 != NULL ? time(NULL) : 0;
+    }
+    RETURN_LONG(result);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_ecdsa_signature_parse_der(resource ctx, resource &sig, string sigIn)
+ * Parse a DER ECDSA signature. */
+PHP_FUNCTION(secp256k1_ecdsa_signature_parse_der)
+{
+    zval *zCtx, *zSig;
+    secp256k1_context *ctx;
+    secp256k1_ecdsa_signature sig;
+    zend_string *sigin;
+    int result;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/S", &zCtx, &zSig, &sigin) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    result = secp256k1_ecdsa_signature_parse_der(ctx, &sig, (unsigned char *) sigin->val, sigin->len);
+    if (result) {
+        php_secp256k1_ecdsa_signature_out(zSig, &sig);
+    }
+
+    RETURN_LONG(result);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_ec_signature_serialize_der(resource context, string &sigOut, resource sig)
+ * Serialize an ECDSA signature in DER format. */
+PHP_FUNCTION(secp256k1_ecdsa_signature_serialize_der)
+{
+    zval *zCtx, *zSig, *zSigOut;
+    secp256k1_context *ctx;
+    secp256k1_ecdsa_signature *sig;
+    size_t sigoutlen = MAX_SIGNATURE_LENGTH;
+    unsigned char sigout[MAX_SIGNATURE_LENGTH];
+    int result;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z", &zCtx, &zSigOut, &zSig) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    if ((sig = php_get_secp256k1_ecdsa_signature(zSig, 3)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    result = secp256k1_ecdsa_signature_serialize_der(ctx, sigout, &sigoutlen, sig);
+    if (result) {
+        zval_dtor(zSigOut);
+        ZVAL_STRINGL(zSigOut, (char *)&sigout, sigoutlen);
+    }
+
+    RETURN_LONG(result);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_ecdsa_signature_serialize_der_many(resource context, string &sigsDerOut, string &lengthsOut, array ecdsaSignatures)
+ * Serialize a list of signatures in DER format into a single string of
+ * concatenated signatures. lengthsOut receives one byte per signature holding
+ * its length, a DER signature is at most 72 bytes long. */
+PHP_FUNCTION(secp256k1_ecdsa_signature_serialize_der_many)
+{
+    zval *zCtx, *zSigsOut, *zLengthsOut, *zSigs, *arrayZval;
+    secp256k1_context *ctx;
+    secp256k1_ecdsa_signature *sig;
+    zend_string *output, *lengths;
+    size_t n, i = 0, pos = 0, siglen;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z/a", &zCtx, &zSigsOut, &zLengthsOut, &zSigs) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    // sized for the longest encoding, and shrunk to fit once afterwards
+    n = (size_t) zend_hash_num_elements(Z_ARRVAL_P(zSigs));
+    SECP256K1_G(stats_items) = n;
+    output = zend_string_safe_alloc(n, MAX_SIGNATURE_LENGTH, 0, 0);
+    lengths = zend_string_alloc(n, 0);
+
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(zSigs), arrayZval) {
+        ZVAL_DEREF(arrayZval);
+        if ((sig = php_get_secp256k1_ecdsa_signature(arrayZval, 0)) == NULL) {
+            zend_string_free(output);
+            zend_string_free(lengths);
+            RETURN_LONG(0);
+        }
+        siglen = MAX_SIGNATURE_LENGTH;
+        secp256k1_ecdsa_signature_serialize_der(ctx, (unsigned char *) output->val + pos, &siglen, sig);
+        lengths->val[i++] = (char) siglen;
+        pos += siglen;
+    } ZEND_HASH_FOREACH_END();
+
+    output = zend_string_truncate(output, pos, 0);
+    output->val[pos] = '\0';
+    lengths->val[n] = '\0';
+
+    zval_dtor(zSigsOut);
+    ZVAL_STR(zSigsOut, output);
+    zval_dtor(zLengthsOut);
+    ZVAL_STR(zLengthsOut, lengths);
+    RETURN_LONG(1);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_ecdsa_signature_parse_compact(resource context, resource &sig, string sig64, int recid)
+ * Parse an ECDSA signature in compact (64 bytes) format. */
+PHP_FUNCTION(secp256k1_ecdsa_signature_parse_compact)
+{
+    zval *zCtx, *zSig;
+    secp256k1_context *ctx;
+    secp256k1_ecdsa_signature sig;
+    zend_string *input64;
+    int result;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/S", &zCtx, &zSig, &input64) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    if (input64->len != COMPACT_SIGNATURE_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ecdsa_signature_parse_compact(): Parameter 3 should be 64 bytes");
+        return;
+    }
+
+    result = secp256k1_ecdsa_signature_parse_compact(ctx, &sig, (unsigned char *) input64->val);
+    if (result) {
+        php_secp256k1_ecdsa_signature_out(zSig, &sig);
+    }
+
+    RETURN_LONG(result);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_ecdsa_signature_serialize_compact(resource context, string &sigOut, resource sig)
+ * Serialize an ECDSA signature in compact (64 byte) format. */
+PHP_FUNCTION(secp256k1_ecdsa_signature_serialize_compact)
+{
+    zval *zCtx, *zSig, *zSigOut;
+    secp256k1_context *ctx;
+    secp256k1_ecdsa_signature *sig;
+    unsigned char sigOut[COMPACT_SIGNATURE_LENGTH];
+    int result;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z", &zCtx, &zSigOut, &zSig) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    if ((sig = php_get_secp256k1_ecdsa_signature(zSig, 3)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    result = secp256k1_ecdsa_signature_serialize_compact(ctx, sigOut, sig);
+
+    zval_dtor(zSigOut);
+    ZVAL_STRINGL(zSigOut, (char *) &sigOut, COMPACT_SIGNATURE_LENGTH);
+    RETURN_LONG(result);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_ecdsa_signature_serialize_compact_many(resource context, string &sigs64Out, array ecdsaSignatures)
+ * Serialize a list of signatures in compact format into a single string of
+ * concatenated 64 byte signatures. */
+PHP_FUNCTION(secp256k1_ecdsa_signature_serialize_compact_many)
+{
+    zval *zCtx, *zSigsOut, *zSigs, *arrayZval;
+    secp256k1_context *ctx;
+    secp256k1_ecdsa_signature *sig;
+    zend_string *output;
+    size_t n, i = 0;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/a", &zCtx, &zSigsOut, &zSigs) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    n = (size_t) zend_hash_num_elements(Z_ARRVAL_P(zSigs));
+    SECP256K1_G(stats_items) = n;
+    output = zend_string_safe_alloc(n, COMPACT_SIGNATURE_LENGTH, 0, 0);
+
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(zSigs), arrayZval) {
+        ZVAL_DEREF(arrayZval);
+        if ((sig = php_get_secp256k1_ecdsa_signature(arrayZval, 0)) == NULL) {
+            zend_string_free(output);
+            RETURN_LONG(0);
+        }
+        secp256k1_ecdsa_signature_serialize_compact(ctx, (unsigned char *) output->val + i++ * COMPACT_SIGNATURE_LENGTH, sig);
+    } ZEND_HASH_FOREACH_END();
+    output->val[output->len] = '\0';
+
+    zval_dtor(zSigsOut);
+    ZVAL_STR(zSigsOut, output);
+    RETURN_LONG(1);
+}
+/* }}} */
+
+/* {{{ proto int ecdsa_signature_parse_der_lax(resource context, resource &sigOut, string sigIn)
+ * Parse a signature in "lax DER" format. */
+PHP_FUNCTION(ecdsa_signature_parse_der_lax)
+{
+    zval *zCtx, *zSig;
+    secp256k1_context *ctx;
+    secp256k1_ecdsa_signature sig;
+    zend_string *sigin;
+    int result;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/S", &zCtx, &zSig, &sigin) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    result = ecdsa_signature_parse_der_lax(ctx, &sig, (unsigned char *) sigin->val, sigin->len);
+    if (result) {
+        php_secp256k1_ecdsa_signature_out(zSig, &sig);
+    }
+
+    RETURN_LONG(result);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_ecdsa_signature_normalize(resource context, resource &sigNormal, resource sig)
+ * Convert a signature to a normalized lower-S form. */
+PHP_FUNCTION(secp256k1_ecdsa_signature_normalize)
+{
+    zval *zCtx, *zSigIn, *zSigOut;
+    secp256k1_context *ctx;
+    secp256k1_ecdsa_signature sigout, *sigin;
+    int result;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z", &zCtx, &zSigOut, &zSigIn) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    if ((sigin = php_get_secp256k1_ecdsa_signature(zSigIn, 3)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    result = secp256k1_ecdsa_signature_normalize(ctx, &sigout, sigin);
+
+    php_secp256k1_ecdsa_signature_out(zSigOut, &sigout);
+    RETURN_LONG(result);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_ecdsa_verify(resource context, resource sig, string msg32, resource pubKey)
+ * Verify an ECDSA signature. */
+PHP_FUNCTION(secp256k1_ecdsa_verify) {
+    zval *zCtx, *zSig, *zPubKey;
+    secp256k1_context *ctx;
+    secp256k1_ecdsa_signature *sig;
+    secp256k1_pubkey *pubkey;
+    zend_string *msg32;
+    int result;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rzSz", &zCtx, &zSig, &msg32, &zPubKey) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    if ((sig = php_get_secp256k1_ecdsa_signature(zSig, 2)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    if ((pubkey = php_get_secp256k1_pubkey(zPubKey, 4)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    result = php_secp256k1_ecdsa_verify_cached(ctx, php_secp256k1_context_verifies(zCtx), sig, (unsigned char *) msg32->val, pubkey);
+    RETURN_LONG(result);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_ecdsa_verify_raw(resource context, string signature, string msg32, string publicKey, int flags = SECP256K1_SIG_FORMAT_DER)
+ * Verify an ECDSA signature straight from its encoding and the 33 or 65 byte
+ * encoding of the public key. flags selects the signature encoding: strict
+ * DER, lax DER or 64 byte compact. High S signatures are rejected, as by
+ * secp256k1_ecdsa_verify, unless flags includes SECP256K1_SIG_ALLOW_HIGH_S.
+ * Returns 0 if either encoding fails to parse. */
+PHP_FUNCTION(secp256k1_ecdsa_verify_raw) {
+    zval *zCtx;
+    secp256k1_context *ctx;
+    secp256k1_ecdsa_signature sig;
+    secp256k1_pubkey pubkey;
+    zend_string *sigin, *msg32, *pubkeyin;
+    zend_long flags = SECP256K1_SIG_FORMAT_DER;
+    int result;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rSSS|l", &zCtx, &sigin, &msg32, &pubkeyin, &flags) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    if (msg32->len != HASH_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ecdsa_verify_raw(): Parameter 3 should be 32 bytes");
+        return;
+    }
+
+    if ((flags & ~(zend_long) (SECP256K1_SIG_FORMAT_MASK | SECP256K1_SIG_ALLOW_HIGH_S)) != 0
+        || (flags & SECP256K1_SIG_FORMAT_MASK) == SECP256K1_SIG_FORMAT_MASK) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ecdsa_verify_raw(): Parameter 5 should be a SECP256K1_SIG_FORMAT_* constant, optionally with SECP256K1_SIG_ALLOW_HIGH_S");
+        return;
+    }
+
+    // everything is parsed onto the stack, nothing outlives the call
+    switch (flags & SECP256K1_SIG_FORMAT_MASK) {
+        case SECP256K1_SIG_FORMAT_DER:
+            result = secp256k1_ecdsa_signature_parse_der(ctx, &sig, (unsigned char *) sigin->val, sigin->len);
+            break;
+        case SECP256K1_SIG_FORMAT_DER_LAX:
+            result = ecdsa_signature_parse_der_lax(ctx, &sig, (unsigned char *) sigin->val, sigin->len);
+            break;
+        default:
+            result = sigin->len == COMPACT_SIGNATURE_LENGTH
+                && secp256k1_ecdsa_signature_parse_compact(ctx, &sig, (unsigned char *) sigin->val);
+            break;
+    }
+    if (result && (flags & SECP256K1_SIG_ALLOW_HIGH_S)) {
+        secp256k1_ecdsa_signature_normalize(ctx, &sig, &sig);
+    }
+
+    result = result
+        && php_secp256k1_ec_pubkey_parse_cached(ctx, &pubkey, (unsigned char *) pubkeyin->val, pubkeyin->len)
+        && php_secp256k1_ecdsa_verify_cached(ctx, php_secp256k1_context_verifies(zCtx), &sig, (unsigned char *) msg32->val, &pubkey);
+    RETURN_LONG(result);
+}
+/* }}} */
+
+typedef struct _php_secp256k1_ecdsa_verify_job {
+    const secp256k1_ecdsa_signature **sigs;
+    const unsigned char **msgs32;
+    const secp256k1_pubkey **pubkeys;
+    // set instead of pubkeys when the keys came from a Secp256k1\PublicKeyVector
+    const secp256k1_pubkey *pubkey_vector;
+} php_secp256k1_ecdsa_verify_job;
+
+static int php_secp256k1_ecdsa_verify_item(const secp256k1_context *ctx, void *arg, size_t i) {
+    php_secp256k1_ecdsa_verify_job *job = (php_secp256k1_ecdsa_verify_job *) arg;
+    return php_secp256k1_ecdsa_verify_cached(ctx, 1, job->sigs[i], job->msgs32[i],
+            job->pubkey_vector != NULL ? &job->pubkey_vector[i] : job->pubkeys[i]);
+}
+
+/* {{{ proto int secp256k1_ecdsa_verify_batch(resource context, array sigs, array msgs32, array|Secp256k1\PublicKeyVector pubKeys, string &results = null)
+ * Verify a batch of ECDSA signatures. The i-th signature is checked against the
+ * i-th message and public key. If results is provided every signature is checked,
+ * and results is set to a bitmap with bit i set if signature i was valid. Otherwise
+ * verification stops at the first invalid signature. The context must have been
+ * created with SECP256K1_CONTEXT_VERIFY. */
+PHP_FUNCTION(secp256k1_ecdsa_verify_batch)
+{
+    zval *zCtx, *zSigs, *zMsgs, *zPubKeys, *zResults = NULL, *arrayZval;
+    secp256k1_context *ctx;
+    HashTable *sigs_hash, *msgs_hash, *pubkeys_hash = NULL;
+    php_secp256k1_pubkey_vector_obj *vec;
+    const void **ptrs;
+    const secp256k1_ecdsa_signature **sigs;
+    const unsigned char **msgs32;
+    const secp256k1_pubkey **pubkeys;
+    php_secp256k1_ecdsa_verify_job job;
+    zend_string *bitmap;
+    size_t n, i;
+    int result = 0;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "raaz|z/", &zCtx, &zSigs, &zMsgs, &zPubKeys, &zResults) == FAILURE) {
+        RETURN_LONG(result);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(result);
+    }
+
+    // the worker threads verify on clones of a SIGN|VERIFY context, so a
+    // context without VERIFY is refused before any item is dispatched.
+    if (!php_secp256k1_context_verifies(zCtx)) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                "secp256k1_ecdsa_verify_batch(): Parameter 1 should be a context created with SECP256K1_CONTEXT_VERIFY");
+        return;
+    }
+
+    sigs_hash = Z_ARRVAL_P(zSigs);
+    msgs_hash = Z_ARRVAL_P(zMsgs);
+    n = (size_t) zend_hash_num_elements(sigs_hash);
+    if ((vec = php_get_secp256k1_pubkey_vector(zPubKeys)) == NULL) {
+        if (Z_TYPE_P(zPubKeys) != IS_ARRAY) {
+            zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                    "secp256k1_ecdsa_verify_batch(): Parameter 4 should be an array or Secp256k1\\PublicKeyVector");
+            return;
+        }
+        pubkeys_hash = Z_ARRVAL_P(zPubKeys);
+    }
+    if (zend_hash_num_elements(msgs_hash) != n ||
+            (vec != NULL ? vec->count : zend_hash_num_elements(pubkeys_hash)) != n) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                "secp256k1_ecdsa_verify_batch(): Parameters 2, 3 and 4 should have the same number of elements");
+        return;
+    }
+
+    // one allocation holds the pointer arrays, so every
+    // exit path only needs to free ptrs.
+    ptrs = safe_emalloc(3 * n + 1, sizeof(void *), 0);
+    sigs = (const secp256k1_ecdsa_signature **) ptrs;
+    msgs32 = (const unsigned char **) (ptrs + n);
+    pubkeys = (const secp256k1_pubkey **) (ptrs + 2 * n);
+
+    i = 0;
+    ZEND_HASH_FOREACH_VAL(sigs_hash, arrayZval) {
+        ZVAL_DEREF(arrayZval);
+        if ((sigs[i++] = php_get_secp256k1_ecdsa_signature(arrayZval, 0)) == NULL) {
+            efree(ptrs);
+            RETURN_LONG(result);
+        }
+    } ZEND_HASH_FOREACH_END();
+
+    i = 0;
+    ZEND_HASH_FOREACH_VAL(msgs_hash, arrayZval) {
+        ZVAL_DEREF(arrayZval);
+        if (Z_TYPE_P(arrayZval) != IS_STRING || Z_STRLEN_P(arrayZval) != HASH_LENGTH) {
+            efree(ptrs);
+            zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                    "secp256k1_ecdsa_verify_batch(): Parameter 3 should only contain 32 byte strings");
+            return;
+        }
+        msgs32[i++] = (const unsigned char *) Z_STRVAL_P(arrayZval);
+    } ZEND_HASH_FOREACH_END();
+
+    if (vec != NULL) {
+        // keys are read straight from the vector's storage
+        pubkeys = NULL;
+    } else {
+        i = 0;
+        ZEND_HASH_FOREACH_VAL(pubkeys_hash, arrayZval) {
+            ZVAL_DEREF(arrayZval);
+            if ((pubkeys[i++] = php_get_secp256k1_pubkey(arrayZval, 0)) == NULL) {
+                efree(ptrs);
+                RETURN_LONG(result);
+            }
+        } ZEND_HASH_FOREACH_END();
+    }
+
+    job.sigs = sigs;
+    job.msgs32 = msgs32;
+    job.pubkeys = pubkeys;
+    job.pubkey_vector = vec != NULL ? vec->keys : NULL;
+    if (zResults == NULL) {
+        result = php_secp256k1_batch(ctx, php_secp256k1_ecdsa_verify_item, &job, n, NULL);
+    } else {
+        bitmap = zend_string_alloc(BITMAP_LENGTH(n), 0);
+        memset(bitmap->val, 0, bitmap->len + 1);
+        result = php_secp256k1_batch(ctx, php_secp256k1_ecdsa_verify_item, &job, n, (unsigned char *) bitmap->val);
+        zval_dtor(zResults);
+        ZVAL_STR(zResults, bitmap);
+    }
+
+    efree(ptrs);
+    RETURN_LONG(result);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_ecdsa_sign(resource context, resource &sig, string msg32, string key32)
+ * Create an ECDSA signature. */
+PHP_FUNCTION (secp256k1_ecdsa_sign)
+{
+    zval *zCtx, *zSig, *zData = NULL;
+    zend_string *msg32, *seckey;
+    secp256k1_context *ctx;
+    secp256k1_ecdsa_signature newsig;
+    secp256k1_nonce_function noncefp = NULL;
+    void *ndata = NULL;
+    zend_fcall_info fci = empty_fcall_info;
+    zend_fcall_info_cache fcc = empty_fcall_info_cache;
+    php_secp256k1_callback callback;
+    int result;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/SS|fz",
+        &zCtx, &zSig, &msg32, &seckey, &fci, &fcc, &zData) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    if (msg32->len != HASH_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0
+       , "secp256k1_ecdsa_sign(): Parameter 3 should be 32 bytes");
+        return;
+    }
+
+    if (seckey->len != SECRETKEY_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0
+       , "secp256k1_ecdsa_sign(): Parameter 4 should be 32 bytes");
+        return;
+    }
+
+    // splits the secp256k1.stats figures by nonce path
+    SECP256K1_G(stats_variant) = "nonce=default";
+    if (ZEND_NUM_ARGS() > 4 && (php_secp256k1_is_native_nonce_function(&fcc, ZEND_FN(secp256k1_nonce_function_rfc6979))
+        || php_secp256k1_is_native_nonce_function(&fcc, ZEND_FN(secp256k1_nonce_function_default)))) {
+        // our own rfc6979 binding: skip the round trip through PHP. invalid
+        // data makes the binding fail, so signing fails the same way here.
+        noncefp = secp256k1_nonce_function_rfc6979;
+        SECP256K1_G(stats_variant) = "nonce=native";
+        if (zData != NULL && !php_nonce_function_extract_data(zData, (unsigned char **) &ndata)) {
+            RETURN_LONG(0);
+        }
+    } else if (ZEND_NUM_ARGS() > 4) {
+        noncefp = php_secp256k1_nonce_function_callback;
+        SECP256K1_G(stats_variant) = "nonce=callback";
+        php_secp256k1_callback_init(&callback, &fci, &fcc, 6);
+        if (zData == NULL) {
+            ZVAL_NULL(&callback.args[4]);
+        } else {
+            ZVAL_COPY_VALUE(&callback.args[4], zData);
+        }
+        ndata = (void *) &callback;
+    }
+
+    php_secp256k1_context_budget(zCtx, 1);
+    result = secp256k1_ecdsa_sign(ctx, &newsig, (unsigned char *) msg32->val, (unsigned char *) seckey->val, noncefp, ndata);
+    if (noncefp == php_secp256k1_nonce_function_callback) {
+        php_secp256k1_callback_release(&callback, 4);
+    }
+    if (result) {
+        php_secp256k1_ecdsa_signature_out(zSig, &newsig);
+    }
+
+    RETURN_LONG(result);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_ec_seckey_verify(resource context, string key32)
+ * Verify an ECDSA secret key. */
+PHP_FUNCTION(secp256k1_ec_seckey_verify)
+{
+    zval *zCtx;
+    secp256k1_context *ctx;
+    zend_string *seckey;
+    int result;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rS", &zCtx, &seckey) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    if (seckey->len != SECRETKEY_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_seckey_verify(): Parameter 1 should be 32 bytes");
+        return;
+    }
+
+    result = secp256k1_ec_seckey_verify(ctx, (unsigned char *) seckey->val);
+
+    RETURN_LONG(result);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_ec_pubkey_create(resource context, resource &pubKey, string key32)
+ * Compute the public key for a secret key. */
+PHP_FUNCTION(secp256k1_ec_pubkey_create)
+{
+    zval *zCtx;
+    zval *zPubKey;
+    secp256k1_context *ctx;
+    secp256k1_pubkey pubkey;
+    zend_string *seckey;
+    int result;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/S", &zCtx, &zPubKey, &seckey) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    if (seckey->len != SECRETKEY_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_pubkey_create(): Parameter 2 should be 32 bytes");
+        return;
+    }
 
-/* Remove if there's nothing to do at request start */
-PHP_RINIT_FUNCTION(secp256k1) {
-    return SUCCESS;
-}
+    php_secp256k1_context_budget(zCtx, 1);
+    result = secp256k1_ec_pubkey_create(ctx, &pubkey, (unsigned char *)seckey->val);
+    if (result) {
+        php_secp256k1_pubkey_out(zPubKey, &pubkey);
+    }
 
-/* Remove if there's nothing to do at request end */
-PHP_RSHUTDOWN_FUNCTION(secp256k1) {
-    return SUCCESS;
+    RETURN_LONG(result);
 }
+/* }}} */
 
-PHP_MINFO_FUNCTION(secp256k1) {
-    php_info_print_table_start();
-    php_info_print_table_header(2, "secp256k1 support", "enabled");
-    php_info_print_table_end();
+typedef struct _php_secp256k1_ec_pubkey_create_job {
+    const unsigned char *seckeys;
+    unsigned char *output;
+    size_t stride;
+    unsigned int flags;
+} php_secp256k1_ec_pubkey_create_job;
+
+static int php_secp256k1_ec_pubkey_create_item(const secp256k1_context *ctx, void *arg, size_t i) {
+    php_secp256k1_ec_pubkey_create_job *job = (php_secp256k1_ec_pubkey_create_job *) arg;
+    secp256k1_pubkey pubkey;
+    size_t pubkeylen = job->stride;
+    if (!secp256k1_ec_pubkey_create(ctx, &pubkey, job->seckeys + i * SECRETKEY_LENGTH)) {
+        return 0;
+    }
+    return secp256k1_ec_pubkey_serialize(ctx, job->output + i * job->stride, &pubkeylen, &pubkey, job->flags);
 }
 
-zend_module_entry secp256k1_module_entry = {
-        STANDARD_MODULE_HEADER,
-        "secp256k1",
-        secp256k1_functions,
-        PHP_MINIT(secp256k1),
-        PHP_MSHUTDOWN(secp256k1),
-        PHP_RINIT(secp256k1), /* Replace with NULL if there's nothing to do at request start */
-        PHP_RSHUTDOWN(secp256k1), /* Replace with NULL if there's nothing to do at request end */
-        PHP_MINFO(secp256k1),
-        PHP_SECP256K1_VERSION,
-        STANDARD_MODULE_PROPERTIES
-};
+/* {{{ proto int secp256k1_ec_pubkey_create_many(resource context, string &publicKeysOut, string &valid, string secretKeys, int flags)
+ * Compute the public keys of a string of concatenated 32 byte secret keys.
+ * publicKeysOut is set to the serialized keys in input order, 33 bytes each if
+ * flags is SECP256K1_EC_COMPRESSED and 65 bytes otherwise. The key of an
+ * invalid secret key is left zeroed, and valid is set to a bitmap with bit i set
+ * if secret key i was valid. */
+PHP_FUNCTION(secp256k1_ec_pubkey_create_many)
+{
+    zval *zCtx, *zPubOut, *zValid;
+    secp256k1_context *ctx;
+    php_secp256k1_ec_pubkey_create_job job;
+    zend_string *seckeys, *output, *bitmap;
+    zend_long flags;
+    size_t n;
+    int result = 0;
 
-#ifdef COMPILE_DL_SECP256K1
-ZEND_GET_MODULE(secp256k1)
-#endif
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z/Sl", &zCtx, &zPubOut, &zValid, &seckeys, &flags) == FAILURE) {
+        RETURN_LONG(result);
+    }
 
-/* {{{ proto ?resource secp256k1_context_create(int flags)
- * Create a secp256k1 context object. */
-PHP_FUNCTION(secp256k1_context_create)
-{
-    long flags;
-    secp256k1_context * ctx;
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "l", &flags) == FAILURE) {
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(result);
+    }
+
+    if (seckeys->len % SECRETKEY_LENGTH != 0) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_pubkey_create_many(): Parameter 4 should be a multiple of 32 bytes long");
         return;
     }
 
-    if ((flags & ~(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY)) > 0) {
+    if (flags != SECP256K1_EC_COMPRESSED && flags != SECP256K1_EC_UNCOMPRESSED) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_pubkey_create_many(): Parameter 5 should be SECP256K1_EC_COMPRESSED or SECP256K1_EC_UNCOMPRESSED");
         return;
     }
 
-    ctx = secp256k1_context_create(flags);
-    RETURN_RES(zend_register_resource(ctx, le_secp256k1_ctx));
+    // keys are derived and serialized straight into the output, so no
+    // secp256k1_pubkey outlives the item which computed it
+    n = seckeys->len / SECRETKEY_LENGTH;
+    job.seckeys = (const unsigned char *) seckeys->val;
+    job.stride = (flags == SECP256K1_EC_COMPRESSED) ? PUBKEY_COMPRESSED_LENGTH : PUBKEY_UNCOMPRESSED_LENGTH;
+    job.flags = (unsigned int) flags;
+    output = zend_string_safe_alloc(n, job.stride, 0, 0);
+    memset(output->val, 0, output->len + 1);
+    job.output = (unsigned char *) output->val;
+    bitmap = zend_string_alloc(BITMAP_LENGTH(n), 0);
+    memset(bitmap->val, 0, bitmap->len + 1);
+    php_secp256k1_context_budget(zCtx, (zend_long) n);
+    result = php_secp256k1_batch(ctx, php_secp256k1_ec_pubkey_create_item, &job, n, (unsigned char *) bitmap->val);
+
+    zval_dtor(zPubOut);
+    ZVAL_STR(zPubOut, output);
+    zval_dtor(zValid);
+    ZVAL_STR(zValid, bitmap);
+
+    RETURN_LONG(result);
 }
 /* }}} */
 
-/* {{{ proto bool secp256k1_context_destroy(resource context)
- * Destroy a secp256k1 context object. */
-PHP_FUNCTION(secp256k1_context_destroy)
+/* {{{ proto int secp256k1_ec_privkey_negate(resource context, string key32)
+ * Negates a private key in place. */
+PHP_FUNCTION(secp256k1_ec_privkey_negate)
 {
-    zval *zCtx;
+    zval *zCtx, *zPrivKey;
     secp256k1_context *ctx;
+    int result;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "r", &zCtx) == FAILURE) {
-        RETURN_FALSE;
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/", &zCtx, &zPrivKey) == FAILURE) {
+        RETURN_LONG(0);
     }
 
     if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
-        RETURN_FALSE;
+        RETURN_LONG(0);
     }
 
-    zend_list_close(Z_RES_P(zCtx));
-    RETURN_TRUE;
+    if (Z_STRLEN_P(zPrivKey) != SECRETKEY_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_privkey_negate(): Parameter 2 should be 32 bytes");
+        return;
+    }
+
+    unsigned char newseckey[SECRETKEY_LENGTH];
+    memcpy(newseckey, Z_STRVAL_P(zPrivKey), SECRETKEY_LENGTH);
+    result = secp256k1_ec_privkey_negate(ctx, newseckey);
+
+    zval_dtor(zPrivKey);
+    ZVAL_STRINGL(zPrivKey, (char *)&newseckey, SECRETKEY_LENGTH);
+
+    RETURN_LONG(result);
 }
 /* }}} */
 
-/* {{{ proto ?resource secp256k1_context_clone(resource context)
- * Copies a secp256k1 context object. */
-PHP_FUNCTION(secp256k1_context_clone)
+/* {{{ proto int secp256k1_ec_pubkey_negate(resource ctx, resource pubkey)
+ * Negates a public key in place. */
+PHP_FUNCTION(secp256k1_ec_pubkey_negate)
 {
-    zval *zCtx;
+    zval *zCtx, *zPubKey;
     secp256k1_context *ctx;
-    secp256k1_context *newCtx;
+    secp256k1_pubkey *pubkey;
+    int result;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "r", &zCtx) == FAILURE) {
-        RETURN_NULL();
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz", &zCtx, &zPubKey) == FAILURE) {
+        RETURN_LONG(0);
     }
 
     if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
-        RETURN_NULL();
+        RETURN_LONG(0);
+    }
+
+    if ((pubkey = php_get_secp256k1_pubkey(zPubKey, 2)) == NULL) {
+        RETURN_LONG(0);
     }
 
-    newCtx = secp256k1_context_clone(ctx);
-    RETURN_RES(zend_register_resource(newCtx, le_secp256k1_ctx));
+    result = secp256k1_ec_pubkey_negate(ctx, pubkey);
+
+    RETURN_LONG(result);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_context_randomize(resource context, [string bytes32 = NULL])
- * Updates the context randomization. */
-PHP_FUNCTION(secp256k1_context_randomize)
+/* {{{ proto int secp256k1_ec_pubkey_parse(resource secp256k1_context, resource &pubKey, string pubKeyIn)
+ * Parse a variable-length public key into the pubkey object. */
+PHP_FUNCTION(secp256k1_ec_pubkey_parse)
 {
-    zval *zCtx, *zSeed = NULL;
+    zval *zCtx, *zPubKey;
     secp256k1_context *ctx;
-    unsigned char *seed32 = NULL;
+    secp256k1_pubkey pubkey;
+    zend_string *pubkeyin;
     int result;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "r|z", &zCtx, &zSeed) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/S", &zCtx, &zPubKey, &pubkeyin) == FAILURE) {
         RETURN_LONG(0);
     }
 
@@ -1033,66 +4022,111 @@ PHP_FUNCTION(secp256k1_context_randomize)
         RETURN_LONG(0);
     }
 
-    if (zSeed != NULL) {
-        if (Z_TYPE_P(zSeed) == IS_STRING) {
-            if (Z_STRLEN_P(zSeed) != 32) {
-                zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
-                        "secp256k1_context_randomize(): Parameter 2 should be 32 bytes");
-                return;
-            }
-            seed32 = (unsigned char *) Z_STRVAL_P(zSeed);
-        }
+    result = php_secp256k1_ec_pubkey_parse_cached(ctx, &pubkey, (unsigned char *)pubkeyin->val, pubkeyin->len);
+    if (result) {
+        php_secp256k1_pubkey_out(zPubKey, &pubkey);
     }
 
-    result = secp256k1_context_randomize(ctx, seed32);
     RETURN_LONG(result);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ecdsa_signature_parse_der(resource ctx, resource &sig, string sigIn)
- * Parse a DER ECDSA signature. */
-PHP_FUNCTION(secp256k1_ecdsa_signature_parse_der)
+typedef struct _php_secp256k1_ec_pubkey_parse_job {
+    const unsigned char *input;
+    size_t stride;
+    secp256k1_pubkey *pubkeys;
+} php_secp256k1_ec_pubkey_parse_job;
+
+static int php_secp256k1_ec_pubkey_parse_item(const secp256k1_context *ctx, void *arg, size_t i) {
+    php_secp256k1_ec_pubkey_parse_job *job = (php_secp256k1_ec_pubkey_parse_job *) arg;
+    return php_secp256k1_ec_pubkey_parse_cached(ctx, &job->pubkeys[i], job->input + i * job->stride, job->stride);
+}
+
+/* {{{ proto int secp256k1_ec_pubkey_parse_many(resource context, Secp256k1\PublicKeyVector &pubKeys, string &valid, string publicKeysIn, int stride)
+ * Parse a string of concatenated public keys, each stride bytes long. Valid
+ * keys are appended to pubKeys in input order, invalid ones are skipped. valid
+ * is set to a bitmap with bit i set if key i could be parsed. */
+PHP_FUNCTION(secp256k1_ec_pubkey_parse_many)
 {
-    zval *zCtx, *zSig;
+    zval *zCtx, *zPubKeys, *zValid;
     secp256k1_context *ctx;
-    secp256k1_ecdsa_signature *sig;
-    zend_string *sigin;
-    int result;
+    php_secp256k1_pubkey_vector_obj *vec;
+    php_secp256k1_ec_pubkey_parse_job job;
+    zend_string *input, *bitmap;
+    zend_long stride;
+    secp256k1_pubkey *keys;
+    size_t n, i, count;
+    int result = 0;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/S", &zCtx, &zSig, &sigin) == FAILURE) {
-        RETURN_LONG(0);
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z/Sl", &zCtx, &zPubKeys, &zValid, &input, &stride) == FAILURE) {
+        RETURN_LONG(result);
     }
 
     if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
-        RETURN_LONG(0);
+        RETURN_LONG(result);
     }
 
-    sig = (secp256k1_ecdsa_signature *) emalloc(sizeof(secp256k1_ecdsa_signature));
-    result = secp256k1_ecdsa_signature_parse_der(ctx, sig, (unsigned char *) sigin->val, sigin->len);
-    if (result) {
-        zval_dtor(zSig);
-        ZVAL_RES(zSig, zend_register_resource(sig, le_secp256k1_sig));
-    } else {
-        // only free when operation fails, won't return this resource
-        efree(sig);
+    if (stride != PUBKEY_COMPRESSED_LENGTH && stride != PUBKEY_UNCOMPRESSED_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_pubkey_parse_many(): Parameter 5 should be 33 or 65");
+        return;
+    }
+
+    if (input->len % (size_t) stride != 0) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_pubkey_parse_many(): Parameter 4 should be a multiple of stride bytes long");
+        return;
+    }
+
+    // keys are appended to a vector passed in, otherwise a new one is returned
+    if ((vec = php_get_secp256k1_pubkey_vector(zPubKeys)) == NULL) {
+        zval_dtor(zPubKeys);
+        object_init_ex(zPubKeys, secp256k1_pubkey_vector_ce);
+        vec = PHP_SECP256K1_OBJ_P(php_secp256k1_pubkey_vector_obj, zPubKeys);
+    }
+
+    n = input->len / (size_t) stride;
+    php_secp256k1_pubkey_vector_reserve(vec, n);
+    keys = vec->keys + vec->count;
+
+    // keys are parsed straight into the vector's spare capacity
+    job.input = (const unsigned char *) input->val;
+    job.stride = (size_t) stride;
+    job.pubkeys = keys;
+    bitmap = zend_string_alloc(BITMAP_LENGTH(n), 0);
+    memset(bitmap->val, 0, bitmap->len + 1);
+    php_secp256k1_batch(ctx, php_secp256k1_ec_pubkey_parse_item, &job, n, (unsigned char *) bitmap->val);
+
+    // close the gaps left by invalid keys
+    count = 0;
+    for (i = 0; i < n; i++) {
+        if (BITMAP_GET((unsigned char *) bitmap->val, i)) {
+            if (count != i) {
+                keys[count] = keys[i];
+            }
+            count++;
+        }
     }
+    vec->count += count;
+    result = count == n;
+
+    zval_dtor(zValid);
+    ZVAL_STR(zValid, bitmap);
 
     RETURN_LONG(result);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ec_signature_serialize_der(resource context, string &sigOut, resource sig)
- * Serialize an ECDSA signature in DER format. */
-PHP_FUNCTION(secp256k1_ecdsa_signature_serialize_der)
+/* {{{ proto int secp256k1_ec_pubkey_serialize(resource context, string &pubKeyOut, resource pubKey, long flags)
+ * Serialize a pubkey object into a serialized byte sequence. */
+PHP_FUNCTION(secp256k1_ec_pubkey_serialize)
 {
-    zval *zCtx, *zSig, *zSigOut;
+    zval *zCtx, *zPubKey, *zPubOut;
     secp256k1_context *ctx;
-    secp256k1_ecdsa_signature *sig;
-    size_t sigoutlen = MAX_SIGNATURE_LENGTH;
-    unsigned char sigout[MAX_SIGNATURE_LENGTH];
+    secp256k1_pubkey * pubkey;
     int result;
+    size_t pubkeylen;
+    zend_long flags;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/r", &zCtx, &zSigOut, &zSig) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/zl", &zCtx, &zPubOut, &zPubKey, &flags) == FAILURE) {
         RETURN_LONG(0);
     }
 
@@ -1100,31 +4134,36 @@ PHP_FUNCTION(secp256k1_ecdsa_signature_serialize_der)
         RETURN_LONG(0);
     }
 
-    if ((sig = php_get_secp256k1_ecdsa_signature(zSig)) == NULL) {
+    if ((pubkey = php_get_secp256k1_pubkey(zPubKey, 3)) == NULL) {
         RETURN_LONG(0);
     }
 
-    result = secp256k1_ecdsa_signature_serialize_der(ctx, sigout, &sigoutlen, sig);
-    if (result) {
-        zval_dtor(zSigOut);
-        ZVAL_STRINGL(zSigOut, (char *)&sigout, sigoutlen);
-    }
+    pubkeylen = (flags == SECP256K1_EC_COMPRESSED) ? PUBKEY_COMPRESSED_LENGTH : PUBKEY_UNCOMPRESSED_LENGTH;
+
+    unsigned char pubkeyout[PUBKEY_UNCOMPRESSED_LENGTH];
+    result = secp256k1_ec_pubkey_serialize(ctx, pubkeyout, &pubkeylen, pubkey, flags);
+
+    zval_dtor(zPubOut);
+    ZVAL_STRINGL(zPubOut, (char *)&pubkeyout, pubkeylen);
 
     RETURN_LONG(result);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ecdsa_signature_parse_compact(resource context, resource &sig, string sig64, int recid)
- * Parse an ECDSA signature in compact (64 bytes) format. */
-PHP_FUNCTION(secp256k1_ecdsa_signature_parse_compact)
+/* {{{ proto int secp256k1_ec_pubkey_serialize_many(resource context, string &publicKeysOut, array|Secp256k1\PublicKeyVector ecPublicKeys, int flags)
+ * Serialize a list of public keys into a single string of concatenated keys,
+ * 33 bytes each if flags is SECP256K1_EC_COMPRESSED and 65 bytes otherwise. */
+PHP_FUNCTION(secp256k1_ec_pubkey_serialize_many)
 {
-    zval *zCtx, *zSig;
+    zval *zCtx, *zPubOut, *zPubKeys, *arrayZval;
     secp256k1_context *ctx;
-    secp256k1_ecdsa_signature *sig;
-    zend_string *input64;
-    int result;
+    php_secp256k1_pubkey_vector_obj *vec;
+    secp256k1_pubkey *pubkey;
+    zend_string *output;
+    zend_long flags;
+    size_t n, i = 0, stride, pubkeylen;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/S", &zCtx, &zSig, &input64) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/zl", &zCtx, &zPubOut, &zPubKeys, &flags) == FAILURE) {
         RETURN_LONG(0);
     }
 
@@ -1132,36 +4171,62 @@ PHP_FUNCTION(secp256k1_ecdsa_signature_parse_compact)
         RETURN_LONG(0);
     }
 
-    if (input64->len != COMPACT_SIGNATURE_LENGTH) {
-        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ecdsa_signature_parse_compact(): Parameter 3 should be 64 bytes");
+    if (flags != SECP256K1_EC_COMPRESSED && flags != SECP256K1_EC_UNCOMPRESSED) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_pubkey_serialize_many(): Parameter 4 should be SECP256K1_EC_COMPRESSED or SECP256K1_EC_UNCOMPRESSED");
         return;
     }
 
-    sig = emalloc(sizeof(secp256k1_ecdsa_signature));
-    result = secp256k1_ecdsa_signature_parse_compact(ctx, sig, (unsigned char *) input64->val);
-    if (result) {
-        zval_dtor(zSig);
-        ZVAL_RES(zSig, zend_register_resource(sig, le_secp256k1_sig));
+    if ((vec = php_get_secp256k1_pubkey_vector(zPubKeys)) != NULL) {
+        n = vec->count;
+    } else if (Z_TYPE_P(zPubKeys) == IS_ARRAY) {
+        n = (size_t) zend_hash_num_elements(Z_ARRVAL_P(zPubKeys));
     } else {
-        // only free when operation fails, won't return this resource
-        efree(sig);
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_pubkey_serialize_many(): Parameter 3 should be an array or Secp256k1\\PublicKeyVector");
+        return;
     }
 
-    RETURN_LONG(result);
+    // picked up by php_secp256k1_instrument_handler for the batch size
+    SECP256K1_G(stats_items) = n;
+    // the output has a fixed size per key, so it is allocated once
+    stride = (flags == SECP256K1_EC_COMPRESSED) ? PUBKEY_COMPRESSED_LENGTH : PUBKEY_UNCOMPRESSED_LENGTH;
+    output = zend_string_safe_alloc(n, stride, 0, 0);
+
+    if (vec != NULL) {
+        for (i = 0; i < n; i++) {
+            pubkeylen = stride;
+            secp256k1_ec_pubkey_serialize(ctx, (unsigned char *) output->val + i * stride, &pubkeylen, &vec->keys[i], flags);
+        }
+    } else {
+        ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(zPubKeys), arrayZval) {
+            ZVAL_DEREF(arrayZval);
+            if ((pubkey = php_get_secp256k1_pubkey(arrayZval, 0)) == NULL) {
+                zend_string_free(output);
+                RETURN_LONG(0);
+            }
+            pubkeylen = stride;
+            secp256k1_ec_pubkey_serialize(ctx, (unsigned char *) output->val + i++ * stride, &pubkeylen, pubkey, flags);
+        } ZEND_HASH_FOREACH_END();
+    }
+    output->val[output->len] = '\0';
+
+    zval_dtor(zPubOut);
+    ZVAL_STR(zPubOut, output);
+    RETURN_LONG(1);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ecdsa_signature_serialize_compact(resource context, string &sigOut, resource sig)
- * Serialize an ECDSA signature in compact (64 byte) format. */
-PHP_FUNCTION(secp256k1_ecdsa_signature_serialize_compact)
+/* {{{ proto int secp256k1_ec_privkey_tweak_add(resource context, string &key32, string tweak32)
+ * Tweak a private key by adding tweak to it. */
+PHP_FUNCTION(secp256k1_ec_privkey_tweak_add)
 {
-    zval *zCtx, *zSig, *zSigOut;
+    zval *zCtx, *zSecKey;
     secp256k1_context *ctx;
-    secp256k1_ecdsa_signature *sig;
-    unsigned char sigOut[COMPACT_SIGNATURE_LENGTH];
+    zend_string *zTweak;
+    unsigned char *tweak;
+    unsigned char newseckey[SECRETKEY_LENGTH];
     int result;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/r", &zCtx, &zSigOut, &zSig) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/S", &zCtx, &zSecKey, &zTweak) == FAILURE) {
         RETURN_LONG(0);
     }
 
@@ -1169,29 +4234,36 @@ PHP_FUNCTION(secp256k1_ecdsa_signature_serialize_compact)
         RETURN_LONG(0);
     }
 
-    if ((sig = php_get_secp256k1_ecdsa_signature(zSig)) == NULL) {
-        RETURN_LONG(0);
+    if (Z_STRLEN_P(zSecKey) != SECRETKEY_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_privkey_tweak_add(): Parameter 2 should be 32 bytes");
+        return;
     }
 
-    result = secp256k1_ecdsa_signature_serialize_compact(ctx, sigOut, sig);
+    if (zTweak->len != SECRETKEY_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_privkey_tweak_add(): Parameter 3 should be 32 bytes");
+        return;
+    }
 
-    zval_dtor(zSigOut);
-    ZVAL_STRINGL(zSigOut, (char *) &sigOut, COMPACT_SIGNATURE_LENGTH);
+    memcpy(newseckey, Z_STRVAL_P(zSecKey), SECRETKEY_LENGTH);
+    result = secp256k1_ec_privkey_tweak_add(ctx, newseckey, (unsigned char *) zTweak->val);
+
+    zval_dtor(zSecKey);
+    ZVAL_STRINGL(zSecKey, (const char *) newseckey, SECRETKEY_LENGTH);
     RETURN_LONG(result);
 }
 /* }}} */
 
-/* {{{ proto int ecdsa_signature_parse_der_lax(resource context, resource &sigOut, string sigIn)
- * Parse a signature in "lax DER" format. */
-PHP_FUNCTION(ecdsa_signature_parse_der_lax)
+/* {{{ proto int secp256k1_ec_pubkey_tweak_add(resource context, resource pubKey, string tweak32)
+ * Tweak a public key by adding tweak times the generator to it. */
+PHP_FUNCTION(secp256k1_ec_pubkey_tweak_add)
 {
-    zval *zCtx, *zSig;
+    zval *zCtx, *zPubKey;
     secp256k1_context *ctx;
-    secp256k1_ecdsa_signature *sig;
-    zend_string *sigin;
+    secp256k1_pubkey *pubkey;
+    zend_string *zTweak;
     int result;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/S", &zCtx, &zSig, &sigin) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rzS", &zCtx, &zPubKey, &zTweak) == FAILURE) {
         RETURN_LONG(0);
     }
 
@@ -1199,30 +4271,31 @@ PHP_FUNCTION(ecdsa_signature_parse_der_lax)
         RETURN_LONG(0);
     }
 
-    sig = (secp256k1_ecdsa_signature *) emalloc(sizeof(secp256k1_ecdsa_signature));
-    result = ecdsa_signature_parse_der_lax(ctx, sig, (unsigned char *) sigin->val, sigin->len);
-    if (result) {
-        zval_dtor(zSig);
-        ZVAL_RES(zSig, zend_register_resource(sig, le_secp256k1_sig));
-    } else {
-        // only free when operation fails, won't return this resource
-        efree(sig);
+    if ((pubkey = php_get_secp256k1_pubkey(zPubKey, 2)) == NULL) {
+        RETURN_LONG(0);
     }
 
+    if (zTweak->len != SECRETKEY_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_pubkey_tweak_add(): Parameter 3 should be 32 bytes");
+        return;
+    }
+
+    result = secp256k1_ec_pubkey_tweak_add(ctx, pubkey, (unsigned char *)zTweak->val);
     RETURN_LONG(result);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ecdsa_signature_normalize(resource context, resource &sigNormal, resource sig)
- * Convert a signature to a normalized lower-S form. */
-PHP_FUNCTION(secp256k1_ecdsa_signature_normalize)
+/* {{{ proto int secp256k1_ec_privkey_tweak_mul(resource context, string &key32, string tweak32)
+ * Tweak a private key by multiplying it by a tweak. */
+PHP_FUNCTION(secp256k1_ec_privkey_tweak_mul)
 {
-    zval *zCtx, *zSigIn, *zSigOut;
+    zval *zCtx, *zSecKey;
+    unsigned char newseckey[SECRETKEY_LENGTH];
+    zend_string *zTweak;
     secp256k1_context *ctx;
-    secp256k1_ecdsa_signature *sigout, *sigin;
     int result;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/r", &zCtx, &zSigOut, &zSigIn) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/S", &zCtx, &zSecKey, &zTweak) == FAILURE) {
         RETURN_LONG(0);
     }
 
@@ -1230,30 +4303,38 @@ PHP_FUNCTION(secp256k1_ecdsa_signature_normalize)
         RETURN_LONG(0);
     }
 
-    if ((sigin = php_get_secp256k1_ecdsa_signature(zSigIn)) == NULL) {
-        RETURN_LONG(0);
+    if (Z_STRLEN_P(zSecKey) != SECRETKEY_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_privkey_tweak_mul(): Parameter 2 should be 32 bytes");
+        return;
+    }
+
+    if (zTweak->len != SECRETKEY_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_privkey_tweak_mul(): Parameter 3 should be 32 bytes");
+        return;
     }
 
-    sigout = (secp256k1_ecdsa_signature *) emalloc(sizeof(secp256k1_ecdsa_signature));
-    result = secp256k1_ecdsa_signature_normalize(ctx, sigout, sigin);
+    memcpy(newseckey, Z_STRVAL_P(zSecKey), SECRETKEY_LENGTH);
+    result = secp256k1_ec_privkey_tweak_mul(ctx, newseckey, (unsigned char *) zTweak->val);
 
-    zval_dtor(zSigOut);
-    ZVAL_RES(zSigOut, zend_register_resource(sigout, le_secp256k1_sig));
+    zval_dtor(zSecKey);
+    ZVAL_STRINGL(zSecKey, (const char *) newseckey, SECRETKEY_LENGTH);
     RETURN_LONG(result);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ecdsa_verify(resource context, resource sig, string msg32, resource pubKey)
- * Verify an ECDSA signature. */
-PHP_FUNCTION(secp256k1_ecdsa_verify) {
-    zval *zCtx, *zSig, *zPubKey;
+/* {{{ proto int secp256k1_ec_pubkey_tweak_mul(resource context, resource pubKey, string tweak32)
+ * Tweak a public key by multiplying it by a tweak value. */
+PHP_FUNCTION(secp256k1_ec_pubkey_tweak_mul)
+{
+    zval *zCtx, *zPubKey;
     secp256k1_context *ctx;
-    secp256k1_ecdsa_signature *sig;
     secp256k1_pubkey *pubkey;
-    zend_string *msg32;
+    unsigned char *newpubkey;
+    size_t newpubkeylen;
+    zend_string *zTweak;
     int result;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rrSr", &zCtx, &zSig, &msg32, &zPubKey) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rzS", &zCtx, &zPubKey, &zTweak) == FAILURE) {
         RETURN_LONG(0);
     }
 
@@ -1261,323 +4342,442 @@ PHP_FUNCTION(secp256k1_ecdsa_verify) {
         RETURN_LONG(0);
     }
 
-    if ((sig = php_get_secp256k1_ecdsa_signature(zSig)) == NULL) {
+    if ((pubkey = php_get_secp256k1_pubkey(zPubKey, 2)) == NULL) {
         RETURN_LONG(0);
     }
 
-    if ((pubkey = php_get_secp256k1_pubkey(zPubKey)) == NULL) {
-        RETURN_LONG(0);
+    if (zTweak->len != SECRETKEY_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_pubkey_tweak_mul(): Parameter 3 should be 32 bytes");
+        return;
     }
 
-    result = secp256k1_ecdsa_verify(ctx, sig, (unsigned char *) msg32->val, pubkey);
+    result = secp256k1_ec_pubkey_tweak_mul(ctx, pubkey, (unsigned char *) zTweak->val);
     RETURN_LONG(result);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ecdsa_sign(resource context, resource &sig, string msg32, string key32)
- * Create an ECDSA signature. */
-PHP_FUNCTION (secp256k1_ecdsa_sign)
+/* {{{ proto int secp256k1_ec_pubkey_combine(resource context, resource &pubKey, array|Secp256k1\PublicKeyVector vPubKey)
+ * Add a number of public keys together. */
+PHP_FUNCTION(secp256k1_ec_pubkey_combine)
 {
-    zval *zCtx, *zSig, *zData = NULL;
-    zend_string *msg32, *seckey;
+    zval *arr, *zCtx, *zPubkeyCombined, *arrayZval;
     secp256k1_context *ctx;
-    secp256k1_ecdsa_signature *newsig;
-    secp256k1_nonce_function noncefp = NULL;
-    void *ndata = NULL;
-    zend_fcall_info fci = empty_fcall_info;
-    zend_fcall_info_cache fcc = empty_fcall_info_cache;
-    php_secp256k1_nonce_function_data calldata;
-    int result;
+    secp256k1_pubkey *ptr, combined;
+    php_secp256k1_pubkey_vector_obj *vec;
+    const secp256k1_pubkey ** pubkeys;
+    int result = 0;
+    size_t array_count, i = 0;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/SS|fz",
-        &zCtx, &zSig, &msg32, &seckey, &fci, &fcc, &zData) == FAILURE) {
-        RETURN_LONG(0);
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z", &zCtx, &zPubkeyCombined, &arr) == FAILURE) {
+        RETURN_LONG(result);
     }
 
     if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
-        RETURN_LONG(0);
+        RETURN_LONG(result);
     }
 
-    if (msg32->len != HASH_LENGTH) {
-        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0
-       , "secp256k1_ecdsa_sign(): Parameter 3 should be 32 bytes");
-        return;
-    }
+    if ((vec = php_get_secp256k1_pubkey_vector(arr)) != NULL) {
+        // a vector already holds the keys, only the pointers are needed
+        array_count = vec->count;
+        pubkeys = safe_emalloc(array_count, sizeof(secp256k1_pubkey *), 0);
+        for (i = 0; i < array_count; i++) {
+            pubkeys[i] = &vec->keys[i];
+        }
+    } else if (Z_TYPE_P(arr) == IS_ARRAY) {
+        array_count = (size_t) zend_hash_num_elements(Z_ARRVAL_P(arr));
+        // emalloc terminates the request if memory can't be allocated.
+        pubkeys = safe_emalloc(array_count, sizeof(secp256k1_pubkey *), 0);
+
+        ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(arr), arrayZval) {
+            if ((ptr = php_get_secp256k1_pubkey(arrayZval, 0)) == NULL) {
+                efree(pubkeys);
+                RETURN_LONG(result);
+            }
 
-    if (seckey->len != SECRETKEY_LENGTH) {
-        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0
-       , "secp256k1_ecdsa_sign(): Parameter 4 should be 32 bytes");
+            pubkeys[i++] = ptr;
+        } ZEND_HASH_FOREACH_END();
+    } else {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_pubkey_combine(): Parameter 3 should be an array or Secp256k1\\PublicKeyVector");
         return;
     }
 
-    if (ZEND_NUM_ARGS() > 4) {
-        noncefp = php_secp256k1_nonce_function_callback;
-        calldata.fci = &fci;
-        calldata.fcc = &fcc;
-        if (zData == NULL) {
-            calldata.data = NULL;
-        } else {
-            calldata.data = zData;
-        }
-        ndata = (void *) &calldata;
-    }
-
-    newsig = (secp256k1_ecdsa_signature *) emalloc(sizeof(secp256k1_ecdsa_signature));
-    result = secp256k1_ecdsa_sign(ctx, newsig, (unsigned char *) msg32->val, (unsigned char *) seckey->val, noncefp, ndata);
+    result = secp256k1_ec_pubkey_combine(ctx, &combined, pubkeys, array_count);
     if (result) {
-        zval_dtor(zSig);
-        ZVAL_RES(zSig, zend_register_resource(newsig, le_secp256k1_sig));
-    } else {
-        // only free when operation fails, won't return this resource
-        efree(newsig);
+        php_secp256k1_pubkey_out(zPubkeyCombined, &combined);
     }
+    efree(pubkeys);
 
     RETURN_LONG(result);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ec_seckey_verify(resource context, string key32)
- * Verify an ECDSA secret key. */
-PHP_FUNCTION(secp256k1_ec_seckey_verify)
+/* {{{ proto int secp256k1_bip32_master(resource context, Secp256k1\ExtendedKey &extendedKey, string seed)
+ * Derive the BIP32 master key from a seed of 16 to 64 bytes. */
+PHP_FUNCTION(secp256k1_bip32_master)
 {
-    zval *zCtx;
+    zval *zCtx, *zKey;
     secp256k1_context *ctx;
-    zend_string *seckey;
-    int result;
+    php_secp256k1_bip32_node node;
+    zend_string *seed;
+    int result = 0;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rS", &zCtx, &seckey) == FAILURE) {
-        RETURN_LONG(0);
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/S", &zCtx, &zKey, &seed) == FAILURE) {
+        RETURN_LONG(result);
     }
 
     if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
-        RETURN_LONG(0);
+        RETURN_LONG(result);
     }
 
-    if (seckey->len != SECRETKEY_LENGTH) {
-        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_seckey_verify(): Parameter 1 should be 32 bytes");
+    if (seed->len < 16 || seed->len > 64) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_bip32_master(): Parameter 3 should be between 16 and 64 bytes");
         return;
     }
 
-    result = secp256k1_ec_seckey_verify(ctx, (unsigned char *) seckey->val);
+    php_secp256k1_context_budget(zCtx, 1);
+    result = php_secp256k1_bip32_master(ctx, &node, (unsigned char *) seed->val, seed->len);
+    if (result) {
+        php_secp256k1_extended_key_out(zKey, &node);
+    }
+    ZEND_SECURE_ZERO(&node, sizeof(node));
 
     RETURN_LONG(result);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ec_pubkey_create(resource context, resource &pubKey, string key32)
- * Compute the public key for a secret key. */
-PHP_FUNCTION(secp256k1_ec_pubkey_create)
+/* {{{ proto int secp256k1_bip32_derive(resource context, Secp256k1\ExtendedKey &childKey, Secp256k1\ExtendedKey parentKey, string path)
+ * Derive a descendant of parentKey along path, such as "m/84'/0'/0'/0/5".
+ * Hardened steps are marked with ', h or H and need an extended private key.
+ * Intermediate keys are cached for the rest of the request, see
+ * secp256k1.bip32_cache_size. */
+PHP_FUNCTION(secp256k1_bip32_derive)
 {
-    zval *zCtx;
-    zval *zPubKey;
+    zval *zCtx, *zChild, *zParent;
     secp256k1_context *ctx;
-    secp256k1_pubkey *pubkey;
-    zend_string *seckey;
-    zend_resource *pubKeyResource;
-    int result;
+    php_secp256k1_bip32_node *parent, node, child;
+    uint32_t indices[BIP32_MAX_DEPTH];
+    zend_string *path;
+    size_t n, i;
+    int result = 0;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/S", &zCtx, &zPubKey, &seckey) == FAILURE) {
-        RETURN_LONG(0);
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/zS", &zCtx, &zChild, &zParent, &path) == FAILURE) {
+        RETURN_LONG(result);
     }
 
     if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
-        RETURN_LONG(0);
+        RETURN_LONG(result);
     }
 
-    if (seckey->len != SECRETKEY_LENGTH) {
-        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_pubkey_create(): Parameter 2 should be 32 bytes");
+    if ((parent = php_get_secp256k1_extended_key(zParent)) == NULL) {
+        RETURN_LONG(result);
+    }
+
+    if (!php_secp256k1_bip32_parse_path(path->val, path->len, indices, &n)) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_bip32_derive(): Parameter 4 should be a derivation path such as m/0'/1");
         return;
     }
 
-    pubkey = (secp256k1_pubkey *) emalloc(sizeof(secp256k1_pubkey));
-    result = secp256k1_ec_pubkey_create(ctx, pubkey, (unsigned char *)seckey->val);
+    // childKey and parentKey may be the same object
+    node = *parent;
+    if (node.has_private) {
+        php_secp256k1_context_budget(zCtx, (zend_long) n);
+    }
+    result = 1;
+    for (i = 0; i < n && result; i++) {
+        if ((result = php_secp256k1_bip32_derive_child(ctx, &child, &node, indices[i]))) {
+            node = child;
+        }
+    }
     if (result) {
-        zval_dtor(zPubKey);
-        ZVAL_RES(zPubKey, zend_register_resource(pubkey, le_secp256k1_pubkey));
-    } else {
-        // only free when operation fails, won't return this resource
-        efree(pubkey);
+        php_secp256k1_extended_key_out(zChild, &node);
     }
+    ZEND_SECURE_ZERO(&node, sizeof(node));
+    ZEND_SECURE_ZERO(&child, sizeof(child));
 
     RETURN_LONG(result);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ec_privkey_negate(resource context, string key32)
- * Negates a private key in place. */
-PHP_FUNCTION(secp256k1_ec_privkey_negate)
+typedef struct _php_secp256k1_bip32_derive_job {
+    php_secp256k1_bip32_node parent;
+    unsigned char fingerprint[4];
+    uint32_t start;
+    unsigned char *output;
+    size_t stride;
+    unsigned int flags;
+} php_secp256k1_bip32_derive_job;
+
+static int php_secp256k1_bip32_derive_item(const secp256k1_context *ctx, void *arg, size_t i) {
+    php_secp256k1_bip32_derive_job *job = (php_secp256k1_bip32_derive_job *) arg;
+    php_secp256k1_bip32_node child;
+    size_t pubkeylen = job->stride;
+    int result;
+    result = php_secp256k1_bip32_ckd(ctx, &child, &job->parent, job->fingerprint, job->start + (uint32_t) i)
+        && secp256k1_ec_pubkey_serialize(ctx, job->output + i * job->stride, &pubkeylen, &child.pubkey, job->flags);
+    ZEND_SECURE_ZERO(&child, sizeof(child));
+    return result;
+}
+
+/* {{{ proto int secp256k1_bip32_derive_many(resource context, string &publicKeysOut, string &valid, Secp256k1\ExtendedKey parentKey, int start, int count, int flags)
+ * Derive the public keys of children start to start + count - 1 of parentKey.
+ * publicKeysOut is set to the serialized keys in index order, 33 bytes each if
+ * flags is SECP256K1_EC_COMPRESSED and 65 bytes otherwise. The key of an index
+ * which can't be derived is left zeroed, and valid is set to a bitmap with bit
+ * i set if child start + i was derived. */
+PHP_FUNCTION(secp256k1_bip32_derive_many)
 {
-    zval *zCtx, *zPrivKey;
+    zval *zCtx, *zPubOut, *zValid, *zParent;
     secp256k1_context *ctx;
-    int result;
+    php_secp256k1_bip32_node *parent;
+    php_secp256k1_bip32_derive_job job;
+    zend_string *output, *bitmap;
+    zend_long start, count, flags;
+    int result = 0;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/", &zCtx, &zPrivKey) == FAILURE) {
-        RETURN_LONG(0);
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z/zlll", &zCtx, &zPubOut, &zValid, &zParent, &start, &count, &flags) == FAILURE) {
+        RETURN_LONG(result);
     }
 
     if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
-        RETURN_LONG(0);
+        RETURN_LONG(result);
     }
 
-    if (Z_STRLEN_P(zPrivKey) != SECRETKEY_LENGTH) {
-        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_privkey_negate(): Parameter 2 should be 32 bytes");
+    if ((parent = php_get_secp256k1_extended_key(zParent)) == NULL) {
+        RETURN_LONG(result);
+    }
+
+    if (start < 0 || (uint64_t) start > 0xffffffffu) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_bip32_derive_many(): Parameter 5 should be a child index");
         return;
     }
 
-    unsigned char newseckey[SECRETKEY_LENGTH];
-    memcpy(newseckey, Z_STRVAL_P(zPrivKey), SECRETKEY_LENGTH);
-    result = secp256k1_ec_privkey_negate(ctx, newseckey);
+    if (count < 0 || (uint64_t) start + (uint64_t) count > ((uint64_t) 1 << 32)) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_bip32_derive_many(): Parameter 6 should not be negative or run past the last child index");
+        return;
+    }
 
-    zval_dtor(zPrivKey);
-    ZVAL_STRINGL(zPrivKey, (char *)&newseckey, SECRETKEY_LENGTH);
+    if (flags != SECP256K1_EC_COMPRESSED && flags != SECP256K1_EC_UNCOMPRESSED) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_bip32_derive_many(): Parameter 7 should be SECP256K1_EC_COMPRESSED or SECP256K1_EC_UNCOMPRESSED");
+        return;
+    }
+
+    // the children are leaves: they bypass the cache, which the workers
+    // could not touch anyway
+    job.parent = *parent;
+    php_secp256k1_bip32_fingerprint(parent, job.fingerprint);
+    job.start = (uint32_t) start;
+    job.stride = (flags == SECP256K1_EC_COMPRESSED) ? PUBKEY_COMPRESSED_LENGTH : PUBKEY_UNCOMPRESSED_LENGTH;
+    job.flags = (unsigned int) flags;
+    output = zend_string_safe_alloc((size_t) count, job.stride, 0, 0);
+    memset(output->val, 0, output->len + 1);
+    job.output = (unsigned char *) output->val;
+    bitmap = zend_string_alloc(BITMAP_LENGTH((size_t) count), 0);
+    memset(bitmap->val, 0, bitmap->len + 1);
+    if (parent->has_private) {
+        php_secp256k1_context_budget(zCtx, count);
+    }
+    result = php_secp256k1_batch(ctx, php_secp256k1_bip32_derive_item, &job, (size_t) count, (unsigned char *) bitmap->val);
+    ZEND_SECURE_ZERO(&job.parent, sizeof(job.parent));
+
+    zval_dtor(zPubOut);
+    ZVAL_STR(zPubOut, output);
+    zval_dtor(zValid);
+    ZVAL_STR(zValid, bitmap);
 
     RETURN_LONG(result);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ec_pubkey_negate(resource ctx, resource pubkey)
- * Negates a public key in place. */
-PHP_FUNCTION(secp256k1_ec_pubkey_negate)
+/* {{{ proto int secp256k1_bip32_serialize(resource context, string &extendedKeyOut, Secp256k1\ExtendedKey extendedKey, int version)
+ * Serialize an extended key to the 78 bytes which are base58check encoded as
+ * xprv/xpub strings. The secret key is serialized if the key holds one, so
+ * version should match: 0x0488ade4 for xprv and 0x0488b21e for xpub. */
+PHP_FUNCTION(secp256k1_bip32_serialize)
 {
-    zval *zCtx, *zPubKey;
-    secp256k1_context *ctx;
-    secp256k1_pubkey *pubkey;
-    int result;
+    zval *zCtx, *zOut, *zKey;
+    php_secp256k1_bip32_node *node;
+    zend_string *output;
+    zend_long version;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rr", &zCtx, &zPubKey) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/zl", &zCtx, &zOut, &zKey, &version) == FAILURE) {
         RETURN_LONG(0);
     }
 
-    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+    if (php_get_secp256k1_context(zCtx) == NULL) {
         RETURN_LONG(0);
     }
 
-    if ((pubkey = php_get_secp256k1_pubkey(zPubKey)) == NULL) {
+    if ((node = php_get_secp256k1_extended_key(zKey)) == NULL) {
         RETURN_LONG(0);
     }
 
-    result = secp256k1_ec_pubkey_negate(ctx, pubkey);
+    if (version < 0 || (uint64_t) version > 0xffffffffu) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_bip32_serialize(): Parameter 4 should be a 32 bit version");
+        return;
+    }
 
-    RETURN_LONG(result);
+    output = zend_string_alloc(BIP32_SERIALIZED_LENGTH, 0);
+    php_secp256k1_bip32_serialize(node, (uint32_t) version, (unsigned char *) output->val);
+    output->val[BIP32_SERIALIZED_LENGTH] = '\0';
+
+    zval_dtor(zOut);
+    ZVAL_STR(zOut, output);
+
+    RETURN_LONG(1);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ec_pubkey_parse(resource secp256k1_context, resource &pubKey, string pubKeyIn)
- * Parse a variable-length public key into the pubkey object. */
-PHP_FUNCTION(secp256k1_ec_pubkey_parse)
+/* {{{ proto int secp256k1_bip32_parse(resource context, Secp256k1\ExtendedKey &extendedKey, string extendedKeyIn, int &version = null)
+ * Parse a 78 byte serialized extended key. The version is returned for the
+ * caller to check, it does not decide whether a key is private. */
+PHP_FUNCTION(secp256k1_bip32_parse)
 {
-    zval *zCtx, *zPubKey;
+    zval *zCtx, *zKey, *zVersion = NULL;
     secp256k1_context *ctx;
-    secp256k1_pubkey *pubkey;
-    zend_string *pubkeyin;
-    int result;
+    php_secp256k1_bip32_node node;
+    zend_string *input;
+    uint32_t version;
+    int result = 0;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/S", &zCtx, &zPubKey, &pubkeyin) == FAILURE) {
-        RETURN_LONG(0);
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/S|z/", &zCtx, &zKey, &input, &zVersion) == FAILURE) {
+        RETURN_LONG(result);
     }
 
     if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
-        RETURN_LONG(0);
+        RETURN_LONG(result);
     }
 
-    pubkey = (secp256k1_pubkey *) emalloc(sizeof(secp256k1_pubkey));
-    result = secp256k1_ec_pubkey_parse(ctx, pubkey, (unsigned char *)pubkeyin->val, pubkeyin->len);
+    if (input->len != BIP32_SERIALIZED_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_bip32_parse(): Parameter 3 should be 78 bytes");
+        return;
+    }
+
+    result = php_secp256k1_bip32_parse(ctx, &node, &version, (unsigned char *) input->val);
     if (result) {
-        zval_dtor(zPubKey);
-        ZVAL_RES(zPubKey, zend_register_resource(pubkey, le_secp256k1_pubkey));
-    } else {
-        // only free when operation fails, won't return this resource
-        efree(pubkey);
+        php_secp256k1_extended_key_out(zKey, &node);
+        if (zVersion != NULL) {
+            zval_dtor(zVersion);
+            ZVAL_LONG(zVersion, (zend_long) version);
+        }
     }
+    ZEND_SECURE_ZERO(&node, sizeof(node));
 
     RETURN_LONG(result);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ec_pubkey_serialize(resource context, string &pubKeyOut, resource pubKey, long flags)
- * Serialize a pubkey object into a serialized byte sequence. */
-PHP_FUNCTION(secp256k1_ec_pubkey_serialize)
+/* {{{ proto int secp256k1_bip32_neuter(resource context, Secp256k1\ExtendedKey &publicKey, Secp256k1\ExtendedKey extendedKey)
+ * Convert an extended key to the extended public key, dropping the secret key. */
+PHP_FUNCTION(secp256k1_bip32_neuter)
 {
-    zval *zCtx, *zPubKey, *zPubOut;
-    secp256k1_context *ctx;
-    secp256k1_pubkey * pubkey;
-    int result;
-    size_t pubkeylen;
-    zend_long flags;
+    zval *zCtx, *zOut, *zKey;
+    php_secp256k1_bip32_node *key, node;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/rl", &zCtx, &zPubOut, &zPubKey, &flags) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z", &zCtx, &zOut, &zKey) == FAILURE) {
         RETURN_LONG(0);
     }
 
-    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+    if (php_get_secp256k1_context(zCtx) == NULL) {
         RETURN_LONG(0);
     }
 
-    if ((pubkey = php_get_secp256k1_pubkey(zPubKey)) == NULL) {
+    if ((key = php_get_secp256k1_extended_key(zKey)) == NULL) {
         RETURN_LONG(0);
     }
 
-    pubkeylen = (flags == SECP256K1_EC_COMPRESSED) ? PUBKEY_COMPRESSED_LENGTH : PUBKEY_UNCOMPRESSED_LENGTH;
+    node = *key;
+    node.has_private = 0;
+    ZEND_SECURE_ZERO(node.seckey, sizeof(node.seckey));
+    php_secp256k1_extended_key_out(zOut, &node);
 
-    unsigned char pubkeyout[PUBKEY_UNCOMPRESSED_LENGTH];
-    result = secp256k1_ec_pubkey_serialize(ctx, pubkeyout, &pubkeylen, pubkey, flags);
+    RETURN_LONG(1);
+}
+/* }}} */
 
-    zval_dtor(zPubOut);
-    ZVAL_STRINGL(zPubOut, (char *)&pubkeyout, pubkeylen);
+/* {{{ proto int secp256k1_bip32_pubkey(resource context, resource &pubKey, Secp256k1\ExtendedKey extendedKey)
+ * Return the public key of an extended key. */
+PHP_FUNCTION(secp256k1_bip32_pubkey)
+{
+    zval *zCtx, *zPubKey, *zKey;
+    php_secp256k1_bip32_node *node;
 
-    RETURN_LONG(result);
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z", &zCtx, &zPubKey, &zKey) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if (php_get_secp256k1_context(zCtx) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    if ((node = php_get_secp256k1_extended_key(zKey)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    php_secp256k1_pubkey_out(zPubKey, &node->pubkey);
+
+    RETURN_LONG(1);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ec_privkey_tweak_add(resource context, string &key32, string tweak32)
- * Tweak a private key by adding tweak to it. */
-PHP_FUNCTION(secp256k1_ec_privkey_tweak_add)
+/* {{{ proto int secp256k1_bip32_seckey(resource context, string &key32, Secp256k1\ExtendedKey extendedKey)
+ * Return the secret key of an extended private key. Returns 0 for an extended
+ * public key. */
+PHP_FUNCTION(secp256k1_bip32_seckey)
 {
-    zval *zCtx, *zSecKey;
-    secp256k1_context *ctx;
-    zend_string *zTweak;
-    unsigned char *tweak;
-    unsigned char newseckey[SECRETKEY_LENGTH];
-    int result;
+    zval *zCtx, *zSecKey, *zKey;
+    php_secp256k1_bip32_node *node;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/S", &zCtx, &zSecKey, &zTweak) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z", &zCtx, &zSecKey, &zKey) == FAILURE) {
         RETURN_LONG(0);
     }
 
-    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+    if (php_get_secp256k1_context(zCtx) == NULL) {
         RETURN_LONG(0);
     }
 
-    if (Z_STRLEN_P(zSecKey) != SECRETKEY_LENGTH) {
-        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_privkey_tweak_add(): Parameter 2 should be 32 bytes");
-        return;
+    if ((node = php_get_secp256k1_extended_key(zKey)) == NULL) {
+        RETURN_LONG(0);
     }
 
-    if (zTweak->len != SECRETKEY_LENGTH) {
-        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_privkey_tweak_add(): Parameter 3 should be 32 bytes");
-        return;
+    if (!node->has_private) {
+        RETURN_LONG(0);
     }
 
-    memcpy(newseckey, Z_STRVAL_P(zSecKey), SECRETKEY_LENGTH);
-    result = secp256k1_ec_privkey_tweak_add(ctx, newseckey, (unsigned char *) zTweak->val);
-
     zval_dtor(zSecKey);
-    ZVAL_STRINGL(zSecKey, (const char *) newseckey, SECRETKEY_LENGTH);
-    RETURN_LONG(result);
+    ZVAL_STRINGL(zSecKey, (char *) node->seckey, SECRETKEY_LENGTH);
+
+    RETURN_LONG(1);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ec_pubkey_tweak_add(resource context, resource pubKey, string tweak32)
- * Tweak a public key by adding tweak times the generator to it. */
-PHP_FUNCTION(secp256k1_ec_pubkey_tweak_add)
+// reads a bech32 human readable part for a witness program of proglen
+// bytes, or defaults to mainnet
+static int php_secp256k1_address_hrp(zend_string *hrp, size_t proglen, const char **out, size_t *outlen) {
+    if (hrp == NULL) {
+        *out = "bc";
+        *outlen = 2;
+        return 1;
+    }
+    *out = hrp->val;
+    *outlen = hrp->len;
+    return php_secp256k1_bech32_hrp_valid(hrp->val, hrp->len, proglen);
+}
+
+/* {{{ proto int secp256k1_address_p2pkh(resource context, string &addressOut, resource pubKey, int version = 0)
+ * Encode the P2PKH address of the compressed public key. version is the
+ * base58check version byte, 0 for mainnet and 111 for testnet. */
+PHP_FUNCTION(secp256k1_address_p2pkh)
 {
-    zval *zCtx, *zPubKey;
+    zval *zCtx, *zAddress, *zPubKey;
     secp256k1_context *ctx;
     secp256k1_pubkey *pubkey;
-    zend_string *zTweak;
-    int result;
+    unsigned char pubkey33[PUBKEY_COMPRESSED_LENGTH];
+    size_t pubkeylen = PUBKEY_COMPRESSED_LENGTH;
+    char address[ADDRESS_MAX_LENGTH];
+    zend_long version = 0;
+    size_t len;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rrS", &zCtx, &zPubKey, &zTweak) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z|l", &zCtx, &zAddress, &zPubKey, &version) == FAILURE) {
         RETURN_LONG(0);
     }
 
@@ -1585,31 +4785,41 @@ PHP_FUNCTION(secp256k1_ec_pubkey_tweak_add)
         RETURN_LONG(0);
     }
 
-    if ((pubkey = php_get_secp256k1_pubkey(zPubKey)) == NULL) {
+    if ((pubkey = php_get_secp256k1_pubkey(zPubKey, 3)) == NULL) {
         RETURN_LONG(0);
     }
 
-    if (zTweak->len != SECRETKEY_LENGTH) {
-        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_pubkey_tweak_add(): Parameter 3 should be 32 bytes");
+    if (version < 0 || version > 255) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_address_p2pkh(): Parameter 4 should be a version byte");
         return;
     }
 
-    result = secp256k1_ec_pubkey_tweak_add(ctx, pubkey, (unsigned char *)zTweak->val);
-    RETURN_LONG(result);
+    secp256k1_ec_pubkey_serialize(ctx, pubkey33, &pubkeylen, pubkey, SECP256K1_EC_COMPRESSED);
+    len = php_secp256k1_address_p2pkh(address, (unsigned char) version, pubkey33, pubkeylen);
+
+    zval_dtor(zAddress);
+    ZVAL_STRINGL(zAddress, address, len);
+
+    RETURN_LONG(1);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ec_privkey_tweak_mul(resource context, string &key32, string tweak32)
- * Tweak a private key by multiplying it by a tweak. */
-PHP_FUNCTION(secp256k1_ec_privkey_tweak_mul)
+/* {{{ proto int secp256k1_address_p2wpkh(resource context, string &addressOut, resource pubKey, string hrp = "bc")
+ * Encode the P2WPKH (segwit v0) address of the compressed public key, under
+ * hrp: "bc" for mainnet and "tb" for testnet. */
+PHP_FUNCTION(secp256k1_address_p2wpkh)
 {
-    zval *zCtx, *zSecKey;
-    unsigned char newseckey[SECRETKEY_LENGTH];
-    zend_string *zTweak;
+    zval *zCtx, *zAddress, *zPubKey;
     secp256k1_context *ctx;
-    int result;
-
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/S", &zCtx, &zSecKey, &zTweak) == FAILURE) {
+    secp256k1_pubkey *pubkey;
+    unsigned char pubkey33[PUBKEY_COMPRESSED_LENGTH];
+    size_t pubkeylen = PUBKEY_COMPRESSED_LENGTH;
+    char address[ADDRESS_MAX_LENGTH];
+    zend_string *zHrp = NULL;
+    const char *hrp;
+    size_t hrplen, len;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z|S!", &zCtx, &zAddress, &zPubKey, &zHrp) == FAILURE) {
         RETURN_LONG(0);
     }
 
@@ -1617,38 +4827,44 @@ PHP_FUNCTION(secp256k1_ec_privkey_tweak_mul)
         RETURN_LONG(0);
     }
 
-    if (Z_STRLEN_P(zSecKey) != SECRETKEY_LENGTH) {
-        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_privkey_tweak_mul(): Parameter 2 should be 32 bytes");
-        return;
+    if ((pubkey = php_get_secp256k1_pubkey(zPubKey, 3)) == NULL) {
+        RETURN_LONG(0);
     }
 
-    if (zTweak->len != SECRETKEY_LENGTH) {
-        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_privkey_tweak_mul(): Parameter 3 should be 32 bytes");
+    if (!php_secp256k1_address_hrp(zHrp, 20, &hrp, &hrplen)) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_address_p2wpkh(): Parameter 4 should be a lowercase human readable part of 1 to %d characters", (int) BECH32_MAX_HRP_LENGTH(20));
         return;
     }
 
-    memcpy(newseckey, Z_STRVAL_P(zSecKey), SECRETKEY_LENGTH);
-    result = secp256k1_ec_privkey_tweak_mul(ctx, newseckey, (unsigned char *) zTweak->val);
+    secp256k1_ec_pubkey_serialize(ctx, pubkey33, &pubkeylen, pubkey, SECP256K1_EC_COMPRESSED);
+    len = php_secp256k1_address_p2wpkh(address, hrp, hrplen, pubkey33);
 
-    zval_dtor(zSecKey);
-    ZVAL_STRINGL(zSecKey, (const char *) newseckey, SECRETKEY_LENGTH);
-    RETURN_LONG(result);
+    zval_dtor(zAddress);
+    ZVAL_STRINGL(zAddress, address, len);
+
+    RETURN_LONG(1);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ec_pubkey_tweak_mul(resource context, resource pubKey, string tweak32)
- * Tweak a public key by multiplying it by a tweak value. */
-PHP_FUNCTION(secp256k1_ec_pubkey_tweak_mul)
+#ifdef SECP256K1_MODULE_EXTRAKEYS
+/* {{{ proto int secp256k1_address_p2tr(resource context, string &addressOut, resource xonlyPubKey, string hrp = "bc", bool tweak = true)
+ * Encode the P2TR (segwit v1) address of an x-only public key, under hrp. By
+ * default the key is the internal key and is tweaked without a script tree,
+ * as BIP86 wallets do. Pass tweak = false if it is the output key already. */
+PHP_FUNCTION(secp256k1_address_p2tr)
 {
-    zval *zCtx, *zPubKey;
+    zval *zCtx, *zAddress, *zPubKey;
     secp256k1_context *ctx;
-    secp256k1_pubkey *pubkey;
-    unsigned char *newpubkey;
-    size_t newpubkeylen;
-    zend_string *zTweak;
+    secp256k1_xonly_pubkey *pubkey;
+    unsigned char output32[32];
+    char address[ADDRESS_MAX_LENGTH];
+    zend_string *zHrp = NULL;
+    zend_bool tweak = 1;
+    const char *hrp;
+    size_t hrplen, len;
     int result;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rrS", &zCtx, &zPubKey, &zTweak) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z|S!b", &zCtx, &zAddress, &zPubKey, &zHrp, &tweak) == FAILURE) {
         RETURN_LONG(0);
     }
 
@@ -1656,35 +4872,96 @@ PHP_FUNCTION(secp256k1_ec_pubkey_tweak_mul)
         RETURN_LONG(0);
     }
 
-    if ((pubkey = php_get_secp256k1_pubkey(zPubKey)) == NULL) {
+    if ((pubkey = php_get_secp256k1_xonly_pubkey(zPubKey, 3)) == NULL) {
         RETURN_LONG(0);
     }
 
-    if (zTweak->len != SECRETKEY_LENGTH) {
-        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ec_pubkey_tweak_mul(): Parameter 3 should be 32 bytes");
+    if (!php_secp256k1_address_hrp(zHrp, 32, &hrp, &hrplen)) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_address_p2tr(): Parameter 4 should be a lowercase human readable part of 1 to %d characters", (int) BECH32_MAX_HRP_LENGTH(32));
         return;
     }
 
-    result = secp256k1_ec_pubkey_tweak_mul(ctx, pubkey, (unsigned char *) zTweak->val);
+    if (tweak) {
+        result = php_secp256k1_taproot_output_key(ctx, output32, pubkey);
+    } else {
+        result = secp256k1_xonly_pubkey_serialize(ctx, output32, pubkey);
+    }
+    if (result) {
+        len = php_secp256k1_segwit_encode(address, hrp, hrplen, 1, output32, sizeof(output32));
+        zval_dtor(zAddress);
+        ZVAL_STRINGL(zAddress, address, len);
+    }
+
     RETURN_LONG(result);
 }
 /* }}} */
+#endif
 
-/* {{{ proto int secp256k1_ec_pubkey_combine(resource context, resource &pubKey, resource[] vPubKey)
- * Add a number of public keys together. */
-PHP_FUNCTION(secp256k1_ec_pubkey_combine)
+typedef struct _php_secp256k1_address_job {
+    const unsigned char *keys;
+    size_t stride;
+    zend_long type;
+    unsigned char version;
+    const char *hrp;
+    size_t hrplen;
+    char *output;
+} php_secp256k1_address_job;
+
+static int php_secp256k1_address_item(const secp256k1_context *ctx, void *arg, size_t i) {
+    php_secp256k1_address_job *job = (php_secp256k1_address_job *) arg;
+    const unsigned char *key = job->keys + i * job->stride;
+    char *out = job->output + i * ADDRESS_MAX_LENGTH;
+    secp256k1_pubkey pubkey;
+#ifdef SECP256K1_MODULE_EXTRAKEYS
+    secp256k1_xonly_pubkey xonly;
+    unsigned char output32[32];
+#endif
+
+    switch (job->type) {
+        case SECP256K1_ADDRESS_P2PKH:
+        case SECP256K1_ADDRESS_P2WPKH:
+            // parsing only validates, the address commits to the bytes given
+            if (!secp256k1_ec_pubkey_parse(ctx, &pubkey, key, PUBKEY_COMPRESSED_LENGTH)) {
+                return 0;
+            }
+            if (job->type == SECP256K1_ADDRESS_P2PKH) {
+                php_secp256k1_address_p2pkh(out, job->version, key, PUBKEY_COMPRESSED_LENGTH);
+            } else {
+                php_secp256k1_address_p2wpkh(out, job->hrp, job->hrplen, key);
+            }
+            return 1;
+#ifdef SECP256K1_MODULE_EXTRAKEYS
+        case SECP256K1_ADDRESS_P2TR:
+            if (!secp256k1_xonly_pubkey_parse(ctx, &xonly, key)
+                || !php_secp256k1_taproot_output_key(ctx, output32, &xonly)) {
+                return 0;
+            }
+            php_secp256k1_segwit_encode(out, job->hrp, job->hrplen, 1, output32, sizeof(output32));
+            return 1;
+#endif
+    }
+    return 0;
+}
+
+/* {{{ proto int secp256k1_address_many(resource context, array &addressesOut, string &valid, int type, string publicKeys, mixed prefix = null)
+ * Encode the addresses of a string of concatenated public keys: 33 byte
+ * compressed keys for SECP256K1_ADDRESS_P2PKH and SECP256K1_ADDRESS_P2WPKH,
+ * 32 byte x-only internal keys for SECP256K1_ADDRESS_P2TR, which are tweaked
+ * as secp256k1_address_p2tr does by default. prefix is the version byte for
+ * P2PKH and the human readable part otherwise, defaulting to mainnet.
+ * addressesOut is set to the addresses in input order with null for invalid
+ * keys, and valid is set to a bitmap with bit i set if key i was valid. */
+PHP_FUNCTION(secp256k1_address_many)
 {
-    zval *arr, *zCtx, *zPubkeyCombined, *arrayZval;
+    zval *zCtx, *zAddresses, *zValid, *zPrefix = NULL;
     secp256k1_context *ctx;
-    secp256k1_pubkey *ptr, *combined;
-    zend_string *arrayKeyStr;
-    HashTable *arr_hash;
-    HashPosition pointer;
-    const secp256k1_pubkey ** pubkeys;
-    int result = 0, i = 0;
-    size_t array_count;
+    php_secp256k1_address_job job;
+    zend_string *keys, *bitmap;
+    zend_long type;
+    size_t n, i;
+    int result = 0;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/a", &zCtx, &zPubkeyCombined, &arr) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z/lS|z!", &zCtx, &zAddresses, &zValid, &type, &keys, &zPrefix) == FAILURE) {
         RETURN_LONG(result);
     }
 
@@ -1692,35 +4969,141 @@ PHP_FUNCTION(secp256k1_ec_pubkey_combine)
         RETURN_LONG(result);
     }
 
-    arr_hash = Z_ARRVAL_P(arr);
-    array_count = (size_t) zend_hash_num_elements(arr_hash);
-    // emalloc terminates the request if memory can't be allocated.
-    pubkeys = emalloc(sizeof(secp256k1_pubkey *) * array_count);
+    job.type = type;
+    job.version = 0;
+    job.hrp = "bc";
+    job.hrplen = 2;
+    switch (type) {
+        case SECP256K1_ADDRESS_P2PKH:
+        case SECP256K1_ADDRESS_P2WPKH:
+            job.stride = PUBKEY_COMPRESSED_LENGTH;
+            break;
+#ifdef SECP256K1_MODULE_EXTRAKEYS
+        case SECP256K1_ADDRESS_P2TR:
+            job.stride = 32;
+            break;
+#endif
+        default:
+            zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_address_many(): Parameter 4 should be a SECP256K1_ADDRESS_* constant");
+            return;
+    }
 
-    ZEND_HASH_FOREACH_KEY_VAL(arr_hash, i, arrayKeyStr, arrayZval) {
-        if ((ptr = php_get_secp256k1_pubkey(arrayZval)) == NULL) {
-            efree(pubkeys);
-            RETURN_LONG(result);
-        }
+    if (keys->len % job.stride != 0) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_address_many(): Parameter 5 should be a multiple of %d bytes long", (int) job.stride);
+        return;
+    }
 
-        pubkeys[i++] = ptr;
-    } ZEND_HASH_FOREACH_END();
+    if (zPrefix != NULL && type == SECP256K1_ADDRESS_P2PKH) {
+        if (Z_TYPE_P(zPrefix) != IS_LONG || Z_LVAL_P(zPrefix) < 0 || Z_LVAL_P(zPrefix) > 255) {
+            zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_address_many(): Parameter 6 should be a version byte for SECP256K1_ADDRESS_P2PKH");
+            return;
+        }
+        job.version = (unsigned char) Z_LVAL_P(zPrefix);
+    } else if (zPrefix != NULL) {
+        // P2WPKH commits to a 20 byte key hash, P2TR to a 32 byte output key
+        size_t proglen = type == SECP256K1_ADDRESS_P2WPKH ? 20 : 32;
+        if (Z_TYPE_P(zPrefix) != IS_STRING || !php_secp256k1_address_hrp(Z_STR_P(zPrefix), proglen, &job.hrp, &job.hrplen)) {
+            zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_address_many(): Parameter 6 should be a lowercase human readable part of 1 to %d characters", (int) BECH32_MAX_HRP_LENGTH(proglen));
+            return;
+        }
+    }
 
-    combined = (secp256k1_pubkey *) emalloc(sizeof(secp256k1_pubkey));
-    result = secp256k1_ec_pubkey_combine(ctx, combined, pubkeys, array_count);
-    if (result) {
-        zval_dtor(zPubkeyCombined);
-        ZVAL_RES(zPubkeyCombined, zend_register_resource(combined, le_secp256k1_pubkey));
-    } else {
-        // free when operation fails, won't return this resource
-        efree(combined);
+    // addresses are encoded into fixed slots by the workers, the zvals are
+    // only built here
+    n = keys->len / job.stride;
+    job.keys = (const unsigned char *) keys->val;
+    job.output = safe_emalloc(n, ADDRESS_MAX_LENGTH, 0);
+    bitmap = zend_string_alloc(BITMAP_LENGTH(n), 0);
+    memset(bitmap->val, 0, bitmap->len + 1);
+    result = php_secp256k1_batch(ctx, php_secp256k1_address_item, &job, n, (unsigned char *) bitmap->val);
+
+    zval_dtor(zAddresses);
+    array_init_size(zAddresses, (uint32_t) n);
+    for (i = 0; i < n; i++) {
+        if (BITMAP_GET((unsigned char *) bitmap->val, i)) {
+            add_next_index_string(zAddresses, job.output + i * ADDRESS_MAX_LENGTH);
+        } else {
+            add_next_index_null(zAddresses);
+        }
     }
-    efree(pubkeys);
+    efree(job.output);
+    zval_dtor(zValid);
+    ZVAL_STR(zValid, bitmap);
 
     RETURN_LONG(result);
 }
 /* }}} */
 
+/* {{{ proto int secp256k1_sha256(string &hashOut, string data)
+ * Compute the SHA256 hash of data. */
+PHP_FUNCTION(secp256k1_sha256)
+{
+    zval *zHash;
+    zend_string *data;
+    php_secp256k1_sha256 hash;
+    unsigned char out[HASH_LENGTH];
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "z/S", &zHash, &data) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    php_secp256k1_sha256_init(&hash);
+    php_secp256k1_sha256_write(&hash, (unsigned char *) data->val, data->len);
+    php_secp256k1_sha256_finalize(&hash, out);
+
+    zval_dtor(zHash);
+    ZVAL_STRINGL(zHash, (char *) out, HASH_LENGTH);
+
+    RETURN_LONG(1);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_tagged_sha256(string &hashOut, string tag, string data)
+ * Compute the BIP-340 tagged hash SHA256(SHA256(tag) || SHA256(tag) || data).
+ * The prefix of the BIP-340 and BIP-341 tags is precomputed. */
+PHP_FUNCTION(secp256k1_tagged_sha256)
+{
+    zval *zHash;
+    zend_string *tag, *data;
+    php_secp256k1_sha256 hash;
+    unsigned char out[HASH_LENGTH];
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "z/SS", &zHash, &tag, &data) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    php_secp256k1_sha256_init_tagged(&hash, (unsigned char *) tag->val, tag->len);
+    php_secp256k1_sha256_write(&hash, (unsigned char *) data->val, data->len);
+    php_secp256k1_sha256_finalize(&hash, out);
+
+    zval_dtor(zHash);
+    ZVAL_STRINGL(zHash, (char *) out, HASH_LENGTH);
+
+    RETURN_LONG(1);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_hmac_sha256(string &hashOut, string key, string data)
+ * Compute HMAC-SHA256 of data under key. */
+PHP_FUNCTION(secp256k1_hmac_sha256)
+{
+    zval *zHash;
+    zend_string *key, *data;
+    unsigned char out[HASH_LENGTH];
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "z/SS", &zHash, &key, &data) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    php_secp256k1_hmac_sha256((unsigned char *) key->val, key->len, (unsigned char *) data->val, data->len, out);
+
+    zval_dtor(zHash);
+    ZVAL_STRINGL(zHash, (char *) out, HASH_LENGTH);
+
+    RETURN_LONG(1);
+}
+/* }}} */
+
 /* {{{ proto resource secp256k1_scratch_space_create(resource context, long size)
  * Return a pointer to a scratch space. Some extra bytes are required for accounting. */
 PHP_FUNCTION(secp256k1_scratch_space_create)
@@ -1791,29 +5174,6 @@ static int php_nonce_function_extract_algo(zval *zAlgo16, unsigned char **algo16
     }
 }
 
-// zData may be any type, however this function is only used in the rfc6979
-// and schnorrsig nonce functions, so it returns a negative result if
-// the value is not NULL or a string. if it's a string value, it's length
-// must be 32 bytes.
-static int php_nonce_function_extract_data(zval *zData, unsigned char **data)
-{
-    // read arbitrary data pointer. enforce expectations of secp256k1_nonce_function_bipschnorr.
-    switch (Z_TYPE_P(zData)) {
-        case IS_STRING:
-            if (Z_STRLEN_P(zData) != 32) {
-                return 0;
-            }
-            *data = (unsigned char *) Z_STRVAL_P(zData);
-            return 1;
-        case IS_NULL:
-            *data = NULL;
-            return 1;
-        default:
-            // rfc6979 expects a 32byte string or NULL.
-            return 0;
-    }
-}
-
 // php_nonce_function_rfc6979 provides a PHP-typed analog for secp256k1_nonce_function_rfc6979.
 static int php_nonce_function_rfc6979(zval *zNonce32, zend_string *zMsg32, zend_string *zKey32, zval *zAlgo16, zval *zData, unsigned int attempt)
 {
@@ -1933,7 +5293,7 @@ PHP_FUNCTION(secp256k1_ecdsa_recoverable_signature_convert)
 {
     zval *zCtx, *zNormalSig, *zRecoverableSig;
     secp256k1_context *ctx;
-    secp256k1_ecdsa_signature * nSig;
+    secp256k1_ecdsa_signature nSig;
     secp256k1_ecdsa_recoverable_signature * rSig;
     int result;
 
@@ -1949,12 +5309,10 @@ PHP_FUNCTION(secp256k1_ecdsa_recoverable_signature_convert)
         RETURN_LONG(0);
     }
 
-    nSig = emalloc(sizeof(secp256k1_ecdsa_recoverable_signature));
-    result = secp256k1_ecdsa_recoverable_signature_convert(ctx, nSig, rSig);
+    result = secp256k1_ecdsa_recoverable_signature_convert(ctx, &nSig, rSig);
 
-    zval_dtor(zNormalSig);
-    ZVAL_RES(zNormalSig, zend_register_resource(nSig, le_secp256k1_sig));
-    // convert() can't fail, so we'll always return the resource here
+    // convert() can't fail, so we'll always return the signature here
+    php_secp256k1_ecdsa_signature_out(zNormalSig, &nSig);
 
     RETURN_LONG(result);
 }
@@ -1964,47 +5322,242 @@ PHP_FUNCTION(secp256k1_ecdsa_recoverable_signature_convert)
  * Serialize an ECDSA signature in compact format (64 bytes + recovery id). */
 PHP_FUNCTION(secp256k1_ecdsa_recoverable_signature_serialize_compact)
 {
-    zval *zCtx, *zRecSig, *zSigOut, *zRecId;
+    zval *zCtx, *zRecSig, *zSigOut, *zRecId;
+    secp256k1_context *ctx;
+    secp256k1_ecdsa_recoverable_signature *recsig;
+    unsigned char sig[COMPACT_SIGNATURE_LENGTH];
+    int result, recid;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z/r", &zCtx, &zSigOut, &zRecId, &zRecSig) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    if ((recsig = php_get_secp256k1_ecdsa_recoverable_signature(zRecSig)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    result = secp256k1_ecdsa_recoverable_signature_serialize_compact(ctx, sig, &recid, recsig);
+
+    zval_dtor(zSigOut);
+    ZVAL_STRINGL(zSigOut, (const char *) sig, COMPACT_SIGNATURE_LENGTH);
+
+    zval_dtor(zRecId);
+    ZVAL_LONG(zRecId, recid);
+
+    RETURN_LONG(result);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_ecdsa_sign_recoverable(resource context, resource &sig, string msg32, string key32)
+ * Create a recoverable ECDSA signature. */
+PHP_FUNCTION(secp256k1_ecdsa_sign_recoverable)
+{
+    zval *zCtx, *zSig;
+    secp256k1_context *ctx;
+    zend_string *msg32, *seckey;
+    secp256k1_ecdsa_recoverable_signature *newsig;
+    int result;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/SS", &zCtx, &zSig, &msg32, &seckey) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    if (msg32->len != HASH_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ecdsa_sign_recoverable(): Parameter 2 should be 32 bytes");
+        return;
+    }
+
+    if (seckey->len != SECRETKEY_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ecdsa_sign_recoverable(): Parameter 3 should be 32 bytes");
+        return;
+    }
+
+    newsig = emalloc(sizeof(secp256k1_ecdsa_recoverable_signature));
+    php_secp256k1_context_budget(zCtx, 1);
+    result = secp256k1_ecdsa_sign_recoverable(ctx, newsig, (const unsigned char *) msg32->val, (const unsigned char *) seckey->val, 0, 0);
+    if (result) {
+        zval_dtor(zSig);
+        ZVAL_RES(zSig, zend_register_resource(newsig, le_secp256k1_recoverable_sig));
+    } else {
+        // free when operation fails, won't return this resource
+        efree(newsig);
+    }
+
+    RETURN_LONG(result);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_ecdsa_recover(resource context, resource &pubKey, resource recSig, string msg32)
+ * Recover an ECDSA public key from a signature. */
+PHP_FUNCTION(secp256k1_ecdsa_recover)
+{
+    zval *zCtx, *zPubKey, *zSig;
+    secp256k1_context *ctx;
+    secp256k1_pubkey pubkey;
+    secp256k1_ecdsa_recoverable_signature *sig;
+    zend_string *msg32;
+    int result;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/rS", &zCtx, &zPubKey, &zSig, &msg32) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    if ((sig = php_get_secp256k1_ecdsa_recoverable_signature(zSig)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    result = secp256k1_ecdsa_recover(ctx, &pubkey, sig, (const unsigned char *) msg32->val);
+    if (result) {
+        php_secp256k1_pubkey_out(zPubKey, &pubkey);
+    }
+
+    RETURN_LONG(result);
+}
+/* }}} */
+
+// a recoverable signature record is r || s || v
+#define RECOVERABLE_SIGNATURE_LENGTH 65
+#define ETHEREUM_ADDRESS_LENGTH 20
+
+typedef struct _php_secp256k1_ecdsa_recover_job {
+    const unsigned char *sigs;
+    const unsigned char *msgs;
+    unsigned char *output;
+    size_t stride;
+    // serialization flags, or 0 to write Ethereum addresses
+    unsigned int flags;
+} php_secp256k1_ecdsa_recover_job;
+
+// recovers the signer of an r || s || v record, v being either the recovery
+// id or, as Ethereum encodes it, 27 more
+static int php_secp256k1_ecdsa_recover_record(const secp256k1_context *ctx, secp256k1_pubkey *pubkey,
+                                              const unsigned char *record, const unsigned char *msg32) {
+    secp256k1_ecdsa_recoverable_signature sig;
+    int recid = record[COMPACT_SIGNATURE_LENGTH];
+
+    if (recid >= 27) {
+        recid -= 27;
+    }
+    return recid <= 3
+        && secp256k1_ecdsa_recoverable_signature_parse_compact(ctx, &sig, record, recid)
+        && secp256k1_ecdsa_recover(ctx, pubkey, &sig, msg32);
+}
+
+// writes the Ethereum address of a public key: the last 20 bytes of the
+// Keccak-256 hash of its uncompressed encoding without the 0x04 prefix
+static void php_secp256k1_ethereum_address(const secp256k1_context *ctx, unsigned char *out20,
+                                           const secp256k1_pubkey *pubkey) {
+    unsigned char pubkey65[PUBKEY_UNCOMPRESSED_LENGTH], hash[32];
+    size_t pubkeylen = PUBKEY_UNCOMPRESSED_LENGTH;
+
+    secp256k1_ec_pubkey_serialize(ctx, pubkey65, &pubkeylen, pubkey, SECP256K1_EC_UNCOMPRESSED);
+    php_secp256k1_keccak256(pubkey65 + 1, PUBKEY_UNCOMPRESSED_LENGTH - 1, hash);
+    memcpy(out20, hash + 12, ETHEREUM_ADDRESS_LENGTH);
+}
+
+static int php_secp256k1_ecdsa_recover_item(const secp256k1_context *ctx, void *arg, size_t i) {
+    php_secp256k1_ecdsa_recover_job *job = (php_secp256k1_ecdsa_recover_job *) arg;
+    secp256k1_pubkey pubkey;
+    size_t pubkeylen = job->stride;
+
+    if (!php_secp256k1_ecdsa_recover_record(ctx, &pubkey, job->sigs + i * RECOVERABLE_SIGNATURE_LENGTH,
+                                            job->msgs + i * HASH_LENGTH)) {
+        return 0;
+    }
+    if (job->flags == 0) {
+        php_secp256k1_ethereum_address(ctx, job->output + i * job->stride, &pubkey);
+        return 1;
+    }
+    return secp256k1_ec_pubkey_serialize(ctx, job->output + i * job->stride, &pubkeylen, &pubkey, job->flags);
+}
+
+/* {{{ proto int secp256k1_ecdsa_recover_many(resource context, string &publicKeysOut, string &valid, string signatures, string msgs32, int flags)
+ * Recover the public keys of a string of concatenated 65 byte r || s || v
+ * signatures, v being the recovery id either as 0 to 3 or as 27 to 30. msgs32
+ * holds the 32 byte message hash of each signature, in the same order.
+ * publicKeysOut is set to the serialized keys in input order, 33 bytes each if
+ * flags is SECP256K1_EC_COMPRESSED and 65 bytes otherwise. The key of a
+ * signature which does not recover is left zeroed, and valid is set to a
+ * bitmap with bit i set if signature i recovered. */
+PHP_FUNCTION(secp256k1_ecdsa_recover_many)
+{
+    zval *zCtx, *zPubOut, *zValid;
     secp256k1_context *ctx;
-    secp256k1_ecdsa_recoverable_signature *recsig;
-    unsigned char sig[COMPACT_SIGNATURE_LENGTH];
-    int result, recid;
+    php_secp256k1_ecdsa_recover_job job;
+    zend_string *sigs, *msgs, *output, *bitmap;
+    zend_long flags;
+    size_t n;
+    int result = 0;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z/r", &zCtx, &zSigOut, &zRecId, &zRecSig) == FAILURE) {
-        RETURN_LONG(0);
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z/SSl", &zCtx, &zPubOut, &zValid, &sigs, &msgs, &flags) == FAILURE) {
+        RETURN_LONG(result);
     }
 
     if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
-        RETURN_LONG(0);
+        RETURN_LONG(result);
     }
 
-    if ((recsig = php_get_secp256k1_ecdsa_recoverable_signature(zRecSig)) == NULL) {
-        RETURN_LONG(0);
+    if (sigs->len % RECOVERABLE_SIGNATURE_LENGTH != 0) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ecdsa_recover_many(): Parameter 4 should be a multiple of 65 bytes long");
+        return;
     }
 
-    result = secp256k1_ecdsa_recoverable_signature_serialize_compact(ctx, sig, &recid, recsig);
+    n = sigs->len / RECOVERABLE_SIGNATURE_LENGTH;
+    if (msgs->len != n * HASH_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ecdsa_recover_many(): Parameter 5 should be 32 bytes for each signature");
+        return;
+    }
 
-    zval_dtor(zSigOut);
-    ZVAL_STRINGL(zSigOut, (const char *) sig, COMPACT_SIGNATURE_LENGTH);
+    if (flags != SECP256K1_EC_COMPRESSED && flags != SECP256K1_EC_UNCOMPRESSED) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ecdsa_recover_many(): Parameter 6 should be SECP256K1_EC_COMPRESSED or SECP256K1_EC_UNCOMPRESSED");
+        return;
+    }
 
-    zval_dtor(zRecId);
-    ZVAL_LONG(zRecId, recid);
+    job.sigs = (const unsigned char *) sigs->val;
+    job.msgs = (const unsigned char *) msgs->val;
+    job.stride = (flags == SECP256K1_EC_COMPRESSED) ? PUBKEY_COMPRESSED_LENGTH : PUBKEY_UNCOMPRESSED_LENGTH;
+    job.flags = (unsigned int) flags;
+    output = zend_string_safe_alloc(n, job.stride, 0, 0);
+    memset(output->val, 0, output->len + 1);
+    job.output = (unsigned char *) output->val;
+    bitmap = zend_string_alloc(BITMAP_LENGTH(n), 0);
+    memset(bitmap->val, 0, bitmap->len + 1);
+    result = php_secp256k1_batch(ctx, php_secp256k1_ecdsa_recover_item, &job, n, (unsigned char *) bitmap->val);
+
+    zval_dtor(zPubOut);
+    ZVAL_STR(zPubOut, output);
+    zval_dtor(zValid);
+    ZVAL_STR(zValid, bitmap);
 
     RETURN_LONG(result);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ecdsa_sign_recoverable(resource context, resource &sig, string msg32, string key32)
- * Create a recoverable ECDSA signature. */
-PHP_FUNCTION(secp256k1_ecdsa_sign_recoverable)
+/* {{{ proto int secp256k1_ecdsa_recover_address(resource context, string &addressOut, string sig65, string msg32)
+ * Recover the 20 byte Ethereum address of the signer of an r || s || v
+ * signature, v being the recovery id either as 0 to 3 or as 27 to 30. */
+PHP_FUNCTION(secp256k1_ecdsa_recover_address)
 {
-    zval *zCtx, *zSig;
+    zval *zCtx, *zAddress;
     secp256k1_context *ctx;
-    zend_string *msg32, *seckey;
-    secp256k1_ecdsa_recoverable_signature *newsig;
+    secp256k1_pubkey pubkey;
+    zend_string *sig65, *msg32;
+    unsigned char address[ETHEREUM_ADDRESS_LENGTH];
     int result;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/SS", &zCtx, &zSig, &msg32, &seckey) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/SS", &zCtx, &zAddress, &sig65, &msg32) == FAILURE) {
         RETURN_LONG(0);
     }
 
@@ -2012,63 +5565,77 @@ PHP_FUNCTION(secp256k1_ecdsa_sign_recoverable)
         RETURN_LONG(0);
     }
 
-    if (msg32->len != HASH_LENGTH) {
-        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ecdsa_sign_recoverable(): Parameter 2 should be 32 bytes");
+    if (sig65->len != RECOVERABLE_SIGNATURE_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ecdsa_recover_address(): Parameter 3 should be 65 bytes");
         return;
     }
 
-    if (seckey->len != SECRETKEY_LENGTH) {
-        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ecdsa_sign_recoverable(): Parameter 3 should be 32 bytes");
+    if (msg32->len != HASH_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ecdsa_recover_address(): Parameter 4 should be 32 bytes");
         return;
     }
 
-    newsig = emalloc(sizeof(secp256k1_ecdsa_recoverable_signature));
-    result = secp256k1_ecdsa_sign_recoverable(ctx, newsig, (const unsigned char *) msg32->val, (const unsigned char *) seckey->val, 0, 0);
+    result = php_secp256k1_ecdsa_recover_record(ctx, &pubkey, (unsigned char *) sig65->val, (unsigned char *) msg32->val);
     if (result) {
-        zval_dtor(zSig);
-        ZVAL_RES(zSig, zend_register_resource(newsig, le_secp256k1_recoverable_sig));
-    } else {
-        // free when operation fails, won't return this resource
-        efree(newsig);
+        php_secp256k1_ethereum_address(ctx, address, &pubkey);
+        zval_dtor(zAddress);
+        ZVAL_STRINGL(zAddress, (char *) address, ETHEREUM_ADDRESS_LENGTH);
     }
 
     RETURN_LONG(result);
 }
 /* }}} */
 
-/* {{{ proto int secp256k1_ecdsa_recover(resource context, resource &pubKey, resource recSig, string msg32)
- * Recover an ECDSA public key from a signature. */
-PHP_FUNCTION(secp256k1_ecdsa_recover)
+/* {{{ proto int secp256k1_ecdsa_recover_address_many(resource context, string &addressesOut, string &valid, string signatures, string msgs32)
+ * Recover the Ethereum addresses of the signers of a string of concatenated
+ * 65 byte r || s || v signatures, msgs32 holding the 32 byte message hash of
+ * each. addressesOut is set to the 20 byte addresses in input order. The
+ * address of a signature which does not recover is left zeroed, and valid is
+ * set to a bitmap with bit i set if signature i recovered. */
+PHP_FUNCTION(secp256k1_ecdsa_recover_address_many)
 {
-    zval *zCtx, *zPubKey, *zSig;
+    zval *zCtx, *zAddresses, *zValid;
     secp256k1_context *ctx;
-    secp256k1_pubkey *pubkey;
-    secp256k1_ecdsa_recoverable_signature *sig;
-    zend_string *msg32;
-    int result;
+    php_secp256k1_ecdsa_recover_job job;
+    zend_string *sigs, *msgs, *output, *bitmap;
+    size_t n;
+    int result = 0;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/rS", &zCtx, &zPubKey, &zSig, &msg32) == FAILURE) {
-        RETURN_LONG(0);
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z/SS", &zCtx, &zAddresses, &zValid, &sigs, &msgs) == FAILURE) {
+        RETURN_LONG(result);
     }
 
     if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
-        RETURN_LONG(0);
+        RETURN_LONG(result);
     }
 
-    if ((sig = php_get_secp256k1_ecdsa_recoverable_signature(zSig)) == NULL) {
-        RETURN_LONG(0);
+    if (sigs->len % RECOVERABLE_SIGNATURE_LENGTH != 0) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ecdsa_recover_address_many(): Parameter 4 should be a multiple of 65 bytes long");
+        return;
     }
 
-    pubkey = (secp256k1_pubkey *) emalloc(sizeof(secp256k1_pubkey));
-    result = secp256k1_ecdsa_recover(ctx, pubkey, sig, (const unsigned char *) msg32->val);
-    if (result) {
-        zval_dtor(zPubKey);
-        ZVAL_RES(zPubKey, zend_register_resource(pubkey, le_secp256k1_pubkey));
-    } else {
-        // free when operation fails, won't return this resource
-        efree(pubkey);
+    n = sigs->len / RECOVERABLE_SIGNATURE_LENGTH;
+    if (msgs->len != n * HASH_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0, "secp256k1_ecdsa_recover_address_many(): Parameter 5 should be 32 bytes for each signature");
+        return;
     }
 
+    job.sigs = (const unsigned char *) sigs->val;
+    job.msgs = (const unsigned char *) msgs->val;
+    job.stride = ETHEREUM_ADDRESS_LENGTH;
+    job.flags = 0;
+    output = zend_string_safe_alloc(n, job.stride, 0, 0);
+    memset(output->val, 0, output->len + 1);
+    job.output = (unsigned char *) output->val;
+    bitmap = zend_string_alloc(BITMAP_LENGTH(n), 0);
+    memset(bitmap->val, 0, bitmap->len + 1);
+    result = php_secp256k1_batch(ctx, php_secp256k1_ecdsa_recover_item, &job, n, (unsigned char *) bitmap->val);
+
+    zval_dtor(zAddresses);
+    ZVAL_STR(zAddresses, output);
+    zval_dtor(zValid);
+    ZVAL_STR(zValid, bitmap);
+
     RETURN_LONG(result);
 }
 /* }}} */
@@ -2080,94 +5647,112 @@ PHP_FUNCTION(secp256k1_ecdsa_recover)
 #ifdef SECP256K1_MODULE_ECDH
 
 typedef struct php_secp256k1_hash_function_data {
-    zend_fcall_info* fci;
-    zend_fcall_info_cache* fcc;
+    php_secp256k1_callback callback;
     long output_len;
-    zval* data;
 } php_secp256k1_hash_function_data;
 
+// php_secp256k1_hash_function is an implementation of secp256k1_ecdh_hash_function
+// which calls a PHP land function with the x & y coordinates. the optional
+// additional data is already placed in args[3] by the caller of secp256k1_ecdh.
 static int php_secp256k1_hash_function(unsigned char *output, const unsigned char *x,
                             const unsigned char *y, void *data) {
-    php_secp256k1_hash_function_data* callback;
-    zend_string* output_str;
-    zval retval, zvalout;
-    zval args[4];
-    int result, i;
-
-    callback = (php_secp256k1_hash_function_data*) data;
-    callback->fci->size = sizeof(*(callback->fci));
-    callback->fci->object = NULL;
-    callback->fci->retval = &retval;
-    callback->fci->params = args;
-    callback->fci->param_count = 3;
-    ZVAL_NEW_STR(&zvalout, zend_string_init("", 0, 0));
-
-    // wrt ownership, args 0, 1, & 2 are managed by us in order to
-    // receive the result, and pass in the x & y parameters.
-    // arg 3 is owned by the caller of secp256k1_ecdh.
-    ZVAL_NEW_REF(&args[0], &zvalout);
-    ZVAL_STR(&args[1], zend_string_init((const char *) x, 32, 0));
-    ZVAL_STR(&args[2], zend_string_init((const char *) y, 32, 0));
-    if (callback->data != NULL) {
-        callback->fci->param_count++;
-        zval* data = callback->data;
-        args[3] = *data;
-    }
-
-    result = zend_call_function(callback->fci, callback->fcc) == SUCCESS;
+    php_secp256k1_hash_function_data* hashdata = (php_secp256k1_hash_function_data*) data;
 
-    // check function invocation result
-    if (result) {
-        // now respect return value
-        if (Z_TYPE(retval) == IS_FALSE) {
-            result = 0;
-        } else if (Z_TYPE(retval) == IS_TRUE) {
-            result = 1;
-        } else if (Z_TYPE(retval) == IS_LONG) {
-            result = Z_LVAL(retval);
-        }
-    }
+    php_secp256k1_callback_arg(&hashdata->callback.args[1], x, 32);
+    php_secp256k1_callback_arg(&hashdata->callback.args[2], y, 32);
 
-    // ensure the resulting string has a length matching callback->output_len,
+    // ensure the resulting string has a length matching output_len,
     // as in secp256k1_ecdh we allocate exactly that many bytes. if the length
     // doesn't match, cancel the operation
-    if (result) {
-        output_str = Z_STR_P(Z_REFVAL(args[0]));
-        if (output_str->len != callback->output_len) {
-            result = 0;
-        }
-    }
+    return php_secp256k1_callback_call(&hashdata->callback, output, (size_t) hashdata->output_len);
+}
 
-    // callback OK & length correct
-    if (result) {
-        memcpy(output, output_str->val, output_str->len);
-    }
+// native implementations of secp256k1_ecdh_hash_function behind the
+// SECP256K1_ECDH_HASH_* modes, so common key derivations never call into PHP.
+static int php_secp256k1_ecdh_hash_x(unsigned char *output, const unsigned char *x,
+                                     const unsigned char *y, void *data)
+{
+    memcpy(output, x, 32);
+    return 1;
+}
 
-    // zval_dtor on our args. arg 3 is managed elsewhere.
-    for (i = 0; i < 3; i++) {
-        zval_dtor(&args[i]);
-    }
+static int php_secp256k1_ecdh_hash_xy(unsigned char *output, const unsigned char *x,
+                                      const unsigned char *y, void *data)
+{
+    memcpy(output, x, 32);
+    memcpy(output + 32, y, 32);
+    return 1;
+}
 
-    return result;
+static int php_secp256k1_ecdh_hash_sha256_x(unsigned char *output, const unsigned char *x,
+                                            const unsigned char *y, void *data)
+{
+    php_secp256k1_sha256 hash;
+    php_secp256k1_sha256_init(&hash);
+    php_secp256k1_sha256_write(&hash, x, 32);
+    php_secp256k1_sha256_finalize(&hash, output);
+    return 1;
+}
+
+static int php_secp256k1_ecdh_hash_sha512_xy(unsigned char *output, const unsigned char *x,
+                                             const unsigned char *y, void *data)
+{
+    php_secp256k1_sha512 hash;
+    php_secp256k1_sha512_init(&hash);
+    php_secp256k1_sha512_write(&hash, x, 32);
+    php_secp256k1_sha512_write(&hash, y, 32);
+    php_secp256k1_sha512_finalize(&hash, output);
+    return 1;
 }
 
-/* {{{ proto int secp256k1_ecdh(resource context, string &result, resource pubKey, string key32, callable hashfp, int output_len, data)
- * Compute an EC Diffie-Hellman secret in constant time. */
+// data is a sha256 state initialized with the tag, which is left untouched.
+static int php_secp256k1_ecdh_hash_tagged_x(unsigned char *output, const unsigned char *x,
+                                            const unsigned char *y, void *data)
+{
+    php_secp256k1_sha256 hash = *(php_secp256k1_sha256 *) data;
+    php_secp256k1_sha256_write(&hash, x, 32);
+    php_secp256k1_sha256_finalize(&hash, output);
+    return 1;
+}
+
+// indexed by SECP256K1_ECDH_HASH_*. a NULL function selects the library default.
+static const struct {
+    secp256k1_ecdh_hash_function hashfp;
+    zend_long output_len;
+} php_secp256k1_ecdh_hash_modes[] = {
+    { NULL, 32 },
+    { php_secp256k1_ecdh_hash_x, 32 },
+    { php_secp256k1_ecdh_hash_xy, 64 },
+    { php_secp256k1_ecdh_hash_sha256_x, 32 },
+    { php_secp256k1_ecdh_hash_sha512_xy, 64 },
+    { php_secp256k1_ecdh_hash_tagged_x, 32 },
+};
+
+/* {{{ proto int secp256k1_ecdh(resource context, string &result, resource pubKey, string key32, callable|int hashfp, int output_len, data)
+ * Compute an EC Diffie-Hellman secret in constant time.
+ * hashfp is either a callable, or one of the SECP256K1_ECDH_HASH_* constants
+ * which hash the shared point without leaving C. The native modes produce a
+ * fixed length, SECP256K1_ECDH_HASH_TAGGED_X takes its tag as data. */
 PHP_FUNCTION(secp256k1_ecdh)
 {
-    zval *zCtx, *zResult, *zPubKey;
+    zval *zCtx, *zResult, *zPubKey, *zHash = NULL;
     secp256k1_context *ctx;
     secp256k1_pubkey *pubkey;
-    zend_string *privKey;
+    zend_string *privKey, *output;
     zval* data = NULL;
-    long output_len = 32;
+    zend_long output_len = 32, mode;
+    zend_bool output_len_null = 1;
     zend_fcall_info fci;
     zend_fcall_info_cache fcc;
-    php_secp256k1_hash_function_data callback;
+    php_secp256k1_hash_function_data hashdata;
+    php_secp256k1_sha256 tagged;
+    secp256k1_ecdh_hash_function hashfp = NULL;
+    void *hashfp_data = NULL;
+    char *error = NULL;
     int result = 0;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/rS|flz",
-        &zCtx, &zResult, &zPubKey, &privKey, &fci, &fcc, &output_len, &data) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/zS|z!l!z",
+        &zCtx, &zResult, &zPubKey, &privKey, &zHash, &output_len, &output_len_null, &data) == FAILURE) {
         RETURN_LONG(result);
     }
 
@@ -2175,29 +5760,204 @@ PHP_FUNCTION(secp256k1_ecdh)
         RETURN_LONG(result);
     }
 
-    if ((pubkey = php_get_secp256k1_pubkey(zPubKey)) == NULL) {
+    if ((pubkey = php_get_secp256k1_pubkey(zPubKey, 3)) == NULL) {
         RETURN_LONG(result);
     }
 
-    // in C codebases, the ecdh var would be allocated before calling secp256k1_ecdh.
-    // PHP does not have a way pre-allocate memory in this way, so we allocate it
-    // here. where a custom hashfp is provided, the output_len must equal the size of
-    // the data to be written by the hashfp. ex, 32 bytes if a sha256 hash is returned.
-    unsigned char resultChars[output_len];
-    memset(resultChars, 0, output_len);
-    if (ZEND_NUM_ARGS() > 4) {
-        callback.fci = &fci;
-        callback.fcc = &fcc;
-        callback.output_len = output_len;
-        callback.data = data;
-        result = secp256k1_ecdh(ctx, resultChars, pubkey, (unsigned char *) privKey->val, php_secp256k1_hash_function, (void*) &callback);
+    if (zHash == NULL || Z_TYPE_P(zHash) == IS_LONG) {
+        mode = zHash == NULL ? SECP256K1_ECDH_HASH_DEFAULT : Z_LVAL_P(zHash);
+        if (mode < 0 || mode >= (zend_long) (sizeof(php_secp256k1_ecdh_hash_modes) / sizeof(php_secp256k1_ecdh_hash_modes[0]))) {
+            zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                "secp256k1_ecdh(): Parameter 5 should be a callable or a SECP256K1_ECDH_HASH_* constant");
+            return;
+        } else if (!output_len_null && output_len != php_secp256k1_ecdh_hash_modes[mode].output_len) {
+            zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                "secp256k1_ecdh(): Parameter 6 should be %d for this hash mode", (int) php_secp256k1_ecdh_hash_modes[mode].output_len);
+            return;
+        }
+        if (mode == SECP256K1_ECDH_HASH_TAGGED_X) {
+            if (data == NULL || Z_TYPE_P(data) != IS_STRING) {
+                zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                    "secp256k1_ecdh(): Parameter 7 should be the tag for SECP256K1_ECDH_HASH_TAGGED_X");
+                return;
+            }
+            php_secp256k1_sha256_init_tagged(&tagged, (unsigned char *) Z_STRVAL_P(data), Z_STRLEN_P(data));
+            hashfp_data = (void *) &tagged;
+        }
+        hashfp = php_secp256k1_ecdh_hash_modes[mode].hashfp;
+        output_len = php_secp256k1_ecdh_hash_modes[mode].output_len;
+    } else if (zend_fcall_info_init(zHash, 0, &fci, &fcc, NULL, &error) == SUCCESS) {
+        // a callable can resolve with a deprecation notice in error
+        if (error != NULL) {
+            efree(error);
+        }
+        // where a custom hashfp is provided, the output_len must equal the size of
+        // the data to be written by the hashfp. ex, 32 bytes if a sha256 hash is returned.
+        if (output_len_null) {
+            output_len = 32;
+        } else if (output_len < 1) {
+            zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                "secp256k1_ecdh(): Parameter 6 should be greater than zero");
+            return;
+        }
+        php_secp256k1_callback_init(&hashdata.callback, &fci, &fcc, data == NULL ? 3 : 4);
+        if (data != NULL) {
+            ZVAL_COPY_VALUE(&hashdata.callback.args[3], data);
+        }
+        hashdata.output_len = output_len;
+        hashfp = php_secp256k1_hash_function;
+        hashfp_data = (void *) &hashdata;
     } else {
-        result = secp256k1_ecdh(ctx, resultChars, pubkey, (unsigned char *) privKey->val, NULL, NULL);
+        if (error != NULL) {
+            efree(error);
+        }
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+            "secp256k1_ecdh(): Parameter 5 should be a callable or a SECP256K1_ECDH_HASH_* constant");
+        return;
+    }
+
+    // the secret is written straight into the string handed back to the caller
+    output = zend_string_alloc(output_len, 0);
+    result = secp256k1_ecdh(ctx, (unsigned char *) output->val, pubkey, (unsigned char *) privKey->val, hashfp, hashfp_data);
+    if (hashfp == php_secp256k1_hash_function) {
+        php_secp256k1_callback_release(&hashdata.callback, 3);
     }
 
     if (result) {
+        output->val[output_len] = '\0';
         zval_dtor(zResult);
-        ZVAL_STRINGL(zResult, (char *) resultChars, output_len);
+        ZVAL_STR(zResult, output);
+    } else {
+        ZEND_SECURE_ZERO(output->val, output_len);
+        zend_string_free(output);
+    }
+
+    RETURN_LONG(result);
+}
+/* }}} */
+
+typedef struct _php_secp256k1_ecdh_job {
+    const unsigned char *seckey;
+    const secp256k1_pubkey **pubkeys;
+    // set instead of pubkeys when the keys came from a Secp256k1\PublicKeyVector
+    const secp256k1_pubkey *pubkey_vector;
+    secp256k1_ecdh_hash_function hashfp;
+    void *hashfp_data;
+    unsigned char *output;
+    size_t output_len;
+} php_secp256k1_ecdh_job;
+
+static int php_secp256k1_ecdh_item(const secp256k1_context *ctx, void *arg, size_t i) {
+    php_secp256k1_ecdh_job *job = (php_secp256k1_ecdh_job *) arg;
+    return secp256k1_ecdh(ctx, job->output + i * job->output_len,
+            job->pubkey_vector != NULL ? &job->pubkey_vector[i] : job->pubkeys[i],
+            job->seckey, job->hashfp, job->hashfp_data);
+}
+
+/* {{{ proto int secp256k1_ecdh_many(resource context, string &secrets, string key32, array|Secp256k1\PublicKeyVector pubKeys, int hashMode = SECP256K1_ECDH_HASH_DEFAULT, data = null)
+ * Compute the EC Diffie-Hellman secret of one secret key with every public key.
+ * secrets is set to the secrets concatenated in input order. Only the native
+ * SECP256K1_ECDH_HASH_* modes are available, as the secrets may be computed
+ * by the worker threads. Returns 0 if the secret key is invalid. */
+PHP_FUNCTION(secp256k1_ecdh_many)
+{
+    zval *zCtx, *zSecrets, *zPubKeys, *data = NULL, *arrayZval;
+    secp256k1_context *ctx;
+    php_secp256k1_pubkey_vector_obj *vec;
+    const secp256k1_pubkey **pubkeys = NULL;
+    php_secp256k1_ecdh_job job;
+    php_secp256k1_sha256 tagged;
+    zend_string *seckey, *output;
+    zend_long mode = SECP256K1_ECDH_HASH_DEFAULT;
+    size_t n, i = 0;
+    int result = 0;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/Sz|lz", &zCtx, &zSecrets, &seckey, &zPubKeys, &mode, &data) == FAILURE) {
+        RETURN_LONG(result);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(result);
+    }
+
+    if (seckey->len != SECRETKEY_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+            "secp256k1_ecdh_many(): Parameter 3 should be 32 bytes");
+        return;
+    }
+
+    if (mode < 0 || mode >= (zend_long) (sizeof(php_secp256k1_ecdh_hash_modes) / sizeof(php_secp256k1_ecdh_hash_modes[0]))) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+            "secp256k1_ecdh_many(): Parameter 5 should be a SECP256K1_ECDH_HASH_* constant");
+        return;
+    }
+
+    if ((vec = php_get_secp256k1_pubkey_vector(zPubKeys)) != NULL) {
+        n = vec->count;
+    } else if (Z_TYPE_P(zPubKeys) == IS_ARRAY) {
+        n = (size_t) zend_hash_num_elements(Z_ARRVAL_P(zPubKeys));
+    } else {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+            "secp256k1_ecdh_many(): Parameter 4 should be an array or Secp256k1\\PublicKeyVector");
+        return;
+    }
+
+    job.hashfp_data = NULL;
+    if (mode == SECP256K1_ECDH_HASH_TAGGED_X) {
+        if (data == NULL || Z_TYPE_P(data) != IS_STRING) {
+            zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                "secp256k1_ecdh_many(): Parameter 6 should be the tag for SECP256K1_ECDH_HASH_TAGGED_X");
+            return;
+        }
+        // the midstate is only read by the hash function, so the threads share it
+        php_secp256k1_sha256_init_tagged(&tagged, (unsigned char *) Z_STRVAL_P(data), Z_STRLEN_P(data));
+        job.hashfp_data = (void *) &tagged;
+    }
+
+    // the scalar is checked once here instead of failing for every key
+    if (!secp256k1_ec_seckey_verify(ctx, (unsigned char *) seckey->val)) {
+        RETURN_LONG(result);
+    }
+
+    if (vec == NULL && n > 0) {
+        pubkeys = safe_emalloc(n, sizeof(secp256k1_pubkey *), 0);
+        ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(zPubKeys), arrayZval) {
+            ZVAL_DEREF(arrayZval);
+            if (Z_TYPE_P(arrayZval) != IS_RESOURCE
+                && (Z_TYPE_P(arrayZval) != IS_OBJECT || Z_OBJCE_P(arrayZval) != secp256k1_pubkey_ce)) {
+                efree(pubkeys);
+                zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                    "secp256k1_ecdh_many(): Parameter 4 should only hold secp256k1_pubkey resources or Secp256k1\\PublicKey objects");
+                return;
+            }
+            if ((pubkeys[i++] = php_get_secp256k1_pubkey(arrayZval, 0)) == NULL) {
+                efree(pubkeys);
+                RETURN_LONG(result);
+            }
+        } ZEND_HASH_FOREACH_END();
+    }
+
+    // the secrets are written straight into the string handed back
+    job.output_len = (size_t) php_secp256k1_ecdh_hash_modes[mode].output_len;
+    output = zend_string_safe_alloc(n, job.output_len, 0, 0);
+    job.seckey = (const unsigned char *) seckey->val;
+    job.pubkeys = pubkeys;
+    job.pubkey_vector = vec != NULL ? vec->keys : NULL;
+    job.hashfp = php_secp256k1_ecdh_hash_modes[mode].hashfp;
+    job.output = (unsigned char *) output->val;
+    result = php_secp256k1_batch(ctx, php_secp256k1_ecdh_item, &job, n, NULL);
+
+    if (pubkeys != NULL) {
+        efree(pubkeys);
+    }
+
+    if (result) {
+        output->val[output->len] = '\0';
+        zval_dtor(zSecrets);
+        ZVAL_STR(zSecrets, output);
+    } else {
+        ZEND_SECURE_ZERO(output->val, output->len);
+        zend_string_free(output);
     }
 
     RETURN_LONG(result);
@@ -2226,7 +5986,7 @@ PHP_FUNCTION(secp256k1_xonly_pubkey_parse)
 {
     zval *zCtx, *zPubKey;
     secp256k1_context *ctx;
-    secp256k1_xonly_pubkey *pubkey;
+    secp256k1_xonly_pubkey pubkey;
     zend_string *input32;
     int result;
 
@@ -2241,14 +6001,9 @@ PHP_FUNCTION(secp256k1_xonly_pubkey_parse)
         return;
     }
 
-    pubkey = (secp256k1_xonly_pubkey *) emalloc(sizeof(secp256k1_xonly_pubkey));
-    result = secp256k1_xonly_pubkey_parse(ctx, pubkey, (unsigned char *)input32->val);
+    result = php_secp256k1_xonly_pubkey_parse_cached(ctx, &pubkey, (unsigned char *)input32->val);
     if (result) {
-        zval_dtor(zPubKey);
-        ZVAL_RES(zPubKey, zend_register_resource(pubkey, le_secp256k1_xonly_pubkey));
-    } else {
-        // only free when operation fails, won't return this resource
-        efree(pubkey);
+        php_secp256k1_xonly_pubkey_out(zPubKey, &pubkey);
     }
 
     RETURN_LONG(result);
@@ -2274,13 +6029,13 @@ PHP_FUNCTION(secp256k1_xonly_pubkey_serialize)
     unsigned char output32[32];
     int result;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/r", &zCtx, &zOutput32, &zPubKey) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z", &zCtx, &zOutput32, &zPubKey) == FAILURE) {
         RETURN_LONG(0);
     }
 
     if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
         RETURN_LONG(0);
-    } else if ((pubkey = php_get_secp256k1_xonly_pubkey(zPubKey)) == NULL) {
+    } else if ((pubkey = php_get_secp256k1_xonly_pubkey(zPubKey, 3)) == NULL) {
         RETURN_LONG(0);
     }
 
@@ -2288,9 +6043,6 @@ PHP_FUNCTION(secp256k1_xonly_pubkey_serialize)
     if (result) {
         zval_dtor(zOutput32);
         ZVAL_STRINGL(zOutput32, (char *)&output32, 32);
-    } else {
-        // only free when operation fails, won't return this resource
-        efree(pubkey);
     }
 
     RETURN_LONG(result);
@@ -2316,11 +6068,11 @@ PHP_FUNCTION(secp256k1_xonly_pubkey_from_pubkey)
     zval *zCtx, *zXOnlyPubKey, *zPkParity, *zPubKey;
     secp256k1_context *ctx;
     secp256k1_pubkey *pubkey;
-    secp256k1_xonly_pubkey *xonly_pubkey;
+    secp256k1_xonly_pubkey xonly_pubkey;
     int parity;
     int result;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z/r", &zCtx, &zXOnlyPubKey, &zPkParity, &zPubKey) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z/z", &zCtx, &zXOnlyPubKey, &zPkParity, &zPubKey) == FAILURE) {
         RETURN_LONG(0);
     }
 
@@ -2328,15 +6080,13 @@ PHP_FUNCTION(secp256k1_xonly_pubkey_from_pubkey)
         RETURN_LONG(0);
     }
 
-    if ((pubkey = php_get_secp256k1_pubkey(zPubKey)) == NULL) {
+    if ((pubkey = php_get_secp256k1_pubkey(zPubKey, 4)) == NULL) {
         RETURN_LONG(0);
     }
 
-    xonly_pubkey = (secp256k1_xonly_pubkey *) emalloc(sizeof(secp256k1_xonly_pubkey));
-    result = secp256k1_xonly_pubkey_from_pubkey(ctx, xonly_pubkey, &parity, pubkey);
+    result = secp256k1_xonly_pubkey_from_pubkey(ctx, &xonly_pubkey, &parity, pubkey);
     if (result) {
-        zval_dtor(zXOnlyPubKey);
-        ZVAL_RES(zXOnlyPubKey, zend_register_resource(xonly_pubkey, le_secp256k1_xonly_pubkey));
+        php_secp256k1_xonly_pubkey_out(zXOnlyPubKey, &xonly_pubkey);
         zval_dtor(zPkParity);
         ZVAL_LONG(zPkParity, parity);
     }
@@ -2373,7 +6123,7 @@ PHP_FUNCTION(secp256k1_xonly_pubkey_tweak_add)
 {
     zval *zCtx, *zOutputPubkey, *zInternalPubkey;
     secp256k1_context *ctx;
-    secp256k1_pubkey *output_pubkey;
+    secp256k1_pubkey output_pubkey, *copy;
     secp256k1_xonly_pubkey *internal_pubkey;
     zend_string *zTweak;
     int result;
@@ -2384,7 +6134,7 @@ PHP_FUNCTION(secp256k1_xonly_pubkey_tweak_add)
 
     if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
         RETURN_LONG(0);
-    } else if ((internal_pubkey = php_get_secp256k1_xonly_pubkey(zInternalPubkey)) == NULL) {
+    } else if ((internal_pubkey = php_get_secp256k1_xonly_pubkey(zInternalPubkey, 3)) == NULL) {
         RETURN_LONG(0);
     } else if (zTweak->len != SECRETKEY_LENGTH) {
         zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
@@ -2392,11 +6142,17 @@ PHP_FUNCTION(secp256k1_xonly_pubkey_tweak_add)
         return;
     }
 
-    output_pubkey = (secp256k1_pubkey *) emalloc(sizeof(secp256k1_pubkey));
-    result = secp256k1_xonly_pubkey_tweak_add(ctx, output_pubkey, internal_pubkey, (unsigned char *)zTweak->val);
+    result = secp256k1_xonly_pubkey_tweak_add(ctx, &output_pubkey, internal_pubkey, (unsigned char *)zTweak->val);
     if (result) {
-        zval_dtor(zOutputPubkey);
-        ZVAL_RES(zOutputPubkey, zend_register_resource(output_pubkey, le_secp256k1_xonly_pubkey));
+        if (Z_TYPE_P(zOutputPubkey) == IS_OBJECT) {
+            php_secp256k1_pubkey_out(zOutputPubkey, &output_pubkey);
+        } else {
+            // resources have always been returned with the xonly_pubkey type
+            copy = (secp256k1_pubkey *) emalloc(sizeof(secp256k1_pubkey));
+            *copy = output_pubkey;
+            zval_dtor(zOutputPubkey);
+            ZVAL_RES(zOutputPubkey, zend_register_resource(copy, le_secp256k1_xonly_pubkey));
+        }
     }
     RETURN_LONG(result);
 }
@@ -2447,7 +6203,7 @@ PHP_FUNCTION(secp256k1_xonly_pubkey_tweak_add_check)
         zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
                 "secp256k1_xonly_pubkey_tweak_add_check(): Parameter 2 should be 32 bytes");
         return;
-    } else if ((internal_pubkey = php_get_secp256k1_xonly_pubkey(zInternalPubkey)) == NULL) {
+    } else if ((internal_pubkey = php_get_secp256k1_xonly_pubkey(zInternalPubkey, 4)) == NULL) {
         RETURN_LONG(0);
     } else if (tweak32->len != SECRETKEY_LENGTH) {
         zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
@@ -2474,7 +6230,7 @@ PHP_FUNCTION(secp256k1_keypair_create)
     zval *zCtx, *zKeyPair;
     zend_string *seckey;
     secp256k1_context *ctx;
-    secp256k1_keypair *keypair;
+    secp256k1_keypair keypair;
     int result;
 
     if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/S", &zCtx, &zKeyPair, &seckey) == FAILURE) {
@@ -2489,15 +6245,12 @@ PHP_FUNCTION(secp256k1_keypair_create)
         return;
     }
 
-    keypair = (secp256k1_keypair *) emalloc(sizeof(secp256k1_keypair));
-    result = secp256k1_keypair_create(ctx, keypair, (unsigned char *)seckey->val);
+    php_secp256k1_context_budget(zCtx, 1);
+    result = secp256k1_keypair_create(ctx, &keypair, (unsigned char *)seckey->val);
     if (result) {
-        zval_dtor(zKeyPair);
-        ZVAL_RES(zKeyPair, zend_register_resource(keypair, le_secp256k1_keypair));
-    } else {
-        // only free when operation fails, won't return this resource
-        efree(keypair);
+        php_secp256k1_keypair_out(zKeyPair, &keypair);
     }
+    ZEND_SECURE_ZERO(&keypair, sizeof(keypair));
 
     RETURN_LONG(result);
 }
@@ -2519,13 +6272,13 @@ PHP_FUNCTION(secp256k1_keypair_sec)
     unsigned char seckey[SECRETKEY_LENGTH];
     int result;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/r", &zCtx, &zSecKey, &zKeyPair) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z", &zCtx, &zSecKey, &zKeyPair) == FAILURE) {
         RETURN_LONG(0);
     }
 
     if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
         RETURN_LONG(0);
-    } else if ((keypair = php_get_secp256k1_keypair(zKeyPair)) == NULL) {
+    } else if ((keypair = php_get_secp256k1_keypair(zKeyPair, 3)) == NULL) {
         RETURN_LONG(0);
     }
 
@@ -2554,26 +6307,22 @@ PHP_FUNCTION(secp256k1_keypair_pub)
     zval *zCtx, *zPubKey, *zKeyPair;
     secp256k1_context *ctx;
     secp256k1_keypair *keypair;
-    secp256k1_pubkey *pubkey;
+    secp256k1_pubkey pubkey;
     int result;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/r", &zCtx, &zPubKey, &zKeyPair) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z", &zCtx, &zPubKey, &zKeyPair) == FAILURE) {
         RETURN_LONG(0);
     }
 
     if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
         RETURN_LONG(0);
-    } else if ((keypair = php_get_secp256k1_keypair(zKeyPair)) == NULL) {
+    } else if ((keypair = php_get_secp256k1_keypair(zKeyPair, 3)) == NULL) {
         RETURN_LONG(0);
     }
 
-    pubkey = (secp256k1_pubkey *) emalloc(sizeof(secp256k1_pubkey));
-    result = secp256k1_keypair_pub(ctx, pubkey, keypair);
+    result = secp256k1_keypair_pub(ctx, &pubkey, keypair);
     if (result) {
-        zval_dtor(zPubKey);
-        ZVAL_RES(zPubKey, zend_register_resource(pubkey, le_secp256k1_pubkey));
-    } else {
-        efree(pubkey);
+        php_secp256k1_pubkey_out(zPubKey, &pubkey);
     }
 
     RETURN_LONG(result);
@@ -2601,30 +6350,25 @@ PHP_FUNCTION(secp256k1_keypair_xonly_pub)
     zval *zCtx, *zXOnlyPub, *zPkParity, *zKeyPair;
     secp256k1_context *ctx;
     secp256k1_keypair *keypair;
-    secp256k1_xonly_pubkey *pubkey;
+    secp256k1_xonly_pubkey pubkey;
     int pk_parity;
     int result;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z/r", &zCtx, &zXOnlyPub, &zPkParity, &zKeyPair) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/z/z", &zCtx, &zXOnlyPub, &zPkParity, &zKeyPair) == FAILURE) {
         RETURN_LONG(0);
     }
 
     if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
         RETURN_LONG(0);
-    } else if ((keypair = php_get_secp256k1_keypair(zKeyPair)) == NULL) {
+    } else if ((keypair = php_get_secp256k1_keypair(zKeyPair, 4)) == NULL) {
         RETURN_LONG(0);
     }
 
-    pubkey = (secp256k1_xonly_pubkey *) emalloc(sizeof(secp256k1_xonly_pubkey));
-    result = secp256k1_keypair_xonly_pub(ctx, pubkey, &pk_parity, keypair);
+    result = secp256k1_keypair_xonly_pub(ctx, &pubkey, &pk_parity, keypair);
     if (result) {
-        zval_dtor(zXOnlyPub);
-        ZVAL_RES(zXOnlyPub, zend_register_resource(pubkey, le_secp256k1_xonly_pubkey));
+        php_secp256k1_xonly_pubkey_out(zXOnlyPub, &pubkey);
         zval_dtor(zPkParity);
         ZVAL_LONG(zPkParity, pk_parity);
-    } else {
-        // only free when operation fails, won't return this resource
-        efree(pubkey);
     }
 
     RETURN_LONG(result);
@@ -2668,7 +6412,7 @@ PHP_FUNCTION(secp256k1_keypair_xonly_tweak_add)
 
     if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
         RETURN_LONG(0);
-    } else if ((keypair = php_get_secp256k1_keypair(zKeyPair)) == NULL) {
+    } else if ((keypair = php_get_secp256k1_keypair(zKeyPair, 2)) == NULL) {
         RETURN_LONG(0);
     } else if (tweak32->len != 32) {
         zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
@@ -2720,11 +6464,11 @@ PHP_FUNCTION (secp256k1_schnorrsig_sign)
     secp256k1_context *ctx;
     unsigned char newsig[SCHNORRSIG_LENGTH];
     secp256k1_nonce_function_hardened noncefp = NULL;
-    php_secp256k1_nonce_function_data calldata;
+    php_secp256k1_callback callback;
     void* ndata = NULL;
     int result;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/Sr|fz",
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz/Sz|fz",
         &zCtx, &zSig, &msg32, &zKeyPair, &fci, &fcc, &zNData) == FAILURE) {
         RETURN_LONG(0);
     }
@@ -2735,24 +6479,38 @@ PHP_FUNCTION (secp256k1_schnorrsig_sign)
         zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
                 "secp256k1_schnorrsig_sign(): Parameter 3 should be 32 bytes");
         return;
-    } else if ((keypair = php_get_secp256k1_keypair(zKeyPair)) == NULL) {
+    } else if ((keypair = php_get_secp256k1_keypair(zKeyPair, 4)) == NULL) {
         RETURN_LONG(0);
     }
 
-    if (ZEND_NUM_ARGS() > 4) {
+    // splits the secp256k1.stats figures by nonce path
+    SECP256K1_G(stats_variant) = "nonce=default";
+    if (ZEND_NUM_ARGS() > 4 && php_secp256k1_is_native_nonce_function(&fcc, ZEND_FN(secp256k1_nonce_function_bip340))) {
+        // our own bip340 binding: skip the round trip through PHP. invalid
+        // data makes the binding fail, so signing fails the same way here.
+        noncefp = secp256k1_nonce_function_bip340;
+        SECP256K1_G(stats_variant) = "nonce=native";
+        if (zNData != NULL && !php_nonce_function_extract_data(zNData, (unsigned char **) &ndata)) {
+            RETURN_LONG(0);
+        }
+    } else if (ZEND_NUM_ARGS() > 4) {
         noncefp = php_secp256k1_nonce_function_hardened_callback;
-        calldata.fci = &fci;
-        calldata.fcc = &fcc;
+        SECP256K1_G(stats_variant) = "nonce=callback";
+        php_secp256k1_callback_init(&callback, &fci, &fcc, 6);
         if (zNData == NULL) {
-            calldata.data = NULL;
+            ZVAL_NULL(&callback.args[5]);
         } else {
-            calldata.data = zNData;
+            ZVAL_COPY_VALUE(&callback.args[5], zNData);
         }
-        ndata = (void *) &calldata;
+        ndata = (void *) &callback;
     }
 
+    php_secp256k1_context_budget(zCtx, 1);
     result = secp256k1_schnorrsig_sign(ctx, newsig,
         (unsigned char *) msg32->val, keypair, noncefp, ndata);
+    if (noncefp == php_secp256k1_nonce_function_hardened_callback) {
+        php_secp256k1_callback_release(&callback, 5);
+    }
     if (result) {
         ZVAL_STRINGL(zSig, (const char *) newsig, SCHNORRSIG_LENGTH);
     }
@@ -2779,7 +6537,7 @@ PHP_FUNCTION(secp256k1_schnorrsig_verify) {
     zend_string *msg32;
     int result;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rSSr", &zCtx, &zSchnorrSig, &msg32, &zXOnlyPubKey) == FAILURE) {
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rSSz", &zCtx, &zSchnorrSig, &msg32, &zXOnlyPubKey) == FAILURE) {
         RETURN_LONG(0);
     }
 
@@ -2793,11 +6551,172 @@ PHP_FUNCTION(secp256k1_schnorrsig_verify) {
         zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
                 "secp256k1_schnorrsig_verify(): Parameter 3 should be 32 bytes");
         return;
-    } else if ((pubkey = php_get_secp256k1_xonly_pubkey(zXOnlyPubKey)) == NULL) {
+    } else if ((pubkey = php_get_secp256k1_xonly_pubkey(zXOnlyPubKey, 4)) == NULL) {
+        RETURN_LONG(0);
+    }
+
+    result = php_secp256k1_schnorrsig_verify_cached(ctx, php_secp256k1_context_verifies(zCtx), (unsigned char *) zSchnorrSig->val, (unsigned char *) msg32->val, pubkey);
+    RETURN_LONG(result);
+}
+/* }}} */
+
+/* {{{ proto int secp256k1_schnorrsig_verify_raw(resource context, string sig64, string msg32, string xonlyPubkey32)
+ * Verify a Schnorr signature against the 32 byte encoding of an x-only public
+ * key. Returns 0 if the key does not parse. */
+PHP_FUNCTION(secp256k1_schnorrsig_verify_raw) {
+    zval *zCtx;
+    zend_string *zSchnorrSig, *msg32, *zXOnlyPubKey;
+    secp256k1_context *ctx;
+    secp256k1_xonly_pubkey pubkey;
+    int result;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rSSS", &zCtx, &zSchnorrSig, &msg32, &zXOnlyPubKey) == FAILURE) {
+        RETURN_LONG(0);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
         RETURN_LONG(0);
+    } else if (zSchnorrSig->len != SCHNORRSIG_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                "secp256k1_schnorrsig_verify_raw(): Parameter 2 should be 64 bytes");
+        return;
+    } else if (msg32->len != HASH_LENGTH) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                "secp256k1_schnorrsig_verify_raw(): Parameter 3 should be 32 bytes");
+        return;
+    } else if (zXOnlyPubKey->len != 32) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                "secp256k1_schnorrsig_verify_raw(): Parameter 4 should be 32 bytes");
+        return;
+    }
+
+    result = php_secp256k1_xonly_pubkey_parse_cached(ctx, &pubkey, (unsigned char *) zXOnlyPubKey->val)
+        && php_secp256k1_schnorrsig_verify_cached(ctx, php_secp256k1_context_verifies(zCtx), (unsigned char *) zSchnorrSig->val, (unsigned char *) msg32->val, &pubkey);
+    RETURN_LONG(result);
+}
+/* }}} */
+
+typedef struct _php_secp256k1_schnorrsig_verify_job {
+    const unsigned char **sigs64;
+    const unsigned char **msgs32;
+    const secp256k1_xonly_pubkey **pubkeys;
+} php_secp256k1_schnorrsig_verify_job;
+
+static int php_secp256k1_schnorrsig_verify_item(const secp256k1_context *ctx, void *arg, size_t i) {
+    php_secp256k1_schnorrsig_verify_job *job = (php_secp256k1_schnorrsig_verify_job *) arg;
+    return php_secp256k1_schnorrsig_verify_cached(ctx, 1, job->sigs64[i], job->msgs32[i], job->pubkeys[i]);
+}
+
+/* {{{ proto int secp256k1_schnorrsig_verify_batch(resource context, array sigs64, array msgs32, array pubkeys, string &results = null)
+ * Verifies each of a list of Schnorr signatures in turn; this is not a batch
+ *  verification in the BIP340 sense, libsecp256k1 offers none.
+ *
+ *  Returns 1 if all succeeded, 0 otherwise. In particular, returns 1 if the
+ *  list is empty. If results is provided every signature is checked, and
+ *  results is set to a bitmap with bit i set if signature i was valid.
+ *  Otherwise verification stops at the first invalid signature.
+ *
+ *  Args:    ctx: a secp256k1 context object, initialized for verification
+ *               (an InvalidArgumentException is thrown otherwise).
+ *  In:    sigs64: array of 64-byte signatures
+ *         msgs32: array of 32-byte messages
+ *        pubkeys: array of x-only public keys
+ */
+PHP_FUNCTION(secp256k1_schnorrsig_verify_batch)
+{
+    zval *zCtx, *zSigs, *zMsgs, *zPubKeys, *zResults = NULL, *arrayZval;
+    secp256k1_context *ctx;
+    HashTable *sigs_hash, *msgs_hash, *pubkeys_hash;
+    const void **ptrs;
+    const unsigned char **sigs64;
+    const unsigned char **msgs32;
+    const secp256k1_xonly_pubkey **pubkeys;
+    php_secp256k1_schnorrsig_verify_job job;
+    zend_string *bitmap;
+    size_t n, i;
+    int result = 0;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "raaa|z/", &zCtx, &zSigs, &zMsgs, &zPubKeys, &zResults) == FAILURE) {
+        RETURN_LONG(result);
+    }
+
+    if ((ctx = php_get_secp256k1_context(zCtx)) == NULL) {
+        RETURN_LONG(result);
+    }
+
+    // refused for the same reason as in secp256k1_ecdsa_verify_batch()
+    if (!php_secp256k1_context_verifies(zCtx)) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                "secp256k1_schnorrsig_verify_batch(): Parameter 1 should be a context created with SECP256K1_CONTEXT_VERIFY");
+        return;
+    }
+
+    sigs_hash = Z_ARRVAL_P(zSigs);
+    msgs_hash = Z_ARRVAL_P(zMsgs);
+    pubkeys_hash = Z_ARRVAL_P(zPubKeys);
+    n = (size_t) zend_hash_num_elements(sigs_hash);
+    if (zend_hash_num_elements(msgs_hash) != n || zend_hash_num_elements(pubkeys_hash) != n) {
+        zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                "secp256k1_schnorrsig_verify_batch(): Parameters 2, 3 and 4 should have the same number of elements");
+        return;
+    }
+
+    ptrs = safe_emalloc(3 * n + 1, sizeof(void *), 0);
+    sigs64 = (const unsigned char **) ptrs;
+    msgs32 = (const unsigned char **) (ptrs + n);
+    pubkeys = (const secp256k1_xonly_pubkey **) (ptrs + 2 * n);
+
+    i = 0;
+    ZEND_HASH_FOREACH_VAL(sigs_hash, arrayZval) {
+        ZVAL_DEREF(arrayZval);
+        if (Z_TYPE_P(arrayZval) != IS_STRING || Z_STRLEN_P(arrayZval) != SCHNORRSIG_LENGTH) {
+            efree(ptrs);
+            zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                    "secp256k1_schnorrsig_verify_batch(): Parameter 2 should only contain 64 byte strings");
+            return;
+        }
+        sigs64[i++] = (const unsigned char *) Z_STRVAL_P(arrayZval);
+    } ZEND_HASH_FOREACH_END();
+
+    i = 0;
+    ZEND_HASH_FOREACH_VAL(msgs_hash, arrayZval) {
+        ZVAL_DEREF(arrayZval);
+        if (Z_TYPE_P(arrayZval) != IS_STRING || Z_STRLEN_P(arrayZval) != HASH_LENGTH) {
+            efree(ptrs);
+            zend_throw_exception_ex(spl_ce_InvalidArgumentException, 0,
+                    "secp256k1_schnorrsig_verify_batch(): Parameter 3 should only contain 32 byte strings");
+            return;
+        }
+        msgs32[i++] = (const unsigned char *) Z_STRVAL_P(arrayZval);
+    } ZEND_HASH_FOREACH_END();
+
+    i = 0;
+    ZEND_HASH_FOREACH_VAL(pubkeys_hash, arrayZval) {
+        ZVAL_DEREF(arrayZval);
+        if ((pubkeys[i++] = php_get_secp256k1_xonly_pubkey(arrayZval, 0)) == NULL) {
+            efree(ptrs);
+            RETURN_LONG(result);
+        }
+    } ZEND_HASH_FOREACH_END();
+
+    // The libsecp256k1 schnorrsig module does not export a multi-scalar
+    // verification (the batch API it once had was removed upstream), so the
+    // signatures are verified individually, which also identifies every
+    // invalid index directly instead of bisecting.
+    job.sigs64 = sigs64;
+    job.msgs32 = msgs32;
+    job.pubkeys = pubkeys;
+    if (zResults == NULL) {
+        result = php_secp256k1_batch(ctx, php_secp256k1_schnorrsig_verify_item, &job, n, NULL);
+    } else {
+        bitmap = zend_string_alloc(BITMAP_LENGTH(n), 0);
+        memset(bitmap->val, 0, bitmap->len + 1);
+        result = php_secp256k1_batch(ctx, php_secp256k1_schnorrsig_verify_item, &job, n, (unsigned char *) bitmap->val);
+        zval_dtor(zResults);
+        ZVAL_STR(zResults, bitmap);
     }
 
-    result = secp256k1_schnorrsig_verify(ctx, (unsigned char *) zSchnorrSig->val, (unsigned char *) msg32->val, pubkey);
+    efree(ptrs);
     RETURN_LONG(result);
 }
 /* }}} */
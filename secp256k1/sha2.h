@@ -0,0 +1,357 @@
+#include <stdint.h>
+#include <string.h>
+
+/** SHA-256 and SHA-512 for hashing done entirely in C.
+ *
+ *  libsecp256k1 keeps its hash functions internal, so the native ECDH hash
+ *  modes bring their own. Both are plain incremental implementations:
+ *  _init, any number of _write calls, then _finalize, which leaves the state
+ *  unusable until the next _init. A state can be copied by value to keep a
+ *  midstate, as php_secp256k1_sha256_init_tagged does for BIP-340 style
+ *  tagged hashes. HMAC-SHA512 is built on top for BIP32 key derivation, and
+ *  HMAC-SHA256 for the hashing functions exposed to PHP.
+ */
+
+typedef struct _php_secp256k1_sha256 {
+    uint32_t s[8];
+    unsigned char buf[64];
+    uint64_t bytes;
+} php_secp256k1_sha256;
+
+typedef struct _php_secp256k1_sha512 {
+    uint64_t s[8];
+    unsigned char buf[128];
+    uint64_t bytes;
+} php_secp256k1_sha512;
+
+static const uint32_t php_secp256k1_sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint64_t php_secp256k1_sha512_k[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+};
+
+#define SHA2_ROR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define SHA2_ROR64(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+static void php_secp256k1_sha256_init(php_secp256k1_sha256 *hash)
+{
+    hash->s[0] = 0x6a09e667;
+    hash->s[1] = 0xbb67ae85;
+    hash->s[2] = 0x3c6ef372;
+    hash->s[3] = 0xa54ff53a;
+    hash->s[4] = 0x510e527f;
+    hash->s[5] = 0x9b05688c;
+    hash->s[6] = 0x1f83d9ab;
+    hash->s[7] = 0x5be0cd19;
+    hash->bytes = 0;
+}
+
+static void php_secp256k1_sha256_transform(uint32_t *s, const unsigned char *chunk)
+{
+    uint32_t w[64], a, b, c, d, e, f, g, h, t1, t2;
+    int i;
+
+    for (i = 0; i < 16; i++) {
+        w[i] = ((uint32_t) chunk[i * 4] << 24) | ((uint32_t) chunk[i * 4 + 1] << 16)
+             | ((uint32_t) chunk[i * 4 + 2] << 8) | (uint32_t) chunk[i * 4 + 3];
+    }
+    for (i = 16; i < 64; i++) {
+        w[i] = w[i - 16] + (SHA2_ROR32(w[i - 15], 7) ^ SHA2_ROR32(w[i - 15], 18) ^ (w[i - 15] >> 3))
+             + w[i - 7] + (SHA2_ROR32(w[i - 2], 17) ^ SHA2_ROR32(w[i - 2], 19) ^ (w[i - 2] >> 10));
+    }
+
+    a = s[0]; b = s[1]; c = s[2]; d = s[3];
+    e = s[4]; f = s[5]; g = s[6]; h = s[7];
+    for (i = 0; i < 64; i++) {
+        t1 = h + (SHA2_ROR32(e, 6) ^ SHA2_ROR32(e, 11) ^ SHA2_ROR32(e, 25)) + ((e & f) ^ (~e & g))
+           + php_secp256k1_sha256_k[i] + w[i];
+        t2 = (SHA2_ROR32(a, 2) ^ SHA2_ROR32(a, 13) ^ SHA2_ROR32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    s[0] += a; s[1] += b; s[2] += c; s[3] += d;
+    s[4] += e; s[5] += f; s[6] += g; s[7] += h;
+}
+
+static void php_secp256k1_sha256_write(php_secp256k1_sha256 *hash, const unsigned char *data, size_t len)
+{
+    size_t used = hash->bytes & 63;
+    hash->bytes += len;
+    if (used > 0) {
+        size_t fill = 64 - used;
+        if (len < fill) {
+            memcpy(hash->buf + used, data, len);
+            return;
+        }
+        memcpy(hash->buf + used, data, fill);
+        php_secp256k1_sha256_transform(hash->s, hash->buf);
+        data += fill;
+        len -= fill;
+    }
+    while (len >= 64) {
+        php_secp256k1_sha256_transform(hash->s, data);
+        data += 64;
+        len -= 64;
+    }
+    memcpy(hash->buf, data, len);
+}
+
+static void php_secp256k1_sha256_finalize(php_secp256k1_sha256 *hash, unsigned char *out32)
+{
+    static const unsigned char pad[64] = {0x80};
+    unsigned char sizedesc[8];
+    uint64_t bits = hash->bytes << 3;
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        sizedesc[i] = (unsigned char) (bits >> (56 - 8 * i));
+    }
+    php_secp256k1_sha256_write(hash, pad, 1 + ((119 - (hash->bytes & 63)) & 63));
+    php_secp256k1_sha256_write(hash, sizedesc, 8);
+    for (i = 0; i < 8; i++) {
+        out32[i * 4] = (unsigned char) (hash->s[i] >> 24);
+        out32[i * 4 + 1] = (unsigned char) (hash->s[i] >> 16);
+        out32[i * 4 + 2] = (unsigned char) (hash->s[i] >> 8);
+        out32[i * 4 + 3] = (unsigned char) hash->s[i];
+    }
+}
+
+/* tags of the BIP-340 and BIP-341 hashes. their midstates are computed once
+ * by php_secp256k1_sha256_tags_init at startup and copied from then on, which
+ * saves the two compressions of the prefix. the table is only written before
+ * any request or worker thread runs. */
+static const char *const php_secp256k1_sha256_tag_names[] = {
+    "BIP0340/aux", "BIP0340/nonce", "BIP0340/challenge",
+    "TapLeaf", "TapBranch", "TapTweak", "TapSighash"
+};
+#define SHA256_TAG_COUNT (sizeof(php_secp256k1_sha256_tag_names) / sizeof(php_secp256k1_sha256_tag_names[0]))
+static php_secp256k1_sha256 php_secp256k1_sha256_tag_midstates[SHA256_TAG_COUNT];
+static int php_secp256k1_sha256_tags_ready = 0;
+
+/* initializes hash with SHA256(tag) || SHA256(tag) already written, the
+ * prefix of a BIP-340 tagged hash. */
+static void php_secp256k1_sha256_init_tagged(php_secp256k1_sha256 *hash, const unsigned char *tag, size_t taglen)
+{
+    unsigned char taghash[32];
+    size_t i;
+
+    if (php_secp256k1_sha256_tags_ready) {
+        for (i = 0; i < SHA256_TAG_COUNT; i++) {
+            if (strlen(php_secp256k1_sha256_tag_names[i]) == taglen
+                && memcmp(php_secp256k1_sha256_tag_names[i], tag, taglen) == 0) {
+                *hash = php_secp256k1_sha256_tag_midstates[i];
+                return;
+            }
+        }
+    }
+    php_secp256k1_sha256_init(hash);
+    php_secp256k1_sha256_write(hash, tag, taglen);
+    php_secp256k1_sha256_finalize(hash, taghash);
+    php_secp256k1_sha256_init(hash);
+    php_secp256k1_sha256_write(hash, taghash, 32);
+    php_secp256k1_sha256_write(hash, taghash, 32);
+}
+
+static void php_secp256k1_sha256_tags_init(void)
+{
+    size_t i;
+    for (i = 0; i < SHA256_TAG_COUNT; i++) {
+        php_secp256k1_sha256_init_tagged(&php_secp256k1_sha256_tag_midstates[i],
+                                         (const unsigned char *) php_secp256k1_sha256_tag_names[i],
+                                         strlen(php_secp256k1_sha256_tag_names[i]));
+    }
+    php_secp256k1_sha256_tags_ready = 1;
+}
+
+/* computes HMAC-SHA256 of data under key into out32. */
+static void php_secp256k1_hmac_sha256(const unsigned char *key, size_t keylen,
+                                      const unsigned char *data, size_t datalen, unsigned char *out32)
+{
+    php_secp256k1_sha256 hash;
+    unsigned char rkey[64], pad[64], inner[32];
+    int i;
+
+    memset(rkey, 0, sizeof(rkey));
+    if (keylen > sizeof(rkey)) {
+        php_secp256k1_sha256_init(&hash);
+        php_secp256k1_sha256_write(&hash, key, keylen);
+        php_secp256k1_sha256_finalize(&hash, rkey);
+    } else {
+        memcpy(rkey, key, keylen);
+    }
+
+    for (i = 0; i < 64; i++) {
+        pad[i] = rkey[i] ^ 0x36;
+    }
+    php_secp256k1_sha256_init(&hash);
+    php_secp256k1_sha256_write(&hash, pad, 64);
+    php_secp256k1_sha256_write(&hash, data, datalen);
+    php_secp256k1_sha256_finalize(&hash, inner);
+
+    for (i = 0; i < 64; i++) {
+        pad[i] = rkey[i] ^ 0x5c;
+    }
+    php_secp256k1_sha256_init(&hash);
+    php_secp256k1_sha256_write(&hash, pad, 64);
+    php_secp256k1_sha256_write(&hash, inner, 32);
+    php_secp256k1_sha256_finalize(&hash, out32);
+
+    ZEND_SECURE_ZERO(rkey, sizeof(rkey));
+    ZEND_SECURE_ZERO(pad, sizeof(pad));
+    ZEND_SECURE_ZERO(&hash, sizeof(hash));
+}
+
+static void php_secp256k1_sha512_init(php_secp256k1_sha512 *hash)
+{
+    hash->s[0] = 0x6a09e667f3bcc908ULL;
+    hash->s[1] = 0xbb67ae8584caa73bULL;
+    hash->s[2] = 0x3c6ef372fe94f82bULL;
+    hash->s[3] = 0xa54ff53a5f1d36f1ULL;
+    hash->s[4] = 0x510e527fade682d1ULL;
+    hash->s[5] = 0x9b05688c2b3e6c1fULL;
+    hash->s[6] = 0x1f83d9abfb41bd6bULL;
+    hash->s[7] = 0x5be0cd19137e2179ULL;
+    hash->bytes = 0;
+}
+
+static void php_secp256k1_sha512_transform(uint64_t *s, const unsigned char *chunk)
+{
+    uint64_t w[80], a, b, c, d, e, f, g, h, t1, t2;
+    int i, j;
+
+    for (i = 0; i < 16; i++) {
+        w[i] = 0;
+        for (j = 0; j < 8; j++) {
+            w[i] = (w[i] << 8) | chunk[i * 8 + j];
+        }
+    }
+    for (i = 16; i < 80; i++) {
+        w[i] = w[i - 16] + (SHA2_ROR64(w[i - 15], 1) ^ SHA2_ROR64(w[i - 15], 8) ^ (w[i - 15] >> 7))
+             + w[i - 7] + (SHA2_ROR64(w[i - 2], 19) ^ SHA2_ROR64(w[i - 2], 61) ^ (w[i - 2] >> 6));
+    }
+
+    a = s[0]; b = s[1]; c = s[2]; d = s[3];
+    e = s[4]; f = s[5]; g = s[6]; h = s[7];
+    for (i = 0; i < 80; i++) {
+        t1 = h + (SHA2_ROR64(e, 14) ^ SHA2_ROR64(e, 18) ^ SHA2_ROR64(e, 41)) + ((e & f) ^ (~e & g))
+           + php_secp256k1_sha512_k[i] + w[i];
+        t2 = (SHA2_ROR64(a, 28) ^ SHA2_ROR64(a, 34) ^ SHA2_ROR64(a, 39)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    s[0] += a; s[1] += b; s[2] += c; s[3] += d;
+    s[4] += e; s[5] += f; s[6] += g; s[7] += h;
+}
+
+static void php_secp256k1_sha512_write(php_secp256k1_sha512 *hash, const unsigned char *data, size_t len)
+{
+    size_t used = hash->bytes & 127;
+    hash->bytes += len;
+    if (used > 0) {
+        size_t fill = 128 - used;
+        if (len < fill) {
+            memcpy(hash->buf + used, data, len);
+            return;
+        }
+        memcpy(hash->buf + used, data, fill);
+        php_secp256k1_sha512_transform(hash->s, hash->buf);
+        data += fill;
+        len -= fill;
+    }
+    while (len >= 128) {
+        php_secp256k1_sha512_transform(hash->s, data);
+        data += 128;
+        len -= 128;
+    }
+    memcpy(hash->buf, data, len);
+}
+
+static void php_secp256k1_sha512_finalize(php_secp256k1_sha512 *hash, unsigned char *out64)
+{
+    static const unsigned char pad[128] = {0x80};
+    unsigned char sizedesc[16] = {0};
+    uint64_t bits = hash->bytes << 3;
+    int i, j;
+
+    // the length field is 128 bits, lengths beyond 2^64 bits are not supported
+    for (i = 0; i < 8; i++) {
+        sizedesc[8 + i] = (unsigned char) (bits >> (56 - 8 * i));
+    }
+    php_secp256k1_sha512_write(hash, pad, 1 + ((239 - (hash->bytes & 127)) & 127));
+    php_secp256k1_sha512_write(hash, sizedesc, 16);
+    for (i = 0; i < 8; i++) {
+        for (j = 0; j < 8; j++) {
+            out64[i * 8 + j] = (unsigned char) (hash->s[i] >> (56 - 8 * j));
+        }
+    }
+}
+
+/* computes HMAC-SHA512 of data under key into out64. */
+static void php_secp256k1_hmac_sha512(const unsigned char *key, size_t keylen,
+                                      const unsigned char *data, size_t datalen, unsigned char *out64)
+{
+    php_secp256k1_sha512 hash;
+    unsigned char rkey[128], pad[128], inner[64];
+    int i;
+
+    memset(rkey, 0, sizeof(rkey));
+    if (keylen > sizeof(rkey)) {
+        php_secp256k1_sha512_init(&hash);
+        php_secp256k1_sha512_write(&hash, key, keylen);
+        php_secp256k1_sha512_finalize(&hash, rkey);
+    } else {
+        memcpy(rkey, key, keylen);
+    }
+
+    for (i = 0; i < 128; i++) {
+        pad[i] = rkey[i] ^ 0x36;
+    }
+    php_secp256k1_sha512_init(&hash);
+    php_secp256k1_sha512_write(&hash, pad, 128);
+    php_secp256k1_sha512_write(&hash, data, datalen);
+    php_secp256k1_sha512_finalize(&hash, inner);
+
+    for (i = 0; i < 128; i++) {
+        pad[i] = rkey[i] ^ 0x5c;
+    }
+    php_secp256k1_sha512_init(&hash);
+    php_secp256k1_sha512_write(&hash, pad, 128);
+    php_secp256k1_sha512_write(&hash, inner, 64);
+    php_secp256k1_sha512_finalize(&hash, out64);
+
+    // the key is usually a BIP32 chain code
+    ZEND_SECURE_ZERO(rkey, sizeof(rkey));
+    ZEND_SECURE_ZERO(pad, sizeof(pad));
+    ZEND_SECURE_ZERO(&hash, sizeof(hash));
+}
+
+#undef SHA2_ROR32
+#undef SHA2_ROR64
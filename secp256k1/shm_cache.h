@@ -0,0 +1,287 @@
+#include <stdint.h>
+#include <string.h>
+
+/** Fixed size hash tables in shared memory, for values which are expensive
+ *  to compute and safe to share between processes.
+ *
+ *  A table is a single anonymous MAP_SHARED mapping created in MINIT, before
+ *  a process manager forks its workers, so every worker reads and fills the
+ *  same table. fork() keeps the mapping at the same address in the child and
+ *  nothing in it refers to process private memory, so no fixup is needed
+ *  after a fork. The table is never resized or remapped.
+ *
+ *  Entries are grouped in buckets of SHM_CACHE_WAYS. Each entry is guarded by
+ *  a sequence counter which is odd while a writer owns the entry. Readers
+ *  copy the entry and count a miss if the counter changed meanwhile, writers
+ *  claim an entry with a compare and swap and drop the insert if another
+ *  process got there first. Nobody ever waits, so a process killed halfway
+ *  through a write only loses that one entry.
+ *
+ *  Keys and values have a fixed size per table, a table of bare keys is a
+ *  set. Bucket indices come from a SipHash of the key under a random salt,
+ *  so the keys a peer chooses cannot be aimed at one bucket; keys which are
+ *  salted hashes already may use their own bits instead. Everything here is
+ *  plain C and safe to run on the batch pool. Requires csprng.h to be
+ *  included first.
+ *
+ *  The statistics are split in SHM_CACHE_STRIPES slots of one cache line
+ *  each, apart from the header which every lookup reads. A process counts in
+ *  the slot php_secp256k1_shm_cache_select() picked for it, so workers do not
+ *  bounce a shared line on every lookup, and readers sum the slots.
+ */
+
+#ifdef HAVE_SECP256K1_SHM
+#include <sys/mman.h>
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#define SHM_CACHE_WAYS 4
+/* the largest key and value an entry holds, together */
+#define SHM_CACHE_MAX_DATA 256
+#define SHM_CACHE_ALIGN 64
+#define SHM_CACHE_ROUND(n) (((n) + SHM_CACHE_ALIGN - 1) & ~(size_t) (SHM_CACHE_ALIGN - 1))
+/* the sequence counter and the tag of an entry precede its key and value */
+#define SHM_CACHE_ENTRY_HEADER 8
+#define SHM_CACHE_STRIPES 32
+
+typedef struct _php_secp256k1_shm_cache {
+    size_t size;
+    size_t buckets;
+    size_t key_size;
+    size_t value_size;
+    size_t entry_size;
+    uint64_t salt[2];
+} php_secp256k1_shm_cache;
+
+/* one slot of statistics, updated without ordering */
+typedef struct _php_secp256k1_shm_cache_counters {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t inserts;
+    uint64_t evictions;
+} php_secp256k1_shm_cache_counters;
+
+/* the slot this process counts in */
+static unsigned int php_secp256k1_shm_cache_stripe;
+
+#define SHM_CACHE_COUNTERS(cache, stripe) ((php_secp256k1_shm_cache_counters *) \
+    ((unsigned char *) (cache) + SHM_CACHE_ROUND(sizeof(php_secp256k1_shm_cache)) + (stripe) * SHM_CACHE_ALIGN))
+#define SHM_CACHE_ENTRY(cache, i) \
+    ((unsigned char *) (cache) + SHM_CACHE_ROUND(sizeof(php_secp256k1_shm_cache)) \
+        + SHM_CACHE_STRIPES * SHM_CACHE_ALIGN + (i) * (cache)->entry_size)
+#define SHM_CACHE_SEQ(entry) ((uint32_t *) (entry))
+#define SHM_CACHE_TAG(entry) ((uint32_t *) (entry) + 1)
+
+#define SIPHASH_ROTL(x, b) (uint64_t) (((x) << (b)) | ((x) >> (64 - (b))))
+#define SIPHASH_ROUND(v0, v1, v2, v3) do { \
+        v0 += v1; v1 = SIPHASH_ROTL(v1, 13); v1 ^= v0; v0 = SIPHASH_ROTL(v0, 32); \
+        v2 += v3; v3 = SIPHASH_ROTL(v3, 16); v3 ^= v2; \
+        v0 += v3; v3 = SIPHASH_ROTL(v3, 21); v3 ^= v0; \
+        v2 += v1; v1 = SIPHASH_ROTL(v1, 17); v1 ^= v2; v2 = SIPHASH_ROTL(v2, 32); \
+    } while (0)
+
+/* SipHash-2-4 of data under the 128 bit key k0 || k1. */
+static uint64_t php_secp256k1_siphash(uint64_t k0, uint64_t k1, const unsigned char *data, size_t len)
+{
+    uint64_t v0 = k0 ^ 0x736f6d6570736575ULL, v1 = k1 ^ 0x646f72616e646f6dULL;
+    uint64_t v2 = k0 ^ 0x6c7967656e657261ULL, v3 = k1 ^ 0x7465646279746573ULL;
+    uint64_t m, b = (uint64_t) len << 56;
+    size_t i, j;
+
+    for (i = 0; i + 8 <= len; i += 8) {
+        m = 0;
+        for (j = 0; j < 8; j++) {
+            m |= (uint64_t) data[i + j] << (8 * j);
+        }
+        v3 ^= m;
+        SIPHASH_ROUND(v0, v1, v2, v3);
+        SIPHASH_ROUND(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+    for (j = 0; i + j < len; j++) {
+        b |= (uint64_t) data[i + j] << (8 * j);
+    }
+    v3 ^= b;
+    SIPHASH_ROUND(v0, v1, v2, v3);
+    SIPHASH_ROUND(v0, v1, v2, v3);
+    v0 ^= b;
+    v2 ^= 0xff;
+    for (i = 0; i < 4; i++) {
+        SIPHASH_ROUND(v0, v1, v2, v3);
+    }
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+/* maps a table with room for at least entries keys. returns NULL if the
+ * mapping or the salt could not be had. */
+static php_secp256k1_shm_cache *php_secp256k1_shm_cache_create(size_t entries, size_t key_size, size_t value_size)
+{
+    php_secp256k1_shm_cache *cache;
+    size_t buckets = 1, entry_size, size;
+    uint64_t salt[2];
+
+    if (key_size + value_size > SHM_CACHE_MAX_DATA) {
+        return NULL;
+    }
+    while (buckets * SHM_CACHE_WAYS < entries) {
+        buckets <<= 1;
+        if (buckets > SIZE_MAX / SHM_CACHE_WAYS / 2) {
+            return NULL;
+        }
+    }
+    entry_size = (SHM_CACHE_ENTRY_HEADER + key_size + value_size + 7) & ~(size_t) 7;
+    if (buckets * SHM_CACHE_WAYS > (SIZE_MAX - (SHM_CACHE_STRIPES + 1) * SHM_CACHE_ALIGN) / entry_size) {
+        return NULL;
+    }
+    size = SHM_CACHE_ROUND(sizeof(php_secp256k1_shm_cache)) + SHM_CACHE_STRIPES * SHM_CACHE_ALIGN
+        + buckets * SHM_CACHE_WAYS * entry_size;
+
+    if (!php_secp256k1_os_random(salt, sizeof(salt))) {
+        return NULL;
+    }
+
+    // anonymous mappings start zeroed: every entry is empty and unlocked
+    cache = (php_secp256k1_shm_cache *) mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (cache == (php_secp256k1_shm_cache *) MAP_FAILED) {
+        return NULL;
+    }
+    cache->size = size;
+    cache->buckets = buckets;
+    cache->key_size = key_size;
+    cache->value_size = value_size;
+    cache->entry_size = entry_size;
+    cache->salt[0] = salt[0];
+    cache->salt[1] = salt[1];
+    return cache;
+}
+
+static void php_secp256k1_shm_cache_destroy(php_secp256k1_shm_cache *cache)
+{
+    munmap((void *) cache, cache->size);
+}
+
+static size_t php_secp256k1_shm_cache_capacity(const php_secp256k1_shm_cache *cache)
+{
+    return cache->buckets * SHM_CACHE_WAYS;
+}
+
+static uint64_t php_secp256k1_shm_cache_hash(const php_secp256k1_shm_cache *cache, const unsigned char *key)
+{
+    return php_secp256k1_siphash(cache->salt[0], cache->salt[1], key, cache->key_size);
+}
+
+/* the tag tells entries of a bucket apart without comparing keys, it is
+ * never 0, which marks an empty entry. */
+#define SHM_CACHE_HASH_TAG(hash) ((uint32_t) ((hash) >> 32) | 1)
+#define SHM_CACHE_HASH_BUCKET(cache, hash) ((size_t) (hash) & ((cache)->buckets - 1))
+
+/* picks the statistics slot of the calling process from an id which tells
+ * processes apart, such as its pid. */
+static void php_secp256k1_shm_cache_select(unsigned long id)
+{
+    php_secp256k1_shm_cache_stripe = (unsigned int) (id % SHM_CACHE_STRIPES);
+}
+
+/* sums the statistics of every process into out. */
+static void php_secp256k1_shm_cache_counters_sum(const php_secp256k1_shm_cache *cache,
+                                                 php_secp256k1_shm_cache_counters *out)
+{
+    const php_secp256k1_shm_cache_counters *slot;
+    unsigned int i;
+
+    memset(out, 0, sizeof(*out));
+    for (i = 0; i < SHM_CACHE_STRIPES; i++) {
+        slot = SHM_CACHE_COUNTERS(cache, i);
+        out->hits += __atomic_load_n(&slot->hits, __ATOMIC_RELAXED);
+        out->misses += __atomic_load_n(&slot->misses, __ATOMIC_RELAXED);
+        out->inserts += __atomic_load_n(&slot->inserts, __ATOMIC_RELAXED);
+        out->evictions += __atomic_load_n(&slot->evictions, __ATOMIC_RELAXED);
+    }
+}
+
+#define SHM_CACHE_COUNT(cache, counter) \
+    __atomic_fetch_add(&SHM_CACHE_COUNTERS(cache, php_secp256k1_shm_cache_stripe)->counter, 1, __ATOMIC_RELAXED)
+
+/* copies the value stored under key to value, which may be NULL in a table
+ * without values. returns 1 on a hit, 0 if the key is absent or its entry
+ * was being written. */
+static int php_secp256k1_shm_cache_get(php_secp256k1_shm_cache *cache, uint64_t hash,
+                                       const unsigned char *key, void *value)
+{
+    unsigned char *entry, copy[SHM_CACHE_MAX_DATA];
+    size_t first = SHM_CACHE_HASH_BUCKET(cache, hash) * SHM_CACHE_WAYS, i;
+    size_t length = cache->key_size + cache->value_size;
+    uint32_t tag = SHM_CACHE_HASH_TAG(hash), seq;
+
+    for (i = first; i < first + SHM_CACHE_WAYS; i++) {
+        entry = SHM_CACHE_ENTRY(cache, i);
+        seq = __atomic_load_n(SHM_CACHE_SEQ(entry), __ATOMIC_ACQUIRE);
+        if ((seq & 1) || __atomic_load_n(SHM_CACHE_TAG(entry), __ATOMIC_RELAXED) != tag) {
+            continue;
+        }
+        // copy first, then check nobody wrote the entry meanwhile
+        memcpy(copy, entry + SHM_CACHE_ENTRY_HEADER, length);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(SHM_CACHE_SEQ(entry), __ATOMIC_RELAXED) != seq) {
+            continue;
+        }
+        if (memcmp(copy, key, cache->key_size) == 0) {
+            if (cache->value_size > 0) {
+                memcpy(value, copy + cache->key_size, cache->value_size);
+            }
+            SHM_CACHE_COUNT(cache, hits);
+            return 1;
+        }
+    }
+    SHM_CACHE_COUNT(cache, misses);
+    return 0;
+}
+
+/* stores value under key, in the entry of the bucket which already has its
+ * tag, or an empty one, or else an entry picked by the hash. the insert is
+ * dropped if that entry is being written by another process. */
+static void php_secp256k1_shm_cache_put(php_secp256k1_shm_cache *cache, uint64_t hash,
+                                        const unsigned char *key, const void *value)
+{
+    unsigned char *entry = NULL;
+    size_t first = SHM_CACHE_HASH_BUCKET(cache, hash) * SHM_CACHE_WAYS, i;
+    uint32_t tag = SHM_CACHE_HASH_TAG(hash), seq, old;
+
+    // two processes missing on the same key both insert it, the second one
+    // overwrites the first rather than taking a second entry
+    for (i = first; i < first + SHM_CACHE_WAYS; i++) {
+        old = __atomic_load_n(SHM_CACHE_TAG(SHM_CACHE_ENTRY(cache, i)), __ATOMIC_RELAXED);
+        if (old == tag) {
+            entry = SHM_CACHE_ENTRY(cache, i);
+            break;
+        }
+        if (old == 0 && entry == NULL) {
+            entry = SHM_CACHE_ENTRY(cache, i);
+        }
+    }
+    if (entry == NULL) {
+        // the upper tag bits are independent of the bucket index
+        entry = SHM_CACHE_ENTRY(cache, first + (tag >> 30) % SHM_CACHE_WAYS);
+    }
+
+    seq = __atomic_load_n(SHM_CACHE_SEQ(entry), __ATOMIC_RELAXED);
+    if ((seq & 1) || !__atomic_compare_exchange_n(SHM_CACHE_SEQ(entry), &seq, seq + 1, 0,
+                                                  __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        return;
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    old = __atomic_load_n(SHM_CACHE_TAG(entry), __ATOMIC_RELAXED);
+    if (old != 0 && old != tag) {
+        SHM_CACHE_COUNT(cache, evictions);
+    }
+    __atomic_store_n(SHM_CACHE_TAG(entry), tag, __ATOMIC_RELAXED);
+    memcpy(entry + SHM_CACHE_ENTRY_HEADER, key, cache->key_size);
+    if (cache->value_size > 0) {
+        memcpy(entry + SHM_CACHE_ENTRY_HEADER + cache->key_size, value, cache->value_size);
+    }
+    __atomic_store_n(SHM_CACHE_SEQ(entry), seq + 2, __ATOMIC_RELEASE);
+    SHM_CACHE_COUNT(cache, inserts);
+}
+#endif
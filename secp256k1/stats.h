@@ -0,0 +1,100 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/** Call counters and latency histograms behind secp256k1_stats().
+ *
+ *  Latencies are nanoseconds, counted in log-linear buckets as HDR
+ *  histograms do: each power of two is split into STATS_SUB_BUCKETS equal
+ *  buckets, so a bucket spans at most a quarter of its lower bound and
+ *  STATS_BUCKETS of them reach past four seconds. Recording is a handful of
+ *  instructions and never allocates.
+ */
+
+#define STATS_SUB_BITS 2
+#define STATS_SUB_BUCKETS (1 << STATS_SUB_BITS)
+#define STATS_BUCKETS 128
+
+typedef struct _php_secp256k1_stats_entry {
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t histogram[STATS_BUCKETS];
+} php_secp256k1_stats_entry;
+
+static unsigned int php_secp256k1_stats_msb(uint64_t v)
+{
+#if defined(__GNUC__)
+    return 63 - (unsigned int) __builtin_clzll(v);
+#else
+    unsigned int msb = 0;
+    while (v >>= 1) {
+        msb++;
+    }
+    return msb;
+#endif
+}
+
+/* returns the bucket counting a latency of ns. */
+static unsigned int php_secp256k1_stats_bucket(uint64_t ns)
+{
+    unsigned int msb, bucket;
+    if (ns < STATS_SUB_BUCKETS) {
+        return (unsigned int) ns;
+    }
+    msb = php_secp256k1_stats_msb(ns);
+    bucket = ((msb - STATS_SUB_BITS + 1) << STATS_SUB_BITS)
+        + (unsigned int) ((ns >> (msb - STATS_SUB_BITS)) & (STATS_SUB_BUCKETS - 1));
+    return bucket < STATS_BUCKETS ? bucket : STATS_BUCKETS - 1;
+}
+
+/* returns the smallest latency counted in bucket. */
+static uint64_t php_secp256k1_stats_bucket_low(unsigned int bucket)
+{
+    unsigned int octave = bucket >> STATS_SUB_BITS;
+    if (octave == 0) {
+        return bucket;
+    }
+    return (uint64_t) (STATS_SUB_BUCKETS + (bucket & (STATS_SUB_BUCKETS - 1))) << (octave - 1);
+}
+
+static void php_secp256k1_stats_record(php_secp256k1_stats_entry *entry, uint64_t ns)
+{
+    entry->calls++;
+    entry->total_ns += ns;
+    if (ns > entry->max_ns) {
+        entry->max_ns = ns;
+    }
+    entry->histogram[php_secp256k1_stats_bucket(ns)]++;
+}
+
+/* returns an upper bound of the permille-th per mille latency: the end of
+ * the bucket it falls in, capped at the largest latency seen. */
+static uint64_t php_secp256k1_stats_quantile(const php_secp256k1_stats_entry *entry, unsigned int permille)
+{
+    uint64_t rank = (entry->calls * permille + 999) / 1000, seen = 0, upper;
+    unsigned int i;
+
+    if (rank == 0) {
+        rank = 1;
+    }
+    for (i = 0; i < STATS_BUCKETS; i++) {
+        seen += entry->histogram[i];
+        if (seen >= rank) {
+            upper = i + 1 < STATS_BUCKETS ? php_secp256k1_stats_bucket_low(i + 1) - 1 : entry->max_ns;
+            return upper < entry->max_ns ? upper : entry->max_ns;
+        }
+    }
+    return entry->max_ns;
+}
+
+/* writes the batch size class of n, such as "n=16..31", to out. */
+static size_t php_secp256k1_stats_batch_class(char *out, size_t outlen, size_t n)
+{
+    uint64_t low;
+    if (n <= 1) {
+        return (size_t) snprintf(out, outlen, "n=%u", (unsigned int) n);
+    }
+    low = (uint64_t) 1 << php_secp256k1_stats_msb(n);
+    return (size_t) snprintf(out, outlen, "n=%llu..%llu", (unsigned long long) low, (unsigned long long) (low * 2 - 1));
+}
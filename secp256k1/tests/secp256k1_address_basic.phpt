@@ -0,0 +1,35 @@
+--TEST--
+secp256k1_address_p2pkh and secp256k1_address_p2wpkh encode known addresses
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+// the generator, public key of secret key 1
+$pubkey = null;
+secp256k1_ec_pubkey_parse($context, $pubkey, hex2bin("0279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798"));
+
+$address = null;
+echo secp256k1_address_p2pkh($context, $address, $pubkey) . " " . $address . PHP_EOL;
+echo secp256k1_address_p2pkh($context, $address, $pubkey, 111) . " " . $address . PHP_EOL;
+echo secp256k1_address_p2wpkh($context, $address, $pubkey) . " " . $address . PHP_EOL;
+echo secp256k1_address_p2wpkh($context, $address, $pubkey, "tb") . " " . $address . PHP_EOL;
+
+// the address always commits to the compressed encoding
+$uncompressed = null;
+$object = new Secp256k1\PublicKey();
+secp256k1_ec_pubkey_serialize($context, $uncompressed, $pubkey, SECP256K1_EC_UNCOMPRESSED);
+secp256k1_ec_pubkey_parse($context, $object, $uncompressed);
+echo secp256k1_address_p2pkh($context, $address, $object) . " " . $address . PHP_EOL;
+
+?>
+--EXPECT--
+1 1BgGZ9tcN4rm9KBzDn7KprQz87SZ26SAMH
+1 mrCDrCybB6J1vRfbwM5hemdJz73FwDBC8r
+1 bc1qw508d6qejxtdg4y5r3zarvary0c5xw7kv8f3t4
+1 tb1qw508d6qejxtdg4y5r3zarvary0c5xw7kxpjzsx
+1 1BgGZ9tcN4rm9KBzDn7KprQz87SZ26SAMH
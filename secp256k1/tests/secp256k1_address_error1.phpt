@@ -0,0 +1,51 @@
+--TEST--
+secp256k1_address functions throw on invalid parameters
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$pubkey = null;
+secp256k1_ec_pubkey_parse($context, $pubkey, hex2bin("0279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798"));
+$key33 = hex2bin("0279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798");
+
+$calls = [
+    function () use ($context, $pubkey) { $out = null; return secp256k1_address_p2pkh($context, $out, $pubkey, 256); },
+    function () use ($context, $pubkey) { $out = null; return secp256k1_address_p2wpkh($context, $out, $pubkey, "BC"); },
+    function () use ($context, $pubkey) { $out = null; return secp256k1_address_p2wpkh($context, $out, $pubkey, ""); },
+    function () use ($context, $pubkey) { $out = null; return secp256k1_address_p2wpkh($context, $out, $pubkey, str_repeat("a", 84)); },
+    function () use ($context, $key33) { $out = null; $valid = null; return secp256k1_address_many($context, $out, $valid, 7, $key33); },
+    function () use ($context, $key33) { $out = null; $valid = null; return secp256k1_address_many($context, $out, $valid, SECP256K1_ADDRESS_P2PKH, $key33 . "\x00"); },
+    function () use ($context, $key33) { $out = null; $valid = null; return secp256k1_address_many($context, $out, $valid, SECP256K1_ADDRESS_P2PKH, $key33, "bc"); },
+    function () use ($context, $key33) { $out = null; $valid = null; return secp256k1_address_many($context, $out, $valid, SECP256K1_ADDRESS_P2WPKH, $key33, 0); },
+];
+foreach ($calls as $call) {
+    try {
+        $call();
+    } catch (\Exception $e) {
+        echo get_class($e) . PHP_EOL;
+        echo $e->getMessage() . PHP_EOL;
+    }
+}
+
+?>
+--EXPECT--
+InvalidArgumentException
+secp256k1_address_p2pkh(): Parameter 4 should be a version byte
+InvalidArgumentException
+secp256k1_address_p2wpkh(): Parameter 4 should be a lowercase human readable part of 1 to 50 characters
+InvalidArgumentException
+secp256k1_address_p2wpkh(): Parameter 4 should be a lowercase human readable part of 1 to 50 characters
+InvalidArgumentException
+secp256k1_address_p2wpkh(): Parameter 4 should be a lowercase human readable part of 1 to 50 characters
+InvalidArgumentException
+secp256k1_address_many(): Parameter 4 should be a SECP256K1_ADDRESS_* constant
+InvalidArgumentException
+secp256k1_address_many(): Parameter 5 should be a multiple of 33 bytes long
+InvalidArgumentException
+secp256k1_address_many(): Parameter 6 should be a version byte for SECP256K1_ADDRESS_P2PKH
+InvalidArgumentException
+secp256k1_address_many(): Parameter 6 should be a lowercase human readable part of 1 to 50 characters
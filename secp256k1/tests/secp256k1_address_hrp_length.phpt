@@ -0,0 +1,48 @@
+--TEST--
+secp256k1_address functions accept the longest hrp that keeps the address within 90 characters
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+if (!function_exists("secp256k1_address_p2tr")) print "skip no extrakeys support";
+?>
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$key33 = hex2bin("0279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798");
+$key32 = substr($key33, 1);
+$pubkey = null;
+$xonly = null;
+secp256k1_ec_pubkey_parse($context, $pubkey, $key33);
+secp256k1_xonly_pubkey_parse($context, $xonly, $key32);
+
+$calls = [
+    function ($hrp) use ($context, $pubkey) { $out = null; secp256k1_address_p2wpkh($context, $out, $pubkey, $hrp); return $out; },
+    function ($hrp) use ($context, $xonly) { $out = null; secp256k1_address_p2tr($context, $out, $xonly, $hrp); return $out; },
+    function ($hrp) use ($context, $key33) { $out = null; $valid = null; secp256k1_address_many($context, $out, $valid, SECP256K1_ADDRESS_P2WPKH, $key33, $hrp); return $out[0]; },
+    function ($hrp) use ($context, $key32) { $out = null; $valid = null; secp256k1_address_many($context, $out, $valid, SECP256K1_ADDRESS_P2TR, $key32, $hrp); return $out[0]; },
+];
+foreach ([[$calls[0], 50], [$calls[1], 30], [$calls[2], 50], [$calls[3], 30]] as list($call, $max)) {
+    echo strlen($call(str_repeat("a", $max))) . PHP_EOL;
+    try {
+        $call(str_repeat("a", $max + 1));
+    } catch (\Exception $e) {
+        echo get_class($e) . PHP_EOL;
+        echo $e->getMessage() . PHP_EOL;
+    }
+}
+
+?>
+--EXPECT--
+90
+InvalidArgumentException
+secp256k1_address_p2wpkh(): Parameter 4 should be a lowercase human readable part of 1 to 50 characters
+90
+InvalidArgumentException
+secp256k1_address_p2tr(): Parameter 4 should be a lowercase human readable part of 1 to 30 characters
+90
+InvalidArgumentException
+secp256k1_address_many(): Parameter 6 should be a lowercase human readable part of 1 to 50 characters
+90
+InvalidArgumentException
+secp256k1_address_many(): Parameter 6 should be a lowercase human readable part of 1 to 30 characters
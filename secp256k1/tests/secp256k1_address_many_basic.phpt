@@ -0,0 +1,59 @@
+--TEST--
+secp256k1_address_many matches encoding each key
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+$seckeys = '';
+for ($i = 0; $i < 40; $i++) {
+    $seckeys .= hash('sha256', "key $i", true);
+}
+$keys = null;
+$valid = null;
+secp256k1_ec_pubkey_create_many($context, $keys, $valid, $seckeys, SECP256K1_EC_COMPRESSED);
+// x = 0 is not on the curve
+$keys = substr_replace($keys, "\x02" . str_repeat("\x00", 32), 33 * 5, 33);
+
+foreach ([[SECP256K1_ADDRESS_P2PKH, null], [SECP256K1_ADDRESS_P2PKH, 111], [SECP256K1_ADDRESS_P2WPKH, null], [SECP256K1_ADDRESS_P2WPKH, "tb"]] as list($type, $prefix)) {
+    $addresses = null;
+    echo secp256k1_address_many($context, $addresses, $valid, $type, $keys, $prefix) . " " . bin2hex($valid) . PHP_EOL;
+
+    $matches = 0;
+    for ($i = 0; $i < 40; $i++) {
+        $pubkey = null;
+        $expected = null;
+        if (secp256k1_ec_pubkey_parse($context, $pubkey, substr($keys, 33 * $i, 33))) {
+            if ($type === SECP256K1_ADDRESS_P2PKH) {
+                secp256k1_address_p2pkh($context, $expected, $pubkey, $prefix === null ? 0 : $prefix);
+            } else {
+                secp256k1_address_p2wpkh($context, $expected, $pubkey, $prefix);
+            }
+        }
+        $matches += $addresses[$i] === $expected;
+    }
+    echo $matches . PHP_EOL;
+}
+
+$addresses = null;
+echo secp256k1_address_many($context, $addresses, $valid, SECP256K1_ADDRESS_P2WPKH, '') . PHP_EOL;
+var_dump($addresses, $valid);
+
+?>
+--EXPECT--
+0 dfffffffff
+40
+0 dfffffffff
+40
+0 dfffffffff
+40
+0 dfffffffff
+40
+1
+array(0) {
+}
+string(0) ""
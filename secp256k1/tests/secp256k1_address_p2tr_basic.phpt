@@ -0,0 +1,41 @@
+--TEST--
+secp256k1_address_p2tr follows the BIP86 test vector
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+if (!function_exists("secp256k1_address_p2tr")) print "skip no extrakeys support";
+?>
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+// m/86'/0'/0'/0/0 of the BIP86 test mnemonic
+$internal = null;
+$output = null;
+secp256k1_xonly_pubkey_parse($context, $internal, hex2bin("cc8a4bc64d897bddc5fbc2f670f7a8ba0b386779106cf1223c6fc5d7cd6fc115"));
+secp256k1_xonly_pubkey_parse($context, $output, hex2bin("a60869f0dbcf1dc659c9cecbaf8050135ea9e8cdc487053f1dc6880949dc684c"));
+
+$address = null;
+echo secp256k1_address_p2tr($context, $address, $internal) . " " . $address . PHP_EOL;
+echo secp256k1_address_p2tr($context, $address, $internal, "tb") . " " . $address . PHP_EOL;
+echo secp256k1_address_p2tr($context, $address, $output, null, false) . " " . $address . PHP_EOL;
+
+$addresses = null;
+$valid = null;
+$keys = hex2bin("cc8a4bc64d897bddc5fbc2f670f7a8ba0b386779106cf1223c6fc5d7cd6fc115") . str_repeat("\x00", 32);
+echo secp256k1_address_many($context, $addresses, $valid, SECP256K1_ADDRESS_P2TR, $keys) . " " . bin2hex($valid) . PHP_EOL;
+var_dump($addresses);
+
+?>
+--EXPECT--
+1 bc1p5cyxnuxmeuwuvkwfem96lqzszd02n6xdcjrs20cac6yqjjwudpxqkedrcr
+1 tb1p5cyxnuxmeuwuvkwfem96lqzszd02n6xdcjrs20cac6yqjjwudpxqp3mvzv
+1 bc1p5cyxnuxmeuwuvkwfem96lqzszd02n6xdcjrs20cac6yqjjwudpxqkedrcr
+0 01
+array(2) {
+  [0]=>
+  string(62) "bc1p5cyxnuxmeuwuvkwfem96lqzszd02n6xdcjrs20cac6yqjjwudpxqkedrcr"
+  [1]=>
+  NULL
+}
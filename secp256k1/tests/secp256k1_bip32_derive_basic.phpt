@@ -0,0 +1,85 @@
+--TEST--
+secp256k1_bip32_derive follows BIP32 test vector 1
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+$master = null;
+echo secp256k1_bip32_master($context, $master, hex2bin("000102030405060708090a0b0c0d0e0f")) . PHP_EOL;
+echo get_class($master) . PHP_EOL;
+
+foreach (["m", "m/0'", "m/0h/1", "m/0H/1/2'", "m/0H/1/2H/2", "m/0H/1/2H/2/1000000000"] as $path) {
+    $key = null;
+    $out = null;
+    echo secp256k1_bip32_derive($context, $key, $master, $path) . " ";
+    secp256k1_bip32_serialize($context, $out, $key, 0x0488ade4);
+    echo bin2hex($out) . PHP_EOL;
+}
+
+// public derivation from the neutered m/0'/1/2'
+$priv = null;
+$pub = null;
+$child = null;
+$out = null;
+secp256k1_bip32_derive($context, $priv, $master, "m/0'/1/2'");
+echo secp256k1_bip32_neuter($context, $pub, $priv) . PHP_EOL;
+echo secp256k1_bip32_derive($context, $child, $pub, "2/1000000000") . PHP_EOL;
+secp256k1_bip32_serialize($context, $out, $child, 0x0488b21e);
+echo bin2hex($out) . PHP_EOL;
+
+// hardened steps and the secret key need an extended private key
+$secret = null;
+echo secp256k1_bip32_derive($context, $child, $pub, "2'") . PHP_EOL;
+echo secp256k1_bip32_seckey($context, $secret, $pub) . PHP_EOL;
+
+echo secp256k1_bip32_seckey($context, $secret, $priv) . " " . bin2hex($secret) . PHP_EOL;
+$pubkey = null;
+$expected = null;
+$serialized = null;
+$serializedExpected = null;
+secp256k1_bip32_pubkey($context, $pubkey, $priv);
+secp256k1_ec_pubkey_create($context, $expected, $secret);
+secp256k1_ec_pubkey_serialize($context, $serialized, $pubkey, SECP256K1_EC_COMPRESSED);
+secp256k1_ec_pubkey_serialize($context, $serializedExpected, $expected, SECP256K1_EC_COMPRESSED);
+var_dump($serialized === $serializedExpected);
+
+// parsing returns the version and round trips
+$parsed = null;
+$version = null;
+$again = null;
+secp256k1_bip32_serialize($context, $out, $priv, 0x0488ade4);
+echo secp256k1_bip32_parse($context, $parsed, $out, $version) . " " . dechex($version) . PHP_EOL;
+secp256k1_bip32_serialize($context, $again, $parsed, $version);
+var_dump($again === $out);
+
+// the child may be written over its parent
+$key = clone $master;
+secp256k1_bip32_derive($context, $key, $key, "0'/1");
+secp256k1_bip32_serialize($context, $again, $key, 0x0488ade4);
+echo bin2hex($again) . PHP_EOL;
+
+?>
+--EXPECT--
+1
+Secp256k1\ExtendedKey
+1 0488ade4000000000000000000873dff81c02f525623fd1fe5167eac3a55a049de3d314bb42ee227ffed37d50800e8f32e723decf4051aefac8e2c93c9c5b214313817cdb01a1494b917c8436b35
+1 0488ade4013442193e8000000047fdacbd0f1097043b78c63c20c34ef4ed9a111d980047ad16282c7ae623614100edb2e14f9ee77d26dd93b4ecede8d16ed408ce149b6cd80b0715a2d911a0afea
+1 0488ade4025c1bd648000000012a7857631386ba23dacac34180dd1983734e444fdbf774041578e9b6adb37c19003c6cb8d0f6a264c91ea8b5030fadaa8e538b020f0a387421a12de9319dc93368
+1 0488ade403bef5a2f98000000204466b9cc8e161e966409ca52986c584f07e9dc81f735db683c3ff6ec7b1503f00cbce0d719ecf7431d88e6a89fa1483e02e35092af60c042b1df2ff59fa424dca
+1 0488ade404ee7ab90c00000002cfb71883f01676f587d023cc53a35bc7f88f724b1f8c2892ac1275ac822a3edd000f479245fb19a38a1954c5c7c0ebab2f9bdfd96a17563ef28a6a4b1a2a764ef4
+1 0488ade405d880d7d83b9aca00c783e67b921d2beb8f6b389cc646d7263b4145701dadd2161548a8b078e65e9e00471b76e389e528d6de6d816857e012c5455051cad6660850e58372a6c3e6e7c8
+1
+1
+0488b21e05d880d7d83b9aca00c783e67b921d2beb8f6b389cc646d7263b4145701dadd2161548a8b078e65e9e022a471424da5e657499d1ff51cb43c47481a03b1e77f951fe64cec9f5a48f7011
+0
+0
+1 cbce0d719ecf7431d88e6a89fa1483e02e35092af60c042b1df2ff59fa424dca
+bool(true)
+1 488ade4
+bool(true)
+0488ade4025c1bd648000000012a7857631386ba23dacac34180dd1983734e444fdbf774041578e9b6adb37c19003c6cb8d0f6a264c91ea8b5030fadaa8e538b020f0a387421a12de9319dc93368
@@ -0,0 +1,40 @@
+--TEST--
+secp256k1_bip32_derive keeps cached children of the same parent at another depth apart
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--INI--
+secp256k1.bip32_cache_size=16
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+$master = null;
+$parent = null;
+$out = null;
+secp256k1_bip32_master($context, $master, hex2bin("000102030405060708090a0b0c0d0e0f"));
+secp256k1_bip32_derive($context, $parent, $master, "m/0'");
+secp256k1_bip32_serialize($context, $out, $parent, 0x0488ade4);
+
+// the same key and chain code, serialized with another depth byte
+$out[4] = chr(5);
+$deeper = null;
+echo secp256k1_bip32_parse($context, $deeper, $out) . PHP_EOL;
+
+foreach ([$parent, $deeper, $parent, $deeper] as $key) {
+    $child = null;
+    $childOut = null;
+    secp256k1_bip32_derive($context, $child, $key, "1");
+    secp256k1_bip32_serialize($context, $childOut, $child, 0x0488ade4);
+    echo ord($childOut[4]) . " " . bin2hex(substr($childOut, 13)) . PHP_EOL;
+}
+
+?>
+--EXPECT--
+1
+2 2a7857631386ba23dacac34180dd1983734e444fdbf774041578e9b6adb37c19003c6cb8d0f6a264c91ea8b5030fadaa8e538b020f0a387421a12de9319dc93368
+6 2a7857631386ba23dacac34180dd1983734e444fdbf774041578e9b6adb37c19003c6cb8d0f6a264c91ea8b5030fadaa8e538b020f0a387421a12de9319dc93368
+2 2a7857631386ba23dacac34180dd1983734e444fdbf774041578e9b6adb37c19003c6cb8d0f6a264c91ea8b5030fadaa8e538b020f0a387421a12de9319dc93368
+6 2a7857631386ba23dacac34180dd1983734e444fdbf774041578e9b6adb37c19003c6cb8d0f6a264c91ea8b5030fadaa8e538b020f0a387421a12de9319dc93368
@@ -0,0 +1,64 @@
+--TEST--
+secp256k1_bip32_derive_many matches deriving each child, with and without the cache
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+$master = null;
+$account = null;
+$public = null;
+secp256k1_bip32_master($context, $master, hex2bin("000102030405060708090a0b0c0d0e0f"));
+secp256k1_bip32_derive($context, $account, $master, "m/84'/0'/0'/0");
+secp256k1_bip32_neuter($context, $public, $account);
+
+foreach ([256, 2, 0] as $cacheSize) {
+    ini_set("secp256k1.bip32_cache_size", $cacheSize);
+    $expected = '';
+    for ($i = 5; $i < 45; $i++) {
+        $child = null;
+        $pubkey = null;
+        $serialized = null;
+        secp256k1_bip32_derive($context, $child, $master, "m/84'/0'/0'/0/$i");
+        secp256k1_bip32_pubkey($context, $pubkey, $child);
+        secp256k1_ec_pubkey_serialize($context, $serialized, $pubkey, SECP256K1_EC_COMPRESSED);
+        $expected .= $serialized;
+    }
+
+    foreach ([$account, $public] as $parent) {
+        $out = null;
+        $valid = null;
+        echo secp256k1_bip32_derive_many($context, $out, $valid, $parent, 5, 40, SECP256K1_EC_COMPRESSED) . " ";
+        echo bin2hex($valid) . " ";
+        var_dump($out === $expected);
+    }
+}
+
+$out = null;
+$valid = null;
+echo secp256k1_bip32_derive_many($context, $out, $valid, $account, 7, 1, SECP256K1_EC_UNCOMPRESSED) . " " . strlen($out) . PHP_EOL;
+
+// hardened children of an extended public key can't be derived
+echo secp256k1_bip32_derive_many($context, $out, $valid, $public, SECP256K1_BIP32_HARDENED - 2, 4, SECP256K1_EC_COMPRESSED) . " ";
+echo bin2hex($valid) . " " . bin2hex(substr($out, 66)) . PHP_EOL;
+
+echo secp256k1_bip32_derive_many($context, $out, $valid, $public, 0, 0, SECP256K1_EC_COMPRESSED) . PHP_EOL;
+var_dump($out, $valid);
+
+?>
+--EXPECT--
+1 ffffffffff bool(true)
+1 ffffffffff bool(true)
+1 ffffffffff bool(true)
+1 ffffffffff bool(true)
+1 ffffffffff bool(true)
+1 ffffffffff bool(true)
+1 65
+0 03 000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000
+1
+string(0) ""
+string(0) ""
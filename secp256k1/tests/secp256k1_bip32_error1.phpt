@@ -0,0 +1,78 @@
+--TEST--
+secp256k1_bip32 functions throw on invalid parameters
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+set_error_handler(function($code, $str) { echo $str . PHP_EOL; });
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$master = null;
+secp256k1_bip32_master($context, $master, str_repeat("\x42", 32));
+
+$calls = [
+    function () use ($context) { $key = null; return secp256k1_bip32_master($context, $key, str_repeat("\x42", 15)); },
+    function () use ($context) { $key = null; return secp256k1_bip32_master($context, $key, str_repeat("\x42", 65)); },
+    function () use ($context, $master) { $key = null; return secp256k1_bip32_derive($context, $key, $master, "m/"); },
+    function () use ($context, $master) { $key = null; return secp256k1_bip32_derive($context, $key, $master, "m/1//2"); },
+    function () use ($context, $master) { $key = null; return secp256k1_bip32_derive($context, $key, $master, "m/2147483648"); },
+    function () use ($context, $master) { $key = null; return secp256k1_bip32_derive($context, $key, $master, "/0"); },
+    function () use ($context) { $key = null; return secp256k1_bip32_parse($context, $key, str_repeat("\x00", 77)); },
+    function () use ($context, $master) { $out = null; return secp256k1_bip32_serialize($context, $out, $master, -1); },
+    function () use ($context, $master) { $out = null; $valid = null; return secp256k1_bip32_derive_many($context, $out, $valid, $master, -1, 1, SECP256K1_EC_COMPRESSED); },
+    function () use ($context, $master) { $out = null; $valid = null; return secp256k1_bip32_derive_many($context, $out, $valid, $master, 0xffffffff, 2, SECP256K1_EC_COMPRESSED); },
+    function () use ($context, $master) { $out = null; $valid = null; return secp256k1_bip32_derive_many($context, $out, $valid, $master, 0, 1, 0); },
+];
+foreach ($calls as $call) {
+    try {
+        $call();
+    } catch (\Exception $e) {
+        echo get_class($e) . PHP_EOL;
+        echo $e->getMessage() . PHP_EOL;
+    }
+}
+
+// the key must be an initialized Secp256k1\ExtendedKey
+$key = null;
+echo secp256k1_bip32_derive($context, $key, 1, "m/0") . PHP_EOL;
+$out = null;
+echo secp256k1_bip32_seckey($context, $out, new Secp256k1\ExtendedKey()) . PHP_EOL;
+
+// a master key with a parent is invalid
+$serialized = null;
+secp256k1_bip32_serialize($context, $serialized, $master, 0x0488ade4);
+$serialized[5] = "\x01";
+echo secp256k1_bip32_parse($context, $key, $serialized) . PHP_EOL;
+
+?>
+--EXPECT--
+InvalidArgumentException
+secp256k1_bip32_master(): Parameter 3 should be between 16 and 64 bytes
+InvalidArgumentException
+secp256k1_bip32_master(): Parameter 3 should be between 16 and 64 bytes
+InvalidArgumentException
+secp256k1_bip32_derive(): Parameter 4 should be a derivation path such as m/0'/1
+InvalidArgumentException
+secp256k1_bip32_derive(): Parameter 4 should be a derivation path such as m/0'/1
+InvalidArgumentException
+secp256k1_bip32_derive(): Parameter 4 should be a derivation path such as m/0'/1
+InvalidArgumentException
+secp256k1_bip32_derive(): Parameter 4 should be a derivation path such as m/0'/1
+InvalidArgumentException
+secp256k1_bip32_parse(): Parameter 3 should be 78 bytes
+InvalidArgumentException
+secp256k1_bip32_serialize(): Parameter 4 should be a 32 bit version
+InvalidArgumentException
+secp256k1_bip32_derive_many(): Parameter 5 should be a child index
+InvalidArgumentException
+secp256k1_bip32_derive_many(): Parameter 6 should not be negative or run past the last child index
+InvalidArgumentException
+secp256k1_bip32_derive_many(): Parameter 7 should be SECP256K1_EC_COMPRESSED or SECP256K1_EC_UNCOMPRESSED
+secp256k1_bip32_derive(): supplied argument is not a Secp256k1\ExtendedKey
+0
+secp256k1_bip32_seckey(): supplied Secp256k1\ExtendedKey has not been initialized
+0
+0
@@ -0,0 +1,19 @@
+--TEST--
+secp256k1_cache_stats reports disabled caches as null
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+var_dump(secp256k1_cache_stats());
+
+?>
+--EXPECT--
+array(2) {
+  ["pubkey"]=>
+  NULL
+  ["sig"]=>
+  NULL
+}
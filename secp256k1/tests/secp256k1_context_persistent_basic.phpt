@@ -0,0 +1,41 @@
+--TEST--
+secp256k1_context_persistent works
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$ctx = secp256k1_context_persistent(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+echo get_resource_type($ctx) . PHP_EOL;
+
+$privKey = str_repeat("\x42", 32);
+$msg32 = hash('sha256', "persistent context", true);
+
+$pubKey = null;
+echo secp256k1_ec_pubkey_create($ctx, $pubKey, $privKey) . PHP_EOL;
+$sig = null;
+echo secp256k1_ecdsa_sign($ctx, $sig, $msg32, $privKey) . PHP_EOL;
+
+// destroying the handle leaves the shared context intact
+echo (secp256k1_context_destroy($ctx) ? "true" : "false") . PHP_EOL;
+
+$ctx2 = secp256k1_context_persistent(SECP256K1_CONTEXT_VERIFY);
+echo get_resource_type($ctx2) . PHP_EOL;
+echo secp256k1_ecdsa_verify($ctx2, $sig, $msg32, $pubKey) . PHP_EOL;
+
+$clone = secp256k1_context_clone($ctx2);
+echo get_resource_type($clone) . PHP_EOL;
+echo secp256k1_ecdsa_verify($clone, $sig, $msg32, $pubKey) . PHP_EOL;
+
+?>
+--EXPECT--
+secp256k1_context
+1
+1
+true
+secp256k1_context
+1
+secp256k1_context
+1
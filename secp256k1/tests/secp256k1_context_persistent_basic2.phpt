@@ -0,0 +1,24 @@
+--TEST--
+secp256k1_context_persistent uses the context created at startup when secp256k1.preload_context is set
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--INI--
+secp256k1.preload_context=1
+--FILE--
+<?php
+
+echo ini_get("secp256k1.preload_context") . PHP_EOL;
+
+$ctx = secp256k1_context_persistent(SECP256K1_CONTEXT_SIGN);
+echo get_resource_type($ctx) . PHP_EOL;
+
+$sig = null;
+echo secp256k1_ecdsa_sign($ctx, $sig, str_repeat("\x01", 32), str_repeat("\x42", 32)) . PHP_EOL;
+
+?>
+--EXPECT--
+1
+secp256k1_context
+1
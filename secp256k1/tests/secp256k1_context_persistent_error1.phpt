@@ -0,0 +1,15 @@
+--TEST--
+secp256k1_context_persistent returns null if provided invalid flags
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$ctx = secp256k1_context_persistent(SECP256K1_CONTEXT_SIGN << 2 | (SECP256K1_CONTEXT_VERIFY+2>>1));
+echo gettype($ctx) . PHP_EOL;
+
+?>
+--EXPECT--
+NULL
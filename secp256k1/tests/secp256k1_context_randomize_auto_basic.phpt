@@ -0,0 +1,63 @@
+--TEST--
+contexts randomized through secp256k1.randomize_ops and secp256k1.randomize_seconds sign as before
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--INI--
+secp256k1.randomize_ops=2
+secp256k1.randomize_seconds=60
+--FILE--
+<?php
+
+$priv = str_repeat("\x42", 32);
+$msg32 = hash('sha256', 'message', true);
+
+function sign_compact($ctx, $msg32, $priv) {
+    $sig = null;
+    secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv);
+    $sig64 = '';
+    secp256k1_ecdsa_signature_serialize_compact($ctx, $sig64, $sig);
+    $pubkey = null;
+    secp256k1_ec_pubkey_create($ctx, $pubkey, $priv);
+    $pub33 = '';
+    secp256k1_ec_pubkey_serialize($ctx, $pub33, $pubkey, SECP256K1_EC_COMPRESSED);
+    return $sig64 . $pub33;
+}
+
+echo ini_get("secp256k1.randomize_ops") . " " . ini_get("secp256k1.randomize_seconds") . PHP_EOL;
+
+ini_set("secp256k1.randomize_ops", "0");
+ini_set("secp256k1.randomize_seconds", "0");
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$expected = sign_compact($ctx, $msg32, $priv);
+
+// blinding changes how the result is computed, not the result
+ini_set("secp256k1.randomize_ops", "2");
+ini_set("secp256k1.randomize_seconds", "60");
+$contexts = [
+    $ctx,
+    secp256k1_context_clone($ctx),
+    secp256k1_context_persistent(SECP256K1_CONTEXT_SIGN),
+];
+foreach ($contexts as $c) {
+    $same = 0;
+    for ($i = 0; $i < 5; $i++) {
+        $same += sign_compact($c, $msg32, $priv) === $expected ? 1 : 0;
+    }
+    echo $same . PHP_EOL;
+}
+
+// a seed passed in restarts the budget
+echo secp256k1_context_randomize($ctx, str_repeat("\x01", 32)) . PHP_EOL;
+echo sign_compact($ctx, $msg32, $priv) === $expected ? "same" : "different";
+echo PHP_EOL;
+
+?>
+--EXPECT--
+2 60
+5
+5
+5
+1
+same
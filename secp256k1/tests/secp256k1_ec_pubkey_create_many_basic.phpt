@@ -0,0 +1,63 @@
+--TEST--
+secp256k1_ec_pubkey_create_many derives and serializes every key
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+$seckeys = [];
+for ($i = 0; $i < 20; $i++) {
+    $seckeys[] = hash('sha256', "key $i", true);
+}
+// zero and the group order are not valid secret keys
+$seckeys[3] = str_repeat("\x00", 32);
+$seckeys[17] = hex2bin("fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141");
+
+foreach ([SECP256K1_EC_COMPRESSED => 33, SECP256K1_EC_UNCOMPRESSED => 65] as $flags => $stride) {
+    $out = null;
+    $valid = null;
+    echo secp256k1_ec_pubkey_create_many($context, $out, $valid, implode('', $seckeys), $flags) . PHP_EOL;
+    echo strlen($out) . " " . bin2hex($valid) . PHP_EOL;
+
+    $matches = 0;
+    foreach ($seckeys as $i => $seckey) {
+        $expected = str_repeat("\x00", $stride);
+        $pubkey = null;
+        if (secp256k1_ec_seckey_verify($context, $seckey)) {
+            secp256k1_ec_pubkey_create($context, $pubkey, $seckey);
+            secp256k1_ec_pubkey_serialize($context, $expected, $pubkey, $flags);
+        }
+        $matches += substr($out, $i * $stride, $stride) === $expected;
+    }
+    echo $matches . PHP_EOL;
+}
+
+// all valid
+$out = null;
+$valid = null;
+echo secp256k1_ec_pubkey_create_many($context, $out, $valid, $seckeys[0] . $seckeys[1], SECP256K1_EC_COMPRESSED) . PHP_EOL;
+echo bin2hex($valid) . PHP_EOL;
+
+// empty input
+$out = null;
+$valid = null;
+echo secp256k1_ec_pubkey_create_many($context, $out, $valid, '', SECP256K1_EC_COMPRESSED) . PHP_EOL;
+var_dump($out, $valid);
+
+?>
+--EXPECT--
+0
+660 f7ff0d
+20
+0
+1300 f7ff0d
+20
+1
+03
+1
+string(0) ""
+string(0) ""
@@ -0,0 +1,31 @@
+--TEST--
+secp256k1_ec_pubkey_create_many throws on invalid parameters
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+foreach ([[str_repeat("\x41", 33), SECP256K1_EC_COMPRESSED], [str_repeat("\x41", 32), 0]] as list($seckeys, $flags)) {
+    $out = null;
+    $valid = null;
+    try {
+        secp256k1_ec_pubkey_create_many($context, $out, $valid, $seckeys, $flags);
+    } catch (\Exception $e) {
+        echo get_class($e) . PHP_EOL;
+        echo $e->getMessage() . PHP_EOL;
+    }
+    var_dump($out);
+}
+
+?>
+--EXPECT--
+InvalidArgumentException
+secp256k1_ec_pubkey_create_many(): Parameter 4 should be a multiple of 32 bytes long
+NULL
+InvalidArgumentException
+secp256k1_ec_pubkey_create_many(): Parameter 5 should be SECP256K1_EC_COMPRESSED or SECP256K1_EC_UNCOMPRESSED
+NULL
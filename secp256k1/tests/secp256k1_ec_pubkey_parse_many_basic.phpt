@@ -0,0 +1,63 @@
+--TEST--
+secp256k1_ec_pubkey_parse_many works
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+
+function serialize_key($ctx, $pubKey) {
+    $out = '';
+    secp256k1_ec_pubkey_serialize($ctx, $out, $pubKey, SECP256K1_EC_COMPRESSED);
+    return bin2hex($out);
+}
+
+$compressed = hex2bin(
+    "0279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798" .
+    // x is larger than the field size
+    "02ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff" .
+    "02f9308a019258c31049344f85f89d5229b531c845836f99b08601f113bce036f9"
+);
+
+$pubKeys = null;
+$valid = null;
+$result = secp256k1_ec_pubkey_parse_many($ctx, $pubKeys, $valid, $compressed, 33);
+echo $result . PHP_EOL;
+echo get_class($pubKeys) . PHP_EOL;
+echo bin2hex($valid) . PHP_EOL;
+echo count($pubKeys) . PHP_EOL;
+echo serialize_key($ctx, $pubKeys->get(0)) . PHP_EOL;
+echo serialize_key($ctx, $pubKeys->get(1)) . PHP_EOL;
+
+// uncompressed keys are appended to the vector passed in
+$uncompressed = hex2bin(
+    "0479be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8" .
+    "042f8bde4d1a07209355b4a7250a5c5128e88b84bddc619ab7cba8d569b240efe4d8ac222636e5e3d6d4dba9dda6c9c426f788271bab0d6840dca87d3aa6ac62d6"
+);
+$result = secp256k1_ec_pubkey_parse_many($ctx, $pubKeys, $valid, $uncompressed, 65);
+echo $result . PHP_EOL;
+echo bin2hex($valid) . PHP_EOL;
+echo count($pubKeys) . PHP_EOL;
+echo serialize_key($ctx, $pubKeys->get(3)) . PHP_EOL;
+
+$empty = null;
+$result = secp256k1_ec_pubkey_parse_many($ctx, $empty, $valid, "", 33);
+echo $result . PHP_EOL;
+echo count($empty) . " " . strlen($valid) . PHP_EOL;
+
+?>
+--EXPECT--
+0
+Secp256k1\PublicKeyVector
+05
+2
+0279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798
+02f9308a019258c31049344f85f89d5229b531c845836f99b08601f113bce036f9
+1
+03
+4
+022f8bde4d1a07209355b4a7250a5c5128e88b84bddc619ab7cba8d569b240efe4
+1
+0 0
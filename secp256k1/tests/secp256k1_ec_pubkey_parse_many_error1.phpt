@@ -0,0 +1,28 @@
+--TEST--
+secp256k1_ec_pubkey_parse_many throws if the input or stride is invalid
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+
+$pubKeys = null;
+$valid = null;
+try {
+    secp256k1_ec_pubkey_parse_many($ctx, $pubKeys, $valid, str_repeat("\x02", 64), 32);
+} catch (\Exception $e) {
+    echo $e->getMessage() . PHP_EOL;
+}
+
+try {
+    secp256k1_ec_pubkey_parse_many($ctx, $pubKeys, $valid, str_repeat("\x02", 34), 33);
+} catch (\Exception $e) {
+    echo $e->getMessage() . PHP_EOL;
+}
+
+?>
+--EXPECT--
+secp256k1_ec_pubkey_parse_many(): Parameter 5 should be 33 or 65
+secp256k1_ec_pubkey_parse_many(): Parameter 4 should be a multiple of stride bytes long
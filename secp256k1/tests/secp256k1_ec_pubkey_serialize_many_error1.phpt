@@ -0,0 +1,30 @@
+--TEST--
+secp256k1_ec_pubkey_serialize_many rejects invalid flags and keys
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+set_error_handler(function($code, $str) { echo $str . PHP_EOL; });
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+$out = null;
+try {
+    secp256k1_ec_pubkey_serialize_many($ctx, $out, [], 0);
+} catch (\Exception $e) {
+    echo $e->getMessage() . PHP_EOL;
+}
+
+$result = secp256k1_ec_pubkey_serialize_many($ctx, $out, [tmpfile()], SECP256K1_EC_COMPRESSED);
+echo $result . PHP_EOL;
+var_dump($out);
+
+?>
+--EXPECT--
+secp256k1_ec_pubkey_serialize_many(): Parameter 4 should be SECP256K1_EC_COMPRESSED or SECP256K1_EC_UNCOMPRESSED
+secp256k1_ec_pubkey_serialize_many(): supplied resource is not a valid secp256k1_pubkey resource
+0
+NULL
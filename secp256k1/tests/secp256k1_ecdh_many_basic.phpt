@@ -0,0 +1,63 @@
+--TEST--
+secp256k1_ecdh_many matches secp256k1_ecdh for every key
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+if (!function_exists("secp256k1_ecdh_many")) print "skip no ecdh support";
+?>
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$scanKey = str_pad('', 32, "\x40");
+
+$pubKeys = [];
+$vector = new \Secp256k1\PublicKeyVector();
+for ($i = 1; $i <= 20; $i++) {
+    $pubKey = null;
+    secp256k1_ec_pubkey_create($context, $pubKey, str_pad('', 32, chr($i)));
+    $pubKeys[] = $pubKey;
+    $vector->append($pubKey);
+}
+
+foreach ([SECP256K1_ECDH_HASH_DEFAULT, SECP256K1_ECDH_HASH_XY, SECP256K1_ECDH_HASH_TAGGED_X] as $mode) {
+    $data = $mode === SECP256K1_ECDH_HASH_TAGGED_X ? "scan" : null;
+    $expected = '';
+    foreach ($pubKeys as $pubKey) {
+        $secret = '';
+        secp256k1_ecdh($context, $secret, $pubKey, $scanKey, $mode, null, $data);
+        $expected .= $secret;
+    }
+
+    $fromArray = '';
+    echo secp256k1_ecdh_many($context, $fromArray, $scanKey, $pubKeys, $mode, $data) . PHP_EOL;
+    $fromVector = '';
+    echo secp256k1_ecdh_many($context, $fromVector, $scanKey, $vector, $mode, $data) . PHP_EOL;
+    echo strlen($fromArray) . " " . (int) ($fromArray === $expected) . " " . (int) ($fromVector === $expected) . PHP_EOL;
+}
+
+// no keys, no secrets
+$secrets = null;
+echo secp256k1_ecdh_many($context, $secrets, $scanKey, []) . PHP_EOL;
+var_dump($secrets);
+
+// an invalid secret key fails once, leaving secrets untouched
+$secrets = null;
+echo secp256k1_ecdh_many($context, $secrets, str_pad('', 32, "\x00"), $pubKeys) . PHP_EOL;
+var_dump($secrets);
+
+?>
+--EXPECT--
+1
+1
+640 1 1
+1
+1
+1280 1 1
+1
+1
+640 1 1
+1
+string(0) ""
+0
+NULL
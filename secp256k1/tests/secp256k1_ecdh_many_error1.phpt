@@ -0,0 +1,54 @@
+--TEST--
+secp256k1_ecdh_many throws on invalid parameters
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+if (!function_exists("secp256k1_ecdh_many")) print "skip no ecdh support";
+?>
+--FILE--
+<?php
+
+set_error_handler(function($code, $str) { echo $str . PHP_EOL; });
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$scanKey = str_pad('', 32, "\x40");
+$pubKey = null;
+secp256k1_ec_pubkey_create($context, $pubKey, str_pad('', 32, "\x41"));
+
+$calls = [
+    [str_pad('', 31, "\x40"), [$pubKey], SECP256K1_ECDH_HASH_DEFAULT, null],
+    [$scanKey, "not keys", SECP256K1_ECDH_HASH_DEFAULT, null],
+    [$scanKey, [$pubKey], -1, null],
+    [$scanKey, [$pubKey], SECP256K1_ECDH_HASH_TAGGED_X, null],
+];
+foreach ($calls as list($key, $keys, $mode, $data)) {
+    $secrets = null;
+    try {
+        secp256k1_ecdh_many($context, $secrets, $key, $keys, $mode, $data);
+    } catch (\Exception $e) {
+        echo get_class($e) . PHP_EOL;
+        echo $e->getMessage() . PHP_EOL;
+    }
+}
+
+// keys which are not public keys throw
+$secrets = null;
+try {
+    secp256k1_ecdh_many($context, $secrets, $scanKey, [$pubKey, 1]);
+} catch (\Exception $e) {
+    echo get_class($e) . PHP_EOL;
+    echo $e->getMessage() . PHP_EOL;
+}
+
+?>
+--EXPECT--
+InvalidArgumentException
+secp256k1_ecdh_many(): Parameter 3 should be 32 bytes
+InvalidArgumentException
+secp256k1_ecdh_many(): Parameter 4 should be an array or Secp256k1\PublicKeyVector
+InvalidArgumentException
+secp256k1_ecdh_many(): Parameter 5 should be a SECP256K1_ECDH_HASH_* constant
+InvalidArgumentException
+secp256k1_ecdh_many(): Parameter 6 should be the tag for SECP256K1_ECDH_HASH_TAGGED_X
+InvalidArgumentException
+secp256k1_ecdh_many(): Parameter 4 should only hold secp256k1_pubkey resources or Secp256k1\PublicKey objects
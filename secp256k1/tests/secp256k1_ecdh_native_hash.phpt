@@ -0,0 +1,70 @@
+--TEST--
+secp256k1_ecdh supports native hash modes
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$priv1 = str_pad('', 32, "\x41");
+$priv2 = str_pad('', 32, "\x40");
+
+/** @var resource $pub1 */
+$pub1 = null;
+$result = \secp256k1_ec_pubkey_create($context, $pub1, $priv1);
+echo $result . PHP_EOL;
+
+$modes = [
+    'DEFAULT' => SECP256K1_ECDH_HASH_DEFAULT,
+    'X' => SECP256K1_ECDH_HASH_X,
+    'XY' => SECP256K1_ECDH_HASH_XY,
+    'SHA256_X' => SECP256K1_ECDH_HASH_SHA256_X,
+    'SHA512_XY' => SECP256K1_ECDH_HASH_SHA512_XY,
+];
+foreach ($modes as $name => $mode) {
+    $secret = '';
+    $result = \secp256k1_ecdh($context, $secret, $pub1, $priv2, $mode);
+    echo $name . " " . $result . " " . bin2hex($secret) . PHP_EOL;
+}
+
+// the output length may be given, as long as it matches the mode
+$secret = '';
+$result = \secp256k1_ecdh($context, $secret, $pub1, $priv2, SECP256K1_ECDH_HASH_SHA512_XY, 64);
+echo $result . " " . strlen($secret) . PHP_EOL;
+
+// null selects the library default
+$default = '';
+$secret = '';
+\secp256k1_ecdh($context, $default, $pub1, $priv2);
+\secp256k1_ecdh($context, $secret, $pub1, $priv2, null);
+echo (int) ($secret === $default) . PHP_EOL;
+
+// the tag is passed as data
+$secret = '';
+$result = \secp256k1_ecdh($context, $secret, $pub1, $priv2, SECP256K1_ECDH_HASH_TAGGED_X, null, "ECDH/test");
+echo "TAGGED_X " . $result . " " . bin2hex($secret) . PHP_EOL;
+
+// and matches the same derivation done in PHP
+$tagged = function (&$output, $x, $y, $tag) {
+    $taghash = hash('sha256', $tag, true);
+    $output = hash('sha256', $taghash . $taghash . $x, true);
+    return 1;
+};
+$viaPhp = '';
+\secp256k1_ecdh($context, $viaPhp, $pub1, $priv2, $tagged, 32, "ECDH/test");
+echo (int) ($viaPhp === $secret) . PHP_EOL;
+
+?>
+--EXPECT--
+1
+DEFAULT 1 238c14f420887f8e9bfa78bc9bdded1975f0bb6384e33b4ebbf7a8c776844aec
+X 1 17d1ee664632a741f87da19c82d4fc8352368305062370769cf78779ad6ad250
+XY 1 17d1ee664632a741f87da19c82d4fc8352368305062370769cf78779ad6ad25070d091c815ec945c61c282e60be6da41423b00b415d76e44ae58a343d670797b
+SHA256_X 1 24424b02d109bc1435343df60b38ab33c0f1969d18b4742ec76829560d8c673c
+SHA512_XY 1 0eaebfee28d7041e4400282584dea6b3e853358785b4f30a90480aca7b0de24869eaaa97ba90eb401c97b77f009dbec7c7f9f7f1b4db1338c8e2cc4bd8474bed
+1 64
+1
+TAGGED_X 1 4ac77d08925646e1deec7e6d48fde0c8957b3b8a99dda782e052b590c456657a
+1
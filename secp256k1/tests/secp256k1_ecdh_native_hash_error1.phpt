@@ -0,0 +1,65 @@
+--TEST--
+secp256k1_ecdh rejects unknown hash modes and bad output lengths
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$priv1 = str_pad('', 32, "\x41");
+$priv2 = str_pad('', 32, "\x40");
+
+$pub1 = null;
+\secp256k1_ec_pubkey_create($context, $pub1, $priv1);
+
+$calls = [
+    function (&$secret) use ($context, $pub1, $priv2) {
+        return \secp256k1_ecdh($context, $secret, $pub1, $priv2, 99);
+    },
+    function (&$secret) use ($context, $pub1, $priv2) {
+        return \secp256k1_ecdh($context, $secret, $pub1, $priv2, "not a function");
+    },
+    function (&$secret) use ($context, $pub1, $priv2) {
+        return \secp256k1_ecdh($context, $secret, $pub1, $priv2, SECP256K1_ECDH_HASH_X, 16);
+    },
+    function (&$secret) use ($context, $pub1, $priv2) {
+        return \secp256k1_ecdh($context, $secret, $pub1, $priv2, SECP256K1_ECDH_HASH_TAGGED_X);
+    },
+    function (&$secret) use ($context, $pub1, $priv2) {
+        return \secp256k1_ecdh($context, $secret, $pub1, $priv2, function (&$out, $x, $y) {
+            $out = $x;
+            return 1;
+        }, 0);
+    },
+];
+
+foreach ($calls as $call) {
+    $secret = 'untouched';
+    try {
+        $call($secret);
+    } catch (\Exception $e) {
+        echo get_class($e) . PHP_EOL;
+        echo $e->getMessage() . PHP_EOL;
+    }
+    echo $secret . PHP_EOL;
+}
+
+?>
+--EXPECT--
+InvalidArgumentException
+secp256k1_ecdh(): Parameter 5 should be a callable or a SECP256K1_ECDH_HASH_* constant
+untouched
+InvalidArgumentException
+secp256k1_ecdh(): Parameter 5 should be a callable or a SECP256K1_ECDH_HASH_* constant
+untouched
+InvalidArgumentException
+secp256k1_ecdh(): Parameter 6 should be 32 for this hash mode
+untouched
+InvalidArgumentException
+secp256k1_ecdh(): Parameter 7 should be the tag for SECP256K1_ECDH_HASH_TAGGED_X
+untouched
+InvalidArgumentException
+secp256k1_ecdh(): Parameter 6 should be greater than zero
+untouched
@@ -0,0 +1,60 @@
+--TEST--
+secp256k1_ecdsa_recover_address and secp256k1_ecdsa_recover_address_many recover Ethereum addresses
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+if (!function_exists("secp256k1_ecdsa_recover_address")) print "skip no recovery support";
+?>
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+$records = '';
+$msgs = '';
+for ($i = 1; $i <= 3; $i++) {
+    $seckey = str_pad(chr($i), 32, "\x00", STR_PAD_LEFT);
+    $msg32 = hash('sha256', "message $i", true);
+    $signature = null;
+    $sig64 = '';
+    $recid = 0;
+    secp256k1_ecdsa_sign_recoverable($context, $signature, $msg32, $seckey);
+    secp256k1_ecdsa_recoverable_signature_serialize_compact($context, $sig64, $recid, $signature);
+    $record = $sig64 . chr($recid + 27);
+
+    $address = null;
+    echo secp256k1_ecdsa_recover_address($context, $address, $record, $msg32) . " " . bin2hex($address) . PHP_EOL;
+    echo secp256k1_ecdsa_recover_address($context, $address, $sig64 . chr($recid), $msg32) . " " . bin2hex($address) . PHP_EOL;
+
+    $records .= $record;
+    $msgs .= $msg32;
+}
+
+// r = 0 does not recover
+$bad = str_repeat("\x00", 32) . substr($records, 32, 33);
+$address = null;
+echo secp256k1_ecdsa_recover_address($context, $address, $bad, substr($msgs, 0, 32)) . PHP_EOL;
+var_dump($address);
+
+$addresses = null;
+$valid = null;
+echo secp256k1_ecdsa_recover_address_many($context, $addresses, $valid, $records . $bad, $msgs . substr($msgs, 0, 32)) . " " . bin2hex($valid) . PHP_EOL;
+foreach (str_split($addresses, 20) as $address) {
+    echo bin2hex($address) . PHP_EOL;
+}
+
+?>
+--EXPECT--
+1 7e5f4552091a69125d5dfcb7b8c2659029395bdf
+1 7e5f4552091a69125d5dfcb7b8c2659029395bdf
+1 2b5ad5c4795c026514f8317c7a215e218dccd6cf
+1 2b5ad5c4795c026514f8317c7a215e218dccd6cf
+1 6813eb9362372eef6200f3b1dbc3f819671cba69
+1 6813eb9362372eef6200f3b1dbc3f819671cba69
+0
+NULL
+0 07
+7e5f4552091a69125d5dfcb7b8c2659029395bdf
+2b5ad5c4795c026514f8317c7a215e218dccd6cf
+6813eb9362372eef6200f3b1dbc3f819671cba69
+0000000000000000000000000000000000000000
@@ -0,0 +1,39 @@
+--TEST--
+secp256k1_ecdsa_recover_address throws on invalid parameters
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+if (!function_exists("secp256k1_ecdsa_recover_address")) print "skip no recovery support";
+?>
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$record = str_repeat("\x01", 65);
+$msg32 = str_repeat("\x02", 32);
+
+$calls = [
+    function () use ($context, $msg32) { $out = null; return secp256k1_ecdsa_recover_address($context, $out, str_repeat("\x01", 64), $msg32); },
+    function () use ($context, $record) { $out = null; return secp256k1_ecdsa_recover_address($context, $out, $record, "\x02"); },
+    function () use ($context, $record, $msg32) { $out = null; $valid = null; return secp256k1_ecdsa_recover_address_many($context, $out, $valid, $record . "\x00", $msg32); },
+    function () use ($context, $record, $msg32) { $out = null; $valid = null; return secp256k1_ecdsa_recover_address_many($context, $out, $valid, $record, $msg32 . "\x00"); },
+];
+foreach ($calls as $call) {
+    try {
+        $call();
+    } catch (\Exception $e) {
+        echo get_class($e) . PHP_EOL;
+        echo $e->getMessage() . PHP_EOL;
+    }
+}
+
+?>
+--EXPECT--
+InvalidArgumentException
+secp256k1_ecdsa_recover_address(): Parameter 3 should be 65 bytes
+InvalidArgumentException
+secp256k1_ecdsa_recover_address(): Parameter 4 should be 32 bytes
+InvalidArgumentException
+secp256k1_ecdsa_recover_address_many(): Parameter 4 should be a multiple of 65 bytes long
+InvalidArgumentException
+secp256k1_ecdsa_recover_address_many(): Parameter 5 should be 32 bytes for each signature
@@ -0,0 +1,75 @@
+--TEST--
+secp256k1_ecdsa_recover_many recovers every key from r || s || v records
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+if (!function_exists("secp256k1_ecdsa_recover_many")) print "skip no recovery support";
+?>
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+$records = '';
+$msgs = '';
+$pubkeys = [];
+for ($i = 0; $i < 20; $i++) {
+    $seckey = hash('sha256', "key $i", true);
+    $msg32 = hash('sha256', "message $i", true);
+    $signature = null;
+    $sig64 = '';
+    $recid = 0;
+    secp256k1_ecdsa_sign_recoverable($context, $signature, $msg32, $seckey);
+    secp256k1_ecdsa_recoverable_signature_serialize_compact($context, $sig64, $recid, $signature);
+    // both conventions for v
+    $records .= $sig64 . chr($i % 2 ? $recid + 27 : $recid);
+    $msgs .= $msg32;
+    $pubkeys[$i] = null;
+    secp256k1_ec_pubkey_create($context, $pubkeys[$i], $seckey);
+}
+// an out of range v, and r = 0
+$records[4 * 65 + 64] = chr(31);
+$records = substr_replace($records, str_repeat("\x00", 32), 9 * 65, 32);
+
+foreach ([SECP256K1_EC_COMPRESSED => 33, SECP256K1_EC_UNCOMPRESSED => 65] as $flags => $stride) {
+    $out = null;
+    $valid = null;
+    echo secp256k1_ecdsa_recover_many($context, $out, $valid, $records, $msgs, $flags) . PHP_EOL;
+    echo strlen($out) . " " . bin2hex($valid) . PHP_EOL;
+
+    $matches = 0;
+    foreach ($pubkeys as $i => $pubkey) {
+        $expected = str_repeat("\x00", $stride);
+        if ($i !== 4 && $i !== 9) {
+            secp256k1_ec_pubkey_serialize($context, $expected, $pubkey, $flags);
+        }
+        $matches += substr($out, $i * $stride, $stride) === $expected;
+    }
+    echo $matches . PHP_EOL;
+}
+
+// all valid
+$out = null;
+$valid = null;
+echo secp256k1_ecdsa_recover_many($context, $out, $valid, substr($records, 0, 130), substr($msgs, 0, 64), SECP256K1_EC_COMPRESSED) . PHP_EOL;
+echo bin2hex($valid) . PHP_EOL;
+
+// empty input
+$out = null;
+$valid = null;
+echo secp256k1_ecdsa_recover_many($context, $out, $valid, '', '', SECP256K1_EC_COMPRESSED) . PHP_EOL;
+var_dump($out, $valid);
+
+?>
+--EXPECT--
+0
+660 effd0f
+20
+0
+1300 effd0f
+20
+1
+03
+1
+string(0) ""
+string(0) ""
@@ -0,0 +1,41 @@
+--TEST--
+secp256k1_ecdsa_recover_many throws on invalid parameters
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+if (!function_exists("secp256k1_ecdsa_recover_many")) print "skip no recovery support";
+?>
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$record = str_repeat("\x01", 65);
+$msg32 = str_repeat("\x02", 32);
+
+$calls = [
+    [$record . "\x00", $msg32, SECP256K1_EC_COMPRESSED],
+    [$record, $msg32 . $msg32, SECP256K1_EC_COMPRESSED],
+    [$record . $record, $msg32, SECP256K1_EC_COMPRESSED],
+    [$record, $msg32, 7],
+];
+foreach ($calls as list($records, $msgs, $flags)) {
+    $out = null;
+    $valid = null;
+    try {
+        secp256k1_ecdsa_recover_many($context, $out, $valid, $records, $msgs, $flags);
+    } catch (\Exception $e) {
+        echo get_class($e) . PHP_EOL;
+        echo $e->getMessage() . PHP_EOL;
+    }
+}
+
+?>
+--EXPECT--
+InvalidArgumentException
+secp256k1_ecdsa_recover_many(): Parameter 4 should be a multiple of 65 bytes long
+InvalidArgumentException
+secp256k1_ecdsa_recover_many(): Parameter 5 should be 32 bytes for each signature
+InvalidArgumentException
+secp256k1_ecdsa_recover_many(): Parameter 5 should be 32 bytes for each signature
+InvalidArgumentException
+secp256k1_ecdsa_recover_many(): Parameter 6 should be SECP256K1_EC_COMPRESSED or SECP256K1_EC_UNCOMPRESSED
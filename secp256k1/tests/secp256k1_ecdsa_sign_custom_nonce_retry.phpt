@@ -0,0 +1,56 @@
+--TEST--
+secp256k1_ecdsa_sign calls a custom nonce function again for each attempt
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$msg32 = \pack("H*", "9e5755ec2f328cc8635a55415d0e9a09c2b6f2c9b0343c945fbbfe08247a4cbe");
+$priv = \pack("H*", "31a84594060e103f5a63eb742bd46cf5f5900d8406e2726dedfc61c7cf43ebad");
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+// a zero nonce is rejected by libsecp256k1, which asks for another attempt.
+// the arguments are kept across attempts to check they are not overwritten.
+$seen = [];
+$nonceFn = function (&$nonce, $msg32, $key32, $algo16, $data, $attempt) use (&$seen) {
+    $seen[] = [$msg32, $key32, $data, $attempt, $nonce];
+    $nonce = $attempt === 0 ? str_repeat("\x00", 32) : hash('sha256', $key32 . $msg32, true);
+    return 1;
+};
+
+$sig = null;
+echo secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv, $nonceFn, "data") . PHP_EOL;
+echo count($seen) . PHP_EOL;
+foreach ($seen as list($msg, $key, $data, $attempt, $nonce)) {
+    echo $attempt . " " . (int) ($msg === $msg32) . " " . (int) ($key === $priv) . " " . $data . " " . var_export($nonce, true) . PHP_EOL;
+}
+
+$pubkey = null;
+secp256k1_ec_pubkey_create($ctx, $pubkey, $priv);
+echo secp256k1_ecdsa_verify($ctx, $sig, $msg32, $pubkey) . PHP_EOL;
+
+// the output is reset for every invocation, so a callback which doesn't
+// write a nonce fails even after a previous attempt did
+$calls = 0;
+$lazyFn = function (&$nonce, $msg32, $key32, $algo16, $data, $attempt) use (&$calls) {
+    $calls++;
+    if ($attempt === 0) {
+        $nonce = str_repeat("\x00", 32);
+    }
+    return 1;
+};
+echo secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv, $lazyFn) . PHP_EOL;
+echo $calls . PHP_EOL;
+
+?>
+--EXPECT--
+1
+2
+0 1 1 data ''
+1 1 1 data ''
+1
+0
+2
@@ -0,0 +1,51 @@
+--TEST--
+secp256k1_ecdsa_sign with the builtin nonce functions matches calling them through a closure
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$msg32 = \pack("H*", "9e5755ec2f328cc8635a55415d0e9a09c2b6f2c9b0343c945fbbfe08247a4cbe");
+$priv = \pack("H*", "31a84594060e103f5a63eb742bd46cf5f5900d8406e2726dedfc61c7cf43ebad");
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+// the closure forces the nonce to be computed by calling back into PHP
+$wrapped = function (&$nonce, $msg32, $key32, $algo16, $data, $attempt) {
+    return secp256k1_nonce_function_rfc6979($nonce, $msg32, $key32, $algo16, $data, $attempt);
+};
+
+function sign_der($ctx, $msg32, $priv, $noncefp, $data) {
+    $sig = null;
+    $result = secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv, $noncefp, $data);
+    if (!$result) {
+        return "failed";
+    }
+    $der = "";
+    secp256k1_ecdsa_signature_serialize_der($ctx, $der, $sig);
+    return bin2hex($der);
+}
+
+foreach ([null, str_repeat("A", 32)] as $data) {
+    $viaPhp = sign_der($ctx, $msg32, $priv, $wrapped, $data);
+    echo (int) ($viaPhp === sign_der($ctx, $msg32, $priv, 'secp256k1_nonce_function_rfc6979', $data)) . PHP_EOL;
+    echo (int) ($viaPhp === sign_der($ctx, $msg32, $priv, 'secp256k1_nonce_function_default', $data)) . PHP_EOL;
+}
+
+// data of the wrong size or type is rejected the same way on both paths
+foreach (["AAAA", 1] as $data) {
+    echo sign_der($ctx, $msg32, $priv, $wrapped, $data) . PHP_EOL;
+    echo sign_der($ctx, $msg32, $priv, 'secp256k1_nonce_function_rfc6979', $data) . PHP_EOL;
+}
+
+?>
+--EXPECT--
+1
+1
+1
+1
+failed
+failed
+failed
+failed
@@ -0,0 +1,71 @@
+--TEST--
+secp256k1_ecdsa_verify_batch works
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+$privs = [
+    \pack("H*", "31a84594060e103f5a63eb742bd46cf5f5900d8406e2726dedfc61c7cf43ebad"),
+    \pack("H*", "17a2209250b59f07a25b560aa09cb395a183eb260797c0396b82904f918518d5"),
+    \pack("H*", "88b59280e39997e49ebd47ecc9e3850faff5d7df1e2a22248c136cbdd0d60aae"),
+];
+$msgs = [
+    \pack("H*", "9e5755ec2f328cc8635a55415d0e9a09c2b6f2c9b0343c945fbbfe08247a4cbe"),
+    \pack("H*", "844afb89e72c14f4455e1232852c4f210a5533fb2454be422268dabab22a225c"),
+    hash('sha256', 'this is a message!', true),
+];
+
+$sigs = [];
+$pubs = [];
+foreach ($privs as $i => $priv) {
+    $sig = null;
+    $pub = null;
+    echo secp256k1_ecdsa_sign($ctx, $sig, $msgs[$i], $priv) . PHP_EOL;
+    echo secp256k1_ec_pubkey_create($ctx, $pub, $priv) . PHP_EOL;
+    $sigs[] = $sig;
+    $pubs[] = $pub;
+}
+
+echo "all valid:" . PHP_EOL;
+echo secp256k1_ecdsa_verify_batch($ctx, $sigs, $msgs, $pubs) . PHP_EOL;
+$results = null;
+echo secp256k1_ecdsa_verify_batch($ctx, $sigs, $msgs, $pubs, $results) . PHP_EOL;
+echo bin2hex($results) . PHP_EOL;
+
+echo "second invalid:" . PHP_EOL;
+$badMsgs = $msgs;
+$badMsgs[1] = $msgs[0];
+echo secp256k1_ecdsa_verify_batch($ctx, $sigs, $badMsgs, $pubs) . PHP_EOL;
+$results = null;
+echo secp256k1_ecdsa_verify_batch($ctx, $sigs, $badMsgs, $pubs, $results) . PHP_EOL;
+echo bin2hex($results) . PHP_EOL;
+
+echo "empty batch:" . PHP_EOL;
+$results = null;
+echo secp256k1_ecdsa_verify_batch($ctx, [], [], [], $results) . PHP_EOL;
+echo strlen($results) . PHP_EOL;
+
+?>
+--EXPECT--
+1
+1
+1
+1
+1
+1
+all valid:
+1
+1
+07
+second invalid:
+0
+0
+05
+empty batch:
+1
+0
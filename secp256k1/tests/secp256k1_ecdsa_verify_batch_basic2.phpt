@@ -0,0 +1,44 @@
+--TEST--
+secp256k1_ecdsa_verify_batch returns results in input order when using worker threads
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--INI--
+secp256k1.threads=4
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+$sigs = [];
+$msgs = [];
+$pubKeys = [];
+for ($i = 0; $i < 40; $i++) {
+    $privKey = hash('sha256', "key $i", true);
+    $msgs[] = hash('sha256', "msg $i", true);
+    $pubKey = null;
+    $sig = null;
+    secp256k1_ec_pubkey_create($ctx, $pubKey, $privKey);
+    secp256k1_ecdsa_sign($ctx, $sig, $msgs[$i], $privKey);
+    $pubKeys[] = $pubKey;
+    $sigs[] = $sig;
+}
+
+$results = null;
+echo secp256k1_ecdsa_verify_batch($ctx, $sigs, $msgs, $pubKeys, $results) . PHP_EOL;
+echo bin2hex($results) . PHP_EOL;
+
+// invalidate index 37
+$msgs[37] = hash('sha256', "other", true);
+echo secp256k1_ecdsa_verify_batch($ctx, $sigs, $msgs, $pubKeys) . PHP_EOL;
+echo secp256k1_ecdsa_verify_batch($ctx, $sigs, $msgs, $pubKeys, $results) . PHP_EOL;
+echo bin2hex($results) . PHP_EOL;
+
+?>
+--EXPECT--
+1
+ffffffffff
+0
+0
+ffffffffdf
@@ -0,0 +1,31 @@
+--TEST--
+secp256k1_ecdsa_verify_batch throws if the arrays have different sizes
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$priv = \pack("H*", "31a84594060e103f5a63eb742bd46cf5f5900d8406e2726dedfc61c7cf43ebad");
+$msg32 = \pack("H*", "9e5755ec2f328cc8635a55415d0e9a09c2b6f2c9b0343c945fbbfe08247a4cbe");
+
+$sig = null;
+$pub = null;
+echo secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv) . PHP_EOL;
+echo secp256k1_ec_pubkey_create($ctx, $pub, $priv) . PHP_EOL;
+
+try {
+    secp256k1_ecdsa_verify_batch($ctx, [$sig], [$msg32, $msg32], [$pub]);
+} catch (\Exception $e) {
+    echo get_class($e) . PHP_EOL;
+    echo $e->getMessage() . PHP_EOL;
+}
+
+?>
+--EXPECT--
+1
+1
+InvalidArgumentException
+secp256k1_ecdsa_verify_batch(): Parameters 2, 3 and 4 should have the same number of elements
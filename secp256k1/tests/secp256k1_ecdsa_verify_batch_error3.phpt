@@ -0,0 +1,25 @@
+--TEST--
+secp256k1_ecdsa_verify_batch errors when a public key is wrong resource type
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+set_error_handler(function($code, $str) { echo $str . PHP_EOL; });
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$priv = \pack("H*", "31a84594060e103f5a63eb742bd46cf5f5900d8406e2726dedfc61c7cf43ebad");
+$msg32 = \pack("H*", "9e5755ec2f328cc8635a55415d0e9a09c2b6f2c9b0343c945fbbfe08247a4cbe");
+
+$sig = null;
+echo secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv) . PHP_EOL;
+
+$result = secp256k1_ecdsa_verify_batch($ctx, [$sig], [$msg32], [tmpfile()]);
+echo $result . PHP_EOL;
+
+?>
+--EXPECT--
+1
+secp256k1_ecdsa_verify_batch(): supplied resource is not a valid secp256k1_pubkey resource
+0
@@ -0,0 +1,51 @@
+--TEST--
+secp256k1_ecdsa_verify_batch refuses a context without VERIFY, with or without worker threads
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--INI--
+secp256k1.threads=4
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$signCtx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN);
+
+$sigs = [];
+$msgs = [];
+$pubKeys = [];
+for ($i = 0; $i < 40; $i++) {
+    $privKey = hash('sha256', "key $i", true);
+    $msgs[] = hash('sha256', "msg $i", true);
+    $pubKey = null;
+    $sig = null;
+    secp256k1_ec_pubkey_create($ctx, $pubKey, $privKey);
+    secp256k1_ecdsa_sign($ctx, $sig, $msgs[$i], $privKey);
+    $pubKeys[] = $pubKey;
+    $sigs[] = $sig;
+}
+
+// 40 items go to the worker threads, 2 stay on the calling thread
+foreach ([40, 2] as $n) {
+    $results = "unchanged";
+    try {
+        secp256k1_ecdsa_verify_batch($signCtx, array_slice($sigs, 0, $n), array_slice($msgs, 0, $n), array_slice($pubKeys, 0, $n), $results);
+    } catch (\Exception $e) {
+        echo get_class($e) . PHP_EOL;
+        echo $e->getMessage() . PHP_EOL;
+    }
+    echo $results . PHP_EOL;
+}
+
+echo secp256k1_ecdsa_verify_batch($ctx, $sigs, $msgs, $pubKeys) . PHP_EOL;
+
+?>
+--EXPECT--
+InvalidArgumentException
+secp256k1_ecdsa_verify_batch(): Parameter 1 should be a context created with SECP256K1_CONTEXT_VERIFY
+unchanged
+InvalidArgumentException
+secp256k1_ecdsa_verify_batch(): Parameter 1 should be a context created with SECP256K1_CONTEXT_VERIFY
+unchanged
+1
@@ -0,0 +1,60 @@
+--TEST--
+secp256k1_ecdsa_verify_raw verifies encoded signatures against encoded public keys
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$msg32 = hash('sha256', 'this is a message!', true);
+
+$der = hex2bin("3044022055ef6953afd139d917d947ba7823ab5dfb9239ba8a26295a218cad88fb7299ef022057147cf4233ff3b87fa64d82a0b9a327e9b6d5d0070ab3f671b795934c4f2074");
+// r with a superfluous leading zero, which only the lax parser accepts
+$lax = hex2bin("304502210055ef6953afd139d917d947ba7823ab5dfb9239ba8a26295a218cad88fb7299ef022057147cf4233ff3b87fa64d82a0b9a327e9b6d5d0070ab3f671b795934c4f2074");
+// the same signature with s negated
+$highS = hex2bin("3045022055ef6953afd139d917d947ba7823ab5dfb9239ba8a26295a218cad88fb7299ef022100a8eb830bdcc00c478059b27d5f465cd6d0f80716a83dec454e1ac8f983e720cd");
+$compact = hex2bin("55ef6953afd139d917d947ba7823ab5dfb9239ba8a26295a218cad88fb7299ef57147cf4233ff3b87fa64d82a0b9a327e9b6d5d0070ab3f671b795934c4f2074");
+$pub65 = hex2bin("04fae8f5e64c9997749ef65c5db9f0ec3e121dc6901096c30da0f105a13212b6db4315e65a2d63cc667c034fac05cdb3c7bc1abfc2ad90f7f97321613f901758c9");
+$pub33 = hex2bin("03fae8f5e64c9997749ef65c5db9f0ec3e121dc6901096c30da0f105a13212b6db");
+
+echo secp256k1_ecdsa_verify_raw($context, $der, $msg32, $pub65) . PHP_EOL;
+echo secp256k1_ecdsa_verify_raw($context, $der, $msg32, $pub33, SECP256K1_SIG_FORMAT_DER) . PHP_EOL;
+echo secp256k1_ecdsa_verify_raw($context, $lax, $msg32, $pub33) . PHP_EOL;
+echo secp256k1_ecdsa_verify_raw($context, $lax, $msg32, $pub33, SECP256K1_SIG_FORMAT_DER_LAX) . PHP_EOL;
+echo secp256k1_ecdsa_verify_raw($context, $compact, $msg32, $pub33, SECP256K1_SIG_FORMAT_COMPACT) . PHP_EOL;
+echo secp256k1_ecdsa_verify_raw($context, $der, $msg32, $pub33, SECP256K1_SIG_FORMAT_COMPACT) . PHP_EOL;
+echo secp256k1_ecdsa_verify_raw($context, $highS, $msg32, $pub33) . PHP_EOL;
+echo secp256k1_ecdsa_verify_raw($context, $highS, $msg32, $pub33, SECP256K1_SIG_FORMAT_DER | SECP256K1_SIG_ALLOW_HIGH_S) . PHP_EOL;
+echo "--" . PHP_EOL;
+// wrong message, unparseable key
+echo secp256k1_ecdsa_verify_raw($context, $der, hash('sha256', 'another message', true), $pub33) . PHP_EOL;
+echo secp256k1_ecdsa_verify_raw($context, $der, $msg32, substr($pub33, 1)) . PHP_EOL;
+
+try {
+    secp256k1_ecdsa_verify_raw($context, $der, "\x00", $pub33);
+} catch (\Exception $e) {
+    echo $e->getMessage() . PHP_EOL;
+}
+try {
+    secp256k1_ecdsa_verify_raw($context, $der, $msg32, $pub33, 3);
+} catch (\Exception $e) {
+    echo $e->getMessage() . PHP_EOL;
+}
+
+?>
+--EXPECT--
+1
+1
+0
+1
+1
+0
+0
+1
+--
+0
+0
+secp256k1_ecdsa_verify_raw(): Parameter 3 should be 32 bytes
+secp256k1_ecdsa_verify_raw(): Parameter 5 should be a SECP256K1_SIG_FORMAT_* constant, optionally with SECP256K1_SIG_ALLOW_HIGH_S
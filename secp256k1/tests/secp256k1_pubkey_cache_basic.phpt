@@ -0,0 +1,57 @@
+--TEST--
+secp256k1_ec_pubkey_parse goes through the shared public key cache when secp256k1.pubkey_cache_size is set
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+else if (secp256k1_cache_stats()["pubkey"] === null) print "skip shared memory caches not supported";
+?>
+--INI--
+secp256k1.pubkey_cache_size=64
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+$compressed = hex2bin("0279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798");
+$uncompressed = hex2bin("0479be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8");
+
+$stats = secp256k1_cache_stats()["pubkey"];
+echo $stats["capacity"] . PHP_EOL;
+echo $stats["hits"] . " " . $stats["misses"] . " " . $stats["inserts"] . PHP_EOL;
+
+// the first parse misses and fills the cache, the second one hits
+for ($i = 0; $i < 2; $i++) {
+    $pubkey = null;
+    echo secp256k1_ec_pubkey_parse($ctx, $pubkey, $compressed) . PHP_EOL;
+    $out = '';
+    secp256k1_ec_pubkey_serialize($ctx, $out, $pubkey, SECP256K1_EC_UNCOMPRESSED);
+    echo bin2hex($out) . PHP_EOL;
+}
+
+// both encodings of a key are cached separately
+$pubkey = null;
+echo secp256k1_ec_pubkey_parse($ctx, $pubkey, $uncompressed) . PHP_EOL;
+echo secp256k1_ecdsa_verify_raw($ctx, str_repeat("\x00", 64), str_repeat("\x00", 32), $uncompressed, SECP256K1_SIG_FORMAT_COMPACT) . PHP_EOL;
+
+// invalid keys are not cached
+$invalid = "\x02" . str_repeat("\xff", 32);
+for ($i = 0; $i < 2; $i++) {
+    $pubkey = null;
+    echo secp256k1_ec_pubkey_parse($ctx, $pubkey, $invalid) . PHP_EOL;
+}
+
+$stats = secp256k1_cache_stats()["pubkey"];
+echo $stats["hits"] . " " . $stats["misses"] . " " . $stats["inserts"] . " " . $stats["evictions"] . PHP_EOL;
+
+?>
+--EXPECT--
+64
+0 0 0
+1
+0479be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8
+1
+0479be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8
+1
+0
+0
+0
+2 4 2 0
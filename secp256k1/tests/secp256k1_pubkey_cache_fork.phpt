@@ -0,0 +1,39 @@
+--TEST--
+the public key cache is shared with forked processes
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+else if (!function_exists("pcntl_fork")) print "skip pcntl not available";
+else if (secp256k1_cache_stats()["pubkey"] === null) print "skip shared memory caches not supported";
+?>
+--INI--
+secp256k1.pubkey_cache_size=64
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+$compressed = hex2bin("02c6047f9441ed7d6d3045406e95c07cd85c778e4b8cef3ca7abac09b95c709ee5");
+
+// the child fills the cache, the parent finds the key there
+$pid = pcntl_fork();
+if ($pid === 0) {
+    $pubkey = null;
+    secp256k1_ec_pubkey_parse($ctx, $pubkey, $compressed);
+    exit(0);
+}
+pcntl_waitpid($pid, $status);
+
+$pubkey = null;
+echo secp256k1_ec_pubkey_parse($ctx, $pubkey, $compressed) . PHP_EOL;
+$out = '';
+secp256k1_ec_pubkey_serialize($ctx, $out, $pubkey, SECP256K1_EC_COMPRESSED);
+echo bin2hex($out) . PHP_EOL;
+
+$stats = secp256k1_cache_stats()["pubkey"];
+echo $stats["hits"] . " " . $stats["misses"] . " " . $stats["inserts"] . PHP_EOL;
+
+?>
+--EXPECT--
+1
+02c6047f9441ed7d6d3045406e95c07cd85c778e4b8cef3ca7abac09b95c709ee5
+1 1 1
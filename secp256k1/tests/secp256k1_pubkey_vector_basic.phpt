@@ -0,0 +1,83 @@
+--TEST--
+Secp256k1\PublicKeyVector stores keys for combine and verify_batch
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+function serialize_key($ctx, $pubKey) {
+    $out = '';
+    secp256k1_ec_pubkey_serialize($ctx, $out, $pubKey, SECP256K1_EC_COMPRESSED);
+    return bin2hex($out);
+}
+
+$vector = new \Secp256k1\PublicKeyVector();
+echo count($vector) . PHP_EOL;
+
+$privs = [];
+$pubs = [];
+foreach ([1, 2, 3] as $i) {
+    $priv = pack("H*", str_pad(dechex($i), 64, "0", STR_PAD_LEFT));
+    // resources and objects can both be appended
+    $pub = $i === 2 ? new \Secp256k1\PublicKey() : null;
+    secp256k1_ec_pubkey_create($ctx, $pub, $priv);
+    $vector->append($pub);
+    $privs[] = $priv;
+    $pubs[] = $pub;
+}
+echo count($vector) . " " . $vector->count() . PHP_EOL;
+echo get_class($vector->get(2)) . PHP_EOL;
+echo serialize_key($ctx, $vector->get(2)) . PHP_EOL;
+
+$slice = $vector->slice(1);
+echo count($slice) . PHP_EOL;
+echo serialize_key($ctx, $slice->get(0)) . PHP_EOL;
+echo count($vector->slice(0, 1)) . " " . count($vector->slice(3)) . " " . count($vector->slice(1, 100)) . PHP_EOL;
+
+$combined = null;
+echo secp256k1_ec_pubkey_combine($ctx, $combined, $vector) . PHP_EOL;
+echo serialize_key($ctx, $combined) . PHP_EOL;
+$combined = null;
+secp256k1_ec_pubkey_combine($ctx, $combined, $pubs);
+echo serialize_key($ctx, $combined) . PHP_EOL;
+
+$sigs = [];
+$msgs = [];
+foreach ($privs as $i => $priv) {
+    $msgs[$i] = hash('sha256', "message $i", true);
+    $sig = null;
+    secp256k1_ecdsa_sign($ctx, $sig, $msgs[$i], $priv);
+    $sigs[$i] = $sig;
+}
+$results = null;
+echo secp256k1_ecdsa_verify_batch($ctx, $sigs, $msgs, $vector, $results) . PHP_EOL;
+echo bin2hex($results) . PHP_EOL;
+$results = null;
+echo secp256k1_ecdsa_verify_batch($ctx, $sigs, array_reverse($msgs), $vector, $results) . PHP_EOL;
+echo bin2hex($results) . PHP_EOL;
+
+// clones do not share storage
+$copy = clone $vector;
+$vector->append($pubs[0]);
+echo count($vector) . " " . count($copy) . PHP_EOL;
+
+?>
+--EXPECT--
+0
+3 3
+Secp256k1\PublicKey
+02f9308a019258c31049344f85f89d5229b531c845836f99b08601f113bce036f9
+2
+02c6047f9441ed7d6d3045406e95c07cd85c778e4b8cef3ca7abac09b95c709ee5
+1 0 2
+1
+03fff97bd5755eeea420453a14355235d382f6472f8568a18b2f057a1460297556
+03fff97bd5755eeea420453a14355235d382f6472f8568a18b2f057a1460297556
+1
+07
+0
+02
+4 3
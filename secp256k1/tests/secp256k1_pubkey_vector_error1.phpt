@@ -0,0 +1,59 @@
+--TEST--
+Secp256k1\PublicKeyVector rejects invalid indexes and keys
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+set_error_handler(function($code, $str) { echo $str . PHP_EOL; });
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$vector = new \Secp256k1\PublicKeyVector(4);
+
+$vector->append(tmpfile());
+$vector->append(new \Secp256k1\PublicKey());
+echo count($vector) . PHP_EOL;
+
+try {
+    $vector->get(0);
+} catch (\Exception $e) {
+    echo $e->getMessage() . PHP_EOL;
+}
+
+try {
+    $vector->slice(1);
+} catch (\Exception $e) {
+    echo $e->getMessage() . PHP_EOL;
+}
+
+try {
+    $vector->slice(0, -1);
+} catch (\Exception $e) {
+    echo $e->getMessage() . PHP_EOL;
+}
+
+try {
+    new \Secp256k1\PublicKeyVector(-1);
+} catch (\Exception $e) {
+    echo $e->getMessage() . PHP_EOL;
+}
+
+$combined = null;
+try {
+    secp256k1_ec_pubkey_combine($ctx, $combined, "not a vector");
+} catch (\Exception $e) {
+    echo $e->getMessage() . PHP_EOL;
+}
+
+?>
+--EXPECT--
+Secp256k1\PublicKeyVector::append(): supplied resource is not a valid secp256k1_pubkey resource
+Secp256k1\PublicKeyVector::append(): supplied Secp256k1\PublicKey has not been initialized
+0
+Secp256k1\PublicKeyVector::get(): Parameter 1 should be a valid index
+Secp256k1\PublicKeyVector::slice(): Parameter 1 should be between 0 and the number of keys
+Secp256k1\PublicKeyVector::slice(): Parameter 2 should not be negative
+Secp256k1\PublicKeyVector::__construct(): Parameter 1 should not be negative
+secp256k1_ec_pubkey_combine(): Parameter 3 should be an array or Secp256k1\PublicKeyVector
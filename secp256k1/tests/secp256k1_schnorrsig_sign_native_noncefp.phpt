@@ -0,0 +1,50 @@
+--TEST--
+secp256k1_schnorrsig_sign with secp256k1_nonce_function_bip340 matches calling it through a closure
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+if (!function_exists("secp256k1_schnorrsig_verify")) print "skip no schnorrsig support";
+?>
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$privKey = hex2bin("b7e151628aed2a6abf7158809cf4f3c762e7160f38b4da56a784d9045190cfef");
+$msg32 = hex2bin("243f6a8885a308d313198a2e03707344a4093822299f31d0082efa98ec4e6c89");
+
+$keypair = null;
+echo secp256k1_keypair_create($ctx, $keypair, $privKey) . PHP_EOL;
+
+// the closure forces the nonce to be computed by calling back into PHP
+$wrapped = function (&$nonce, $msg32, $key32, $xonlyPk32, $algo16, $data) {
+    return secp256k1_nonce_function_bip340($nonce, $msg32, $key32, $xonlyPk32, $algo16, $data);
+};
+
+function sign_hex($ctx, $msg32, $keypair, $noncefp, $data) {
+    $sig64 = null;
+    if (!secp256k1_schnorrsig_sign($ctx, $sig64, $msg32, $keypair, $noncefp, $data)) {
+        return "failed";
+    }
+    return bin2hex($sig64);
+}
+
+foreach ([null, str_repeat("\x01", 32)] as $data) {
+    $viaPhp = sign_hex($ctx, $msg32, $keypair, $wrapped, $data);
+    echo (int) ($viaPhp === sign_hex($ctx, $msg32, $keypair, 'secp256k1_nonce_function_bip340', $data)) . PHP_EOL;
+}
+
+// data of the wrong size or type is rejected the same way on both paths
+foreach (["AAAA", 1] as $data) {
+    echo sign_hex($ctx, $msg32, $keypair, $wrapped, $data) . PHP_EOL;
+    echo sign_hex($ctx, $msg32, $keypair, 'secp256k1_nonce_function_bip340', $data) . PHP_EOL;
+}
+
+?>
+--EXPECT--
+1
+1
+1
+failed
+failed
+failed
+failed
@@ -0,0 +1,61 @@
+--TEST--
+secp256k1_schnorrsig_verify_batch works
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+if (!function_exists("secp256k1_schnorrsig_verify_batch")) print "skip no schnorrsig support";
+?>
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+
+// BIP340 test vectors 0, 5 (invalid) and 3
+$sigs = [
+    pack("H*", "E907831F80848D1069A5371B402410364BDF1C5F8307B0084C55F1CE2DCA821525F66A4A85EA8B71E482A74F382D2CE5EBEEE8FDB2172F477DF4900D310536C0"),
+    pack("H*", "FFF97BD5755EEEA420453A14355235D382F6472F8568A18B2F057A14602975563CC27944640AC607CD107AE10923D9EF7A73C643E166BE5EBEAFA34B1AC553E2"),
+    pack("H*", "00000000000000000000003B78CE563F89A0ED9414F5AA28AD0D96D6795F9C6376AFB1548AF603B3EB45C9F8207DEE1060CB71C04E80F593060B07D28308D7F4"),
+];
+$msgs = [
+    hex2bin("0000000000000000000000000000000000000000000000000000000000000000"),
+    hex2bin("243F6A8885A308D313198A2E03707344A4093822299F31D0082EFA98EC4E6C89"),
+    hex2bin("4DF3C3F68FCC83B27E9D42C90431A72499F17875C81A599B566C9889B9696703"),
+];
+$pubKeysBin = [
+    pack("H*", "F9308A019258C31049344F85F89D5229B531C845836F99B08601F113BCE036F9"),
+    pack("H*", "DFF1D77F2A671C5F36183726DB2341BE58FEAE1DA2DECED843240F7B502BA659"),
+    pack("H*", "D69C3509BB99E412E68B0FE8544E72837DFA30746D8BE2AA65975F29D22DC7B9"),
+];
+
+$pubKeys = [];
+foreach ($pubKeysBin as $pubKeyBin) {
+    $pubKey = null;
+    echo secp256k1_xonly_pubkey_parse($ctx, $pubKey, $pubKeyBin) . PHP_EOL;
+    $pubKeys[] = $pubKey;
+}
+
+echo "valid only:" . PHP_EOL;
+echo secp256k1_schnorrsig_verify_batch($ctx, [$sigs[0], $sigs[2]], [$msgs[0], $msgs[2]], [$pubKeys[0], $pubKeys[2]]) . PHP_EOL;
+
+echo "with invalid:" . PHP_EOL;
+echo secp256k1_schnorrsig_verify_batch($ctx, $sigs, $msgs, $pubKeys) . PHP_EOL;
+$results = null;
+echo secp256k1_schnorrsig_verify_batch($ctx, $sigs, $msgs, $pubKeys, $results) . PHP_EOL;
+echo bin2hex($results) . PHP_EOL;
+
+echo "empty batch:" . PHP_EOL;
+echo secp256k1_schnorrsig_verify_batch($ctx, [], [], []) . PHP_EOL;
+
+?>
+--EXPECT--
+1
+1
+1
+valid only:
+1
+with invalid:
+0
+0
+05
+empty batch:
+1
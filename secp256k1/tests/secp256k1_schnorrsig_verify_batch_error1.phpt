@@ -0,0 +1,36 @@
+--TEST--
+secp256k1_schnorrsig_verify_batch throws if a signature is not 64 bytes
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+if (!function_exists("secp256k1_schnorrsig_verify_batch")) print "skip no schnorrsig support";
+?>
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+
+$pubKey = null;
+echo secp256k1_xonly_pubkey_parse($ctx, $pubKey, pack("H*", "F9308A019258C31049344F85F89D5229B531C845836F99B08601F113BCE036F9")) . PHP_EOL;
+
+try {
+    secp256k1_schnorrsig_verify_batch($ctx, [str_repeat("A", 63)], [str_repeat("B", 32)], [$pubKey]);
+} catch (\Exception $e) {
+    echo get_class($e) . PHP_EOL;
+    echo $e->getMessage() . PHP_EOL;
+}
+
+try {
+    secp256k1_schnorrsig_verify_batch($ctx, [str_repeat("A", 64)], [], [$pubKey]);
+} catch (\Exception $e) {
+    echo get_class($e) . PHP_EOL;
+    echo $e->getMessage() . PHP_EOL;
+}
+
+?>
+--EXPECT--
+1
+InvalidArgumentException
+secp256k1_schnorrsig_verify_batch(): Parameter 2 should only contain 64 byte strings
+InvalidArgumentException
+secp256k1_schnorrsig_verify_batch(): Parameters 2, 3 and 4 should have the same number of elements
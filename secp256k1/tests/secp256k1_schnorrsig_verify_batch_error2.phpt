@@ -0,0 +1,18 @@
+--TEST--
+secp256k1_schnorrsig_verify_batch errors when context is wrong resource type
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+if (!function_exists("secp256k1_schnorrsig_verify_batch")) print "skip no schnorrsig support";
+?>
+--FILE--
+<?php
+set_error_handler(function($code, $str) { echo $str . PHP_EOL; });
+
+$result = secp256k1_schnorrsig_verify_batch(tmpfile(), [], [], []);
+echo $result . PHP_EOL;
+
+?>
+--EXPECT--
+secp256k1_schnorrsig_verify_batch(): supplied resource is not a valid secp256k1_context resource
+0
@@ -0,0 +1,54 @@
+--TEST--
+secp256k1_schnorrsig_verify_batch refuses a context without VERIFY, with or without worker threads
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+if (!function_exists("secp256k1_schnorrsig_verify_batch")) print "skip no schnorrsig support";
+?>
+--INI--
+secp256k1.threads=4
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$signCtx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN);
+
+$sigs = [];
+$msgs = [];
+$pubKeys = [];
+for ($i = 0; $i < 40; $i++) {
+    $keypair = null;
+    $pubKey = null;
+    $parity = null;
+    $sig64 = null;
+    $msgs[] = hash('sha256', "msg $i", true);
+    secp256k1_keypair_create($ctx, $keypair, hash('sha256', "key $i", true));
+    secp256k1_keypair_xonly_pub($ctx, $pubKey, $parity, $keypair);
+    secp256k1_schnorrsig_sign($ctx, $sig64, $msgs[$i], $keypair, 'secp256k1_nonce_function_bip340', str_repeat("\x00", 32));
+    $pubKeys[] = $pubKey;
+    $sigs[] = $sig64;
+}
+
+// 40 items go to the worker threads, 2 stay on the calling thread
+foreach ([40, 2] as $n) {
+    $results = "unchanged";
+    try {
+        secp256k1_schnorrsig_verify_batch($signCtx, array_slice($sigs, 0, $n), array_slice($msgs, 0, $n), array_slice($pubKeys, 0, $n), $results);
+    } catch (\Exception $e) {
+        echo get_class($e) . PHP_EOL;
+        echo $e->getMessage() . PHP_EOL;
+    }
+    echo $results . PHP_EOL;
+}
+
+echo secp256k1_schnorrsig_verify_batch($ctx, $sigs, $msgs, $pubKeys) . PHP_EOL;
+
+?>
+--EXPECT--
+InvalidArgumentException
+secp256k1_schnorrsig_verify_batch(): Parameter 1 should be a context created with SECP256K1_CONTEXT_VERIFY
+unchanged
+InvalidArgumentException
+secp256k1_schnorrsig_verify_batch(): Parameter 1 should be a context created with SECP256K1_CONTEXT_VERIFY
+unchanged
+1
@@ -0,0 +1,38 @@
+--TEST--
+secp256k1_schnorrsig_verify_raw verifies against an encoded x-only public key
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+if (!function_exists("secp256k1_schnorrsig_verify_raw")) print "skip no schnorrsig support";
+?>
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+//https://github.com/bitcoin/bips/blob/master/bip-0340/test-vectors.csv
+$xonly32 = hex2bin("F9308A019258C31049344F85F89D5229B531C845836F99B08601F113BCE036F9");
+$msg32 = hex2bin("0000000000000000000000000000000000000000000000000000000000000000");
+$sig64 = hex2bin("E907831F80848D1069A5371B402410364BDF1C5F8307B0084C55F1CE2DCA821525F66A4A85EA8B71E482A74F382D2CE5EBEEE8FDB2172F477DF4900D310536C0");
+
+echo secp256k1_schnorrsig_verify_raw($ctx, $sig64, $msg32, $xonly32) . PHP_EOL;
+echo secp256k1_schnorrsig_verify_raw($ctx, $sig64, str_repeat("\x01", 32), $xonly32) . PHP_EOL;
+// x = 5 is not on the curve
+echo secp256k1_schnorrsig_verify_raw($ctx, $sig64, $msg32, str_pad("\x05", 32, "\x00", STR_PAD_LEFT)) . PHP_EOL;
+
+foreach ([[substr($sig64, 1), $msg32, $xonly32], [$sig64, "\x00", $xonly32], [$sig64, $msg32, "\x02" . $xonly32]] as list($sig, $msg, $key)) {
+    try {
+        secp256k1_schnorrsig_verify_raw($ctx, $sig, $msg, $key);
+    } catch (\Exception $e) {
+        echo $e->getMessage() . PHP_EOL;
+    }
+}
+
+?>
+--EXPECT--
+1
+0
+0
+secp256k1_schnorrsig_verify_raw(): Parameter 2 should be 64 bytes
+secp256k1_schnorrsig_verify_raw(): Parameter 3 should be 32 bytes
+secp256k1_schnorrsig_verify_raw(): Parameter 4 should be 32 bytes
@@ -0,0 +1,84 @@
+--TEST--
+secp256k1_ec_pubkey_serialize_many and secp256k1_ecdsa_signature_serialize_*_many work
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+$pubs = [];
+$sigs = [];
+$vector = new \Secp256k1\PublicKeyVector();
+foreach ([1, 2, 3] as $i) {
+    $priv = pack("H*", str_pad(dechex($i), 64, "0", STR_PAD_LEFT));
+    $pub = null;
+    $sig = null;
+    secp256k1_ec_pubkey_create($ctx, $pub, $priv);
+    secp256k1_ecdsa_sign($ctx, $sig, hash('sha256', "message $i", true), $priv);
+    $pubs[] = $pub;
+    $sigs[] = $sig;
+    $vector->append($pub);
+}
+
+$out = null;
+echo secp256k1_ec_pubkey_serialize_many($ctx, $out, $pubs, SECP256K1_EC_COMPRESSED) . PHP_EOL;
+echo strlen($out) . PHP_EOL;
+echo bin2hex(substr($out, 33, 33)) . PHP_EOL;
+
+$fromVector = null;
+echo secp256k1_ec_pubkey_serialize_many($ctx, $fromVector, $vector, SECP256K1_EC_UNCOMPRESSED) . PHP_EOL;
+echo strlen($fromVector) . PHP_EOL;
+$expected = '';
+foreach ($pubs as $pub) {
+    $one = '';
+    secp256k1_ec_pubkey_serialize($ctx, $one, $pub, SECP256K1_EC_UNCOMPRESSED);
+    $expected .= $one;
+}
+var_dump($fromVector === $expected);
+
+$compact = null;
+echo secp256k1_ecdsa_signature_serialize_compact_many($ctx, $compact, $sigs) . PHP_EOL;
+echo strlen($compact) . PHP_EOL;
+
+$der = null;
+$lengths = null;
+echo secp256k1_ecdsa_signature_serialize_der_many($ctx, $der, $lengths, $sigs) . PHP_EOL;
+echo strlen($lengths) . PHP_EOL;
+$expectedCompact = '';
+$expectedDer = '';
+$expectedLengths = [];
+foreach ($sigs as $sig) {
+    $one = '';
+    secp256k1_ecdsa_signature_serialize_compact($ctx, $one, $sig);
+    $expectedCompact .= $one;
+    secp256k1_ecdsa_signature_serialize_der($ctx, $one, $sig);
+    $expectedDer .= $one;
+    $expectedLengths[] = strlen($one);
+}
+var_dump($compact === $expectedCompact);
+var_dump($der === $expectedDer);
+var_dump(array_values(unpack("C*", $lengths)) === $expectedLengths);
+
+$empty = null;
+echo secp256k1_ecdsa_signature_serialize_der_many($ctx, $empty, $lengths, []) . PHP_EOL;
+echo strlen($empty) . " " . strlen($lengths) . PHP_EOL;
+
+?>
+--EXPECT--
+1
+99
+02c6047f9441ed7d6d3045406e95c07cd85c778e4b8cef3ca7abac09b95c709ee5
+1
+195
+bool(true)
+1
+192
+1
+3
+bool(true)
+bool(true)
+bool(true)
+1
+0 0
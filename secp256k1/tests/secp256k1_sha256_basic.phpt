@@ -0,0 +1,38 @@
+--TEST--
+secp256k1_sha256, secp256k1_tagged_sha256 and secp256k1_hmac_sha256 match known hashes
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$hash = null;
+echo secp256k1_sha256($hash, "abc") . " " . bin2hex($hash) . PHP_EOL;
+// precomputed and computed tag prefixes
+echo secp256k1_tagged_sha256($hash, "TapTweak", "abc") . " " . bin2hex($hash) . PHP_EOL;
+echo secp256k1_tagged_sha256($hash, "BIP0340/challenge", "") . " " . bin2hex($hash) . PHP_EOL;
+echo secp256k1_tagged_sha256($hash, "my/tag", "hello world") . " " . bin2hex($hash) . PHP_EOL;
+echo secp256k1_hmac_sha256($hash, "key", "The quick brown fox jumps over the lazy dog") . " " . bin2hex($hash) . PHP_EOL;
+
+$matches = 0;
+foreach ([0, 1, 55, 56, 63, 64, 65, 200] as $length) {
+    $data = str_repeat(chr($length), $length);
+    secp256k1_sha256($hash, $data);
+    $matches += $hash === hash('sha256', $data, true);
+    secp256k1_hmac_sha256($hash, $data, $data);
+    $matches += $hash === hash_hmac('sha256', $data, $data, true);
+    $tag = hash('sha256', $data, true);
+    secp256k1_tagged_sha256($hash, $data, $data);
+    $matches += $hash === hash('sha256', $tag . $tag . $data, true);
+}
+echo $matches . PHP_EOL;
+
+?>
+--EXPECT--
+1 ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad
+1 b4db0a539110ab84dac5af069f081eee7e3becbf970e6705d20f59ea9b4eb1f8
+1 c216d352f5818b7b4beacd4ae0a26fe888080823d2a598856661bcd54f1b3713
+1 1296f696e6f4c2afd19ab6cd57c0258253e2c64fb94eb1eebe5651bbebde9b52
+1 f7bc83f430538424b13298e6aa6fb143ef4d59a14946175997479dbc2d1a3cd8
+24
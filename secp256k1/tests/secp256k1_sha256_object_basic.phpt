@@ -0,0 +1,41 @@
+--TEST--
+Secp256k1\Sha256 hashes incrementally and clones its midstate
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+$hash = new Secp256k1\Sha256();
+echo bin2hex($hash->digest()) . PHP_EOL;
+for ($i = 0; $i < 10; $i++) {
+    $hash->update(str_repeat("a", 100));
+}
+echo bin2hex($hash->digest()) . PHP_EOL;
+// digest() leaves the state alone
+echo bin2hex($hash->digest()) . PHP_EOL;
+
+// a tagged hash, with the prefix reused through clone
+$tagged = new Secp256k1\Sha256("my/tag");
+$copy = clone $tagged;
+$tagged->update("hello world");
+$copy->update("hello");
+$copy->update(" world");
+var_dump($tagged->digest() === $copy->digest());
+echo bin2hex($tagged->digest()) . PHP_EOL;
+
+$expected = null;
+secp256k1_tagged_sha256($expected, "TapTweak", "abc");
+$tagged = new Secp256k1\Sha256("TapTweak");
+$tagged->update("abc");
+var_dump($tagged->digest() === $expected);
+
+?>
+--EXPECT--
+e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855
+41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3
+41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3
+bool(true)
+1296f696e6f4c2afd19ab6cd57c0258253e2c64fb94eb1eebe5651bbebde9b52
+bool(true)
@@ -0,0 +1,54 @@
+--TEST--
+secp256k1_ecdsa_verify only stores valid signatures in the cache set up by secp256k1.sigcache_size
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+else if (secp256k1_cache_stats()["sig"] === null) print "skip shared memory caches not supported";
+?>
+--INI--
+secp256k1.sigcache_size=64
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$priv = str_repeat("\x42", 32);
+$msg32 = hash('sha256', 'message', true);
+$other32 = hash('sha256', 'other message', true);
+
+$pubkey = null;
+secp256k1_ec_pubkey_create($ctx, $pubkey, $priv);
+$pub33 = '';
+secp256k1_ec_pubkey_serialize($ctx, $pub33, $pubkey, SECP256K1_EC_COMPRESSED);
+$sig = null;
+secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv);
+$sig64 = '';
+secp256k1_ecdsa_signature_serialize_compact($ctx, $sig64, $sig);
+
+// verified once, then found in the cache, by the raw variant too
+echo secp256k1_ecdsa_verify($ctx, $sig, $msg32, $pubkey) . PHP_EOL;
+echo secp256k1_ecdsa_verify($ctx, $sig, $msg32, $pubkey) . PHP_EOL;
+echo secp256k1_ecdsa_verify_raw($ctx, $sig64, $msg32, $pub33, SECP256K1_SIG_FORMAT_COMPACT) . PHP_EOL;
+
+// failures are checked every time
+echo secp256k1_ecdsa_verify($ctx, $sig, $other32, $pubkey) . PHP_EOL;
+echo secp256k1_ecdsa_verify($ctx, $sig, $other32, $pubkey) . PHP_EOL;
+
+$results = null;
+echo secp256k1_ecdsa_verify_batch($ctx, [$sig, $sig], [$msg32, $other32], [$pubkey, $pubkey], $results) . PHP_EOL;
+echo bin2hex($results) . PHP_EOL;
+
+$stats = secp256k1_cache_stats()["sig"];
+echo $stats["capacity"] . PHP_EOL;
+echo $stats["hits"] . " " . $stats["misses"] . " " . $stats["inserts"] . PHP_EOL;
+
+?>
+--EXPECT--
+1
+1
+1
+0
+0
+0
+01
+64
+3 4 1
@@ -0,0 +1,36 @@
+--TEST--
+secp256k1_schnorrsig_verify shares the signature cache with its raw variant
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+else if (!function_exists("secp256k1_schnorrsig_verify")) print "skip no schnorrsig support";
+else if (secp256k1_cache_stats()["sig"] === null) print "skip shared memory caches not supported";
+?>
+--INI--
+secp256k1.sigcache_size=64
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+
+//https://github.com/bitcoin/bips/blob/master/bip-0340/test-vectors.csv
+$xonly32 = hex2bin("F9308A019258C31049344F85F89D5229B531C845836F99B08601F113BCE036F9");
+$msg32 = hex2bin("0000000000000000000000000000000000000000000000000000000000000000");
+$sig64 = hex2bin("E907831F80848D1069A5371B402410364BDF1C5F8307B0084C55F1CE2DCA821525F66A4A85EA8B71E482A74F382D2CE5EBEEE8FDB2172F477DF4900D310536C0");
+
+$pubkey = null;
+secp256k1_xonly_pubkey_parse($ctx, $pubkey, $xonly32);
+
+echo secp256k1_schnorrsig_verify_raw($ctx, $sig64, $msg32, $xonly32) . PHP_EOL;
+echo secp256k1_schnorrsig_verify($ctx, $sig64, $msg32, $pubkey) . PHP_EOL;
+echo secp256k1_schnorrsig_verify($ctx, $sig64, str_repeat("\x01", 32), $pubkey) . PHP_EOL;
+
+$stats = secp256k1_cache_stats()["sig"];
+echo $stats["hits"] . " " . $stats["misses"] . " " . $stats["inserts"] . PHP_EOL;
+
+?>
+--EXPECT--
+1
+1
+0
+1 2 1
@@ -0,0 +1,60 @@
+--TEST--
+secp256k1_stats counts calls by nonce path and batch size when secp256k1.stats is enabled
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--INI--
+secp256k1.stats=1
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$priv = str_repeat("\x42", 32);
+$msg32 = hash('sha256', 'message', true);
+$wrapped = function (&$nonce, $msg32, $key32, $algo16, $data, $attempt) {
+    return secp256k1_nonce_function_rfc6979($nonce, $msg32, $key32, $algo16, $data, $attempt);
+};
+
+$sig = null;
+secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv);
+secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv, 'secp256k1_nonce_function_rfc6979', null);
+secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv, 'secp256k1_nonce_function_rfc6979', null);
+secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv, $wrapped, null);
+
+$pubkeys = null;
+$valid = null;
+secp256k1_ec_pubkey_create_many($ctx, $pubkeys, $valid, str_repeat($priv, 5), SECP256K1_EC_COMPRESSED);
+
+$stats = secp256k1_stats();
+$sign = $stats["secp256k1_ecdsa_sign"];
+echo $sign["calls"] . PHP_EOL;
+foreach ($sign["variants"] as $variant => $figures) {
+    echo $variant . " " . $figures["calls"] . PHP_EOL;
+}
+// the userland nonce function calls back into the extension
+echo $stats["secp256k1_nonce_function_rfc6979"]["calls"] . PHP_EOL;
+echo implode(",", array_keys($stats["secp256k1_ec_pubkey_create_many"]["variants"])) . PHP_EOL;
+
+echo array_sum($sign["histogram"]) . PHP_EOL;
+echo $sign["p50_ns"] <= $sign["p90_ns"] && $sign["p90_ns"] <= $sign["p99_ns"]
+    && $sign["p99_ns"] <= $sign["max_ns"] && $sign["max_ns"] <= $sign["total_ns"] ? "ordered" : "unordered";
+echo PHP_EOL;
+echo isset($stats["secp256k1_stats"]) ? "self" : "no self";
+echo PHP_EOL;
+
+secp256k1_stats(true);
+echo count(secp256k1_stats()) . PHP_EOL;
+
+?>
+--EXPECT--
+4
+nonce=default 1
+nonce=native 2
+nonce=callback 1
+1
+n=4..7
+4
+ordered
+no self
+0
@@ -0,0 +1,23 @@
+--TEST--
+secp256k1_stats returns nothing while secp256k1.stats is off
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--INI--
+secp256k1.stats=0
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$sig = null;
+echo secp256k1_ecdsa_sign($ctx, $sig, hash('sha256', 'message', true), str_repeat("\x42", 32)) . PHP_EOL;
+var_dump(secp256k1_stats(), secp256k1_stats(true));
+
+?>
+--EXPECT--
+1
+array(0) {
+}
+array(0) {
+}
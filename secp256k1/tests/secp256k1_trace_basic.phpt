@@ -0,0 +1,77 @@
+--TEST--
+secp256k1_trace_register observers see sign, verify and batch calls with their attributes
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--INI--
+secp256k1.trace=1
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$priv = str_repeat("\x42", 32);
+$msg32 = hash('sha256', 'message', true);
+$other32 = hash('sha256', 'other message', true);
+
+$spans = 0;
+$id = secp256k1_trace_register(
+    function ($function) use (&$spans, $ctx, $priv, $other32) {
+        // calls made by observers are not traced
+        $sig = null;
+        secp256k1_ecdsa_sign($ctx, $sig, $other32, $priv);
+        return ++$spans;
+    },
+    function ($span, $function, array $attributes) {
+        unset($attributes["duration_ns"]);
+        echo $span . " " . $function . " " . json_encode($attributes) . PHP_EOL;
+    }
+);
+echo $id > 0 ? "registered" : "failed";
+echo PHP_EOL;
+
+$sig = null;
+secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv);
+secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv, 'secp256k1_nonce_function_rfc6979', null);
+
+$pubkey = null;
+secp256k1_ec_pubkey_create($ctx, $pubkey, $priv);
+secp256k1_ecdsa_verify($ctx, $sig, $msg32, $pubkey);
+secp256k1_ecdsa_verify($ctx, $sig, $other32, $pubkey);
+
+$pubkeys = null;
+$valid = null;
+secp256k1_ec_pubkey_create_many($ctx, $pubkeys, $valid, str_repeat($priv, 3), SECP256K1_EC_COMPRESSED);
+$serialized = null;
+secp256k1_ec_pubkey_serialize_many($ctx, $serialized, [$pubkey, $pubkey], SECP256K1_EC_COMPRESSED);
+$lengths = null;
+secp256k1_ecdsa_signature_serialize_der_many($ctx, $serialized, $lengths, [$sig]);
+secp256k1_ecdsa_signature_serialize_compact_many($ctx, $serialized, [$sig, $sig, $sig, $sig]);
+
+try {
+    secp256k1_ecdsa_sign($ctx, $sig, "short", $priv);
+} catch (\InvalidArgumentException $e) {
+    echo "caught" . PHP_EOL;
+}
+
+echo secp256k1_trace_unregister($id) . PHP_EOL;
+echo secp256k1_trace_unregister($id) . PHP_EOL;
+secp256k1_ecdsa_verify($ctx, $sig, $msg32, $pubkey);
+echo $spans . PHP_EOL;
+
+?>
+--EXPECT--
+registered
+1 secp256k1_ecdsa_sign {"outcome":"ok","nonce":"default"}
+2 secp256k1_ecdsa_sign {"outcome":"ok","nonce":"native"}
+3 secp256k1_ecdsa_verify {"outcome":"ok"}
+4 secp256k1_ecdsa_verify {"outcome":"failed"}
+5 secp256k1_ec_pubkey_create_many {"outcome":"ok","batch_size":3}
+6 secp256k1_ec_pubkey_serialize_many {"outcome":"ok","batch_size":2}
+7 secp256k1_ecdsa_signature_serialize_der_many {"outcome":"ok","batch_size":1}
+8 secp256k1_ecdsa_signature_serialize_compact_many {"outcome":"ok","batch_size":4}
+9 secp256k1_ecdsa_sign {"outcome":"exception"}
+caught
+1
+0
+9
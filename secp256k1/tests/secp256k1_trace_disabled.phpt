@@ -0,0 +1,26 @@
+--TEST--
+secp256k1_trace_register refuses observers while secp256k1.trace is off
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--INI--
+secp256k1.trace=0
+--FILE--
+<?php
+
+var_dump(secp256k1_trace_register(function ($function) {
+    echo "begin" . PHP_EOL;
+}, null));
+
+try {
+    secp256k1_trace_register("not a function", null);
+} catch (\InvalidArgumentException $e) {
+    echo $e->getMessage() . PHP_EOL;
+}
+
+?>
+--EXPECTF--
+Warning: secp256k1_trace_register(): secp256k1.trace is disabled, the observer would never be called in %s on line %d
+int(0)
+secp256k1_trace_register(): Parameter 1 should be a callable or null
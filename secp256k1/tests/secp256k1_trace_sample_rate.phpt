@@ -0,0 +1,36 @@
+--TEST--
+secp256k1.trace_sample_rate reports only a fraction of the calls to the observers
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--INI--
+secp256k1.trace=1
+secp256k1.trace_sample_rate=0
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$priv = str_repeat("\x42", 32);
+$msg32 = hash('sha256', 'message', true);
+$sig = null;
+
+$ends = 0;
+secp256k1_trace_register(null, function ($span, $function, array $attributes) use (&$ends) {
+    $ends++;
+});
+
+foreach (["0", "1", "0.5"] as $rate) {
+    ini_set("secp256k1.trace_sample_rate", $rate);
+    $ends = 0;
+    for ($i = 0; $i < 200; $i++) {
+        secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv);
+    }
+    echo $rate . " " . ($rate === "0.5" ? ($ends > 40 && $ends < 160 ? "some" : $ends) : $ends) . PHP_EOL;
+}
+
+?>
+--EXPECT--
+0 0
+1 200
+0.5 some
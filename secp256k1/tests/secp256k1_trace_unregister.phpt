@@ -0,0 +1,62 @@
+--TEST--
+secp256k1_trace_unregister stops spans once the last observer is gone
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--INI--
+secp256k1.trace=1
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$priv = str_repeat("\x42", 32);
+$msg32 = hash('sha256', 'message', true);
+
+$observer = function ($name) {
+    return function ($function) use ($name) {
+        echo $name . " " . $function . PHP_EOL;
+    };
+};
+
+$first = secp256k1_trace_register($observer("first"), null);
+$second = secp256k1_trace_register($observer("second"), null);
+$sig = null;
+secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv);
+
+echo secp256k1_trace_unregister($first) . PHP_EOL;
+secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv);
+
+echo secp256k1_trace_unregister($second) . PHP_EOL;
+secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv);
+echo secp256k1_trace_unregister($second) . PHP_EOL;
+echo "no spans" . PHP_EOL;
+
+// the last observer may go away while a call it traces is running
+$third = secp256k1_trace_register($observer("third"), function ($span, $function) {
+    echo "end " . $function . PHP_EOL;
+});
+$nonceFn = function (&$nonce, $msg32, $key32, $algo16, $data, $attempt) use (&$third) {
+    echo "unregister " . secp256k1_trace_unregister($third) . PHP_EOL;
+    $nonce = hash('sha256', $key32 . $msg32, true);
+    return 1;
+};
+echo secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv, $nonceFn) . PHP_EOL;
+secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv);
+
+$fourth = secp256k1_trace_register($observer("fourth"), null);
+secp256k1_ecdsa_sign($ctx, $sig, $msg32, $priv);
+
+?>
+--EXPECT--
+first secp256k1_ecdsa_sign
+second secp256k1_ecdsa_sign
+1
+second secp256k1_ecdsa_sign
+1
+0
+no spans
+third secp256k1_ecdsa_sign
+unregister 1
+1
+fourth secp256k1_ecdsa_sign
@@ -0,0 +1,70 @@
+--TEST--
+Secp256k1\PublicKey and Secp256k1\EcdsaSignature can be used in place of resources
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$seckey = hex2bin('7ccca75d019dbae79ac4266501578684ee64eeb3c9212105f7a3bdc0ddb0f27e');
+$msg32 = hash('sha256', 'a message', true);
+
+$pubKey = new \Secp256k1\PublicKey();
+$result = secp256k1_ec_pubkey_create($ctx, $pubKey, $seckey);
+echo $result . PHP_EOL;
+echo get_class($pubKey) . PHP_EOL;
+
+$serialized = '';
+$result = secp256k1_ec_pubkey_serialize($ctx, $serialized, $pubKey, SECP256K1_EC_COMPRESSED);
+echo $result . PHP_EOL;
+echo unpack("H*", $serialized)[1] . PHP_EOL;
+
+$sig = new \Secp256k1\EcdsaSignature();
+$result = secp256k1_ecdsa_sign($ctx, $sig, $msg32, $seckey);
+echo $result . PHP_EOL;
+echo get_class($sig) . PHP_EOL;
+echo secp256k1_ecdsa_verify($ctx, $sig, $msg32, $pubKey) . PHP_EOL;
+
+// objects and resources can be mixed
+$pubKeyRes = null;
+$sigRes = null;
+secp256k1_ec_pubkey_create($ctx, $pubKeyRes, $seckey);
+secp256k1_ecdsa_sign($ctx, $sigRes, $msg32, $seckey);
+echo get_resource_type($sigRes) . PHP_EOL;
+echo secp256k1_ecdsa_verify($ctx, $sig, $msg32, $pubKeyRes) . PHP_EOL;
+echo secp256k1_ecdsa_verify($ctx, $sigRes, $msg32, $pubKey) . PHP_EOL;
+
+$compactObj = '';
+$compactRes = '';
+secp256k1_ecdsa_signature_serialize_compact($ctx, $compactObj, $sig);
+secp256k1_ecdsa_signature_serialize_compact($ctx, $compactRes, $sigRes);
+var_dump($compactObj === $compactRes);
+
+// clones are independent of the original
+$copy = clone $pubKey;
+$tweak = str_repeat("\x01", 32);
+echo secp256k1_ec_pubkey_tweak_add($ctx, $pubKey, $tweak) . PHP_EOL;
+$tweaked = '';
+$copied = '';
+secp256k1_ec_pubkey_serialize($ctx, $tweaked, $pubKey, SECP256K1_EC_COMPRESSED);
+secp256k1_ec_pubkey_serialize($ctx, $copied, $copy, SECP256K1_EC_COMPRESSED);
+var_dump($tweaked === $serialized);
+var_dump($copied === $serialized);
+
+?>
+--EXPECT--
+1
+Secp256k1\PublicKey
+1
+03e9a06e539d6bf5cf1ca5c41b59121fa3df07a338322405a312c67b6349a707e9
+1
+Secp256k1\EcdsaSignature
+1
+secp256k1_ecdsa_signature
+1
+1
+bool(true)
+1
+bool(false)
+bool(true)
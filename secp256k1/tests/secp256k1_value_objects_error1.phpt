@@ -0,0 +1,40 @@
+--TEST--
+Secp256k1\PublicKey must be initialized before use and cannot be serialized
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+?>
+--FILE--
+<?php
+
+set_error_handler(function($code, $str) { echo $str . PHP_EOL; });
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$pubKey = new \Secp256k1\PublicKey();
+
+$serialized = '';
+$result = secp256k1_ec_pubkey_serialize($ctx, $serialized, $pubKey, SECP256K1_EC_COMPRESSED);
+echo $result . PHP_EOL;
+
+// neither is an object of the wrong class, nor anything else
+foreach ([new \Secp256k1\EcdsaSignature(), "not a key"] as $notKey) {
+    try {
+        secp256k1_ec_pubkey_serialize($ctx, $serialized, $notKey, SECP256K1_EC_COMPRESSED);
+    } catch (\TypeError $e) {
+        echo $e->getMessage() . PHP_EOL;
+    }
+}
+
+try {
+    serialize($pubKey);
+} catch (\Exception $e) {
+    echo $e->getMessage() . PHP_EOL;
+}
+
+?>
+--EXPECT--
+secp256k1_ec_pubkey_serialize(): supplied Secp256k1\PublicKey has not been initialized
+0
+Argument 3 passed to secp256k1_ec_pubkey_serialize() must be of the type resource, object given
+Argument 3 passed to secp256k1_ec_pubkey_serialize() must be of the type resource, string given
+Serialization of 'Secp256k1\PublicKey' is not allowed
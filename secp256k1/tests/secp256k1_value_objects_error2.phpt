@@ -0,0 +1,26 @@
+--TEST--
+Value arguments passed by reference still only take resources or value objects
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+if (!function_exists("secp256k1_keypair_xonly_tweak_add")) print "skip no extrakeys support";
+?>
+--FILE--
+<?php
+
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+$tweak = str_repeat("\x01", 32);
+
+// the keypair is a reference parameter, so it is not read from the call frame
+foreach ([new \Secp256k1\PublicKey(), "not a keypair"] as $notKeypair) {
+    try {
+        secp256k1_keypair_xonly_tweak_add($ctx, $notKeypair, $tweak);
+    } catch (\TypeError $e) {
+        echo $e->getMessage() . PHP_EOL;
+    }
+}
+
+?>
+--EXPECT--
+Argument 2 passed to secp256k1_keypair_xonly_tweak_add() must be of the type resource, object given
+Argument 2 passed to secp256k1_keypair_xonly_tweak_add() must be of the type resource, string given
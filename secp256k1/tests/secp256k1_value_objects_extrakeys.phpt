@@ -0,0 +1,55 @@
+--TEST--
+Secp256k1\KeyPair and Secp256k1\XOnlyPublicKey can be used in place of resources
+--SKIPIF--
+<?php
+if (!extension_loaded("secp256k1")) print "skip extension not loaded";
+if (!function_exists("secp256k1_keypair_create")) print "skip no extrakeys support";
+?>
+--FILE--
+<?php
+$ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+$seckey = pack("H*", "0000000000000000000000000000000000000000000000000000000000000003");
+$keypair = new \Secp256k1\KeyPair();
+$result = secp256k1_keypair_create($ctx, $keypair, $seckey);
+echo $result . PHP_EOL;
+
+$seckeyOut = '';
+$result = secp256k1_keypair_sec($ctx, $seckeyOut, $keypair);
+echo $result . PHP_EOL;
+var_dump($seckeyOut === $seckey);
+
+$xonlyPub = new \Secp256k1\XOnlyPublicKey();
+$pkParity = null;
+$result = secp256k1_keypair_xonly_pub($ctx, $xonlyPub, $pkParity, $keypair);
+echo $result . PHP_EOL;
+echo "Parity $pkParity\n";
+
+$xonlyPub32 = '';
+$result = secp256k1_xonly_pubkey_serialize($ctx, $xonlyPub32, $xonlyPub);
+echo $result . PHP_EOL;
+echo unpack("H*", $xonlyPub32)[1] . PHP_EOL;
+
+$pubKey = new \Secp256k1\PublicKey();
+$result = secp256k1_keypair_pub($ctx, $pubKey, $keypair);
+echo $result . PHP_EOL;
+
+$fromPub = new \Secp256k1\XOnlyPublicKey();
+$result = secp256k1_xonly_pubkey_from_pubkey($ctx, $fromPub, $pkParity, $pubKey);
+echo $result . PHP_EOL;
+$fromPub32 = '';
+secp256k1_xonly_pubkey_serialize($ctx, $fromPub32, $fromPub);
+var_dump($fromPub32 === $xonlyPub32);
+
+?>
+--EXPECT--
+1
+1
+bool(true)
+1
+Parity 0
+1
+f9308a019258c31049344f85f89d5229b531c845836f99b08601f113bce036f9
+1
+1
+bool(true)
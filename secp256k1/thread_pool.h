@@ -0,0 +1,286 @@
+#include <stdlib.h>
+#include <string.h>
+
+/** Worker pool behind the batch functions.
+ *
+ *  A batch is a function applied to the indices [0, n). The calling thread
+ *  and the workers claim chunks of indices until none are left. The outcome
+ *  for index i is written to bit i of the result bitmap, so results are in
+ *  input order no matter which thread computed them. Chunks are multiples of
+ *  8 indices, which means no two threads ever write the same bitmap byte.
+ *
+ *  Workers only ever touch libsecp256k1 and the memory handed to them by the
+ *  caller: they never call into the Zend engine, allocate request memory or
+ *  read module globals. Each worker owns a context cloned with
+ *  secp256k1_context_clone, the calling thread keeps using its own.
+ *
+ *  The pool is process wide. Threads do not survive fork(), so a pool found
+ *  in a child process is abandoned and a new one is started.
+ */
+
+/* computes the result for item i of a batch, returns 1 on success. */
+typedef int (*php_secp256k1_batch_fn)(const secp256k1_context *ctx, void *arg, size_t i);
+
+/* runs items [start, end) in the calling thread. Without a bitmap it stops
+ * at the first failure. */
+static int php_secp256k1_batch_serial(const secp256k1_context *ctx, php_secp256k1_batch_fn fn, void *arg,
+                                      size_t start, size_t end, unsigned char *bitmap)
+{
+    size_t i;
+    int result = 1;
+    for (i = start; i < end; i++) {
+        if (fn(ctx, arg, i)) {
+            if (bitmap != NULL) {
+                BITMAP_SET(bitmap, i);
+            }
+        } else {
+            result = 0;
+            if (bitmap == NULL) {
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+#ifdef HAVE_SECP256K1_THREADS
+#include <pthread.h>
+#include <unistd.h>
+
+/* batches smaller than this run in the calling thread, waking the workers
+ * costs more than verifying a handful of signatures. */
+#define POOL_MIN_BATCH 16
+
+typedef struct _php_secp256k1_pool {
+    pthread_mutex_t lock;
+    pthread_cond_t work_cond;
+    pthread_cond_t done_cond;
+    // held by the thread which owns the pool for the current batch
+    pthread_mutex_t busy;
+    pthread_t *threads;
+    secp256k1_context **ctxs;
+    size_t nthreads;
+    pid_t pid;
+    int shutdown;
+
+    // the batch currently being processed, guarded by lock
+    unsigned long generation;
+    php_secp256k1_batch_fn fn;
+    void *arg;
+    unsigned char *bitmap;
+    size_t n;
+    size_t next;
+    size_t chunk;
+    size_t active;
+    int failed;
+} php_secp256k1_pool;
+
+static php_secp256k1_pool *php_secp256k1_pool_instance = NULL;
+static pthread_mutex_t php_secp256k1_pool_init_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* claims and runs chunks of the current batch until none are left, or
+ * until an item failed and there is no bitmap to fill. called with lock
+ * held, returns with lock held. */
+static void php_secp256k1_pool_drain(php_secp256k1_pool *pool, const secp256k1_context *ctx)
+{
+    size_t start, end;
+    while (pool->next < pool->n && !(pool->bitmap == NULL && pool->failed)) {
+        start = pool->next;
+        end = start + pool->chunk < pool->n ? start + pool->chunk : pool->n;
+        pool->next = end;
+        pthread_mutex_unlock(&pool->lock);
+        if (!php_secp256k1_batch_serial(ctx, pool->fn, pool->arg, start, end, pool->bitmap)) {
+            pthread_mutex_lock(&pool->lock);
+            pool->failed = 1;
+        } else {
+            pthread_mutex_lock(&pool->lock);
+        }
+    }
+}
+
+static void *php_secp256k1_pool_worker(void *ptr)
+{
+    php_secp256k1_pool *pool = (php_secp256k1_pool *) ptr;
+    const secp256k1_context *ctx;
+    unsigned long seen = 0;
+    size_t id;
+
+    pthread_mutex_lock(&pool->lock);
+    // workers are started in order while the creating thread holds lock
+    id = pool->active++;
+    ctx = pool->ctxs[id];
+    if (pool->active == pool->nthreads) {
+        pthread_cond_signal(&pool->done_cond);
+    }
+    for (;;) {
+        while (!pool->shutdown && seen == pool->generation) {
+            pthread_cond_wait(&pool->work_cond, &pool->lock);
+        }
+        if (pool->shutdown) {
+            break;
+        }
+        seen = pool->generation;
+        php_secp256k1_pool_drain(pool, ctx);
+        if (--pool->active == 0) {
+            pthread_cond_signal(&pool->done_cond);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+static void php_secp256k1_pool_free(php_secp256k1_pool *pool)
+{
+    size_t i;
+    for (i = 0; i < pool->nthreads; i++) {
+        if (pool->ctxs[i] != NULL) {
+            secp256k1_context_destroy(pool->ctxs[i]);
+        }
+    }
+    free(pool->ctxs);
+    free(pool->threads);
+    free(pool);
+}
+
+/* stops and joins the workers. only valid in the process which started them. */
+static void php_secp256k1_pool_destroy(php_secp256k1_pool *pool)
+{
+    size_t i;
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->lock);
+    for (i = 0; i < pool->nthreads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_cond_destroy(&pool->work_cond);
+    pthread_cond_destroy(&pool->done_cond);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_mutex_destroy(&pool->busy);
+    php_secp256k1_pool_free(pool);
+}
+
+static php_secp256k1_pool *php_secp256k1_pool_create(size_t nthreads, const secp256k1_context *source)
+{
+    php_secp256k1_pool *pool;
+    size_t i, started;
+
+    if ((pool = calloc(1, sizeof(php_secp256k1_pool))) == NULL) {
+        return NULL;
+    }
+    pool->threads = calloc(nthreads, sizeof(pthread_t));
+    pool->ctxs = calloc(nthreads, sizeof(secp256k1_context *));
+    pool->nthreads = nthreads;
+    if (pool->threads == NULL || pool->ctxs == NULL) {
+        php_secp256k1_pool_free(pool);
+        return NULL;
+    }
+    for (i = 0; i < nthreads; i++) {
+        pool->ctxs[i] = secp256k1_context_clone(source);
+    }
+
+    pool->pid = getpid();
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_mutex_init(&pool->busy, NULL);
+    pthread_cond_init(&pool->work_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+
+    pthread_mutex_lock(&pool->lock);
+    for (started = 0; started < nthreads; started++) {
+        if (pthread_create(&pool->threads[started], NULL, php_secp256k1_pool_worker, pool) != 0) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    if (started < nthreads) {
+        for (i = started; i < nthreads; i++) {
+            secp256k1_context_destroy(pool->ctxs[i]);
+            pool->ctxs[i] = NULL;
+        }
+        pool->nthreads = started;
+        php_secp256k1_pool_destroy(pool);
+        return NULL;
+    }
+
+    // wait until every worker picked up its context and went idle
+    pthread_mutex_lock(&pool->lock);
+    while (pool->active < nthreads) {
+        pthread_cond_wait(&pool->done_cond, &pool->lock);
+    }
+    pool->active = 0;
+    pthread_mutex_unlock(&pool->lock);
+    return pool;
+}
+
+/* returns the process wide pool, starting it on first use, or after a fork.
+ * source is the context cloned for each worker. */
+static php_secp256k1_pool *php_secp256k1_pool_get(size_t nthreads, const secp256k1_context *source)
+{
+    php_secp256k1_pool *pool;
+
+    pthread_mutex_lock(&php_secp256k1_pool_init_lock);
+    pool = php_secp256k1_pool_instance;
+    if (pool != NULL && pool->pid != getpid()) {
+        // inherited from the parent: its threads are gone and its locks may
+        // have been held at fork time, only the contexts can be released.
+        php_secp256k1_pool_free(pool);
+        pool = php_secp256k1_pool_instance = NULL;
+    }
+    if (pool == NULL && source != NULL) {
+        pool = php_secp256k1_pool_instance = php_secp256k1_pool_create(nthreads, source);
+    }
+    pthread_mutex_unlock(&php_secp256k1_pool_init_lock);
+    return pool;
+}
+
+/* joins the workers at module shutdown. */
+static void php_secp256k1_pool_shutdown(void)
+{
+    php_secp256k1_pool *pool = php_secp256k1_pool_instance;
+    php_secp256k1_pool_instance = NULL;
+    if (pool != NULL && pool->pid == getpid()) {
+        php_secp256k1_pool_destroy(pool);
+    }
+}
+
+/* runs a batch on the pool, with the calling thread taking part using ctx.
+ * falls back to running inline if another thread is using the pool. */
+static int php_secp256k1_pool_run(php_secp256k1_pool *pool, const secp256k1_context *ctx,
+                                  php_secp256k1_batch_fn fn, void *arg, size_t n, unsigned char *bitmap)
+{
+    int result;
+
+    if (pthread_mutex_trylock(&pool->busy) != 0) {
+        return php_secp256k1_batch_serial(ctx, fn, arg, 0, n, bitmap);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->arg = arg;
+    pool->bitmap = bitmap;
+    pool->n = n;
+    pool->next = 0;
+    // a few chunks per thread evens out the load, rounded to whole bitmap bytes
+    pool->chunk = ((n / ((pool->nthreads + 1) * 4)) + 7) & ~((size_t) 7);
+    if (pool->chunk == 0) {
+        pool->chunk = 8;
+    }
+    pool->failed = 0;
+    pool->active = pool->nthreads;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_cond);
+
+    php_secp256k1_pool_drain(pool, ctx);
+    while (pool->active > 0) {
+        pthread_cond_wait(&pool->done_cond, &pool->lock);
+    }
+    result = !pool->failed;
+    pool->fn = NULL;
+    pool->arg = NULL;
+    pool->bitmap = NULL;
+    pthread_mutex_unlock(&pool->lock);
+
+    pthread_mutex_unlock(&pool->busy);
+    return result;
+}
+#endif
@@ -0,0 +1,93 @@
+<?php
+namespace Secp256k1;
+
+/**
+ * A public key, usable wherever a secp256k1_pubkey resource is accepted.
+ *
+ * Pass a new instance as the out parameter of a function returning a public
+ * key to have the key written into it.
+ */
+final class PublicKey {}
+/**
+ * An ECDSA signature, usable wherever a secp256k1_ecdsa_signature resource is accepted.
+ */
+final class EcdsaSignature {}
+/**
+ * An x-only public key, usable wherever a secp256k1_xonly_pubkey resource is accepted.
+ */
+final class XOnlyPublicKey {}
+/**
+ * A keypair, usable wherever a secp256k1_keypair resource is accepted.
+ *
+ * The secret key is wiped when the object is destroyed.
+ */
+final class KeyPair {}
+/**
+ * A list of public keys stored contiguously, at 64 bytes per key.
+ *
+ * Accepted in place of an array of public keys by secp256k1_ec_pubkey_combine()
+ * and secp256k1_ecdsa_verify_batch().
+ */
+final class PublicKeyVector implements \Countable {
+    /**
+     * @param int $capacity number of keys to reserve room for
+     */
+    public function __construct(int $capacity = 0) {}
+    /**
+     * Copy a public key onto the end of the vector.
+     *
+     * @param resource|PublicKey $ecPublicKey
+     */
+    public function append($ecPublicKey) {}
+    /**
+     * Returns a copy of the key at $index.
+     *
+     * @param int $index
+     * @return PublicKey
+     */
+    public function get(int $index) {}
+    /**
+     * Returns a new vector holding up to $length keys starting at $offset.
+     *
+     * @param int $offset
+     * @param int|null $length
+     * @return PublicKeyVector
+     */
+    public function slice(int $offset, ?int $length = null) {}
+    /**
+     * @return int
+     */
+    public function count(): int {}
+}
+/**
+ * A BIP32 extended key: a chain code and a public key, plus the secret key
+ * for an extended private key.
+ *
+ * The secret key is wiped when the object is destroyed.
+ */
+final class ExtendedKey {}
+/**
+ * A running SHA256 hash, optionally BIP-340 tagged.
+ *
+ * Cloning copies the state, so a tagged or otherwise shared prefix is hashed
+ * once and cloned for every message.
+ */
+final class Sha256 {
+    /**
+     * @param string|null $tag starts a BIP-340 tagged hash if given
+     */
+    public function __construct(?string $tag = null) {}
+    /**
+     * Append data to the hash.
+     *
+     * @param string $data
+     */
+    public function update(string $data) {}
+    /**
+     * Returns the 32 byte hash of the data so far. The hash can be updated
+     * further afterwards.
+     *
+     * @return string
+     */
+    public function digest(): string {}
+}
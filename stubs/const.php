@@ -16,6 +16,20 @@ const SECP256K1_TAG_PUBKEY_ODD = 3;
 const SECP256K1_TAG_PUBKEY_UNCOMPRESSED = 4;
 const SECP256K1_TAG_PUBKEY_HYBRID_EVEN = 6;
 const SECP256K1_TAG_PUBKEY_HYBRID_ODD = 7;
+const SECP256K1_BIP32_HARDENED = 2147483648;
+const SECP256K1_ADDRESS_P2PKH = 0;
+const SECP256K1_ADDRESS_P2WPKH = 1;
+const SECP256K1_ADDRESS_P2TR = 2;
+const SECP256K1_SIG_FORMAT_DER = 0;
+const SECP256K1_SIG_FORMAT_DER_LAX = 1;
+const SECP256K1_SIG_FORMAT_COMPACT = 2;
+const SECP256K1_SIG_ALLOW_HIGH_S = 4;
 const SECP256K1_TYPE_RECOVERABLE_SIG = "secp256k1_ecdsa_recoverable_signature";
 const SECP256K1_TYPE_XONLY_PUBKEY = "secp256k1_xonly_pubkey";
 const SECP256K1_TYPE_KEYPAIR = "secp256k1_keypair";
+const SECP256K1_ECDH_HASH_DEFAULT = 0;
+const SECP256K1_ECDH_HASH_X = 1;
+const SECP256K1_ECDH_HASH_XY = 2;
+const SECP256K1_ECDH_HASH_SHA256_X = 3;
+const SECP256K1_ECDH_HASH_SHA512_XY = 4;
+const SECP256K1_ECDH_HASH_TAGGED_X = 5;
@@ -38,6 +38,56 @@ function secp256k1_context_clone($context): ?resource {}
  * @return bool
  */
 function secp256k1_context_destroy($context): bool {}
+/**
+ * Returns a process wide secp256k1 context which outlives the request.
+ * 
+ * The context is created once per process (during module startup when
+ * secp256k1.preload_context is enabled, otherwise on first use) and shared
+ * by every request, so the precomputed tables are not rebuilt per request.
+ * Destroying the returned resource leaves the shared context intact.
+ * 
+ * @param int $flags
+ * @return resource|null
+ */
+function secp256k1_context_persistent(int $flags): ?resource {}
+/**
+ * Returns the counters of the shared memory caches, summed over every process
+ * sharing them. A cache which is disabled or not supported is null.
+ * 
+ * @return array
+ */
+function secp256k1_cache_stats(): array {}
+/**
+ * Returns call counts and latencies of the functions called so far by this
+ * process, or thread in a threaded build, keyed by function name. Empty
+ * unless secp256k1.stats is enabled. Percentiles are upper bounds from the
+ * histogram, keyed by the smallest latency each bucket counts. With reset
+ * the figures start over after being returned.
+ * 
+ * @param bool $reset
+ * @return array
+ */
+function secp256k1_stats(bool $reset = false): array {}
+/**
+ * Registers an observer for the rest of the request. With secp256k1.trace
+ * enabled, begin(string $function) is called before each sampled signing,
+ * verification, recovery, ecdh or batch call, and end($begin, string
+ * $function, array $attributes) after it, $begin being what begin returned.
+ * Returns an id for secp256k1_trace_unregister(), or 0 on failure.
+ * 
+ * @param callable|null $begin
+ * @param callable|null $end
+ * @return int
+ */
+function secp256k1_trace_register(?callable $begin, ?callable $end): int {}
+/**
+ * Removes an observer registered with secp256k1_trace_register(). Returns 1
+ * if it was registered, 0 otherwise.
+ * 
+ * @param int $id
+ * @return int
+ */
+function secp256k1_trace_unregister(int $id): int {}
 /**
  * Parse a variable-length public key into the pubkey object.
  * 
@@ -49,6 +99,24 @@ function secp256k1_context_destroy($context): bool {}
  * @return int
  */
 function secp256k1_ec_pubkey_parse($context, &$ecPublicKey, string $publicKeyIn): int {}
+/**
+ * Parse a string of concatenated public keys, each $stride bytes long.
+ * 
+ * Valid keys are appended to $ecPublicKeys in input order and invalid keys
+ * are skipped. If $ecPublicKeys is not a Secp256k1\PublicKeyVector it is
+ * replaced with a new one. $validOut is set to a bitmap with bit i set when
+ * key i could be parsed.
+ * 
+ * Returns: 1 if every key was valid, 0 otherwise.
+ * 
+ * @param resource $context
+ * @param \Secp256k1\PublicKeyVector|null $ecPublicKeys
+ * @param string|null $validOut
+ * @param string $publicKeysIn
+ * @param int $stride
+ * @return int
+ */
+function secp256k1_ec_pubkey_parse_many($context, &$ecPublicKeys, ?string &$validOut, string $publicKeysIn, int $stride): int {}
 /**
  * Serialize a pubkey object into a serialized byte sequence.
  * 
@@ -61,6 +129,21 @@ function secp256k1_ec_pubkey_parse($context, &$ecPublicKey, string $publicKeyIn)
  * @return int
  */
 function secp256k1_ec_pubkey_serialize($context, ?string &$publicKeyOut, $ecPublicKey, int $flags): int {}
+/**
+ * Serialize a list of public keys into one string of concatenated keys.
+ * 
+ * Each key takes 33 bytes with SECP256K1_EC_COMPRESSED and 65 bytes with
+ * SECP256K1_EC_UNCOMPRESSED. The output is allocated once.
+ * 
+ * Returns: 1 always.
+ * 
+ * @param resource $context
+ * @param string|null $publicKeysOut
+ * @param array|\Secp256k1\PublicKeyVector $ecPublicKeys
+ * @param int $flags
+ * @return int
+ */
+function secp256k1_ec_pubkey_serialize_many($context, ?string &$publicKeysOut, $ecPublicKeys, int $flags): int {}
 /**
  * Parse an ECDSA signature in compact (64 bytes) format.
  * 
@@ -94,6 +177,21 @@ function secp256k1_ecdsa_signature_parse_der($context, &$ecdsaSignatureOut, stri
  * @return int
  */
 function secp256k1_ecdsa_signature_serialize_der($context, ?string &$sigDerOut, $ecdsaSignature): int {}
+/**
+ * Serialize a list of ECDSA signatures in DER format into one string.
+ * 
+ * $lengthsOut is set to a string with one byte per signature holding the
+ * length of its encoding, in the same order as the signatures.
+ * 
+ * Returns: 1 always.
+ * 
+ * @param resource $context
+ * @param string|null $sigsDerOut
+ * @param string|null $lengthsOut
+ * @param array $ecdsaSignatures
+ * @return int
+ */
+function secp256k1_ecdsa_signature_serialize_der_many($context, ?string &$sigsDerOut, ?string &$lengthsOut, array $ecdsaSignatures): int {}
 /**
  * Serialize an ECDSA signature in compact (64 byte) format.
  * 
@@ -105,6 +203,18 @@ function secp256k1_ecdsa_signature_serialize_der($context, ?string &$sigDerOut,
  * @return int
  */
 function secp256k1_ecdsa_signature_serialize_compact($context, ?string &$sig64Out, $ecdsaSignature): int {}
+/**
+ * Serialize a list of ECDSA signatures in compact format into one string of
+ * concatenated 64 byte signatures.
+ * 
+ * Returns: 1 always.
+ * 
+ * @param resource $context
+ * @param string|null $sigs64Out
+ * @param array $ecdsaSignatures
+ * @return int
+ */
+function secp256k1_ecdsa_signature_serialize_compact_many($context, ?string &$sigs64Out, array $ecdsaSignatures): int {}
 /**
  * Verify an ECDSA signature.
  * 
@@ -118,6 +228,44 @@ function secp256k1_ecdsa_signature_serialize_compact($context, ?string &$sig64Ou
  * @return int
  */
 function secp256k1_ecdsa_verify($context, $ecdsaSignature, string $msg32, $ecPublicKey): int {}
+/**
+ * Verify an ECDSA signature straight from its encoding and the 33 or 65 byte
+ * encoding of the public key, without creating resources. flags selects the
+ * signature encoding: SECP256K1_SIG_FORMAT_DER, SECP256K1_SIG_FORMAT_DER_LAX or
+ * SECP256K1_SIG_FORMAT_COMPACT. High S signatures are rejected unless flags
+ * includes SECP256K1_SIG_ALLOW_HIGH_S.
+ * 
+ * Returns: 1: correct signature
+ *          0: incorrect signature, or an encoding failed to parse
+ * 
+ * @param resource $context
+ * @param string $signature
+ * @param string $msg32
+ * @param string $publicKey
+ * @param int $flags
+ * @return int
+ */
+function secp256k1_ecdsa_verify_raw($context, string $signature, string $msg32, string $publicKey, int $flags = SECP256K1_SIG_FORMAT_DER): int {}
+/**
+ * Verify a batch of ECDSA signatures.
+ * 
+ * The i-th signature is verified against the i-th message and public key.
+ * If $resultsOut is provided, every signature is verified and $resultsOut is
+ * set to a bitmap with bit i set when signature i was valid. Otherwise
+ * verification stops at the first invalid signature. The context must have
+ * been created with SECP256K1_CONTEXT_VERIFY.
+ * 
+ * Returns: 1: all signatures were valid (or the batch was empty).
+ *          0: at least one signature was invalid.
+ * 
+ * @param resource $context
+ * @param array $ecdsaSignatures
+ * @param array $msgs32
+ * @param array $ecPublicKeys
+ * @param string|null $resultsOut
+ * @return int
+ */
+function secp256k1_ecdsa_verify_batch($context, array $ecdsaSignatures, array $msgs32, array $ecPublicKeys, ?string &$resultsOut): int {}
 /**
  * Convert a signature to a normalized lower-S form.
  * 
@@ -167,6 +315,24 @@ function secp256k1_ec_seckey_verify($context, string $secretKey): int {}
  * @return int
  */
 function secp256k1_ec_pubkey_create($context, &$ecPublicKey, string $secretKey): int {}
+/**
+ * Compute the public keys of a string of concatenated 32 byte secret keys.
+ * 
+ * $publicKeysOut is set to the serialized keys in input order, 33 bytes
+ * each if $flags is SECP256K1_EC_COMPRESSED and 65 bytes otherwise. The
+ * key of an invalid secret key is left zeroed. $validOut is set to a
+ * bitmap with bit i set when secret key i was valid.
+ * 
+ * Returns: 1 if every secret key was valid, 0 otherwise.
+ * 
+ * @param resource $context
+ * @param string|null $publicKeysOut
+ * @param string|null $validOut
+ * @param string $secretKeys
+ * @param int $flags
+ * @return int
+ */
+function secp256k1_ec_pubkey_create_many($context, ?string &$publicKeysOut, ?string &$validOut, string $secretKeys, int $flags): int {}
 /**
  * Negates a private key in place.
  * 
@@ -257,6 +423,214 @@ function secp256k1_context_randomize($context, ?string $seed32): int {}
  * @return int
  */
 function secp256k1_ec_pubkey_combine($context, &$combinedEcPublicKey, array $publicKeys): int {}
+/**
+ * Derive the BIP32 master key from a seed of 16 to 64 bytes.
+ * 
+ * Returns: 1 if the seed yields a valid key, 0 otherwise.
+ * 
+ * @param resource $context
+ * @param \Secp256k1\ExtendedKey|null $extendedKey
+ * @param string $seed
+ * @return int
+ */
+function secp256k1_bip32_master($context, &$extendedKey, string $seed): int {}
+/**
+ * Derive a descendant of an extended key along a path such as "m/84'/0'/0'/0/5".
+ * 
+ * Hardened steps are marked with ', h or H and need an extended private key.
+ * Intermediate keys are cached for the rest of the request, up to
+ * secp256k1.bip32_cache_size keys, so deriving sequential children of one
+ * account only computes the last step.
+ * 
+ * Returns: 1 if every step could be derived, 0 otherwise.
+ * 
+ * @param resource $context
+ * @param \Secp256k1\ExtendedKey|null $childKey
+ * @param \Secp256k1\ExtendedKey $parentKey
+ * @param string $path
+ * @return int
+ */
+function secp256k1_bip32_derive($context, &$childKey, $parentKey, string $path): int {}
+/**
+ * Derive the public keys of children $start to $start + $count - 1 of an extended key.
+ * 
+ * $publicKeysOut is set to the serialized keys in index order, 33 bytes
+ * each if $flags is SECP256K1_EC_COMPRESSED and 65 bytes otherwise. The
+ * key of an index which can't be derived is left zeroed. $validOut is set
+ * to a bitmap with bit i set when child $start + i was derived.
+ * 
+ * Returns: 1 if every child was derived, 0 otherwise.
+ * 
+ * @param resource $context
+ * @param string|null $publicKeysOut
+ * @param string|null $validOut
+ * @param \Secp256k1\ExtendedKey $parentKey
+ * @param int $start
+ * @param int $count
+ * @param int $flags
+ * @return int
+ */
+function secp256k1_bip32_derive_many($context, ?string &$publicKeysOut, ?string &$validOut, $parentKey, int $start, int $count, int $flags): int {}
+/**
+ * Serialize an extended key to the 78 bytes which are base58check encoded as xprv/xpub strings.
+ * 
+ * The secret key is serialized if the key holds one, so $version should
+ * match: 0x0488ade4 for xprv and 0x0488b21e for xpub.
+ * 
+ * Returns: 1 always.
+ * 
+ * @param resource $context
+ * @param string|null $extendedKeyOut
+ * @param \Secp256k1\ExtendedKey $extendedKey
+ * @param int $version
+ * @return int
+ */
+function secp256k1_bip32_serialize($context, ?string &$extendedKeyOut, $extendedKey, int $version): int {}
+/**
+ * Parse a 78 byte serialized extended key.
+ * 
+ * The version is returned for the caller to check, whether the key is
+ * private follows from the key data.
+ * 
+ * Returns: 1 if the key could be parsed, 0 otherwise.
+ * 
+ * @param resource $context
+ * @param \Secp256k1\ExtendedKey|null $extendedKey
+ * @param string $extendedKeyIn
+ * @param int|null $version
+ * @return int
+ */
+function secp256k1_bip32_parse($context, &$extendedKey, string $extendedKeyIn, ?int &$version = null): int {}
+/**
+ * Convert an extended key to the extended public key, dropping the secret key.
+ * 
+ * Returns: 1 always.
+ * 
+ * @param resource $context
+ * @param \Secp256k1\ExtendedKey|null $publicKey
+ * @param \Secp256k1\ExtendedKey $extendedKey
+ * @return int
+ */
+function secp256k1_bip32_neuter($context, &$publicKey, $extendedKey): int {}
+/**
+ * Return the public key of an extended key.
+ * 
+ * Returns: 1 always.
+ * 
+ * @param resource $context
+ * @param resource|\Secp256k1\PublicKey|null $ecPublicKey
+ * @param \Secp256k1\ExtendedKey $extendedKey
+ * @return int
+ */
+function secp256k1_bip32_pubkey($context, &$ecPublicKey, $extendedKey): int {}
+/**
+ * Return the secret key of an extended private key.
+ * 
+ * Returns: 1 if the key holds a secret key, 0 for an extended public key.
+ * 
+ * @param resource $context
+ * @param string|null $secretKeyOut
+ * @param \Secp256k1\ExtendedKey $extendedKey
+ * @return int
+ */
+function secp256k1_bip32_seckey($context, ?string &$secretKeyOut, $extendedKey): int {}
+/**
+ * Encode the P2PKH address of a public key. The key is hashed in its
+ * compressed encoding. version is the base58check version byte, 0 for
+ * mainnet and 111 for testnet.
+ * 
+ * Returns: 1 always.
+ * 
+ * @param resource $context
+ * @param string|null $addressOut
+ * @param resource $ecPublicKey
+ * @param int $version
+ * @return int
+ */
+function secp256k1_address_p2pkh($context, ?string &$addressOut, $ecPublicKey, int $version = 0): int {}
+/**
+ * Encode the P2WPKH (segwit v0) address of a public key under the human
+ * readable part hrp, "bc" for mainnet and "tb" for testnet.
+ * 
+ * Returns: 1 always.
+ * 
+ * @param resource $context
+ * @param string|null $addressOut
+ * @param resource $ecPublicKey
+ * @param string|null $hrp
+ * @return int
+ */
+function secp256k1_address_p2wpkh($context, ?string &$addressOut, $ecPublicKey, ?string $hrp = null): int {}
+/**
+ * Encode the P2TR (segwit v1) address of an x-only public key under the
+ * human readable part hrp. By default the key is an internal key and is
+ * tweaked without a script tree, as BIP86 wallets do. Pass tweak = false if
+ * it is the output key already.
+ * 
+ * Returns: 1 if the address was encoded, 0 if tweaking failed.
+ * 
+ * @param resource $context
+ * @param string|null $addressOut
+ * @param resource $xonlyPublicKey
+ * @param string|null $hrp
+ * @param bool $tweak
+ * @return int
+ */
+function secp256k1_address_p2tr($context, ?string &$addressOut, $xonlyPublicKey, ?string $hrp = null, bool $tweak = true): int {}
+/**
+ * Encode the addresses of a string of concatenated public keys: 33 byte
+ * compressed keys for SECP256K1_ADDRESS_P2PKH and SECP256K1_ADDRESS_P2WPKH,
+ * 32 byte x-only internal keys for SECP256K1_ADDRESS_P2TR. prefix is the
+ * version byte for P2PKH and the human readable part otherwise, defaulting
+ * to mainnet. addressesOut is set to the addresses in input order, with null
+ * for invalid keys, and validOut to a bitmap with bit i set if key i was
+ * valid. Large batches are spread over secp256k1.threads threads.
+ * 
+ * Returns: 1 if every key was valid, 0 otherwise.
+ * 
+ * @param resource $context
+ * @param array|null $addressesOut
+ * @param string|null $validOut
+ * @param int $type
+ * @param string $publicKeys
+ * @param int|string|null $prefix
+ * @return int
+ */
+function secp256k1_address_many($context, ?array &$addressesOut, ?string &$validOut, int $type, string $publicKeys, $prefix = null): int {}
+/**
+ * Compute the SHA256 hash of data.
+ * 
+ * Returns: 1 always.
+ * 
+ * @param string|null $hashOut
+ * @param string $data
+ * @return int
+ */
+function secp256k1_sha256(?string &$hashOut, string $data): int {}
+/**
+ * Compute the BIP-340 tagged hash SHA256(SHA256(tag) || SHA256(tag) || data).
+ * The prefix of the BIP-340 and BIP-341 tags is precomputed, use a cloned
+ * Secp256k1\Sha256 to reuse the prefix of other tags.
+ * 
+ * Returns: 1 always.
+ * 
+ * @param string|null $hashOut
+ * @param string $tag
+ * @param string $data
+ * @return int
+ */
+function secp256k1_tagged_sha256(?string &$hashOut, string $tag, string $data): int {}
+/**
+ * Compute HMAC-SHA256 of data under key.
+ * 
+ * Returns: 1 always.
+ * 
+ * @param string|null $hashOut
+ * @param string $key
+ * @param string $data
+ * @return int
+ */
+function secp256k1_hmac_sha256(?string &$hashOut, string $key, string $data): int {}
 /**
  * Create a secp256k1 scratch space object.
  * 
@@ -364,6 +738,59 @@ function secp256k1_ecdsa_sign_recoverable($context, &$ecdsaRecoverableSignatureO
  * @return int
  */
 function secp256k1_ecdsa_recover($context, &$ecPublicKey, $ecdsaRecoverableSignature, string $msg32): int {}
+/**
+ * Recover the public keys of a string of concatenated 65 byte r || s || v
+ * signatures, v being the recovery id either as 0 to 3 or as 27 to 30. msgs32
+ * holds the 32 byte message hash of each signature, in the same order.
+ * publicKeysOut is set to the serialized keys in input order, 33 bytes each if
+ * flags is SECP256K1_EC_COMPRESSED and 65 bytes otherwise. The key of a
+ * signature which does not recover is left zeroed, and validOut is set to a
+ * bitmap with bit i set if signature i recovered. Large batches are spread
+ * over secp256k1.threads threads.
+ * 
+ * Returns: 1 if every signature recovered, 0 otherwise.
+ * 
+ * @param resource $context
+ * @param string|null $publicKeysOut
+ * @param string|null $validOut
+ * @param string $signatures
+ * @param string $msgs32
+ * @param int $flags
+ * @return int
+ */
+function secp256k1_ecdsa_recover_many($context, ?string &$publicKeysOut, ?string &$validOut, string $signatures, string $msgs32, int $flags): int {}
+/**
+ * Recover the 20 byte Ethereum address of the signer of an r || s || v
+ * signature, v being the recovery id either as 0 to 3 or as 27 to 30. The
+ * Keccak-256 hash is computed natively.
+ * 
+ * Returns: 1 if the signature recovered, 0 otherwise.
+ * 
+ * @param resource $context
+ * @param string|null $addressOut
+ * @param string $sig65
+ * @param string $msg32
+ * @return int
+ */
+function secp256k1_ecdsa_recover_address($context, ?string &$addressOut, string $sig65, string $msg32): int {}
+/**
+ * Recover the Ethereum addresses of the signers of a string of concatenated
+ * 65 byte r || s || v signatures, msgs32 holding the 32 byte message hash of
+ * each. addressesOut is set to the 20 byte addresses in input order. The
+ * address of a signature which does not recover is left zeroed, and validOut
+ * is set to a bitmap with bit i set if signature i recovered. Large batches
+ * are spread over secp256k1.threads threads.
+ * 
+ * Returns: 1 if every signature recovered, 0 otherwise.
+ * 
+ * @param resource $context
+ * @param string|null $addressesOut
+ * @param string|null $validOut
+ * @param string $signatures
+ * @param string $msgs32
+ * @return int
+ */
+function secp256k1_ecdsa_recover_address_many($context, ?string &$addressesOut, ?string &$validOut, string $signatures, string $msgs32): int {}
 /**
  * Compute an EC Diffie-Hellman secret in constant time.
  * A custom hash function may be provided as the 5th
@@ -371,6 +798,11 @@ function secp256k1_ecdsa_recover($context, &$ecPublicKey, $ecdsaRecoverableSigna
  * passed as the 6th argument.
  * Optional additional data may be provided to the callback
  * via the 7th argument.
+ * Instead of a callable, one of the SECP256K1_ECDH_HASH_*
+ * constants selects a hash computed without calling into PHP:
+ * X (32 bytes), XY (64 bytes), SHA256_X (32 bytes),
+ * SHA512_XY (64 bytes) or TAGGED_X (32 bytes, the tag is
+ * passed as the 7th argument).
  * The default hash function is essentially the following:
  * function (&$output, $x, $y, $data) {
  *     $version = 0x02 | (unpack("C", $y[31])[1] & 0x01);
@@ -388,12 +820,31 @@ function secp256k1_ecdsa_recover($context, &$ecPublicKey, $ecdsaRecoverableSigna
  * @param string $result
  * @param resource $ecPublicKey
  * @param string $privKey
- * @param callable|null $hashfxn
+ * @param callable|int|null $hashfxn
  * @param int|null $outputLen
  * @param  $data
  * @return int
  */
-function secp256k1_ecdh($context, string &$result, $ecPublicKey, string $privKey, ?callable $hashfxn, ?int $outputLen, $data): int {}
+function secp256k1_ecdh($context, string &$result, $ecPublicKey, string $privKey, $hashfxn, ?int $outputLen, $data): int {}
+/**
+ * Compute the EC Diffie-Hellman secret of one secret key with every
+ * public key, in constant time. secrets is set to the secrets
+ * concatenated in input order. Only the native SECP256K1_ECDH_HASH_*
+ * modes are available, SECP256K1_ECDH_HASH_TAGGED_X takes its tag
+ * as the 6th argument.
+ * 
+ * Returns: 1: the secrets were computed
+ *          0: the secret key was invalid (zero or overflow)
+ * 
+ * @param resource $context
+ * @param string|null $secrets
+ * @param string $privKey
+ * @param array|\Secp256k1\PublicKeyVector $ecPublicKeys
+ * @param int $hashMode
+ * @param string|null $data
+ * @return int
+ */
+function secp256k1_ecdh_many($context, ?string &$secrets, string $privKey, $ecPublicKeys, int $hashMode = SECP256K1_ECDH_HASH_DEFAULT, ?string $data = null): int {}
 /**
  * @param resource $context
  * @param resource|null $pubkey
@@ -502,6 +953,42 @@ function secp256k1_schnorrsig_sign($context, &$sig64, string $msg32, $keypair, ?
  * @return int
  */
 function secp256k1_schnorrsig_verify($context, string $sig64, string $msg32, $pubkey): int {}
+/**
+ * Verify a Schnorr signature against the 32 byte encoding of an x-only public
+ * key, without creating a resource.
+ * 
+ * Returns: 1: correct signature
+ *          0: incorrect signature, or the key failed to parse
+ * 
+ * @param resource $context
+ * @param string $sig64
+ * @param string $msg32
+ * @param string $xonlyPubkey32
+ * @return int
+ */
+function secp256k1_schnorrsig_verify_raw($context, string $sig64, string $msg32, string $xonlyPubkey32): int {}
+/**
+ * Verifies each of a list of Schnorr signatures in turn; this is not a batch
+ *  verification in the BIP340 sense, libsecp256k1 offers none.
+ * 
+ *  Returns 1 if all succeeded, 0 otherwise. In particular, returns 1 if the list is empty.
+ *  If $resultsOut is provided every signature is checked, and $resultsOut is set to
+ *  a bitmap with bit i set when signature i was valid. Otherwise verification stops at
+ *  the first invalid signature.
+ * 
+ *   Args:    ctx: a secp256k1 context object, initialized for verification
+ *                (an InvalidArgumentException is thrown otherwise).
+ *   In:   sigs64: array of 64-byte signatures
+ *         msgs32: array of 32-byte messages
+ *        pubkeys: array of x-only public keys
+ * @param resource $context
+ * @param array $sigs64
+ * @param array $msgs32
+ * @param array $pubkeys
+ * @param string|null $resultsOut
+ * @return int
+ */
+function secp256k1_schnorrsig_verify_batch($context, array $sigs64, array $msgs32, array $pubkeys, ?string &$resultsOut): int {}
 /**
  * @param string|null $nonce32
  * @param string $msg32